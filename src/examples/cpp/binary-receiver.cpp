@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <log4cxx/logmanager.h>
+#include <log4cxx/basicconfigurator.h>
+#include <log4cxx/propertyconfigurator.h>
+#include <log4cxx/xml/domconfigurator.h>
+#include <log4cxx/net/binarysocketreceiver.h>
+#include <log4cxx/helpers/exception.h>
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+using namespace log4cxx;
+
+/**
+This program receives events from BinarySocketAppender instances
+and logs them using the appenders in a configuration file.
+It runs until standard input is closed.
+*/
+int main(int argc, const char* argv[])
+{
+	if (argc < 2 || 3 < argc)
+	{
+		std::cout << "Usage: " << argv[0] << " port [configFile]" << std::endl;
+		return EXIT_FAILURE;
+	}
+	if (argc == 3)
+	{
+		std::string configFile(argv[2]);
+		if (configFile.length() > 4 &&
+			configFile.substr(configFile.length() - 4) == ".xml")
+			xml::DOMConfigurator::configure(configFile);
+		else
+			PropertyConfigurator::configure(configFile);
+	}
+	else
+		BasicConfigurator::configure();
+
+	int result = EXIT_SUCCESS;
+	try
+	{
+		net::BinarySocketReceiver receiver(std::atoi(argv[1]), LogManager::getLoggerRepository());
+		receiver.start();
+		std::string line;
+		while (std::getline(std::cin, line))
+			;
+		receiver.close();
+		std::cout << receiver.getEventCount() << " events received" << std::endl;
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		result = EXIT_FAILURE;
+	}
+	LogManager::shutdown();
+	return result;
+}
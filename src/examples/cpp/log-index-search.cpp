@@ -0,0 +1,103 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/helpers/logfileindex.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <log4cxx/level.h>
+#include <algorithm>
+#include <ctime>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+// Microseconds since 1970 for seconds since 1970 or a local YYYY-MM-DDTHH:MM:SS time
+log4cxx_time_t parseTime(const std::string& value)
+{
+	if (value.find_first_not_of("0123456789") == std::string::npos)
+		return log4cxx_time_t(std::stoll(value)) * 1000000;
+	std::tm tm{};
+	std::istringstream input(value);
+	input >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
+	if (input.fail())
+		throw std::runtime_error("Invalid time: " + value);
+	tm.tm_isdst = -1;
+	return log4cxx_time_t(std::mktime(&tm)) * 1000000;
+}
+
+/**
+This program writes the parts of a log file that can hold events
+in a time range to standard output,
+using the index maintained by a FileAppender with the IndexInterval option.
+*/
+int main(int argc, const char* argv[])
+{
+	if (argc < 4 || 6 < argc)
+	{
+		std::cout << "Usage: " << argv[0] << " logFile from to [threshold [logger]]" << std::endl
+			<< "  from and to are seconds since 1970 or local times as YYYY-MM-DDTHH:MM:SS" << std::endl;
+		return EXIT_FAILURE;
+	}
+	int result = EXIT_SUCCESS;
+	try
+	{
+		Pool p;
+		LOG4CXX_DECODE_CHAR(logFileName, std::string(argv[1]));
+		auto entries = LogFileIndex::read(LogFileIndex::getIndexFileName(logFileName), p);
+		uint32_t levelMask = UINT32_MAX;
+		if (4 < argc)
+		{
+			LOG4CXX_DECODE_CHAR(threshold, std::string(argv[4]));
+			levelMask = LogFileIndex::getLevelMask(Level::toLevel(threshold));
+		}
+		LogString loggerName;
+		if (5 < argc)
+			Transcoder::decode(std::string(argv[5]), loggerName);
+		auto ranges = LogFileIndex::findRanges(entries, parseTime(argv[2]), parseTime(argv[3]), levelMask, loggerName);
+
+		std::ifstream input(argv[1], std::ios::binary);
+		char buffer[64 * 1024];
+		for (auto& range : ranges)
+		{
+			input.clear();
+			input.seekg(std::streamoff(range.first));
+			auto remaining = range.second - range.first;
+			while (0 < remaining)
+			{
+				input.read(buffer, std::streamsize(std::min<uint64_t>(remaining, sizeof(buffer))));
+				auto count = input.gcount();
+				if (count <= 0)
+					break;
+				std::cout.write(buffer, count);
+				remaining -= uint64_t(count);
+			}
+		}
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		result = EXIT_FAILURE;
+	}
+	return result;
+}
@@ -20,7 +20,11 @@
 #include <log4cxx/spi/loggingevent.h>
 #include <algorithm>
 #include <log4cxx/helpers/pool.h>
+#include <log4cxx/private/hazardpointer.h>
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 using namespace LOG4CXX_NS;
 using namespace LOG4CXX_NS::helpers;
@@ -30,9 +34,50 @@ IMPLEMENT_LOG4CXX_OBJECT(AppenderAttachableImpl)
 
 struct AppenderAttachableImpl::priv_data
 {
-	/** Array of appenders. */
-	AppenderList  appenderList;
+	/** The current array of appenders or null when there are none.
+	 *
+	 * The array is never modified once published, so a reader can iterate
+	 * over it without copying it or taking a reference.
+	 */
+	std::atomic<const AppenderList*> appenderList{nullptr};
+
+	/** Replaced arrays that a thread may still be iterating over. */
+	std::vector<std::unique_ptr<const AppenderList>> retiredLists;
+
 	mutable std::mutex m_mutex;
+
+	~priv_data()
+	{
+		delete appenderList.load(std::memory_order_relaxed);
+	}
+
+	/** A copy of the current array. */
+	AppenderList getAppenderList() const
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		AppenderList result;
+		if (auto current = appenderList.load(std::memory_order_relaxed))
+			result = *current;
+		return result;
+	}
+
+	/** Publish \c newList as the current array. Requires m_mutex to be held. */
+	void setAppenderList(AppenderList&& newList)
+	{
+		const AppenderList* newValue = nullptr;
+		if (!newList.empty())
+			newValue = new AppenderList(std::move(newList));
+		if (auto previous = appenderList.exchange(newValue, std::memory_order_seq_cst))
+			retiredLists.emplace_back(previous);
+
+		// Delete the replaced arrays that no thread is iterating over
+		retiredLists.erase(std::remove_if(retiredLists.begin(), retiredLists.end()
+			, [](const std::unique_ptr<const AppenderList>& list)
+			{
+				return !HazardPointer::isInUse(list.get());
+			})
+			, retiredLists.end());
+	}
 };
 
 
@@ -57,13 +102,16 @@ void AppenderAttachableImpl::addAppender(const AppenderPtr newAppender)
 		m_priv = std::make_unique<AppenderAttachableImpl::priv_data>();
 
 	std::lock_guard<std::mutex> lock( m_priv->m_mutex );
-	AppenderList::iterator it = std::find(
-			m_priv->appenderList.begin(), m_priv->appenderList.end(), newAppender);
-
-	if (it == m_priv->appenderList.end())
+	AppenderList newList;
+	if (auto current = m_priv->appenderList.load(std::memory_order_relaxed))
 	{
-		m_priv->appenderList.push_back(newAppender);
+		if (std::find(current->begin(), current->end(), newAppender) != current->end())
+			return;
+		newList.reserve(current->size() + 1);
+		newList = *current;
 	}
+	newList.push_back(newAppender);
+	m_priv->setAppenderList(std::move(newList));
 }
 
 int AppenderAttachableImpl::appendLoopOnAppenders(
@@ -75,13 +123,25 @@ int AppenderAttachableImpl::appendLoopOnAppenders(
 	{
 		// FallbackErrorHandler::error() may modify our list of appenders
 		// while we are iterating over them (if it holds the same logger).
-		// So, make a local copy of the appenders that we want to iterate over
-		// before actually iterating over them.
-		AppenderList allAppenders = getAllAppenders();
-		for (auto appender : allAppenders)
+		// A modification publishes a new array, and the one announced here
+		// (and each appender in it) is not deleted until the loop completes.
+		HazardPointer guard;
+		if (!guard.hasSlot())
 		{
-			appender->doAppend(event, p);
-			numberAppended++;
+			// Deeply nested logging uses a copy
+			for (auto& appender : m_priv->getAppenderList())
+			{
+				appender->doAppend(event, p);
+				numberAppended++;
+			}
+		}
+		else if (auto allAppenders = guard.protect(m_priv->appenderList))
+		{
+			for (auto& appender : *allAppenders)
+			{
+				appender->doAppend(event, p);
+				numberAppended++;
+			}
 		}
 	}
 
@@ -92,10 +152,7 @@ AppenderList AppenderAttachableImpl::getAllAppenders() const
 {
 	AppenderList result;
 	if (m_priv)
-	{
-		std::lock_guard<std::mutex> lock( m_priv->m_mutex );
-		result = m_priv->appenderList;
-	}
+		result = m_priv->getAppenderList();
 	return result;
 }
 
@@ -104,8 +161,7 @@ AppenderPtr AppenderAttachableImpl::getAppender(const LogString& name) const
 	AppenderPtr result;
 	if (m_priv && !name.empty())
 	{
-		std::lock_guard<std::mutex> lock( m_priv->m_mutex );
-		for (auto appender : m_priv->appenderList)
+		for (auto& appender : m_priv->getAppenderList())
 		{
 			if (name == appender->getName())
 			{
@@ -123,7 +179,8 @@ bool AppenderAttachableImpl::isAttached(const AppenderPtr appender) const
 	if (m_priv && appender)
 	{
 		std::lock_guard<std::mutex> lock( m_priv->m_mutex );
-		result = std::find(m_priv->appenderList.begin(), m_priv->appenderList.end(), appender) != m_priv->appenderList.end();
+		if (auto current = m_priv->appenderList.load(std::memory_order_relaxed))
+			result = std::find(current->begin(), current->end(), appender) != current->end();
 	}
 	return result;
 }
@@ -132,22 +189,50 @@ void AppenderAttachableImpl::removeAllAppenders()
 {
 	if (m_priv)
 	{
-		for (auto a : getAllAppenders())
+		AppenderList previous;
+		{
+			std::lock_guard<std::mutex> lock( m_priv->m_mutex );
+			if (auto current = m_priv->appenderList.load(std::memory_order_relaxed))
+				previous = *current;
+			m_priv->setAppenderList(AppenderList());
+		}
+		for (auto& a : previous)
 			a->close();
-		std::lock_guard<std::mutex> lock( m_priv->m_mutex );
-		m_priv->appenderList.clear();
 	}
 }
 
+AppenderList AppenderAttachableImpl::replaceAppenders(const AppenderList& newList)
+{
+	AppenderList result;
+	if (!m_priv)
+		m_priv = std::make_unique<AppenderAttachableImpl::priv_data>();
+	AppenderList uniqueList;
+	for (auto& item : newList)
+	{
+		if (item && std::find(uniqueList.begin(), uniqueList.end(), item) == uniqueList.end())
+			uniqueList.push_back(item);
+	}
+	std::lock_guard<std::mutex> lock( m_priv->m_mutex );
+	if (auto current = m_priv->appenderList.load(std::memory_order_relaxed))
+		result = *current;
+	m_priv->setAppenderList(std::move(uniqueList));
+	return result;
+}
+
 void AppenderAttachableImpl::removeAppender(const AppenderPtr appender)
 {
 	if (m_priv && appender)
 	{
 		std::lock_guard<std::mutex> lock( m_priv->m_mutex );
-		auto it = std::find(m_priv->appenderList.begin(), m_priv->appenderList.end(), appender);
-		if (it != m_priv->appenderList.end())
+		if (auto current = m_priv->appenderList.load(std::memory_order_relaxed))
 		{
-			m_priv->appenderList.erase(it);
+			auto it = std::find(current->begin(), current->end(), appender);
+			if (it != current->end())
+			{
+				AppenderList newList(current->begin(), it);
+				newList.insert(newList.end(), it + 1, current->end());
+				m_priv->setAppenderList(std::move(newList));
+			}
 		}
 	}
 }
@@ -157,14 +242,20 @@ void AppenderAttachableImpl::removeAppender(const LogString& name)
 	if (m_priv && !name.empty())
 	{
 		std::lock_guard<std::mutex> lock( m_priv->m_mutex );
-		auto it = std::find_if(m_priv->appenderList.begin(), m_priv->appenderList.end()
-			, [&name](const AppenderPtr& appender) -> bool
+		if (auto current = m_priv->appenderList.load(std::memory_order_relaxed))
+		{
+			auto it = std::find_if(current->begin(), current->end()
+				, [&name](const AppenderPtr& appender) -> bool
+				{
+					return name == appender->getName();
+				});
+			if (it != current->end())
 			{
-				return name == appender->getName();
-			});
-		if (it != m_priv->appenderList.end())
-			m_priv->appenderList.erase(it);
+				AppenderList newList(current->begin(), it);
+				newList.insert(newList.end(), it + 1, current->end());
+				m_priv->setAppenderList(std::move(newList));
+			}
+		}
 	}
 }
 
-
@@ -0,0 +1,338 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/helpers/appendermetrics.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/pool.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <functional>
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::helpers;
+
+namespace
+{
+// Each power of two range is divided into this many buckets
+const int SubBucketBits = 3;
+const uint64_t SubBucketCount = uint64_t(1) << SubBucketBits;
+// Durations of 2^MaxExponent nanoseconds (about 2.4 hours) or more share the last bucket
+const int MaxExponent = 43;
+const size_t BucketCount = size_t(MaxExponent - SubBucketBits + 2) * SubBucketCount;
+const size_t ShardCount = 16;
+
+// The position of the most significant set bit of a non-zero value
+int highestBit(uint64_t value)
+{
+#if defined(__GNUC__)
+	return 63 - __builtin_clzll(value);
+#else
+	int result = 0;
+	for (int shift = 32; 0 < shift; shift /= 2)
+	{
+		if (value >> shift)
+		{
+			value >>= shift;
+			result += shift;
+		}
+	}
+	return result;
+#endif
+}
+
+struct alignas(128) Shard
+{
+	std::atomic<uint64_t> counters[AppenderMetrics::CounterCount];
+	struct Histogram
+	{
+		std::atomic<uint64_t> count;
+		std::atomic<uint64_t> total;
+		std::atomic<uint64_t> maximum;
+		std::atomic<uint64_t> buckets[BucketCount];
+	} histograms[AppenderMetrics::HistogramCount];
+};
+
+void updateMaximum(std::atomic<uint64_t>& maximum, uint64_t value)
+{
+	auto current = maximum.load(std::memory_order_relaxed);
+	while (current < value && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed))
+		;
+}
+
+} // namespace
+
+struct AppenderMetrics::AppenderMetricsPrivate
+{
+	AppenderMetricsPrivate()
+		: queueDepth(0)
+		, maximumQueueDepth(0)
+	{
+		for (auto& shard : shards)
+			shard.store(nullptr, std::memory_order_relaxed);
+	}
+
+	~AppenderMetricsPrivate()
+	{
+		for (auto& shard : shards)
+			delete shard.load(std::memory_order_relaxed);
+	}
+
+	// The shard used by the calling thread, allocated on first use
+	Shard& getShard()
+	{
+		auto index = std::hash<std::thread::id>()(std::this_thread::get_id()) % ShardCount;
+		auto pShard = shards[index].load(std::memory_order_acquire);
+		if (!pShard)
+		{
+			auto pNewShard = new Shard();
+			if (shards[index].compare_exchange_strong(pShard, pNewShard, std::memory_order_acq_rel))
+				pShard = pNewShard;
+			else
+				delete pNewShard;
+		}
+		return *pShard;
+	}
+
+	std::atomic<Shard*> shards[ShardCount];
+	std::atomic<uint64_t> queueDepth;
+	std::atomic<uint64_t> maximumQueueDepth;
+};
+
+AppenderMetrics::AppenderMetrics()
+	: m_priv(std::make_unique<AppenderMetricsPrivate>())
+{
+}
+
+AppenderMetrics::~AppenderMetrics()
+{
+}
+
+void AppenderMetrics::add(Counter counter, uint64_t value)
+{
+	m_priv->getShard().counters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+void AppenderMetrics::record(Histogram histogram, std::chrono::nanoseconds duration)
+{
+	auto value = duration.count() < 0 ? uint64_t(0) : uint64_t(duration.count());
+	auto& h = m_priv->getShard().histograms[histogram];
+	h.count.fetch_add(1, std::memory_order_relaxed);
+	h.total.fetch_add(value, std::memory_order_relaxed);
+	updateMaximum(h.maximum, value);
+	h.buckets[getBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void AppenderMetrics::setQueueDepth(uint64_t depth)
+{
+	m_priv->queueDepth.store(depth, std::memory_order_relaxed);
+	updateMaximum(m_priv->maximumQueueDepth, depth);
+}
+
+AppenderMetrics::Snapshot AppenderMetrics::getSnapshot() const
+{
+	Snapshot result{};
+	for (auto& h : result.histograms)
+		h.m_buckets.resize(BucketCount, 0);
+	for (auto& item : m_priv->shards)
+	{
+		auto pShard = item.load(std::memory_order_acquire);
+		if (!pShard)
+			continue;
+		for (int i = 0; i < CounterCount; ++i)
+			result.counters[i] += pShard->counters[i].load(std::memory_order_relaxed);
+		for (int i = 0; i < HistogramCount; ++i)
+		{
+			auto& source = pShard->histograms[i];
+			auto& dest = result.histograms[i];
+			dest.m_count += source.count.load(std::memory_order_relaxed);
+			dest.m_total += source.total.load(std::memory_order_relaxed);
+			dest.m_maximum = std::max(dest.m_maximum, source.maximum.load(std::memory_order_relaxed));
+			for (size_t j = 0; j < BucketCount; ++j)
+				dest.m_buckets[j] += source.buckets[j].load(std::memory_order_relaxed);
+		}
+	}
+	result.queueDepth = m_priv->queueDepth.load(std::memory_order_relaxed);
+	result.maximumQueueDepth = m_priv->maximumQueueDepth.load(std::memory_order_relaxed);
+	return result;
+}
+
+void AppenderMetrics::reset()
+{
+	for (auto& item : m_priv->shards)
+	{
+		auto pShard = item.load(std::memory_order_acquire);
+		if (!pShard)
+			continue;
+		for (auto& counter : pShard->counters)
+			counter.store(0, std::memory_order_relaxed);
+		for (auto& h : pShard->histograms)
+		{
+			h.count.store(0, std::memory_order_relaxed);
+			h.total.store(0, std::memory_order_relaxed);
+			h.maximum.store(0, std::memory_order_relaxed);
+			for (auto& bucket : h.buckets)
+				bucket.store(0, std::memory_order_relaxed);
+		}
+	}
+	m_priv->queueDepth.store(0, std::memory_order_relaxed);
+	m_priv->maximumQueueDepth.store(0, std::memory_order_relaxed);
+}
+
+void AppenderMetrics::format(LogString& dest, const Snapshot& snapshot)
+{
+	Pool p;
+	for (int i = 0; i < CounterCount; ++i)
+	{
+		if (i)
+			dest.append(LOG4CXX_STR(", "));
+		dest.append(getName(Counter(i)));
+		dest.append(LOG4CXX_STR("="));
+		StringHelper::toString((size_t)snapshot.counters[i], p, dest);
+	}
+	dest.append(LOG4CXX_STR(", QueueDepth="));
+	StringHelper::toString((size_t)snapshot.queueDepth, p, dest);
+	dest.append(LOG4CXX_STR(", MaximumQueueDepth="));
+	StringHelper::toString((size_t)snapshot.maximumQueueDepth, p, dest);
+	for (int i = 0; i < HistogramCount; ++i)
+	{
+		auto& h = snapshot.histograms[i];
+		if (0 == h.getCount())
+			continue;
+		dest.append(LOG4CXX_STR(", "));
+		dest.append(getName(Histogram(i)));
+		dest.append(LOG4CXX_STR("(ns) count="));
+		StringHelper::toString((size_t)h.getCount(), p, dest);
+		dest.append(LOG4CXX_STR(" mean="));
+		StringHelper::toString((size_t)h.getMean(), p, dest);
+		dest.append(LOG4CXX_STR(" p50="));
+		StringHelper::toString((size_t)h.getValueAtPercentile(50.0), p, dest);
+		dest.append(LOG4CXX_STR(" p99="));
+		StringHelper::toString((size_t)h.getValueAtPercentile(99.0), p, dest);
+		dest.append(LOG4CXX_STR(" max="));
+		StringHelper::toString((size_t)h.getMaximum(), p, dest);
+	}
+}
+
+LogString AppenderMetrics::getName(Counter counter)
+{
+	switch (counter)
+	{
+		case EventsAppended:
+			return LOG4CXX_STR("EventsAppended");
+		case BytesWritten:
+			return LOG4CXX_STR("BytesWritten");
+		case FilterDenials:
+			return LOG4CXX_STR("FilterDenials");
+		case Discards:
+			return LOG4CXX_STR("Discards");
+		default:
+			break;
+	}
+	return LogString();
+}
+
+LogString AppenderMetrics::getName(Histogram histogram)
+{
+	switch (histogram)
+	{
+		case AppendLatency:
+			return LOG4CXX_STR("AppendLatency");
+		case LockWait:
+			return LOG4CXX_STR("LockWait");
+		case RolloverDuration:
+			return LOG4CXX_STR("RolloverDuration");
+		default:
+			break;
+	}
+	return LogString();
+}
+
+size_t AppenderMetrics::getBucketCount()
+{
+	return BucketCount;
+}
+
+size_t AppenderMetrics::getBucketIndex(uint64_t nanoseconds)
+{
+	if (nanoseconds < SubBucketCount)
+		return size_t(nanoseconds);
+	auto exponent = highestBit(nanoseconds);
+	if (MaxExponent < exponent)
+		return BucketCount - 1;
+	auto subBucket = (nanoseconds >> (exponent - SubBucketBits)) & (SubBucketCount - 1);
+	return size_t(exponent - SubBucketBits + 1) * SubBucketCount + size_t(subBucket);
+}
+
+uint64_t AppenderMetrics::getBucketUpperBound(size_t index)
+{
+	if (index < SubBucketCount)
+		return index;
+	auto exponent = int(index / SubBucketCount) + SubBucketBits - 1;
+	auto subBucket = index % SubBucketCount;
+	auto width = uint64_t(1) << (exponent - SubBucketBits);
+	return (SubBucketCount + subBucket) * width + width - 1;
+}
+
+AppenderMetrics::HistogramSnapshot::HistogramSnapshot()
+	: m_count(0)
+	, m_total(0)
+	, m_maximum(0)
+{
+}
+
+uint64_t AppenderMetrics::HistogramSnapshot::getCount() const
+{
+	return m_count;
+}
+
+uint64_t AppenderMetrics::HistogramSnapshot::getTotal() const
+{
+	return m_total;
+}
+
+uint64_t AppenderMetrics::HistogramSnapshot::getMaximum() const
+{
+	return m_maximum;
+}
+
+uint64_t AppenderMetrics::HistogramSnapshot::getMean() const
+{
+	return m_count ? m_total / m_count : 0;
+}
+
+uint64_t AppenderMetrics::HistogramSnapshot::getValueAtPercentile(double percentile) const
+{
+	if (0 == m_count)
+		return 0;
+	auto threshold = uint64_t(percentile * double(m_count) / 100.0 + 0.5);
+	if (threshold < 1)
+		threshold = 1;
+	uint64_t total = 0;
+	for (size_t i = 0; i < m_buckets.size(); ++i)
+	{
+		total += m_buckets[i];
+		if (threshold <= total)
+			return std::min(getBucketUpperBound(i), m_maximum);
+	}
+	return m_maximum;
+}
+
+const std::vector<uint64_t>& AppenderMetrics::HistogramSnapshot::getBuckets() const
+{
+	return m_buckets;
+}
@@ -21,7 +21,15 @@
 #include <log4cxx/helpers/onlyonceerrorhandler.h>
 #include <log4cxx/level.h>
 #include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/optionconverter.h>
 #include <log4cxx/private/appenderskeleton_priv.h>
+#include <log4cxx/private/filter_priv.h>
+#include <log4cxx/private/hazardpointer.h>
+#include <log4cxx/filter/levelmatchfilter.h>
+#include <log4cxx/filter/levelrangefilter.h>
+#include <log4cxx/filter/denyallfilter.h>
+#include <log4cxx/logger.h>
+#include <algorithm>
 #include <mutex>
 
 using namespace LOG4CXX_NS;
@@ -30,6 +38,45 @@ using namespace LOG4CXX_NS::helpers;
 
 IMPLEMENT_LOG4CXX_OBJECT(AppenderSkeleton)
 
+namespace
+{
+// The bit position of a built-in level in a FilterChain mask
+int getLevelIndex(int level)
+{
+	switch (level)
+	{
+		case Level::ALL_INT:
+			return 0;
+		case Level::TRACE_INT:
+			return 1;
+		case Level::DEBUG_INT:
+			return 2;
+		case Level::INFO_INT:
+			return 3;
+		case Level::WARN_INT:
+			return 4;
+		case Level::ERROR_INT:
+			return 5;
+		case Level::FATAL_INT:
+			return 6;
+		case Level::OFF_INT:
+			return 7;
+		default:
+			break;
+	}
+	return -1;
+}
+
+// Does the decision of \c filter depend only on the level of the event?
+bool isLevelFilter(const FilterPtr& filter)
+{
+	auto& filterClass = filter->getClass();
+	return &filterClass == &filter::LevelMatchFilter::getStaticClass()
+		|| &filterClass == &filter::LevelRangeFilter::getStaticClass()
+		|| &filterClass == &filter::DenyAllFilter::getStaticClass();
+}
+} // namespace
+
 AppenderSkeleton::AppenderSkeleton( std::unique_ptr<AppenderSkeletonPrivate> priv )
 	:   m_priv(std::move(priv))
 {
@@ -75,12 +122,14 @@ void AppenderSkeleton::addFilter(const spi::FilterPtr newFilter)
 		m_priv->tailFilter->setNext(newFilter);
 		m_priv->tailFilter = newFilter;
 	}
+	m_priv->filterGeneration->fetch_add(1, std::memory_order_acq_rel);
 }
 
 void AppenderSkeleton::clearFilters()
 {
 	std::lock_guard<std::recursive_mutex> lock(m_priv->mutex);
 	m_priv->headFilter = m_priv->tailFilter = nullptr;
+	m_priv->filterGeneration->fetch_add(1, std::memory_order_acq_rel);
 }
 
 bool AppenderSkeleton::isAsSevereAsThreshold(const LevelPtr& level) const
@@ -90,9 +139,38 @@ bool AppenderSkeleton::isAsSevereAsThreshold(const LevelPtr& level) const
 
 void AppenderSkeleton::doAppend(const spi::LoggingEventPtr& event, Pool& pool1)
 {
-	std::lock_guard<std::recursive_mutex> lock(m_priv->mutex);
+	// Events rejected by the threshold or a filter do not wait for the lock
+	if (!m_priv->isAccepted(event))
+	{
+		return;
+	}
+
+	auto metrics = m_priv->getMetrics();
+	std::chrono::steady_clock::time_point start;
+	if (metrics)
+		start = std::chrono::steady_clock::now();
+	{
+		std::lock_guard<std::recursive_mutex> lock(m_priv->mutex);
+		if (metrics)
+			metrics->record(AppenderMetrics::LockWait, std::chrono::steady_clock::now() - start);
+
+		if (m_priv->closed)
+		{
+			LogLog::error(((LogString) LOG4CXX_STR("Attempted to append to closed appender named ["))
+				+ m_priv->name + LOG4CXX_STR("]."));
+			return;
+		}
 
-	doAppendImpl(event, pool1);
+		{
+			AppenderMetrics::ScopedTimer timer(metrics, AppenderMetrics::AppendLatency);
+			append(event, pool1);
+		}
+	}
+	if (metrics)
+	{
+		metrics->add(AppenderMetrics::EventsAppended);
+		m_priv->reportMetricsIfDue();
+	}
 }
 
 void AppenderSkeleton::doAppendImpl(const spi::LoggingEventPtr& event, Pool& pool1)
@@ -104,31 +182,146 @@ void AppenderSkeleton::doAppendImpl(const spi::LoggingEventPtr& event, Pool& poo
 		return;
 	}
 
-	if (!isAsSevereAsThreshold(event->getLevel()))
+	if (!m_priv->isAccepted(event))
 	{
 		return;
 	}
 
-	FilterPtr f = m_priv->headFilter;
+	auto metrics = m_priv->getMetrics();
+	{
+		AppenderMetrics::ScopedTimer timer(metrics, AppenderMetrics::AppendLatency);
+		append(event, pool1);
+	}
+	if (metrics)
+		metrics->add(AppenderMetrics::EventsAppended);
+}
 
+bool AppenderSkeleton::AppenderSkeletonPrivate::isAccepted(const spi::LoggingEventPtr& event)
+{
+	bool result = true;
+	auto& level = event->getLevel();
+	if (level && level->toInt() < thresholdInt.load(std::memory_order_relaxed))
+		result = false;
+	else
+	{
+		// A version of the filter chain is not deleted while it is protected
+		HazardPointer guard;
+		if (!guard.hasSlot())
+		{
+			std::lock_guard<std::recursive_mutex> lock(mutex);
+			result = Filter::DENY != compileFilters()->decide(event);
+		}
+		else
+		{
+			auto chain = guard.protect(filterChain);
+			if (!chain || chain->generation != filterGeneration->load(std::memory_order_acquire))
+			{
+				{
+					std::lock_guard<std::recursive_mutex> lock(mutex);
+					compileFilters();
+				}
+				chain = guard.protect(filterChain);
+			}
+			result = Filter::DENY != chain->decide(event);
+		}
+	}
+	if (!result)
+	{
+		if (auto metrics = getMetrics())
+			metrics->add(AppenderMetrics::FilterDenials);
+	}
+	return result;
+}
+
+const AppenderSkeleton::AppenderSkeletonPrivate::FilterChain*
+AppenderSkeleton::AppenderSkeletonPrivate::compileFilters()
+{
+	auto generation = filterGeneration->load(std::memory_order_acquire);
+	auto current = filterChain.load(std::memory_order_relaxed);
+	if (current && current->generation == generation)
+		return current;
+
+	auto result = std::make_unique<FilterChain>();
+	result->generation = generation;
+	result->levelFilterCount = 0;
+	result->denyMask = 0;
+	result->acceptMask = 0;
+	for (auto f = headFilter; f; )
+	{
+		// Register before reading the filter so a concurrent change causes recompilation
+		addFilterOwner(*f, filterGeneration);
+		if (result->levelFilterCount == result->filters.size() && isLevelFilter(f))
+			++result->levelFilterCount;
+		result->filters.push_back(f);
+		f = f->getNext();
+	}
 
-	while (f != 0)
+	auto& data = Level::getData();
+	LevelPtr levels[] = { data.All, data.Trace, data.Debug, data.Info, data.Warn, data.Error, data.Fatal, data.Off };
+	for (unsigned index = 0; index < 8; ++index)
 	{
-		switch (f->decide(event))
+		result->levels[index] = levels[index].get();
+		if (0 == result->levelFilterCount)
+			continue;
+		auto event = std::make_shared<LoggingEvent>(LogString(), levels[index], LogString(), LocationInfo::getLocationUnavailable());
+		for (size_t i = 0; i < result->levelFilterCount; ++i)
+		{
+			auto decision = result->filters[i]->decide(event);
+			if (Filter::DENY == decision)
+			{
+				result->denyMask |= (1u << index);
+				break;
+			}
+			if (Filter::ACCEPT == decision)
+			{
+				result->acceptMask |= (1u << index);
+				break;
+			}
+		}
+	}
+
+	auto pChain = result.get();
+	filterChain.store(pChain, std::memory_order_seq_cst);
+	if (currentFilterChain)
+		retiredFilterChains.push_back(std::move(currentFilterChain));
+	currentFilterChain = std::move(result);
+	retiredFilterChains.erase(std::remove_if(retiredFilterChains.begin(), retiredFilterChains.end()
+		, [](const std::unique_ptr<const FilterChain>& chain) { return !HazardPointer::isInUse(chain.get()); })
+		, retiredFilterChains.end());
+	return pChain;
+}
+
+Filter::FilterDecision AppenderSkeleton::AppenderSkeletonPrivate::FilterChain::decide(const spi::LoggingEventPtr& event) const
+{
+	size_t start = 0;
+	if (0 < levelFilterCount)
+	{
+		auto pLevel = event->getLevel().get();
+		auto index = pLevel ? getLevelIndex(pLevel->toInt()) : -1;
+		if (0 <= index && levels[index] == pLevel)
+		{
+			if (denyMask & (1u << index))
+				return Filter::DENY;
+			if (acceptMask & (1u << index))
+				return Filter::ACCEPT;
+			start = levelFilterCount;
+		}
+	}
+	for (auto i = start; i < filters.size(); ++i)
+	{
+		switch (filters[i]->decide(event))
 		{
 			case Filter::DENY:
-				return;
+				return Filter::DENY;
 
 			case Filter::ACCEPT:
-				f = nullptr;
-				break;
+				return Filter::ACCEPT;
 
 			case Filter::NEUTRAL:
-				f = f->getNext();
+				break;
 		}
 	}
-
-	append(event, pool1);
+	return Filter::NEUTRAL;
 }
 
 void AppenderSkeleton::setErrorHandler(const spi::ErrorHandlerPtr errorHandler1)
@@ -151,6 +344,7 @@ void AppenderSkeleton::setThreshold(const LevelPtr& threshold1)
 {
 	std::lock_guard<std::recursive_mutex> lock(m_priv->mutex);
 	m_priv->threshold = threshold1;
+	m_priv->thresholdInt = threshold1 ? threshold1->toInt() : Level::ALL_INT;
 }
 
 void AppenderSkeleton::setOption(const LogString& option,
@@ -161,6 +355,21 @@ void AppenderSkeleton::setOption(const LogString& option,
 	{
 		setThreshold(Level::toLevelLS(value));
 	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXX_STR("METRICS"), LOG4CXX_STR("metrics")))
+	{
+		setMetricsEnabled(OptionConverter::toBoolean(value, false));
+	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXX_STR("METRICSLOGGER"), LOG4CXX_STR("metricslogger")))
+	{
+		setMetricsLogger(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXX_STR("METRICSINTERVAL"), LOG4CXX_STR("metricsinterval")))
+	{
+		setMetricsInterval(OptionConverter::toInt(value, 0));
+	}
 }
 
 const spi::ErrorHandlerPtr AppenderSkeleton::getErrorHandler() const
@@ -202,3 +411,68 @@ void AppenderSkeleton::setName(const LogString& name1)
 {
 	m_priv->name.assign(name1);
 }
+
+void AppenderSkeleton::setMetricsEnabled(bool newValue)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_priv->mutex);
+	if (newValue && !m_priv->metrics)
+		m_priv->metrics = std::make_shared<AppenderMetrics>();
+	m_priv->activeMetrics.store(newValue ? m_priv->metrics.get() : nullptr, std::memory_order_release);
+}
+
+bool AppenderSkeleton::getMetricsEnabled() const
+{
+	return !!m_priv->getMetrics();
+}
+
+AppenderMetricsPtr AppenderSkeleton::getMetrics() const
+{
+	std::lock_guard<std::recursive_mutex> lock(m_priv->mutex);
+	return m_priv->getMetrics() ? m_priv->metrics : AppenderMetricsPtr();
+}
+
+void AppenderSkeleton::setMetricsLogger(const LogString& loggerName)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_priv->mutex);
+	m_priv->metricsLoggerName = loggerName;
+}
+
+void AppenderSkeleton::setMetricsInterval(int milliseconds)
+{
+	m_priv->metricsInterval = (milliseconds < 0) ? 0 : milliseconds;
+	m_priv->nextMetricsReport = 0;
+}
+
+void AppenderSkeleton::AppenderSkeletonPrivate::reportMetricsIfDue()
+{
+	auto interval = metricsInterval.load(std::memory_order_relaxed);
+	if (interval <= 0)
+		return;
+	auto now = std::chrono::duration_cast<std::chrono::milliseconds>
+		(std::chrono::steady_clock::now().time_since_epoch()).count();
+	auto due = nextMetricsReport.load(std::memory_order_relaxed);
+	if (now < due)
+		return;
+	// Only the thread that advances the due time sends the report
+	if (!nextMetricsReport.compare_exchange_strong(due, now + interval, std::memory_order_relaxed))
+		return;
+	if (0 == due) // The first call only starts the interval
+		return;
+	LogString loggerName;
+	AppenderMetricsPtr current;
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+		loggerName = metricsLoggerName;
+		current = metrics;
+	}
+	if (loggerName.empty() || !current)
+		return;
+	auto logger = Logger::getLogger(loggerName);
+	if (!logger->isInfoEnabled())
+		return;
+	LogString msg(LOG4CXX_STR("Appender ["));
+	msg.append(name);
+	msg.append(LOG4CXX_STR("] "));
+	AppenderMetrics::format(msg, current->getSnapshot());
+	logger->forcedLogLS(Level::getInfo(), msg, spi::LocationInfo::getLocationUnavailable());
+}
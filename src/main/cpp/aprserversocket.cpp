@@ -159,5 +159,10 @@ SocketPtr APRServerSocket::accept()
 	return std::make_shared<APRSocket>(newSocket, newPool);
 }
 
+apr_socket_t* APRServerSocket::getSocketHandle() const
+{
+	return _priv->socket;
+}
+
 } //namespace helpers
 } //namespace log4cxx
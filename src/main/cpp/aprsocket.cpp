@@ -143,6 +143,47 @@ size_t APRSocket::write(ByteBuffer& buf)
 	return totalWritten;
 }
 
+size_t APRSocket::read(ByteBuffer& buf)
+{
+	if (_priv->socket == 0)
+	{
+		throw ClosedChannelException();
+	}
+
+	apr_size_t bytesRead = buf.remaining();
+	apr_status_t status = apr_socket_recv(_priv->socket, buf.current(), &bytesRead);
+	buf.position(buf.position() + bytesRead);
+
+	if (APR_STATUS_IS_EOF(status))
+	{
+		return 0;
+	}
+	else if (APR_STATUS_IS_TIMEUP(status))
+	{
+		throw SocketTimeoutException();
+	}
+	else if (status != APR_SUCCESS)
+	{
+		throw SocketException(status);
+	}
+
+	return bytesRead;
+}
+
+void APRSocket::setSoTimeout(int timeout)
+{
+	if (_priv->socket == 0)
+	{
+		throw ClosedChannelException();
+	}
+
+	apr_status_t status = apr_socket_timeout_set(_priv->socket, apr_interval_time_t(timeout) * 1000);
+
+	if (status != APR_SUCCESS)
+	{
+		throw SocketException(status);
+	}
+}
 
 void APRSocket::close()
 {
@@ -159,5 +200,10 @@ void APRSocket::close()
 	}
 }
 
+apr_socket_t* APRSocket::getSocketHandle() const
+{
+	return _priv->socket;
+}
+
 } //namespace helpers
 } //namespace log4cxx
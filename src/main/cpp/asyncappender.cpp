@@ -24,7 +24,9 @@
 #include <log4cxx/helpers/stringhelper.h>
 #include <log4cxx/helpers/optionconverter.h>
 #include <log4cxx/helpers/threadutility.h>
+#include <log4cxx/helpers/transcoder.h>
 #include <log4cxx/private/appenderskeleton_priv.h>
+#include <log4cxx/private/emergencydrain.h>
 #include <thread>
 #include <atomic>
 #include <condition_variable>
@@ -32,6 +34,10 @@
 #if LOG4CXX_EVENTS_AT_EXIT
 #include <log4cxx/private/atexitregistry.h>
 #endif
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using namespace LOG4CXX_NS;
 using namespace LOG4CXX_NS::helpers;
@@ -115,7 +121,48 @@ struct AsyncAppender::AsyncAppenderPriv : public AppenderSkeleton::AppenderSkele
 		, eventCount(0)
 		, dispatchedCount(0)
 		, commitCount(0)
+		, appendedCount(0)
+	{
+	}
+
+	~AsyncAppenderPriv()
 	{
+		EmergencyDrain::remove(drainSlot);
+	}
+
+	/**
+	 * Write the events not yet passed to the attached appenders.
+	 * Called by the fatal signal handler.
+	 */
+	static void drainEvents(void* context)
+	{
+		auto self = static_cast<AsyncAppenderPriv*>(context);
+		size_t size = self->buffer.size();
+		size_t end = self->commitCount.load(std::memory_order_acquire);
+		size_t start = self->appendedCount.load(std::memory_order_acquire);
+		if (size < end - start)
+			start = end - size;
+		int fd = 2;
+#if !defined(_WIN32)
+		if (!self->emergencyPath.empty())
+		{
+			fd = ::open(self->emergencyPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+			if (fd < 0)
+				fd = 2;
+		}
+#endif
+		for (auto index = start; index != end; ++index)
+		{
+			// Skip a slot that a logging thread may be replacing
+			if (size <= self->eventCount.load(std::memory_order_relaxed) - index)
+				continue;
+			if (auto event = self->buffer[index % size].get())
+				EmergencyDrain::write(fd, *event);
+		}
+#if !defined(_WIN32)
+		if (2 != fd)
+			::close(fd);
+#endif
 	}
 
 #if LOG4CXX_EVENTS_AT_EXIT
@@ -189,6 +236,31 @@ struct AsyncAppender::AsyncAppenderPriv : public AppenderSkeleton::AppenderSkele
 	 * Used to communicate to the dispatch thread when an event is committed in buffer.
 	*/
 	alignas(CACHE_LINE_SIZE) std::atomic<size_t> commitCount;
+
+	/**
+	 * The number of buffered events passed to the attached appenders.
+	*/
+	std::atomic<size_t> appendedCount;
+
+	/**
+	 * Should undispatched events be written on a fatal signal?
+	*/
+	bool emergencyDrain = false;
+
+	/**
+	 * The file to which undispatched events are written on a fatal signal.
+	*/
+	LogString emergencyFile;
+
+	/**
+	 * The emergencyFile name in the file system encoding.
+	*/
+	std::string emergencyPath;
+
+	/**
+	 * The EmergencyDrain table entry, or -1.
+	*/
+	int drainSlot = -1;
 };
 
 
@@ -229,6 +301,14 @@ void AsyncAppender::setOption(const LogString& option,
 	{
 		setBlocking(OptionConverter::toBoolean(value, true));
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("EMERGENCYDRAIN"), LOG4CXX_STR("emergencydrain")))
+	{
+		setEmergencyDrain(OptionConverter::toBoolean(value, false));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("EMERGENCYFILE"), LOG4CXX_STR("emergencyfile")))
+	{
+		setEmergencyFile(value);
+	}
 	else
 	{
 		AppenderSkeleton::setOption(option, value);
@@ -239,6 +319,8 @@ void AsyncAppender::setOption(const LogString& option,
 void AsyncAppender::doAppend(const spi::LoggingEventPtr& event, Pool& pool1)
 {
 	doAppendImpl(event, pool1);
+	if (priv->getMetrics())
+		priv->reportMetricsIfDue();
 }
 
 void AsyncAppender::append(const spi::LoggingEventPtr& event, Pool& p)
@@ -281,6 +363,8 @@ void AsyncAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 				 oldEventCount = savedEventCount;
 			}
 			priv->bufferNotEmpty.notify_all();
+			if (auto metrics = priv->getMetrics())
+				metrics->setQueueDepth(oldEventCount + 1 - priv->dispatchedCount);
 			break;
 		}
 		//
@@ -322,6 +406,8 @@ void AsyncAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 			{
 				(*iter).second.add(event);
 			}
+			if (auto metrics = priv->getMetrics())
+				metrics->add(AppenderMetrics::Discards);
 
 			break;
 		}
@@ -342,6 +428,9 @@ void AsyncAppender::close()
 		priv->dispatcher.join();
 	}
 
+	EmergencyDrain::remove(priv->drainSlot);
+	priv->drainSlot = -1;
+
 	for (auto item : priv->appenders.getAllAppenders())
 	{
 		item->close();
@@ -419,6 +508,39 @@ void AsyncAppender::setBlocking(bool value)
 	priv->bufferNotFull.notify_all();
 }
 
+void AsyncAppender::setEmergencyDrain(bool value)
+{
+	std::lock_guard<std::mutex> lock(priv->bufferMutex);
+	priv->emergencyDrain = value;
+	if (value && priv->drainSlot < 0 && EmergencyDrain::install())
+	{
+		priv->drainSlot = EmergencyDrain::add(&AsyncAppenderPriv::drainEvents, priv, EmergencyDrain::Queues);
+	}
+	else if (!value)
+	{
+		EmergencyDrain::remove(priv->drainSlot);
+		priv->drainSlot = -1;
+	}
+}
+
+bool AsyncAppender::getEmergencyDrain() const
+{
+	return priv->emergencyDrain;
+}
+
+void AsyncAppender::setEmergencyFile(const LogString& fileName)
+{
+	std::lock_guard<std::mutex> lock(priv->bufferMutex);
+	priv->emergencyFile = fileName;
+	priv->emergencyPath.clear();
+	Transcoder::encode(fileName, priv->emergencyPath);
+}
+
+LogString AsyncAppender::getEmergencyFile() const
+{
+	return priv->emergencyFile;
+}
+
 bool AsyncAppender::getBlocking() const
 {
 	return priv->blocking;
@@ -488,6 +610,7 @@ void AsyncAppender::dispatch()
 		Pool p;
 		LoggingEventList events;
 		events.reserve(priv->bufferSize);
+		size_t bufferedCount = 0;
 		//
 		//   process events after lock on buffer is released.
 		//
@@ -504,6 +627,7 @@ void AsyncAppender::dispatch()
 				events.push_back(priv->buffer[index]);
 				++priv->dispatchedCount;
 			}
+			bufferedCount = events.size();
 			for (auto discardItem : priv->discardMap)
 			{
 				events.push_back(discardItem.second.createEvent(p));
@@ -513,8 +637,9 @@ void AsyncAppender::dispatch()
 			priv->bufferNotFull.notify_all();
 		}
 
-		for (auto item : events)
+		for (size_t i = 0; i < events.size(); ++i)
 		{
+			auto& item = events[i];
 			try
 			{
 				priv->appenders.appendLoopOnAppenders(item, p);
@@ -535,6 +660,9 @@ void AsyncAppender::dispatch()
 					isActive = false;
 				}
 			}
+			// Events up to this count need not be written by the fatal signal handler
+			if (i < bufferedCount)
+				priv->appendedCount.fetch_add(1, std::memory_order_release);
 		}
 	}
 
@@ -0,0 +1,344 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/net/binaryeventdecoder.h>
+#include <log4cxx/net/binaryeventencoder.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/level.h>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::helpers;
+using namespace LOG4CXX_NS::net;
+using namespace LOG4CXX_NS::spi;
+
+namespace
+{
+// The largest record accepted
+const uint64_t MaxRecordSize = 64 * 1024 * 1024;
+// The number of distinct location strings shared by the events of a decoder
+const size_t MaxLocationStrings = 1024;
+// The number of logger names a peer may define (the number an encoder retains)
+const size_t MaxNames = 64 * 1024;
+// The total size of the logger names a peer may define
+const size_t MaxNameBytes = 16 * 1024 * 1024;
+// The size of the longest record length prefix
+const size_t MaxLengthSize = 10;
+
+enum RecordType
+{
+	NameRecord = 1,
+	EventRecord = 2
+};
+
+enum EventFlag
+{
+	HasNDC = 0x01,
+	HasMDC = 0x02,
+	HasLocation = 0x04,
+	HasLoggerName = 0x08
+};
+
+// Reads the fields of a record
+class RecordReader
+{
+	public:
+		RecordReader(const char* data, size_t size)
+			: m_current(data)
+			, m_end(data + size)
+		{}
+
+		bool atEnd() const
+		{
+			return m_current == m_end;
+		}
+
+		uint64_t getUnsigned()
+		{
+			uint64_t result = 0;
+			for (int shift = 0; ; shift += 7)
+			{
+				if (m_current == m_end || 63 < shift)
+					throw IOException(LOG4CXX_STR("Invalid binary event record"));
+				auto byte = static_cast<unsigned char>(*m_current++);
+				result |= uint64_t(byte & 0x7F) << shift;
+				if (0 == (byte & 0x80))
+					break;
+			}
+			return result;
+		}
+
+		int64_t getSigned()
+		{
+			auto value = getUnsigned();
+			return int64_t(value >> 1) ^ -int64_t(value & 1);
+		}
+
+		std::string getBytes()
+		{
+			auto size = getUnsigned();
+			if (uint64_t(m_end - m_current) < size)
+				throw IOException(LOG4CXX_STR("Invalid binary event record"));
+			std::string result(m_current, size_t(size));
+			m_current += size;
+			return result;
+		}
+
+		LogString getString()
+		{
+			LogString result;
+			Transcoder::decodeUTF8(getBytes(), result);
+			return result;
+		}
+
+	private:
+		const char* m_current;
+		const char* m_end;
+};
+
+typedef std::shared_ptr<const std::string> StringPtr;
+
+// A LoggingEvent that keeps alive the strings its LocationInfo and thread names refer to
+struct RemoteEvent
+{
+	RemoteEvent
+		( const StringPtr& fileName1
+		, const StringPtr& methodName1
+		, int lineNumber
+		, const LogString& logger
+		, const LevelPtr& level
+		, LogString&& message
+		, log4cxx_time_t timeStamp
+		, LogString&& threadName1
+		, LogString&& threadUserName1
+		, const LogString* ndc
+		, MDC::Map&& mdc
+		)
+		: fileName(fileName1)
+		, methodName(methodName1)
+		, threadName(std::move(threadName1))
+		, threadUserName(std::move(threadUserName1))
+		, event
+			( logger
+			, level
+			, fileName
+				? LocationInfo(fileName->c_str(), LocationInfo::calcShortFileName(fileName->c_str()), methodName->c_str(), lineNumber)
+				: LocationInfo()
+			, std::move(message)
+			, timeStamp
+			, threadName
+			, threadUserName
+			, ndc
+			, std::move(mdc)
+			)
+	{}
+
+	StringPtr fileName;
+	StringPtr methodName;
+	LogString threadName;
+	LogString threadUserName;
+	LoggingEvent event;
+};
+
+} // namespace
+
+struct BinaryEventDecoder::BinaryEventDecoderPrivate
+{
+	BinaryEventDecoderPrivate()
+		: position(0)
+		, headerReceived(false)
+	{}
+
+	std::vector<char> data;
+	size_t position;
+	bool headerReceived;
+	std::vector<LogString> names;
+	size_t nameBytes = 0;
+
+	/**
+	Location strings shared by the events of this decoder.
+	Emptied when full, so a peer sending many distinct values cannot exhaust memory.
+	Each event holds a reference to the strings it uses.
+	*/
+	std::unordered_map<std::string, StringPtr> locationStrings;
+
+	StringPtr getLocationString(std::string&& value)
+	{
+		auto pItem = locationStrings.find(value);
+		if (pItem != locationStrings.end())
+			return pItem->second;
+		if (MaxLocationStrings <= locationStrings.size())
+			locationStrings.clear();
+		auto result = std::make_shared<const std::string>(value);
+		locationStrings.emplace(std::move(value), result);
+		return result;
+	}
+
+	LoggingEventPtr decodeEvent(RecordReader& reader)
+	{
+		auto flags = reader.getUnsigned();
+		auto level = Level::toLevel(int(reader.getSigned()));
+		LogString loggerName;
+		if (flags & HasLoggerName)
+			loggerName = reader.getString();
+		else
+		{
+			auto index = reader.getUnsigned();
+			if (names.size() <= index)
+				throw IOException(LOG4CXX_STR("Unknown logger name index"));
+			loggerName = names[size_t(index)];
+		}
+		auto timeStamp = log4cxx_time_t(reader.getSigned());
+		auto threadName = reader.getString();
+		auto threadUserName = reader.getString();
+		auto message = reader.getString();
+		LogString ndc;
+		if (flags & HasNDC)
+			ndc = reader.getString();
+		MDC::Map mdc;
+		if (flags & HasMDC)
+		{
+			auto count = reader.getUnsigned();
+			for (uint64_t i = 0; i < count; ++i)
+			{
+				auto key = reader.getString();
+				mdc[key] = reader.getString();
+			}
+		}
+		StringPtr fileName, methodName;
+		int lineNumber = 0;
+		if (flags & HasLocation)
+		{
+			fileName = getLocationString(reader.getBytes());
+			methodName = getLocationString(reader.getBytes());
+			lineNumber = int(reader.getUnsigned());
+		}
+		auto remote = std::make_shared<RemoteEvent>
+			( fileName
+			, methodName
+			, lineNumber
+			, loggerName
+			, level
+			, std::move(message)
+			, timeStamp
+			, std::move(threadName)
+			, std::move(threadUserName)
+			, (flags & HasNDC) ? &ndc : nullptr
+			, std::move(mdc)
+			);
+		return LoggingEventPtr(remote, &remote->event);
+	}
+};
+
+BinaryEventDecoder::BinaryEventDecoder()
+	: m_priv(std::make_unique<BinaryEventDecoderPrivate>())
+{
+}
+
+BinaryEventDecoder::~BinaryEventDecoder()
+{
+}
+
+void BinaryEventDecoder::append(const char* data, size_t size)
+{
+	// Discard the consumed data before adding more
+	if (0 < m_priv->position)
+	{
+		m_priv->data.erase(m_priv->data.begin(), m_priv->data.begin() + m_priv->position);
+		m_priv->position = 0;
+	}
+	m_priv->data.insert(m_priv->data.end(), data, data + size);
+}
+
+void BinaryEventDecoder::reset()
+{
+	m_priv->data.clear();
+	m_priv->position = 0;
+	m_priv->headerReceived = false;
+	m_priv->names.clear();
+	m_priv->nameBytes = 0;
+	m_priv->locationStrings.clear();
+}
+
+LoggingEventPtr BinaryEventDecoder::next()
+{
+	auto& data = m_priv->data;
+	if (!m_priv->headerReceived)
+	{
+		if (data.size() - m_priv->position < 5)
+			return LoggingEventPtr();
+		if (0 != std::memcmp(&data[m_priv->position], "L4CB", 4))
+			throw IOException(LOG4CXX_STR("Not a binary event stream"));
+		if (BinaryEventEncoder::VERSION < data[m_priv->position + 4])
+			throw IOException(LOG4CXX_STR("Unsupported binary event stream version"));
+		m_priv->position += 5;
+		m_priv->headerReceived = true;
+	}
+
+	while (m_priv->position < data.size())
+	{
+		// Is the record length complete?
+		size_t lengthSize = 0;
+		while (m_priv->position + lengthSize < data.size()
+			&& (data[m_priv->position + lengthSize] & 0x80))
+		{
+			if (MaxLengthSize <= ++lengthSize)
+				throw IOException(LOG4CXX_STR("Invalid binary event record length"));
+		}
+		if (data.size() <= m_priv->position + lengthSize)
+			return LoggingEventPtr();
+		++lengthSize;
+		RecordReader lengthReader(&data[m_priv->position], lengthSize);
+		auto length = lengthReader.getUnsigned();
+		if (length < 1 || MaxRecordSize < length)
+			throw IOException(LOG4CXX_STR("Invalid binary event record length"));
+
+		// Is the record body complete?
+		if (data.size() - m_priv->position - lengthSize < length)
+			return LoggingEventPtr();
+		auto body = &data[m_priv->position + lengthSize];
+		m_priv->position += lengthSize + size_t(length);
+		RecordReader reader(body + 1, size_t(length) - 1);
+		switch (body[0])
+		{
+			case NameRecord:
+			{
+				auto index = reader.getUnsigned();
+				if (index != m_priv->names.size())
+					throw IOException(LOG4CXX_STR("Unexpected logger name index"));
+				auto name = reader.getString();
+				m_priv->nameBytes += name.size() * sizeof (logchar);
+				if (MaxNames <= index || MaxNameBytes < m_priv->nameBytes)
+					throw IOException(LOG4CXX_STR("Too many logger names"));
+				m_priv->names.push_back(std::move(name));
+				break;
+			}
+			case EventRecord:
+				return m_priv->decodeEvent(reader);
+			default:
+				// Ignore record types added by a later version
+				break;
+		}
+	}
+	return LoggingEventPtr();
+}
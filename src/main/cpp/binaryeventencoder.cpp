@@ -0,0 +1,207 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/net/binaryeventencoder.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <log4cxx/level.h>
+#include <unordered_map>
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::helpers;
+using namespace LOG4CXX_NS::net;
+using namespace LOG4CXX_NS::spi;
+
+namespace
+{
+// The number of logger names retained, further names are sent with each event
+const size_t MaxNameCount = 64 * 1024;
+
+enum RecordType
+{
+	NameRecord = 1,
+	EventRecord = 2
+};
+
+enum EventFlag
+{
+	HasNDC = 0x01,
+	HasMDC = 0x02,
+	HasLocation = 0x04,
+	HasLoggerName = 0x08
+};
+
+void putUnsigned(std::string& dest, uint64_t value)
+{
+	while (0x80 <= value)
+	{
+		dest.push_back(char(0x80 | (value & 0x7F)));
+		value >>= 7;
+	}
+	dest.push_back(char(value));
+}
+
+void putSigned(std::string& dest, int64_t value)
+{
+	putUnsigned(dest, (uint64_t(value) << 1) ^ uint64_t(value >> 63));
+}
+
+void putBytes(std::string& dest, const std::string& value)
+{
+	putUnsigned(dest, value.size());
+	dest.append(value);
+}
+
+void putString(std::string& dest, const LogString& value)
+{
+	std::string utf8;
+	Transcoder::encodeUTF8(value, utf8);
+	putBytes(dest, utf8);
+}
+
+// Prefix the record that starts at \c start with its length
+void putLength(std::string& dest, size_t start)
+{
+	std::string length;
+	putUnsigned(length, dest.size() - start);
+	dest.insert(start, length);
+}
+
+} // namespace
+
+struct BinaryEventEncoder::BinaryEventEncoderPrivate
+{
+	BinaryEventEncoderPrivate()
+		: internNames(true)
+		, locationInfo(false)
+	{}
+
+	bool internNames;
+	bool locationInfo;
+	std::unordered_map<LogString, uint64_t> names;
+};
+
+BinaryEventEncoder::BinaryEventEncoder()
+	: m_priv(std::make_unique<BinaryEventEncoderPrivate>())
+{
+}
+
+BinaryEventEncoder::~BinaryEventEncoder()
+{
+}
+
+void BinaryEventEncoder::setInternNames(bool newValue)
+{
+	m_priv->internNames = newValue;
+}
+
+bool BinaryEventEncoder::getInternNames() const
+{
+	return m_priv->internNames;
+}
+
+void BinaryEventEncoder::setLocationInfo(bool newValue)
+{
+	m_priv->locationInfo = newValue;
+}
+
+bool BinaryEventEncoder::getLocationInfo() const
+{
+	return m_priv->locationInfo;
+}
+
+void BinaryEventEncoder::reset()
+{
+	m_priv->names.clear();
+}
+
+void BinaryEventEncoder::encodeHeader(std::string& dest)
+{
+	dest.append("L4CB", 4);
+	dest.push_back(char(VERSION));
+}
+
+void BinaryEventEncoder::encode(const LoggingEventPtr& event, std::string& dest)
+{
+	uint64_t flags = 0;
+	uint64_t nameIndex = 0;
+	auto& loggerName = event->getLoggerName();
+	if (!m_priv->internNames)
+		flags |= HasLoggerName;
+	else
+	{
+		auto pItem = m_priv->names.find(loggerName);
+		if (m_priv->names.end() != pItem)
+			nameIndex = pItem->second;
+		else if (m_priv->names.size() < MaxNameCount)
+		{
+			nameIndex = m_priv->names.size();
+			m_priv->names[loggerName] = nameIndex;
+			size_t start = dest.size();
+			dest.push_back(char(NameRecord));
+			putUnsigned(dest, nameIndex);
+			putString(dest, loggerName);
+			putLength(dest, start);
+		}
+		else
+			flags |= HasLoggerName;
+	}
+
+	LogString ndc;
+	if (event->getNDC(ndc))
+		flags |= HasNDC;
+	auto mdcKeys = event->getMDCKeySet();
+	if (!mdcKeys.empty())
+		flags |= HasMDC;
+	auto& location = event->getLocationInformation();
+	if (m_priv->locationInfo && location.getLineNumber() != -1)
+		flags |= HasLocation;
+
+	size_t start = dest.size();
+	dest.push_back(char(EventRecord));
+	putUnsigned(dest, flags);
+	putSigned(dest, event->getLevel()->toInt());
+	if (flags & HasLoggerName)
+		putString(dest, loggerName);
+	else
+		putUnsigned(dest, nameIndex);
+	putSigned(dest, event->getTimeStamp());
+	putString(dest, event->getThreadName());
+	putString(dest, event->getThreadUserName());
+	putString(dest, event->getRenderedMessage());
+	if (flags & HasNDC)
+		putString(dest, ndc);
+	if (flags & HasMDC)
+	{
+		putUnsigned(dest, mdcKeys.size());
+		for (auto& key : mdcKeys)
+		{
+			LogString value;
+			event->getMDC(key, value);
+			putString(dest, key);
+			putString(dest, value);
+		}
+	}
+	if (flags & HasLocation)
+	{
+		putBytes(dest, location.getFileName() ? location.getFileName() : "");
+		auto className = location.getClassName();
+		putBytes(dest, className.empty() ? location.getMethodName() : className + "::" + location.getMethodName());
+		putUnsigned(dest, uint64_t(location.getLineNumber()));
+	}
+	putLength(dest, start);
+}
@@ -0,0 +1,164 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/net/binarysocketappender.h>
+#include <log4cxx/net/binaryeventencoder.h>
+#include <log4cxx/helpers/loglog.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/private/appenderskeleton_priv.h>
+#include <log4cxx/private/socketappenderskeleton_priv.h>
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::helpers;
+using namespace LOG4CXX_NS::net;
+
+struct BinarySocketAppender::BinarySocketAppenderPriv : public SocketAppenderSkeletonPriv
+{
+	BinarySocketAppenderPriv(int defaultPort, int reconnectionDelay) :
+		SocketAppenderSkeletonPriv(defaultPort, reconnectionDelay),
+		headerRequired(false) {}
+
+	BinarySocketAppenderPriv(InetAddressPtr address, int defaultPort, int reconnectionDelay) :
+		SocketAppenderSkeletonPriv( address, defaultPort, reconnectionDelay ),
+		headerRequired(false) {}
+
+	BinarySocketAppenderPriv(const LogString& host, int port, int delay) :
+		SocketAppenderSkeletonPriv( host, port, delay ),
+		headerRequired(false) {}
+
+	SocketPtr socket;
+	BinaryEventEncoder encoder;
+	bool headerRequired;
+	std::string buffer;
+};
+
+IMPLEMENT_LOG4CXX_OBJECT(BinarySocketAppender)
+
+#define _priv static_cast<BinarySocketAppenderPriv*>(m_priv.get())
+
+int BinarySocketAppender::DEFAULT_PORT                 = 4562;
+
+int BinarySocketAppender::DEFAULT_RECONNECTION_DELAY   = 30000;
+
+BinarySocketAppender::BinarySocketAppender()
+	: SocketAppenderSkeleton(std::make_unique<BinarySocketAppenderPriv>(DEFAULT_PORT, DEFAULT_RECONNECTION_DELAY))
+{
+}
+
+BinarySocketAppender::BinarySocketAppender(InetAddressPtr address1, int port1)
+	: SocketAppenderSkeleton(std::make_unique<BinarySocketAppenderPriv>(address1, port1, DEFAULT_RECONNECTION_DELAY))
+{
+	Pool p;
+	activateOptions(p);
+}
+
+BinarySocketAppender::BinarySocketAppender(const LogString& host, int port1)
+	: SocketAppenderSkeleton(std::make_unique<BinarySocketAppenderPriv>(host, port1, DEFAULT_RECONNECTION_DELAY))
+{
+	Pool p;
+	activateOptions(p);
+}
+
+BinarySocketAppender::~BinarySocketAppender()
+{
+	finalize();
+}
+
+void BinarySocketAppender::activateOptions(Pool& p)
+{
+	{
+		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+		_priv->encoder.setLocationInfo(_priv->locationInfo);
+		// Events resent after a reconnection must not depend on earlier records
+		_priv->encoder.setInternNames(!_priv->backgroundSend);
+		std::string header;
+		BinaryEventEncoder::encodeHeader(header);
+		setStreamHeader(header);
+	}
+	SocketAppenderSkeleton::activateOptions(p);
+}
+
+int BinarySocketAppender::getDefaultDelay() const
+{
+	return DEFAULT_RECONNECTION_DELAY;
+}
+
+int BinarySocketAppender::getDefaultPort() const
+{
+	return DEFAULT_PORT;
+}
+
+void BinarySocketAppender::setSocket(LOG4CXX_NS::helpers::SocketPtr& socket, Pool& /* p */)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->socket = socket;
+	_priv->encoder.reset();
+	_priv->headerRequired = true;
+}
+
+void BinarySocketAppender::cleanUp(Pool& /* p */)
+{
+	if (_priv->socket)
+	{
+		try
+		{
+			_priv->socket->close();
+		}
+		catch (std::exception&)
+		{
+		}
+		_priv->socket = nullptr;
+	}
+}
+
+void BinarySocketAppender::append(const spi::LoggingEventPtr& event, LOG4CXX_NS::helpers::Pool& /* p */)
+{
+	if (_priv->backgroundSend)
+	{
+		std::string bytes;
+		_priv->encoder.encode(event, bytes);
+		enqueue(std::move(bytes));
+	}
+	else if (_priv->socket)
+	{
+		auto& bytes = _priv->buffer;
+		bytes.clear();
+		if (_priv->headerRequired)
+		{
+			BinaryEventEncoder::encodeHeader(bytes);
+			_priv->headerRequired = false;
+		}
+		_priv->encoder.encode(event, bytes);
+
+		try
+		{
+			ByteBuffer buf(&bytes[0], bytes.size());
+			_priv->socket->write(buf);
+		}
+		catch (std::exception& e)
+		{
+			_priv->socket = nullptr;
+			LogLog::warn(LOG4CXX_STR("Detected problem with connection: "), e);
+
+			if (getReconnectionDelay() > 0)
+			{
+				fireConnector();
+			}
+		}
+	}
+}
@@ -0,0 +1,246 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/net/binarysocketreceiver.h>
+#include <log4cxx/net/binaryeventdecoder.h>
+#include <log4cxx/helpers/serversocket.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/loglog.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/threadutility.h>
+#include <log4cxx/private/aprsocket.h>
+#include <log4cxx/logger.h>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <thread>
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::helpers;
+using namespace LOG4CXX_NS::net;
+using namespace LOG4CXX_NS::spi;
+
+namespace
+{
+// How often (in milliseconds) the background threads check for closure
+const int PollInterval = 1000;
+}
+
+struct BinarySocketReceiver::BinarySocketReceiverPrivate
+{
+	BinarySocketReceiverPrivate(int port, const LoggerRepositoryPtr& repository)
+		: port(port)
+		, repository(repository)
+		, closed(false)
+		, eventCount(0)
+		, maxConnections(64)
+		, rejectedCount(0)
+	{}
+
+	int port;
+	LoggerRepositoryPtr repository;
+	std::atomic<bool> closed;
+	std::atomic<size_t> eventCount;
+	std::atomic<size_t> maxConnections;
+	std::atomic<size_t> rejectedCount;
+	ServerSocketUniquePtr serverSocket;
+	std::thread acceptor;
+	std::mutex mutex;
+
+	struct Reader
+	{
+		std::thread thread;
+		std::atomic<bool> finished{false};
+	};
+	std::list<Reader> readers;
+
+	// Release the resources of the threads that have finished
+	void joinFinishedReaders()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto pReader = readers.begin(); pReader != readers.end(); )
+		{
+			if (pReader->finished)
+			{
+				pReader->thread.join();
+				pReader = readers.erase(pReader);
+			}
+			else
+				++pReader;
+		}
+	}
+};
+
+BinarySocketReceiver::BinarySocketReceiver(int port, const LoggerRepositoryPtr& repository)
+	: m_priv(std::make_unique<BinarySocketReceiverPrivate>(port, repository))
+{
+}
+
+BinarySocketReceiver::~BinarySocketReceiver()
+{
+	close();
+}
+
+void BinarySocketReceiver::start()
+{
+	if (m_priv->acceptor.joinable())
+		return;
+	m_priv->closed = false;
+	m_priv->serverSocket = ServerSocket::create(m_priv->port);
+	m_priv->serverSocket->setSoTimeout(PollInterval);
+	m_priv->acceptor = ThreadUtility::instance()->createThread( LOG4CXX_STR("BinaryAccept"), &BinarySocketReceiver::acceptConnections, this );
+}
+
+void BinarySocketReceiver::close()
+{
+	m_priv->closed = true;
+	if (m_priv->acceptor.joinable())
+		m_priv->acceptor.join();
+	{
+		std::lock_guard<std::mutex> lock(m_priv->mutex);
+		for (auto& reader : m_priv->readers)
+			reader.thread.join();
+		m_priv->readers.clear();
+	}
+	if (m_priv->serverSocket)
+	{
+		try
+		{
+			m_priv->serverSocket->close();
+		}
+		catch (IOException&)
+		{
+		}
+		m_priv->serverSocket.reset();
+	}
+}
+
+size_t BinarySocketReceiver::getEventCount() const
+{
+	return m_priv->eventCount;
+}
+
+void BinarySocketReceiver::setMaxConnections(size_t count)
+{
+	m_priv->maxConnections = count;
+}
+
+size_t BinarySocketReceiver::getMaxConnections() const
+{
+	return m_priv->maxConnections;
+}
+
+size_t BinarySocketReceiver::getRejectedCount() const
+{
+	return m_priv->rejectedCount;
+}
+
+void BinarySocketReceiver::acceptConnections()
+{
+	while (!m_priv->closed)
+	{
+		try
+		{
+			auto socket = m_priv->serverSocket->accept();
+			m_priv->joinFinishedReaders();
+			std::lock_guard<std::mutex> lock(m_priv->mutex);
+			// Each connection has a thread, so their number is limited
+			if (m_priv->maxConnections <= m_priv->readers.size())
+			{
+				++m_priv->rejectedCount;
+				LogLog::warn(LOG4CXX_STR("Too many connections, closing connection from ")
+					+ socket->getInetAddress()->toString());
+				try
+				{
+					socket->close();
+				}
+				catch (IOException&)
+				{
+				}
+				continue;
+			}
+			m_priv->readers.emplace_back();
+			auto& reader = m_priv->readers.back();
+			reader.thread = ThreadUtility::instance()->createThread
+				( LOG4CXX_STR("BinaryReceive"), &BinarySocketReceiver::receiveEvents, this, socket, &reader.finished );
+		}
+		catch (InterruptedIOException&)
+		{
+			m_priv->joinFinishedReaders();
+		}
+		catch (IOException& e)
+		{
+			if (!m_priv->closed)
+				LogLog::error(LOG4CXX_STR("Could not accept connection"), e);
+			break;
+		}
+	}
+}
+
+void BinarySocketReceiver::receiveEvents(SocketPtr socket, std::atomic<bool>* finished)
+{
+	auto aprSocket = std::dynamic_pointer_cast<APRSocket>(socket);
+	if (!aprSocket)
+	{
+		*finished = true;
+		return;
+	}
+	LogString peer = socket->getInetAddress()->toString();
+	LogLog::debug(LOG4CXX_STR("Receiving binary events from ") + peer);
+	Pool p;
+	BinaryEventDecoder decoder;
+	char data[64 * 1024];
+	try
+	{
+		aprSocket->setSoTimeout(PollInterval);
+		while (!m_priv->closed)
+		{
+			ByteBuffer buf(data, sizeof (data));
+			try
+			{
+				if (0 == aprSocket->read(buf))
+					break;
+			}
+			catch (InterruptedIOException&)
+			{
+				continue;
+			}
+			decoder.append(data, buf.position());
+			while (auto event = decoder.next())
+			{
+				++m_priv->eventCount;
+				auto logger = m_priv->repository->getLogger(event->getLoggerName());
+				if (event->getLevel()->isGreaterOrEqual(logger->getEffectiveLevel()))
+					logger->callAppenders(event, p);
+			}
+		}
+	}
+	catch (IOException& e)
+	{
+		LogLog::warn(LOG4CXX_STR("Stopped receiving binary events from ") + peer, e);
+	}
+	try
+	{
+		socket->close();
+	}
+	catch (IOException&)
+	{
+	}
+	LogLog::debug(LOG4CXX_STR("Connection closed by ") + peer);
+	*finished = true;
+}
@@ -20,6 +20,7 @@
 #include <log4cxx/helpers/cacheddateformat.h>
 #include <log4cxx/helpers/pool.h>
 #include <limits>
+#include <mutex>
 #include <log4cxx/helpers/exception.h>
 
 using namespace LOG4CXX_NS;
@@ -71,6 +72,11 @@ struct CachedDateFormat::CachedDateFormatPriv
 	 *  Date requested in previous conversion.
 	 */
 	mutable log4cxx_time_t previousTime;
+
+	/**
+	 *  Serializes use of the cache by concurrently formatting threads.
+	 */
+	mutable std::mutex mutex;
 };
 
 
@@ -242,6 +248,17 @@ int CachedDateFormat::findMillisecondStart(
  */
 void CachedDateFormat::format(LogString& buf, log4cxx_time_t now, Pool& p) const
 {
+	//
+	// A thread that finds the cache in use formats directly
+	//     rather than waiting.
+	//
+	std::unique_lock<std::mutex> lock(m_priv->mutex, std::try_to_lock);
+
+	if (!lock.owns_lock())
+	{
+		m_priv->formatter->format(buf, now, p);
+		return;
+	}
 
 	//
 	// If the current requested time is identical to the previously
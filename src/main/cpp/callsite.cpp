@@ -0,0 +1,128 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/spi/callsite.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/level.h>
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::spi;
+
+std::atomic<unsigned> CallSite::s_generation(1);
+
+namespace
+{
+// The most recently registered call site
+std::atomic<const CallSite*>& registryHead()
+{
+	static std::atomic<const CallSite*> head(nullptr);
+	return head;
+}
+} // namespace
+
+bool CallSite::evaluate(const LoggerPtr& logger)
+{
+	registerCallSite();
+
+	// Read the generation before making the decision
+	// so a concurrent change causes it to be re-evaluated
+	auto generation = s_generation.load(std::memory_order_acquire);
+	bool result = false;
+	switch (m_level)
+	{
+		case Level::TRACE_INT:
+			result = Logger::isTraceEnabledFor(logger);
+			break;
+		case Level::DEBUG_INT:
+			result = Logger::isDebugEnabledFor(logger);
+			break;
+		case Level::INFO_INT:
+			result = Logger::isInfoEnabledFor(logger);
+			break;
+		case Level::WARN_INT:
+			result = Logger::isWarnEnabledFor(logger);
+			break;
+		case Level::ERROR_INT:
+			result = Logger::isErrorEnabledFor(logger);
+			break;
+		case Level::FATAL_INT:
+			result = Logger::isFatalEnabledFor(logger);
+			break;
+		default:
+			result = logger && logger->isEnabledFor(Level::toLevel(m_level));
+			break;
+	}
+
+	// The cache is only used for the first non-null logger seen at this call site
+	if (auto pLogger = logger.get())
+	{
+		const Logger* expected = nullptr;
+		if (m_logger.compare_exchange_strong(expected, pLogger, std::memory_order_relaxed)
+			|| expected == pLogger)
+			m_state.store((generation << 1) | (result ? 1 : 0), std::memory_order_release);
+	}
+	return result;
+}
+
+void CallSite::registerCallSite()
+{
+	if (m_registered.load(std::memory_order_relaxed) || m_registered.exchange(true))
+		return;
+	auto& head = registryHead();
+	auto pNext = head.load(std::memory_order_relaxed);
+	do
+	{
+		m_next = pNext;
+	}
+	while (!head.compare_exchange_weak(pNext, this, std::memory_order_release, std::memory_order_relaxed));
+}
+
+LevelPtr CallSite::getLevel() const
+{
+	return Level::toLevel(m_level);
+}
+
+LocationInfo CallSite::getLocation() const
+{
+	if (!m_fileName)
+		return LocationInfo::getLocationUnavailable();
+	return LocationInfo(m_fileName, LocationInfo::calcShortFileName(m_fileName), m_methodName, m_lineNumber);
+}
+
+bool CallSite::isEnabled() const
+{
+	auto state = m_state.load(std::memory_order_acquire);
+	return state == ((s_generation.load(std::memory_order_acquire) << 1) | 1);
+}
+
+CallSiteList CallSite::getCallSites()
+{
+	CallSiteList result;
+	for (auto pSite = registryHead().load(std::memory_order_acquire); pSite; pSite = pSite->m_next)
+		result.push_back(pSite);
+	return result;
+}
+
+unsigned CallSite::getGeneration()
+{
+	return s_generation.load(std::memory_order_acquire);
+}
+
+void CallSite::invalidateAll()
+{
+	s_generation.fetch_add(1, std::memory_order_acq_rel);
+}
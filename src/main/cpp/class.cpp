@@ -31,6 +31,7 @@
 #include <log4cxx/asyncappender.h>
 #include <log4cxx/consoleappender.h>
 #include <log4cxx/fileappender.h>
+#include <log4cxx/routingappender.h>
 #include <log4cxx/db/odbcappender.h>
 #if defined(WIN32) || defined(_WIN32)
 	#if !defined(_WIN32_WCE)
@@ -44,6 +45,11 @@
 #include <log4cxx/net/telnetappender.h>
 #include <log4cxx/writerappender.h>
 #include <log4cxx/net/xmlsocketappender.h>
+#include <log4cxx/net/binarysocketappender.h>
+#if !defined(_WIN32)
+#include <log4cxx/net/sharedmemoryappender.h>
+#include <log4cxx/net/unixsocketappender.h>
+#endif
 #include <log4cxx/layout.h>
 #include <log4cxx/patternlayout.h>
 #include <log4cxx/jsonlayout.h>
@@ -173,6 +179,7 @@ void Class::registerClasses()
 	AsyncAppender::registerClass();
 	ConsoleAppender::registerClass();
 	FileAppender::registerClass();
+	RoutingAppender::registerClass();
 	LOG4CXX_NS::db::ODBCAppender::registerClass();
 #if (defined(WIN32) || defined(_WIN32))
 #if !defined(_WIN32_WCE)
@@ -204,7 +211,12 @@ void Class::registerClasses()
 #if LOG4CXX_HAS_NETWORKING
 	TelnetAppender::registerClass();
 	XMLSocketAppender::registerClass();
+	BinarySocketAppender::registerClass();
 	SyslogAppender::registerClass();
+#if !defined(_WIN32)
+	SharedMemoryAppender::registerClass();
+	UnixSocketAppender::registerClass();
+#endif
 #endif
 }
 
@@ -20,9 +20,27 @@
 #include <log4cxx/helpers/systemoutwriter.h>
 #include <log4cxx/helpers/systemerrwriter.h>
 #include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/appendermetrics.h>
+#include <log4cxx/helpers/optionconverter.h>
+#include <log4cxx/helpers/threadutility.h>
+#include <log4cxx/helpers/transcoder.h>
 #include <log4cxx/layout.h>
 #include <log4cxx/private/appenderskeleton_priv.h>
 #include <log4cxx/private/writerappender_priv.h>
+#include <log4cxx/private/log4cxx_private.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <wchar.h>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 using namespace LOG4CXX_NS;
 using namespace LOG4CXX_NS::helpers;
@@ -34,6 +52,25 @@ struct ConsoleAppender::ConsoleAppenderPriv : public WriterAppender::WriterAppen
 		target(target) {}
 
 	LogString target;
+
+	bool directWrite = false;
+	size_t bufferSize = 8 * 1024;
+	/** The maximum milliseconds output waits to be written */
+	int flushInterval = 1000;
+	bool backgroundWrite = false;
+	/** The descriptor used when directWrite is in effect, otherwise -1 */
+	int fd = -1;
+	/** Output waiting to be written, guarded by bufferMutex */
+	std::string buffer;
+	size_t discardCount = 0;
+	bool stopping = false;
+	std::mutex bufferMutex;
+	std::condition_variable bufferChanged;
+	std::thread writer;
+
+	void write(const std::string& data);
+	void writeBufferedOutput();
+	void stopWriter();
 };
 
 #define _priv static_cast<ConsoleAppenderPriv*>(m_priv.get())
@@ -54,6 +91,157 @@ ConsoleAppender::ConsoleAppender(const LayoutPtr& layout)
 	WriterAppender::activateOptions(p);
 }
 
+void ConsoleAppender::close()
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->stopWriter();
+	if (0 <= _priv->fd)
+	{
+		std::lock_guard<std::mutex> bufferLock(_priv->bufferMutex);
+		_priv->write(_priv->buffer);
+		_priv->buffer.clear();
+		_priv->fd = -1;
+	}
+	WriterAppender::close();
+}
+
+void ConsoleAppender::subAppend(const spi::LoggingEventPtr& event, Pool& p)
+{
+	if (_priv->fd < 0)
+	{
+		WriterAppender::subAppend(event, p);
+		return;
+	}
+	LogString formatted;
+	const LogString* pMsg = _priv->preformatted;
+	if (!pMsg)
+	{
+		_priv->layout->format(formatted, event, p);
+		pMsg = &formatted;
+	}
+	const LogString& msg = *pMsg;
+
+	std::unique_lock<std::mutex> lock(_priv->bufferMutex);
+	auto previousSize = _priv->buffer.size();
+	if (_priv->backgroundWrite && 8 * _priv->bufferSize <= previousSize)
+	{
+		// Limit the memory used when the reader cannot keep up
+		++_priv->discardCount;
+		if (auto metrics = _priv->getMetrics())
+			metrics->add(AppenderMetrics::Discards);
+		return;
+	}
+	Transcoder::encode(msg, _priv->buffer);
+	if (auto metrics = _priv->getMetrics())
+		metrics->add(AppenderMetrics::BytesWritten, _priv->buffer.size() - previousSize);
+
+	if (_priv->backgroundWrite)
+	{
+		if (_priv->immediateFlush ? 0 == previousSize : _priv->bufferSize <= _priv->buffer.size())
+			_priv->bufferChanged.notify_all();
+	}
+	else if (_priv->immediateFlush || _priv->bufferSize <= _priv->buffer.size())
+	{
+		_priv->write(_priv->buffer);
+		_priv->buffer.clear();
+	}
+}
+
+void ConsoleAppender::ConsoleAppenderPriv::write(const std::string& data)
+{
+	const char* p = data.data();
+	size_t remaining = data.size();
+	while (0 < remaining)
+	{
+		size_t count = remaining;
+#if defined(PIPE_BUF)
+		// A pipe write of up to PIPE_BUF bytes is not interleaved with writes by other processes
+		if (PIPE_BUF < count)
+		{
+			count = PIPE_BUF;
+			while (1 < count && '\n' != p[count - 1])
+				--count;
+			// A line longer than PIPE_BUF cannot be written atomically
+			if ('\n' != p[count - 1])
+				count = PIPE_BUF;
+		}
+#endif
+#if defined(_WIN32)
+		auto result = _write(fd, p, unsigned(count));
+#else
+		auto result = ::write(fd, p, count);
+#endif
+		if (0 < result)
+		{
+			p += result;
+			remaining -= size_t(result);
+		}
+		else if (result < 0 && EINTR == errno)
+			continue;
+		else
+		{
+			errorHandler->error(LOG4CXX_STR("Unable to write console output"), IOException(errno), spi::ErrorCode::WRITE_FAILURE);
+			break;
+		}
+	}
+}
+
+void ConsoleAppender::ConsoleAppenderPriv::writeBufferedOutput()
+{
+	std::string output;
+	output.reserve(bufferSize);
+	bool finished = false;
+	while (!finished)
+	{
+		size_t discards = 0;
+		{
+			std::unique_lock<std::mutex> lock(bufferMutex);
+			if (backgroundWrite)
+			{
+				bufferChanged.wait_for(lock, std::chrono::milliseconds(flushInterval), [this]()
+					{ return stopping || (immediateFlush ? !buffer.empty() : bufferSize <= buffer.size()); });
+				std::swap(output, buffer);
+				std::swap(discards, discardCount);
+			}
+			else
+			{
+				// Writes are made by the logging threads except when the interval expires
+				if (!bufferChanged.wait_for(lock, std::chrono::milliseconds(flushInterval), [this]() { return stopping; }))
+				{
+					write(buffer);
+					buffer.clear();
+				}
+				finished = stopping;
+				continue;
+			}
+			finished = stopping;
+		}
+
+		if (0 < discards)
+		{
+			Pool p;
+			LogString msg;
+			StringHelper::toString(discards, p, msg);
+			msg += LOG4CXX_STR(" events discarded by [") + name + LOG4CXX_STR("] as the buffer was full.");
+			LogLog::warn(msg);
+		}
+
+		write(output);
+		output.clear();
+	}
+}
+
+void ConsoleAppender::ConsoleAppenderPriv::stopWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock(bufferMutex);
+		stopping = true;
+		bufferChanged.notify_all();
+	}
+	if (writer.joinable())
+		writer.join();
+}
+
 ConsoleAppender::ConsoleAppender(const LayoutPtr& layout, const LogString& target)
 	: WriterAppender (std::make_unique<ConsoleAppenderPriv>(target))
 {
@@ -114,6 +302,9 @@ void ConsoleAppender::targetWarn(const LogString& val)
 
 void ConsoleAppender::activateOptions(Pool& p)
 {
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->stopWriter();
+	_priv->fd = -1;
 	if (StringHelper::equalsIgnoreCase(_priv->target,
 			LOG4CXX_STR("SYSTEM.OUT"), LOG4CXX_STR("system.out")))
 	{
@@ -128,6 +319,28 @@ void ConsoleAppender::activateOptions(Pool& p)
 	}
 
 	WriterAppender::activateOptions(p);
+
+	FILE* stream = getSystemErr() == _priv->target ? stderr : stdout;
+	if (_priv->directWrite
+#if LOG4CXX_HAS_FWIDE
+		&& fwide(stream, 0) <= 0
+#endif
+		)
+	{
+		// Output written by the C library (e.g. the layout header) must precede ours
+		fflush(stream);
+#if defined(_WIN32)
+		_priv->fd = _fileno(stream);
+#else
+		_priv->fd = fileno(stream);
+#endif
+		_priv->buffer.reserve(_priv->bufferSize);
+		if (_priv->backgroundWrite || !_priv->immediateFlush)
+		{
+			_priv->stopping = false;
+			_priv->writer = ThreadUtility::instance()->createThread( LOG4CXX_STR("ConsoleAppender"), &ConsoleAppenderPriv::writeBufferedOutput, _priv );
+		}
+	}
 }
 
 void ConsoleAppender::setOption(const LogString& option, const LogString& value)
@@ -137,14 +350,68 @@ void ConsoleAppender::setOption(const LogString& option, const LogString& value)
 	{
 		setTarget(value);
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("DIRECTWRITE"), LOG4CXX_STR("directwrite")))
+	{
+		setDirectWrite(OptionConverter::toBoolean(value, false));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("IMMEDIATEFLUSH"), LOG4CXX_STR("immediateflush")))
+	{
+		setImmediateFlush(OptionConverter::toBoolean(value, true));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("BUFFERSIZE"), LOG4CXX_STR("buffersize")))
+	{
+		setBufferSize(OptionConverter::toFileSize(value, 8 * 1024));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("FLUSHINTERVAL"), LOG4CXX_STR("flushinterval")))
+	{
+		setFlushInterval(OptionConverter::toInt(value, 1000));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("BACKGROUNDWRITE"), LOG4CXX_STR("backgroundwrite")))
+	{
+		setBackgroundWrite(OptionConverter::toBoolean(value, false));
+	}
 	else
 	{
 		WriterAppender::setOption(option, value);
 	}
 }
 
+void ConsoleAppender::setDirectWrite(bool newValue)
+{
+	_priv->directWrite = newValue;
+}
 
+bool ConsoleAppender::getDirectWrite() const
+{
+	return _priv->directWrite;
+}
 
+void ConsoleAppender::setBufferSize(size_t byteCount)
+{
+	_priv->bufferSize = (byteCount < 1) ? 1 : byteCount;
+}
 
+size_t ConsoleAppender::getBufferSize() const
+{
+	return _priv->bufferSize;
+}
 
+void ConsoleAppender::setFlushInterval(int milliseconds)
+{
+	_priv->flushInterval = (milliseconds < 1) ? 1 : milliseconds;
+}
 
+int ConsoleAppender::getFlushInterval() const
+{
+	return _priv->flushInterval;
+}
+
+void ConsoleAppender::setBackgroundWrite(bool newValue)
+{
+	_priv->backgroundWrite = newValue;
+}
+
+bool ConsoleAppender::getBackgroundWrite() const
+{
+	return _priv->backgroundWrite;
+}
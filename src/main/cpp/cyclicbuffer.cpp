@@ -171,6 +171,11 @@ void CyclicBuffer::resize(int newSize)
 	}
 }
 
+void CyclicBuffer::swap(CyclicBuffer& other)
+{
+	std::swap(m_priv, other.m_priv);
+}
+
 int CyclicBuffer::getMaxSize() const
 {
 	return m_priv->maxSize;
@@ -34,9 +34,17 @@
 #include <log4cxx/pattern/threadpatternconverter.h>
 #include <log4cxx/pattern/threadusernamepatternconverter.h>
 #include <log4cxx/pattern/ndcpatternconverter.h>
+#include <log4cxx/helpers/appendermetrics.h>
+#include <log4cxx/helpers/optionconverter.h>
+#include <log4cxx/helpers/threadutility.h>
 #include <log4cxx/private/appenderskeleton_priv.h>
 #include <apr_dbd.h>
+#include <algorithm>
 #include <assert.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 using namespace LOG4CXX_NS;
 using namespace LOG4CXX_NS::helpers;
@@ -72,6 +80,25 @@ struct DBAppender::DBAppenderPriv : public AppenderSkeleton::AppenderSkeletonPri
     std::string sqlStatement;
     Pool m_pool;
     std::vector<pattern::LoggingEventPatternConverterPtr> converters;
+
+    /** The number of rows written in each transaction */
+    int bufferSize = 1;
+    /** The maximum milliseconds a row waits to be written */
+    int flushInterval = 1000;
+    /** The number of waiting rows at which events are discarded, zero for eight times bufferSize */
+    int maxPendingRows = 0;
+    using Row = std::vector<std::string>;
+    /** Rows waiting to be written, guarded by bufferMutex */
+    std::vector<Row> buffer;
+    size_t discardCount = 0;
+    bool stopping = false;
+    std::mutex bufferMutex;
+    std::condition_variable bufferChanged;
+    std::thread writer;
+
+    void insert(const Row& row, Pool& p, int& errorCount, LogString& lastError);
+    void writeBatch(std::vector<Row>& rows);
+    void writeBufferedRows();
 };
 
 #define RULES_PUT(spec, cls) \
@@ -110,6 +137,14 @@ DBAppender::~DBAppender()
 }
 
 void DBAppender::close(){
+    std::lock_guard<std::recursive_mutex> appenderLock(_priv->mutex);
+    {
+        std::lock_guard<std::mutex> lock(_priv->bufferMutex);
+        _priv->stopping = true;
+        _priv->bufferChanged.notify_all();
+    }
+    if (_priv->writer.joinable())
+        _priv->writer.join();
     if(_priv->m_driver && _priv->m_databaseHandle){
         apr_dbd_close(_priv->m_driver, _priv->m_databaseHandle);
     }
@@ -138,6 +173,18 @@ void DBAppender::setOption(const LogString& option, const LogString& value){
     {
         Transcoder::encodeUTF8(value, _priv->sqlStatement);
     }
+    else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("BUFFERSIZE"), LOG4CXX_STR("buffersize")))
+    {
+        setBufferSize(OptionConverter::toInt(value, 1));
+    }
+    else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("FLUSHINTERVAL"), LOG4CXX_STR("flushinterval")))
+    {
+        setFlushInterval(OptionConverter::toInt(value, 1000));
+    }
+    else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("MAXPENDINGROWS"), LOG4CXX_STR("maxpendingrows")))
+    {
+        setMaxPendingRows(OptionConverter::toInt(value, 0));
+    }
     else
     {
         AppenderSkeleton::setOption(option, value);
@@ -206,14 +253,15 @@ void DBAppender::activateOptions(helpers::Pool& p){
             _priv->converters.push_back(converter);
         }
     }
+
+    if (1 < _priv->bufferSize && !_priv->writer.joinable())
+    {
+        _priv->stopping = false;
+        _priv->writer = ThreadUtility::instance()->createThread( LOG4CXX_STR("DBAppender"), &DBAppenderPriv::writeBufferedRows, _priv );
+    }
 }
 
 void DBAppender::append(const spi::LoggingEventPtr& event, helpers::Pool& p){
-	std::vector<std::string> ls_args;
-    std::vector<const char*> args;
-    int stat;
-    int num_rows;
-
     if(_priv->m_driver == nullptr ||
             _priv->m_databaseHandle == nullptr ||
             _priv->preparedStmt == nullptr){
@@ -221,30 +269,173 @@ void DBAppender::append(const spi::LoggingEventPtr& event, helpers::Pool& p){
         return;
     }
 
+    // The values are formatted on the calling thread as they may depend on its context (e.g. NDC)
+    DBAppenderPriv::Row row;
     for(auto& converter : _priv->converters){
         LogString str_data;
         converter->format(event, str_data, p);
-		LOG4CXX_ENCODE_CHAR(new_str_data, str_data);
-		ls_args.push_back(new_str_data);
+        LOG4CXX_ENCODE_CHAR(new_str_data, str_data);
+        row.push_back(std::move(new_str_data));
+    }
+
+    if (_priv->writer.joinable())
+    {
+        std::lock_guard<std::mutex> lock(_priv->bufferMutex);
+        // Limit the memory used when the database cannot keep up
+        size_t maxPendingRows = 0 < _priv->maxPendingRows
+            ? size_t(std::max(_priv->maxPendingRows, _priv->bufferSize))
+            : size_t(_priv->bufferSize) * 8;
+        if (maxPendingRows <= _priv->buffer.size())
+        {
+            ++_priv->discardCount;
+            if (auto metrics = _priv->getMetrics())
+                metrics->add(AppenderMetrics::Discards);
+            return;
+        }
+        _priv->buffer.push_back(std::move(row));
+        if (_priv->buffer.size() == size_t(_priv->bufferSize))
+            _priv->bufferChanged.notify_all();
+        return;
+    }
+
+    int errorCount = 0;
+    LogString error;
+    _priv->insert(row, _priv->m_pool, errorCount, error);
+    if (0 < errorCount)
+    {
+        LogLog::error(error);
+        _priv->errorHandler->error(error);
     }
+}
 
-	for(std::string& str : ls_args){
+void DBAppender::DBAppenderPriv::insert(const Row& row, Pool& p, int& errorCount, LogString& lastError)
+{
+    std::vector<const char*> args;
+    for(auto& str : row){
         args.push_back(str.data());
     }
     args.push_back(nullptr);
 
-    stat = apr_dbd_pquery(_priv->m_driver,
-                          _priv->m_pool.getAPRPool(),
-                          _priv->m_databaseHandle,
+    int num_rows;
+    int stat = apr_dbd_pquery(m_driver,
+                          p.getAPRPool(),
+                          m_databaseHandle,
                           &num_rows,
-                          _priv->preparedStmt,
+                          preparedStmt,
                           int(args.size()),
                           args.data());
     if(stat != APR_SUCCESS){
-        LogString error = LOG4CXX_STR("Unable to insert: ");
-		LOG4CXX_DECODE_CHAR(local_error, apr_dbd_error(_priv->m_driver, _priv->m_databaseHandle, stat));
-		error.append(local_error);
-        LogLog::error(error);
-        _priv->errorHandler->error(error);
+        ++errorCount;
+        lastError = LOG4CXX_STR("Unable to insert: ");
+        LOG4CXX_DECODE_CHAR(local_error, apr_dbd_error(m_driver, m_databaseHandle, stat));
+        lastError.append(local_error);
+    }
+}
+
+void DBAppender::DBAppenderPriv::writeBatch(std::vector<Row>& rows)
+{
+    // Memory allocated by the driver is released after each batch
+    Pool p;
+    apr_dbd_transaction_t* transaction = nullptr;
+    int errorCount = 0;
+    LogString lastError;
+    int stat = apr_dbd_transaction_start(m_driver, p.getAPRPool(), m_databaseHandle, &transaction);
+    if (stat == APR_SUCCESS)
+    {
+        // Keep the rows that were inserted when some fail
+        apr_dbd_transaction_mode_set(m_driver, transaction,
+            APR_DBD_TRANSACTION_COMMIT | APR_DBD_TRANSACTION_IGNORE_ERRORS);
     }
+    else
+    {
+        transaction = nullptr;
+        LogLog::warn(LOG4CXX_STR("Unable to start a transaction: each row is committed separately"));
+    }
+
+    for (auto& row : rows)
+        insert(row, p, errorCount, lastError);
+
+    if (transaction)
+    {
+        stat = apr_dbd_transaction_end(m_driver, p.getAPRPool(), transaction);
+        if (stat != APR_SUCCESS)
+        {
+            errorCount = int(rows.size());
+            lastError = LOG4CXX_STR("Unable to commit: ");
+            LOG4CXX_DECODE_CHAR(local_error, apr_dbd_error(m_driver, m_databaseHandle, stat));
+            lastError.append(local_error);
+        }
+    }
+
+    if (0 < errorCount)
+    {
+        LogString msg;
+        StringHelper::toString(errorCount, p, msg);
+        msg += LOG4CXX_STR(" of ");
+        StringHelper::toString(rows.size(), p, msg);
+        msg += LOG4CXX_STR(" rows were not written by [") + name + LOG4CXX_STR("]. ") + lastError;
+        LogLog::error(msg);
+        errorHandler->error(msg);
+    }
+    rows.clear();
+}
+
+void DBAppender::DBAppenderPriv::writeBufferedRows()
+{
+    std::vector<Row> rows;
+    bool finished = false;
+    while (!finished)
+    {
+        size_t discards = 0;
+        {
+            std::unique_lock<std::mutex> lock(bufferMutex);
+            bufferChanged.wait_for(lock, std::chrono::milliseconds(flushInterval), [this]()
+                { return stopping || size_t(bufferSize) <= buffer.size(); });
+            std::swap(rows, buffer);
+            std::swap(discards, discardCount);
+            finished = stopping;
+        }
+
+        if (0 < discards)
+        {
+            Pool p;
+            LogString msg;
+            StringHelper::toString(discards, p, msg);
+            msg += LOG4CXX_STR(" events discarded by [") + name + LOG4CXX_STR("] as the buffer was full.");
+            LogLog::warn(msg);
+        }
+
+        if (!rows.empty())
+            writeBatch(rows);
+    }
+}
+
+void DBAppender::setBufferSize(int newValue)
+{
+    _priv->bufferSize = (newValue < 1) ? 1 : newValue;
+}
+
+int DBAppender::getBufferSize() const
+{
+    return _priv->bufferSize;
+}
+
+void DBAppender::setFlushInterval(int milliseconds)
+{
+    _priv->flushInterval = (milliseconds < 1) ? 1 : milliseconds;
+}
+
+int DBAppender::getFlushInterval() const
+{
+    return _priv->flushInterval;
+}
+
+void DBAppender::setMaxPendingRows(int count)
+{
+    _priv->maxPendingRows = (count < 0) ? 0 : count;
+}
+
+int DBAppender::getMaxPendingRows() const
+{
+    return _priv->maxPendingRows;
 }
@@ -36,6 +36,7 @@
 #include <log4cxx/spi/loggingevent.h>
 #include <log4cxx/helpers/pool.h>
 #include <sstream>
+#include <set>
 #include <log4cxx/helpers/transcoder.h>
 #include <log4cxx/rolling/rollingfileappender.h>
 #include <log4cxx/rolling/filterbasedtriggeringpolicy.h>
@@ -58,11 +59,53 @@ using namespace LOG4CXX_NS::rolling;
 
 #define MAX_ATTRIBUTE_NAME_LEN 2000
 
+namespace
+{
+/**
+The parts of a configuration file used to determine what changed on reload.
+*/
+struct ReloadState
+{
+	/** The serialized element of each appender */
+	std::map<LogString, std::string> appenderDefinitions;
+	/** The name of each configured logger */
+	std::set<LogString> loggerNames;
+};
+
+void appendDefinition(const apr_xml_elem* element, std::string& buf)
+{
+	buf += '<';
+	buf += element->name;
+	for (const apr_xml_attr* attr = element->attr; attr; attr = attr->next)
+	{
+		buf += ' ';
+		buf += attr->name;
+		buf += "=\"";
+		buf += attr->value;
+		buf += '"';
+	}
+	buf += '>';
+	for (const apr_xml_elem* child = element->first_child; child; child = child->next)
+		appendDefinition(child, buf);
+	buf += "</";
+	buf += element->name;
+	buf += '>';
+}
+
+} // namespace
+
 struct DOMConfigurator::DOMConfiguratorPrivate
 {
 	helpers::Properties props;
 	spi::LoggerRepositoryPtr repository;
 	spi::LoggerFactoryPtr loggerFactory;
+
+	/** The state of the previously loaded configuration or null */
+	const ReloadState* previous = nullptr;
+	/** The state of the configuration being loaded */
+	ReloadState current;
+	/** Attached appenders with an unchanged definition */
+	AppenderMap retainedAppenders;
 };
 
 namespace LOG4CXX_NS
@@ -79,12 +122,26 @@ class XMLWatchdog  : public FileWatchdog
 		/**
 		Call DOMConfigurator#doConfigure with the
 		<code>filename</code> to reconfigure log4cxx.
+
+		The state of the previous load is provided
+		for use when the <code>incrementalReload</code> attribute is true.
 		*/
 		void doOnChange()
 		{
-			DOMConfigurator().doConfigure(file(),
-				LogManager::getLoggerRepository());
+			DOMConfigurator configurator;
+			if (loaded)
+				configurator.m_priv->previous = &state;
+			if (spi::ConfigurationStatus::Configured == configurator.doConfigure(file(),
+				LogManager::getLoggerRepository()))
+			{
+				state = std::move(configurator.m_priv->current);
+				loaded = true;
+			}
 		}
+
+	private:
+		ReloadState state;
+		bool loaded = false;
 };
 }
 }
@@ -121,6 +178,7 @@ IMPLEMENT_LOG4CXX_OBJECT(DOMConfigurator)
 #define CONFIG_DEBUG_ATTR "configDebug"
 #define INTERNAL_DEBUG_ATTR "debug"
 #define THREAD_CONFIG_ATTR "threadConfiguration"
+#define INCREMENTAL_RELOAD_ATTR "incrementalReload"
 
 DOMConfigurator::DOMConfigurator()
 	: m_priv(std::make_unique<DOMConfiguratorPrivate>())
@@ -181,6 +239,12 @@ AppenderPtr DOMConfigurator::findAppenderByReference(
 	{
 		appender = match->second;
 	}
+	else if ((match = m_priv->retainedAppenders.find(appenderName)) != m_priv->retainedAppenders.end())
+	{
+		LogLog::debug(LOG4CXX_STR("Retaining unchanged appender [") + appenderName + LOG4CXX_STR("]."));
+		appender = match->second;
+		appenders.insert(AppenderMap::value_type(appenderName, appender));
+	}
 	else if (doc)
 	{
 		appender = findAppenderByName(p, utf8Decoder, doc->root, doc, appenderName, appenders);
@@ -509,10 +573,6 @@ void DOMConfigurator::parseChildrenOfLoggerElement(
 	PropertySetter propSetter(logger);
 	std::vector<AppenderPtr> newappenders;
 
-	// Remove all existing appenders from logger. They will be
-	// reconstructed if need be.
-	logger->removeAllAppenders();
-
 	for (apr_xml_elem* currentElement = loggerElement->first_child;
 		currentElement;
 		currentElement = currentElement->next)
@@ -535,8 +595,10 @@ void DOMConfigurator::parseChildrenOfLoggerElement(
 					LOG4CXX_STR("] not found."));
 			}
 
-			logger->addAppender(appender);
-
+			if (appender)
+			{
+				newappenders.push_back(appender);
+			}
 		}
 		else if (tagName == LEVEL_TAG)
 		{
@@ -552,6 +614,9 @@ void DOMConfigurator::parseChildrenOfLoggerElement(
 		}
 	}
 
+	// Replace the existing appenders in a single step
+	logger->reconfigure(newappenders, logger->getAdditivity());
+
 	propSetter.activate(p);
 }
 
@@ -1067,6 +1132,31 @@ void DOMConfigurator::parse(
 
 	apr_xml_elem* currentElement;
 
+	for (currentElement = element->first_child;
+		currentElement;
+		currentElement = currentElement->next)
+	{
+		std::string tagName(currentElement->name);
+
+		if (tagName == APPENDER_TAG)
+		{
+			std::string definition;
+			appendDefinition(currentElement, definition);
+			m_priv->current.appenderDefinitions[subst(getAttribute(utf8Decoder, currentElement, NAME_ATTR))] = definition;
+		}
+		else if (tagName == CATEGORY || tagName == LOGGER)
+		{
+			m_priv->current.loggerNames.insert(subst(getAttribute(utf8Decoder, currentElement, NAME_ATTR)));
+		}
+	}
+
+	LogString incrementalReload = subst(getAttribute(utf8Decoder, element, INCREMENTAL_RELOAD_ATTR));
+
+	if (m_priv->previous && OptionConverter::toBoolean(incrementalReload, false))
+	{
+		retainUnchangedAppenders();
+	}
+
 	for (currentElement = element->first_child;
 		currentElement;
 		currentElement = currentElement->next)
@@ -1096,6 +1186,39 @@ void DOMConfigurator::parse(
 	}
 }
 
+void DOMConfigurator::retainUnchangedAppenders()
+{
+	auto& previous = *m_priv->previous;
+	auto& current = m_priv->current;
+	auto loggers = m_priv->repository->getCurrentLoggers();
+	loggers.push_back(m_priv->repository->getRootLogger());
+	for (auto& logger : loggers)
+	{
+		for (auto& appender : logger->getAllAppenders())
+		{
+			auto pPrevious = previous.appenderDefinitions.find(appender->getName());
+			auto pCurrent = current.appenderDefinitions.find(appender->getName());
+			if (pPrevious != previous.appenderDefinitions.end()
+				&& pCurrent != current.appenderDefinitions.end()
+				&& pPrevious->second == pCurrent->second)
+				m_priv->retainedAppenders[appender->getName()] = appender;
+		}
+	}
+
+	// Restore the default state of loggers that are no longer configured
+	for (auto& loggerName : previous.loggerNames)
+	{
+		if (current.loggerNames.find(loggerName) != current.loggerNames.end())
+			continue;
+		if (auto logger = m_priv->repository->exists(loggerName))
+		{
+			LogLog::debug(LOG4CXX_STR("Resetting unconfigured logger [") + loggerName + LOG4CXX_STR("]."));
+			logger->setLevel(0);
+			logger->reconfigure(std::vector<AppenderPtr>(), true);
+		}
+	}
+}
+
 LogString DOMConfigurator::subst(const LogString& value)
 {
 	try
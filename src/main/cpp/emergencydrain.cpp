@@ -0,0 +1,349 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/private/emergencydrain.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/loglog.h>
+#include <log4cxx/level.h>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#if !defined(_WIN32)
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::helpers;
+
+namespace
+{
+
+const size_t SlotCount = 256;
+
+enum SlotState
+{
+	Free,
+	Busy,
+	Active
+};
+
+// Preallocated so the signal handler does not use the heap
+struct Slot
+{
+	std::atomic<int> state;
+	EmergencyDrain::Action action;
+	void* context;
+	EmergencyDrain::Order order;
+} slots[SlotCount];
+
+std::atomic_flag draining = ATOMIC_FLAG_INIT;
+
+#if !defined(_WIN32)
+const int fatalSignals[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+const size_t fatalSignalCount = sizeof(fatalSignals) / sizeof(fatalSignals[0]);
+struct sigaction previousActions[fatalSignalCount];
+
+void handleSignal(int signalNumber, siginfo_t*, void*)
+{
+	int savedErrno = errno;
+	EmergencyDrain::drain();
+	errno = savedErrno;
+
+	// Let the previous handler (or the default action) deal with the signal
+	for (size_t i = 0; i < fatalSignalCount; ++i)
+	{
+		if (fatalSignals[i] == signalNumber)
+			sigaction(signalNumber, &previousActions[i], nullptr);
+	}
+	// Delivered when this handler returns, as the signal is blocked until then
+	raise(signalNumber);
+}
+#endif
+
+// The text of a built-in level, available without allocating memory
+const char* getLevelName(int level)
+{
+	switch (level)
+	{
+		case Level::TRACE_INT:
+			return "TRACE";
+		case Level::DEBUG_INT:
+			return "DEBUG";
+		case Level::INFO_INT:
+			return "INFO";
+		case Level::WARN_INT:
+			return "WARN";
+		case Level::ERROR_INT:
+			return "ERROR";
+		case Level::FATAL_INT:
+			return "FATAL";
+		default:
+			break;
+	}
+	return "LEVEL";
+}
+
+// Write \c str using UTF-8 or, for wider characters, replacing non-ASCII characters with '?'
+void writeString(int fd, const LogString& str)
+{
+#if LOG4CXX_LOGCHAR_IS_UTF8
+	EmergencyDrain::write(fd, str.data(), str.size());
+#else
+	char buffer[256];
+	size_t used = 0;
+	for (auto ch : str)
+	{
+		buffer[used++] = (0 < ch && ch < 0x80) ? char(ch) : '?';
+		if (used == sizeof(buffer))
+		{
+			EmergencyDrain::write(fd, buffer, used);
+			used = 0;
+		}
+	}
+	EmergencyDrain::write(fd, buffer, used);
+#endif
+}
+
+// Append the decimal digits of \c value to \c dest, returning the position after the last digit
+char* formatNumber(char* dest, uint64_t value, int minimumDigits)
+{
+	char digits[24];
+	int count = 0;
+	do
+	{
+		digits[count++] = char('0' + value % 10);
+		value /= 10;
+	} while (value != 0 || count < minimumDigits);
+	while (0 < count)
+		*dest++ = digits[--count];
+	return dest;
+}
+
+} // namespace
+
+bool EmergencyDrain::install()
+{
+#if defined(_WIN32)
+	LogLog::warn(LOG4CXX_STR("Emergency drain is not available on this platform"));
+	return false;
+#else
+	static std::once_flag installed;
+	std::call_once(installed, []
+	{
+		struct sigaction action;
+		std::memset(&action, 0, sizeof(action));
+		action.sa_sigaction = handleSignal;
+		// Run on the alternate stack (if the thread has one) so a stack overflow can be drained
+		action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+		sigemptyset(&action.sa_mask);
+		for (size_t i = 0; i < fatalSignalCount; ++i)
+			sigaction(fatalSignals[i], &action, &previousActions[i]);
+	});
+	return true;
+#endif
+}
+
+int EmergencyDrain::add(Action action, void* context, Order order)
+{
+	for (size_t i = 0; i < SlotCount; ++i)
+	{
+		int expected = Free;
+		if (slots[i].state.compare_exchange_strong(expected, Busy, std::memory_order_acquire))
+		{
+			slots[i].action = action;
+			slots[i].context = context;
+			slots[i].order = order;
+			slots[i].state.store(Active, std::memory_order_release);
+			return int(i);
+		}
+	}
+	LogLog::warn(LOG4CXX_STR("Emergency drain table is full"));
+	return -1;
+}
+
+void EmergencyDrain::remove(int id)
+{
+	if (0 <= id && size_t(id) < SlotCount)
+		slots[id].state.store(Free, std::memory_order_release);
+}
+
+void EmergencyDrain::drain()
+{
+	// Only the first thread to receive a fatal signal writes the output
+	if (draining.test_and_set())
+		return;
+	for (auto order : { Buffers, Queues })
+	{
+		for (auto& slot : slots)
+		{
+			if (Active == slot.state.load(std::memory_order_acquire) && slot.order == order)
+				slot.action(slot.context);
+		}
+	}
+}
+
+void EmergencyDrain::write(int fd, const char* data, size_t size)
+{
+#if !defined(_WIN32)
+	while (0 < size)
+	{
+		auto result = ::write(fd, data, size);
+		if (result < 0 && errno == EINTR)
+			continue;
+		if (result <= 0)
+			break;
+		data += result;
+		size -= size_t(result);
+	}
+#endif
+}
+
+void EmergencyDrain::write(int fd, const spi::LoggingEvent& event)
+{
+	// seconds.microseconds LEVEL logger - message
+	char prefix[64];
+	auto timeStamp = event.getTimeStamp();
+	auto pEnd = formatNumber(prefix, uint64_t(timeStamp / 1000000), 1);
+	*pEnd++ = '.';
+	pEnd = formatNumber(pEnd, uint64_t(timeStamp % 1000000), 6);
+	*pEnd++ = ' ';
+	auto& level = event.getLevel();
+	auto levelName = getLevelName(level ? level->toInt() : Level::INFO_INT);
+	auto levelLength = std::strlen(levelName);
+	std::memcpy(pEnd, levelName, levelLength);
+	pEnd += levelLength;
+	*pEnd++ = ' ';
+	write(fd, prefix, size_t(pEnd - prefix));
+	writeString(fd, event.getLoggerName());
+	write(fd, " - ", 3);
+	writeString(fd, event.getRenderedMessage());
+	write(fd, "\n", 1);
+}
+
+size_t EmergencyDrain::getCapacity()
+{
+	return SlotCount;
+}
+
+struct DrainableOutputStream::DrainableOutputStreamPrivate
+{
+	DrainableOutputStreamPrivate(const OutputStreamPtr& os1, int fd1, size_t capacity1)
+		: os(os1)
+		, fd(fd1)
+		, capacity(capacity1)
+		, data(new char[capacity1])
+		, length(0)
+	{
+	}
+
+	/**
+	 * Held bytes are written to this stream.
+	 */
+	OutputStreamPtr os;
+
+	/**
+	 * The file descriptor used by the signal handler.
+	 */
+	int fd;
+
+	size_t capacity;
+	std::unique_ptr<char[]> data;
+
+	/**
+	 * The number of bytes held, stored after they are copied into data.
+	 */
+	std::atomic<size_t> length;
+
+	/**
+	 * The EmergencyDrain table entry, or -1.
+	 */
+	int slot = -1;
+
+	void writeHeldBytes(Pool& p)
+	{
+		auto size = length.load(std::memory_order_relaxed);
+		if (0 < size)
+		{
+			ByteBuffer buf(data.get(), size);
+			os->write(buf, p);
+			length.store(0, std::memory_order_release);
+		}
+	}
+
+	static void drain(void* context)
+	{
+		auto self = static_cast<DrainableOutputStreamPrivate*>(context);
+		auto size = self->length.load(std::memory_order_acquire);
+		EmergencyDrain::write(self->fd, self->data.get(), size);
+		self->length.store(0, std::memory_order_relaxed);
+	}
+};
+
+DrainableOutputStream::DrainableOutputStream(const OutputStreamPtr& os, int fd, size_t capacity)
+	: m_priv(std::make_unique<DrainableOutputStreamPrivate>(os, fd, std::max(capacity, size_t(1))))
+{
+	m_priv->slot = EmergencyDrain::add(&DrainableOutputStreamPrivate::drain, m_priv.get(), EmergencyDrain::Buffers);
+}
+
+DrainableOutputStream::~DrainableOutputStream()
+{
+	EmergencyDrain::remove(m_priv->slot);
+}
+
+void DrainableOutputStream::close(Pool& p)
+{
+	m_priv->writeHeldBytes(p);
+	// The descriptor is invalid once the file is closed
+	EmergencyDrain::remove(m_priv->slot);
+	m_priv->slot = -1;
+	m_priv->os->close(p);
+}
+
+void DrainableOutputStream::flush(Pool& p)
+{
+	m_priv->writeHeldBytes(p);
+	m_priv->os->flush(p);
+}
+
+void DrainableOutputStream::write(ByteBuffer& buf, Pool& p)
+{
+	auto size = buf.remaining();
+	auto held = m_priv->length.load(std::memory_order_relaxed);
+	if (m_priv->capacity < held + size)
+	{
+		m_priv->writeHeldBytes(p);
+		held = 0;
+	}
+	if (m_priv->capacity <= size)
+	{
+		m_priv->os->write(buf, p);
+		return;
+	}
+	std::memcpy(m_priv->data.get() + held, buf.current(), size);
+	buf.position(buf.limit());
+	// The signal handler only writes the bytes covered by length
+	m_priv->length.store(held + size, std::memory_order_release);
+}
+
+size_t DrainableOutputStream::getLength() const
+{
+	return m_priv->length.load(std::memory_order_relaxed);
+}
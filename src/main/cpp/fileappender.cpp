@@ -27,12 +27,252 @@
 #include <log4cxx/helpers/bytebuffer.h>
 #include <log4cxx/private/writerappender_priv.h>
 #include <log4cxx/private/fileappender_priv.h>
+#include <log4cxx/private/log4cxx_private.h>
+#include <log4cxx/private/emergencydrain.h>
+#include <log4cxx/helpers/threadutility.h>
+#include <log4cxx/helpers/logfileindex.h>
+#if LOG4CXX_HAS_ZLIB
+#include <log4cxx/private/gzipoutputstream.h>
+#endif
 #include <mutex>
+#include <apr_portable.h>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 
 using namespace LOG4CXX_NS;
 using namespace LOG4CXX_NS::helpers;
 using namespace LOG4CXX_NS::spi;
 
+namespace
+{
+
+// Flush the operating system's buffers for \c fd to the storage device
+bool syncToDevice(apr_os_file_t fd)
+{
+#if defined(_WIN32)
+	return 0 != FlushFileBuffers(fd);
+#elif LOG4CXX_HAS_FDATASYNC
+	return 0 == fdatasync(fd);
+#else
+	return 0 == fsync(fd);
+#endif
+}
+
+/**
+ * Wrapper for a file stream that ensures the file content is
+ * on stable storage before the file is closed.
+ */
+class DurableOutputStream : public OutputStream
+{
+	private:
+		FileOutputStreamPtr os;
+
+	public:
+		DurableOutputStream(const FileOutputStreamPtr& os1)
+			: os(os1)
+		{
+		}
+
+		void close(Pool& p) override
+		{
+			apr_os_file_t fd;
+
+			if (os->getFilePtr() && APR_SUCCESS == apr_os_file_get(&fd, os->getFilePtr()) && !syncToDevice(fd))
+			{
+				LogLog::warn(LOG4CXX_STR("Unable to synchronize a log file with the storage device"));
+			}
+
+			os->close(p);
+		}
+
+		void flush(Pool& p) override
+		{
+			os->flush(p);
+		}
+
+		void write(ByteBuffer& buf, Pool& p) override
+		{
+			os->write(buf, p);
+		}
+};
+
+} // namespace
+
+namespace LOG4CXX_NS
+{
+namespace helpers
+{
+
+/**
+ * Writes the time index of a log file.
+ */
+class FileIndexWriter
+{
+	public:
+		FileIndexWriter(size_t interval1)
+			: interval(interval1)
+		{
+		}
+
+		/**
+		 * The position in the log file of the next byte written.
+		 */
+		uint64_t position = 0;
+
+		bool isOpen() const
+		{
+			return !!stream;
+		}
+
+		/**
+		 * Start a block at the current position of \c logFileName.
+		 */
+		void open(const LogString& logFileName, Pool& p)
+		{
+			File indexFile;
+			indexFile.setPath(LogFileIndex::getIndexFileName(logFileName));
+			// Continue an existing index if it has only complete entries
+			bool append = 0 < position && indexFile.exists(p);
+
+			if (append)
+			{
+				auto length = indexFile.length(p);
+				append = LogFileIndex::HeaderSize <= length
+					&& 0 == (length - LogFileIndex::HeaderSize) % LogFileIndex::EntrySize;
+			}
+
+			stream = std::make_shared<FileOutputStream>(indexFile.getPath(), append);
+
+			if (!append)
+			{
+				ByteBuffer buf(const_cast<char*>(LogFileIndex::getHeader()), LogFileIndex::HeaderSize);
+				stream->write(buf, p);
+			}
+
+			startBlock();
+		}
+
+		/**
+		 * Include \c event in the current block.
+		 */
+		void add(const spi::LoggingEventPtr& event)
+		{
+			auto timeStamp = event->getTimeStamp();
+
+			if (0 == entry.eventCount)
+			{
+				entry.minimumTime = entry.maximumTime = timeStamp;
+			}
+			else
+			{
+				entry.minimumTime = std::min(entry.minimumTime, timeStamp);
+				entry.maximumTime = std::max(entry.maximumTime, timeStamp);
+			}
+
+			entry.levels |= LogFileIndex::getLevelBit(event->getLevel());
+			entry.loggers |= LogFileIndex::getLoggerBits(event->getLoggerName());
+			++entry.eventCount;
+		}
+
+		bool isBlockFull() const
+		{
+			return interval <= position - entry.offset;
+		}
+
+		/**
+		 * Write the entry for the bytes written since the block started.
+		 */
+		void finishBlock(Pool& p)
+		{
+			if (stream && 0 < entry.eventCount && entry.offset < position)
+			{
+				char data[LogFileIndex::EntrySize];
+				entry.length = position - entry.offset;
+				LogFileIndex::encode(entry, data);
+				ByteBuffer buf(data, sizeof(data));
+				stream->write(buf, p);
+			}
+
+			startBlock();
+		}
+
+		void close(Pool& p)
+		{
+			if (stream)
+			{
+				finishBlock(p);
+				stream->close(p);
+				stream.reset();
+			}
+		}
+
+	private:
+		void startBlock()
+		{
+			entry = LogFileIndex::Entry();
+			entry.offset = position;
+		}
+
+		size_t interval;
+		LogFileIndex::Entry entry{};
+		FileOutputStreamPtr stream;
+};
+
+} // namespace helpers
+} // namespace LOG4CXX_NS
+
+namespace
+{
+
+/**
+ * Wrapper for OutputStream that keeps the position of a file index up to date
+ * and completes the index when the file is closed.
+ */
+class IndexedOutputStream : public OutputStream
+{
+	private:
+		OutputStreamPtr os;
+		std::shared_ptr<FileIndexWriter> index;
+
+	public:
+		IndexedOutputStream(const OutputStreamPtr& os1, const std::shared_ptr<FileIndexWriter>& index1)
+			: os(os1)
+			, index(index1)
+		{
+		}
+
+		void close(Pool& p) override
+		{
+			os->close(p);
+
+			try
+			{
+				index->close(p);
+			}
+			catch (std::exception&)
+			{
+				LogLog::warn(LOG4CXX_STR("Unable to complete a log file index"));
+			}
+		}
+
+		void flush(Pool& p) override
+		{
+			os->flush(p);
+		}
+
+		void write(ByteBuffer& buf, Pool& p) override
+		{
+			auto length = buf.remaining();
+			os->write(buf, p);
+			index->position += length;
+		}
+};
+
+} // namespace
+
 IMPLEMENT_LOG4CXX_OBJECT(FileAppender)
 
 #define _priv static_cast<FileAppenderPriv*>(m_priv.get())
@@ -140,6 +380,30 @@ void FileAppender::setOption(const LogString& option,
 		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
 		_priv->bufferSize = OptionConverter::toFileSize(value, 8 * 1024);
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("DURABILITY"), LOG4CXX_STR("durability")))
+	{
+		setDurability(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("COMPRESSION"), LOG4CXX_STR("compression")))
+	{
+		setCompression(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("COMPRESSIONFRAMESIZE"), LOG4CXX_STR("compressionframesize")))
+	{
+		setCompressionFrameSize((size_t)OptionConverter::toFileSize(value, 1024 * 1024));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("COMPRESSIONINTERVAL"), LOG4CXX_STR("compressioninterval")))
+	{
+		setCompressionInterval(OptionConverter::toInt(value, 1000));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("INDEXINTERVAL"), LOG4CXX_STR("indexinterval")))
+	{
+		setIndexInterval((size_t)OptionConverter::toFileSize(value, 0));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("EMERGENCYDRAIN"), LOG4CXX_STR("emergencydrain")))
+	{
+		setEmergencyDrain(OptionConverter::toBoolean(value, false));
+	}
 	else
 	{
 		WriterAppender::setOption(option, value);
@@ -184,9 +448,424 @@ void FileAppender::activateOptionsInternal(Pool& p)
 	if (errors == 0)
 	{
 		WriterAppender::activateOptions(p);
+
+		if (_priv->groupCommit || _priv->gzip)
+		{
+			_priv->startSyncer();
+		}
 	}
 }
 
+void FileAppender::setDurability(const LogString& value)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+
+	if (StringHelper::equalsIgnoreCase(value, LOG4CXX_STR("GROUPCOMMIT"), LOG4CXX_STR("groupcommit")))
+	{
+		_priv->groupCommit = true;
+	}
+	else if (StringHelper::equalsIgnoreCase(value, LOG4CXX_STR("NONE"), LOG4CXX_STR("none")))
+	{
+		_priv->groupCommit = false;
+	}
+	else
+	{
+		LogLog::warn(LOG4CXX_STR("Unknown Durability [") + value + LOG4CXX_STR("] ignored"));
+	}
+}
+
+LogString FileAppender::getDurability() const
+{
+	return _priv->groupCommit ? LOG4CXX_STR("GroupCommit") : LOG4CXX_STR("None");
+}
+
+void FileAppender::setCompression(const LogString& value)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+
+	if (StringHelper::equalsIgnoreCase(value, LOG4CXX_STR("GZIP"), LOG4CXX_STR("gzip")))
+	{
+#if LOG4CXX_HAS_ZLIB
+		_priv->gzip = true;
+#else
+		LogLog::warn(LOG4CXX_STR("GZip compression is not available in this build of log4cxx"));
+#endif
+	}
+	else if (StringHelper::equalsIgnoreCase(value, LOG4CXX_STR("NONE"), LOG4CXX_STR("none")))
+	{
+		_priv->gzip = false;
+	}
+	else
+	{
+		LogLog::warn(LOG4CXX_STR("Unknown Compression [") + value + LOG4CXX_STR("] ignored"));
+	}
+}
+
+LogString FileAppender::getCompression() const
+{
+	return _priv->gzip ? LOG4CXX_STR("GZip") : LOG4CXX_STR("None");
+}
+
+void FileAppender::setCompressionFrameSize(size_t value)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->compressionFrameSize = value;
+}
+
+size_t FileAppender::getCompressionFrameSize() const
+{
+	return _priv->compressionFrameSize;
+}
+
+void FileAppender::setCompressionInterval(int milliseconds)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->compressionInterval = milliseconds;
+}
+
+int FileAppender::getCompressionInterval() const
+{
+	return _priv->compressionInterval;
+}
+
+void FileAppender::setIndexInterval(size_t value)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->indexInterval = value;
+}
+
+size_t FileAppender::getIndexInterval() const
+{
+	return _priv->indexInterval;
+}
+
+void FileAppender::setEmergencyDrain(bool value)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->emergencyDrain = value && EmergencyDrain::install();
+}
+
+bool FileAppender::getEmergencyDrain() const
+{
+	return _priv->emergencyDrain;
+}
+
+void FileAppender::doAppend(const spi::LoggingEventPtr& event, Pool& p)
+{
+	WriterAppender::doAppend(event, p);
+
+	if (_priv->groupCommit)
+	{
+		_priv->waitUntilDurable();
+	}
+}
+
+void FileAppender::subAppend(const spi::LoggingEventPtr& event, Pool& p)
+{
+	auto index = _priv->index;
+
+	if (index && !index->isOpen())
+	{
+		try
+		{
+			// Index from the position of the next byte written
+			writeCombinedOutput(p);
+			_priv->writer->flush(p);
+			index->position = File().setPath(_priv->fileName).length(p);
+			index->open(_priv->fileName, p);
+		}
+		catch (std::exception&)
+		{
+			LogLog::warn(LOG4CXX_STR("Unable to open the index of ") + _priv->fileName);
+			index.reset();
+			_priv->index.reset();
+		}
+	}
+
+	WriterAppender::subAppend(event, p);
+	++_priv->writtenCount;
+
+	if (index)
+	{
+		index->add(event);
+
+		if (index->isBlockFull())
+		{
+			try
+			{
+				// The block ends after the output of the events it describes
+				writeCombinedOutput(p);
+				_priv->writer->flush(p);
+				index->finishBlock(p);
+			}
+			catch (std::exception&)
+			{
+				LogLog::warn(LOG4CXX_STR("Unable to update the index of ") + _priv->fileName);
+			}
+		}
+	}
+}
+
+void FileAppender::close()
+{
+	WriterAppender::close();
+	_priv->stopSyncer();
+}
+
+WriterPtr FileAppender::createWriter(OutputStreamPtr& os)
+{
+	OutputStreamPtr dos = _priv->prepareFileStream(os);
+#if LOG4CXX_HAS_ZLIB
+	if (_priv->gzip)
+	{
+		_priv->gzipStream = std::make_shared<GZipOutputStream>(dos, _priv->compressionFrameSize
+			, std::chrono::milliseconds(_priv->compressionInterval));
+		dos = _priv->gzipStream;
+	}
+#endif
+
+	// File positions are not useful in compressed output
+	if (0 < _priv->indexInterval && !_priv->gzip)
+	{
+		_priv->index = std::make_shared<FileIndexWriter>(_priv->indexInterval);
+		dos = std::make_shared<IndexedOutputStream>(dos, _priv->index);
+	}
+	else
+	{
+		_priv->index.reset();
+	}
+
+	return WriterAppender::createWriter(dos);
+}
+
+OutputStreamPtr FileAppender::FileAppenderPriv::makeDurable(const OutputStreamPtr& os)
+{
+	auto fos = LOG4CXX_NS::cast<FileOutputStream>(os);
+
+	if (!groupCommit || !fos)
+	{
+		return os;
+	}
+
+	syncFile = fos;
+	return std::make_shared<DurableOutputStream>(fos);
+}
+
+OutputStreamPtr FileAppender::FileAppenderPriv::prepareFileStream(const OutputStreamPtr& os)
+{
+	auto fos = LOG4CXX_NS::cast<FileOutputStream>(os);
+
+	if (!fos)
+	{
+		return os;
+	}
+
+	drainStream.reset();
+	OutputStreamPtr result = makeDurable(os);
+	apr_os_file_t fd;
+
+	// Raw bytes written to a compressed file would corrupt it
+	if (emergencyDrain && bufferedIO && !gzip && fos->getFilePtr()
+		&& APR_SUCCESS == apr_os_file_get(&fd, fos->getFilePtr()))
+	{
+#if !defined(_WIN32)
+		drainStream = std::make_shared<DrainableOutputStream>(result, fd, size_t(bufferSize));
+		result = drainStream;
+#endif
+	}
+
+	return result;
+}
+
+void FileAppender::FileAppenderPriv::startSyncer()
+{
+	std::lock_guard<std::mutex> lock(syncMutex);
+
+	frameCheckInterval = gzip ? compressionInterval : 0;
+
+	if (!syncer.joinable())
+	{
+		stopping = false;
+		syncer = ThreadUtility::instance()->createThread(LOG4CXX_STR("FileSyncer"), &FileAppenderPriv::runSyncer, this);
+	}
+	else
+	{
+		syncRequested.notify_one();
+	}
+}
+
+void FileAppender::FileAppenderPriv::stopSyncer()
+{
+	{
+		std::lock_guard<std::mutex> lock(syncMutex);
+		stopping = true;
+	}
+	syncRequested.notify_all();
+	syncCompleted.notify_all();
+
+	if (syncer.joinable())
+	{
+		syncer.join();
+	}
+}
+
+void FileAppender::FileAppenderPriv::waitUntilDurable()
+{
+	// The events this caller appended are included in the count
+	uint64_t target = writtenCount;
+	std::unique_lock<std::mutex> lock(syncMutex);
+
+	if (target <= getCompletedCount() || stopping || !syncer.joinable())
+	{
+		return;
+	}
+
+	if (requestedCount < target)
+	{
+		requestedCount = target;
+		syncRequested.notify_one();
+	}
+
+	syncCompleted.wait(lock, [this, target]
+	{
+		return target <= getCompletedCount() || stopping;
+	});
+}
+
+void FileAppender::FileAppenderPriv::runSyncer()
+{
+	Pool p;
+	std::unique_lock<std::mutex> lock(syncMutex);
+
+	auto isRequested = [this]
+	{
+		return stopping || getCompletedCount() < requestedCount;
+	};
+
+	while (true)
+	{
+		if (0 < frameCheckInterval)
+		{
+			if (!syncRequested.wait_for(lock, std::chrono::milliseconds(frameCheckInterval), isRequested))
+			{
+				lock.unlock();
+				finishIdleFrame(p);
+				lock.lock();
+				continue;
+			}
+		}
+		else
+		{
+			syncRequested.wait(lock, isRequested);
+		}
+
+		if (requestedCount <= getCompletedCount())
+		{
+			break;
+		}
+
+		lock.unlock();
+		uint64_t count;
+		bool synced = true;
+		apr_os_file_t fd;
+#if !defined(_WIN32)
+		bool haveFile = false;
+#endif
+		{
+			std::lock_guard<std::recursive_mutex> appenderLock(mutex);
+			count = writtenCount;
+
+			try
+			{
+				if (writer)
+				{
+					writer->flush(p);
+#if LOG4CXX_HAS_ZLIB
+					// Waiting callers need their output in a completed member
+					if (gzipStream)
+					{
+						gzipStream->finishFrame(p);
+					}
+#endif
+				}
+			}
+			catch (std::exception& e)
+			{
+				errorHandler->error(LOG4CXX_STR("Unable to flush the log file"), e, ErrorCode::FLUSH_FAILURE);
+				synced = false;
+			}
+
+			if (syncFile && syncFile->getFilePtr()
+				&& APR_SUCCESS == apr_os_file_get(&fd, syncFile->getFilePtr()))
+			{
+#if defined(_WIN32)
+				// The handle is only usable while the appender lock is held
+				if (!syncToDevice(fd))
+				{
+					reportSyncFailure(apr_get_os_error());
+					synced = false;
+				}
+#else
+				// A duplicate descriptor remains valid if a rollover closes the file
+				fd = dup(fd);
+				haveFile = 0 <= fd;
+#endif
+			}
+		}
+
+#if !defined(_WIN32)
+		if (haveFile)
+		{
+			if (!syncToDevice(fd))
+			{
+				auto status = apr_get_os_error();
+				std::lock_guard<std::recursive_mutex> appenderLock(mutex);
+				reportSyncFailure(status);
+				synced = false;
+			}
+			::close(fd);
+		}
+#endif
+
+		lock.lock();
+
+		// Events that may not be on the storage device are not counted as durable
+		auto& completedCount = synced ? durableCount : failedCount;
+		if (completedCount < count)
+		{
+			completedCount = count;
+		}
+
+		syncCompleted.notify_all();
+	}
+}
+
+void FileAppender::FileAppenderPriv::reportSyncFailure(log4cxx_status_t status)
+{
+	IOException e(status);
+	errorHandler->error(LOG4CXX_STR("Unable to synchronize a log file with the storage device"), e, ErrorCode::FLUSH_FAILURE);
+}
+
+void FileAppender::FileAppenderPriv::finishIdleFrame(Pool& p)
+{
+#if LOG4CXX_HAS_ZLIB
+	std::lock_guard<std::recursive_mutex> appenderLock(mutex);
+
+	try
+	{
+		// Completes the member only if it was started more than the interval ago
+		if (gzipStream)
+		{
+			gzipStream->flush(p);
+		}
+	}
+	catch (std::exception&)
+	{
+		LogLog::warn(LOG4CXX_STR("Unable to write to the log file"));
+	}
+#endif
+}
+
 
 /**
  * Replaces double backslashes (except the leading doubles of UNC's)
@@ -279,7 +958,8 @@ void FileAppender::setFileInternal(
 
 	bool writeBOM = false;
 
-	if (StringHelper::equalsIgnoreCase(getEncoding(),
+	// A byte order mark would precede the compressed data
+	if (!_priv->gzip && StringHelper::equalsIgnoreCase(getEncoding(),
 			LOG4CXX_STR("utf-16"), LOG4CXX_STR("UTF-16")))
 	{
 		//
@@ -340,7 +1020,8 @@ void FileAppender::setFileInternal(
 
 	WriterPtr newWriter(createWriter(outStream));
 
-	if (bufferedIO1)
+	// A drainable stream already buffers the output
+	if (bufferedIO1 && !_priv->drainStream)
 	{
 		newWriter = std::make_shared<BufferedWriter>(newWriter, bufferSize1);
 	}
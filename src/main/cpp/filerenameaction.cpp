@@ -18,6 +18,7 @@
 #include <log4cxx/logstring.h>
 #include <log4cxx/rolling/filerenameaction.h>
 #include <log4cxx/private/action_priv.h>
+#include <log4cxx/helpers/logfileindex.h>
 
 using namespace LOG4CXX_NS;
 using namespace LOG4CXX_NS::rolling;
@@ -48,5 +49,21 @@ FileRenameAction::FileRenameAction(const File& toRename,
 
 bool FileRenameAction::execute(LOG4CXX_NS::helpers::Pool& pool1) const
 {
-	return priv->source.renameTo(priv->destination, pool1);
+	if (!priv->source.renameTo(priv->destination, pool1))
+	{
+		return false;
+	}
+
+	// Keep the time index beside the log file it describes
+	File sourceIndex;
+	sourceIndex.setPath(LogFileIndex::getIndexFileName(priv->source.getPath()));
+
+	if (sourceIndex.exists(pool1))
+	{
+		File destinationIndex;
+		destinationIndex.setPath(LogFileIndex::getIndexFileName(priv->destination.getPath()));
+		sourceIndex.renameTo(destinationIndex, pool1);
+	}
+
+	return true;
 }
@@ -18,6 +18,7 @@
 #include <log4cxx/logstring.h>
 #include <log4cxx/spi/filter.h>
 #include <log4cxx/private/filter_priv.h>
+#include <algorithm>
 
 using namespace LOG4CXX_NS;
 using namespace LOG4CXX_NS::spi;
@@ -43,6 +44,7 @@ FilterPtr Filter::getNext() const
 void Filter::setNext(const FilterPtr& newNext)
 {
 	m_priv->next = newNext;
+	onFilterChange(*this);
 }
 
 void Filter::activateOptions(Pool&)
@@ -53,3 +55,27 @@ void Filter::setOption(const LogString&, const LogString&)
 {
 }
 
+void LOG4CXX_NS::spi::onFilterChange(Filter& filter)
+{
+	std::lock_guard<std::mutex> lock(filter.m_priv->ownersMutex);
+	for (auto& owner : filter.m_priv->owners)
+	{
+		if (auto generation = owner.lock())
+			generation->fetch_add(1, std::memory_order_acq_rel);
+	}
+}
+
+void LOG4CXX_NS::spi::addFilterOwner(Filter& filter, const FilterGenerationPtr& generation)
+{
+	std::lock_guard<std::mutex> lock(filter.m_priv->ownersMutex);
+	auto& owners = filter.m_priv->owners;
+	owners.erase(std::remove_if(owners.begin(), owners.end()
+		, [](const std::weak_ptr<FilterGeneration>& owner) { return owner.expired(); })
+		, owners.end());
+	for (auto& owner : owners)
+	{
+		if (owner.lock() == generation)
+			return;
+	}
+	owners.push_back(generation);
+}
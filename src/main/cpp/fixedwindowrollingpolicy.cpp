@@ -28,6 +28,17 @@
 #include <log4cxx/rolling/zipcompressaction.h>
 #include <log4cxx/pattern/integerpatternconverter.h>
 #include <log4cxx/private/rollingpolicybase_priv.h>
+#include <log4cxx/private/deferredaction.h>
+#include <log4cxx/helpers/fileinputstream.h>
+#include <log4cxx/helpers/fileoutputstream.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/threadutility.h>
+#include <log4cxx/helpers/logfileindex.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
 
 using namespace LOG4CXX_NS;
 using namespace LOG4CXX_NS::rolling;
@@ -48,8 +59,112 @@ struct FixedWindowRollingPolicy::FixedWindowRollingPolicyPrivate : public Rollin
 	int maxIndex;
 	bool explicitActiveFile;
 	bool throwIOExceptionOnForkFailure = true;
+
+	/**
+	 * Are archived files given increasing index values?
+	 */
+	bool monotonicIndex = false;
+
+	/**
+	 * The index of the oldest and newest files in a monotonic window.
+	 */
+	int firstIndex = 0;
+	int lastIndex = 0;
+
+	/**
+	 * The file holding firstIndex and lastIndex.
+	 */
+	LogString manifestFile;
+
+	/**
+	 * Work done by the background thread.
+	 */
+	std::vector<ActionPtr> pendingActions;
+	int purgedIndex = 0; // Files below this index have been deleted
+	int purgeLimit = 0; // Files below this index are to be deleted
+	int manifestFirst = 0;
+	int manifestLast = 0;
+	bool manifestChanged = false;
+	bool stopping = false;
+	std::mutex backgroundMutex;
+	std::condition_variable backgroundChanged;
+	std::thread backgroundThread;
 };
 
+namespace
+{
+
+// The length of the compression extension at the end of \c fileName
+size_t getCompressionSuffixLength(const LogString& fileName)
+{
+	if (StringHelper::endsWith(fileName, LOG4CXX_STR(".gz")))
+	{
+		return 3;
+	}
+	else if (StringHelper::endsWith(fileName, LOG4CXX_STR(".zip")))
+	{
+		return 4;
+	}
+	return 0;
+}
+
+// Load \c first and \c last from \c manifestFile if it exists
+bool readManifest(const LogString& manifestFile, int& first, int& last, Pool& p)
+{
+	if (!File().setPath(manifestFile).exists(p))
+	{
+		return false;
+	}
+
+	try
+	{
+		FileInputStream fis(manifestFile);
+		char data[64];
+		ByteBuffer buf(data, sizeof(data) - 1);
+		int count = fis.read(buf);
+
+		if (count <= 0)
+		{
+			return false;
+		}
+
+		data[count] = 0;
+		return 2 == sscanf(data, "%d %d", &first, &last);
+	}
+	catch (std::exception&)
+	{
+		LogLog::warn(LOG4CXX_STR("Unable to read ") + manifestFile);
+	}
+
+	return false;
+}
+
+// Replace the content of \c manifestFile with \c first and \c last
+void writeManifest(const LogString& manifestFile, int first, int last, Pool& p)
+{
+	char data[64];
+	int count = snprintf(data, sizeof(data), "%d %d\n", first, last);
+	LogString tempFile(manifestFile + LOG4CXX_STR(".tmp"));
+
+	try
+	{
+		{
+			FileOutputStream fos(tempFile, false);
+			ByteBuffer buf(data, count);
+			fos.write(buf, p);
+			fos.close(p);
+		}
+
+		File().setPath(tempFile).renameTo(File().setPath(manifestFile), p);
+	}
+	catch (std::exception&)
+	{
+		LogLog::warn(LOG4CXX_STR("Unable to write ") + manifestFile);
+	}
+}
+
+} // namespace
+
 IMPLEMENT_LOG4CXX_OBJECT(FixedWindowRollingPolicy)
 
 FixedWindowRollingPolicy::FixedWindowRollingPolicy() :
@@ -57,7 +172,18 @@ FixedWindowRollingPolicy::FixedWindowRollingPolicy() :
 {
 }
 
-FixedWindowRollingPolicy::~FixedWindowRollingPolicy(){}
+FixedWindowRollingPolicy::~FixedWindowRollingPolicy()
+{
+	if (priv->backgroundThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(priv->backgroundMutex);
+			priv->stopping = true;
+		}
+		priv->backgroundChanged.notify_all();
+		priv->backgroundThread.join();
+	}
+}
 
 void FixedWindowRollingPolicy::setMaxIndex(int maxIndex1)
 {
@@ -69,6 +195,16 @@ void FixedWindowRollingPolicy::setMinIndex(int minIndex1)
 	priv->minIndex = minIndex1;
 }
 
+bool FixedWindowRollingPolicy::getMonotonicIndex() const
+{
+	return priv->monotonicIndex;
+}
+
+void FixedWindowRollingPolicy::setMonotonicIndex(bool newValue)
+{
+	priv->monotonicIndex = newValue;
+}
+
 void FixedWindowRollingPolicy::setOption(const LogString& option,
 	const LogString& value)
 {
@@ -84,6 +220,12 @@ void FixedWindowRollingPolicy::setOption(const LogString& option,
 	{
 		priv->maxIndex = OptionConverter::toInt(value, 7);
 	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXX_STR("MONOTONICINDEX"),
+			LOG4CXX_STR("monotonicindex")))
+	{
+		priv->monotonicIndex = OptionConverter::toBoolean(value, false);
+	}
 	else if (StringHelper::equalsIgnoreCase(option,
 			LOG4CXX_STR("THROWIOEXCEPTIONONFORKFAILURE"),
 			LOG4CXX_STR("throwioexceptiononforkfailure")))
@@ -110,7 +252,7 @@ void FixedWindowRollingPolicy::activateOptions(Pool& p)
 		priv->maxIndex = priv->minIndex;
 	}
 
-	if ((priv->maxIndex - priv->minIndex) > MAX_WINDOW_SIZE)
+	if (!priv->monotonicIndex && (priv->maxIndex - priv->minIndex) > MAX_WINDOW_SIZE)
 	{
 		LogLog::warn(LOG4CXX_STR("Large window sizes are not allowed."));
 		priv->maxIndex = priv->minIndex + MAX_WINDOW_SIZE;
@@ -141,6 +283,11 @@ RolloverDescriptionPtr FixedWindowRollingPolicy::initialize(
 		newActiveFile = currentActiveFile;
 	}
 
+	if (priv->monotonicIndex)
+	{
+		return initializeMonotonic(currentActiveFile, append, pool);
+	}
+
 	if (!priv->explicitActiveFile)
 	{
 		LogString buf;
@@ -169,6 +316,11 @@ RolloverDescriptionPtr FixedWindowRollingPolicy::rollover(
 		return desc;
 	}
 
+	if (priv->monotonicIndex)
+	{
+		return rolloverMonotonic(currentActiveFile, append, pool);
+	}
+
 	int purgeStart = priv->minIndex;
 
 	if (!priv->explicitActiveFile)
@@ -291,6 +443,7 @@ bool FixedWindowRollingPolicy::purge(int lowIndex, int highIndex, Pool& p) const
 				if (toRenameBase.exists(p))
 				{
 					toRenameBase.deleteFile(p);
+					LogFileIndex::deleteIndexFile(toRenameBase.getPath(), p);
 				}
 			}
 			else
@@ -314,6 +467,7 @@ bool FixedWindowRollingPolicy::purge(int lowIndex, int highIndex, Pool& p) const
 					return false;
 				}
 
+				LogFileIndex::deleteIndexFile(toRename->getPath(), p);
 				break;
 			}
 
@@ -368,6 +522,281 @@ bool FixedWindowRollingPolicy::purge(int lowIndex, int highIndex, Pool& p) const
 	return true;
 }
 
+/**
+ * Continue the numbering of an existing monotonic window.
+ */
+RolloverDescriptionPtr FixedWindowRollingPolicy::initializeMonotonic(
+	const LogString& currentActiveFile,
+	bool             append,
+	Pool&            p)
+{
+	LogString newActiveFile(currentActiveFile);
+
+	if (priv->explicitActiveFile)
+	{
+		priv->manifestFile = currentActiveFile + LOG4CXX_STR(".manifest");
+	}
+	else
+	{
+		LogString minFile(getIndexFileName(priv->minIndex, p));
+		minFile.resize(minFile.size() - getCompressionSuffixLength(minFile));
+		priv->manifestFile = minFile + LOG4CXX_STR(".manifest");
+	}
+
+	int first = priv->minIndex;
+	int last = priv->minIndex - 1;
+
+	if (!readManifest(priv->manifestFile, first, last, p) || last < first - 1)
+	{
+		first = priv->minIndex;
+		last = priv->minIndex - 1;
+	}
+
+	// The manifest may not include the last rollover before a crash
+	while (indexFileExists(last + 1, p))
+	{
+		++last;
+	}
+
+	if (!priv->explicitActiveFile)
+	{
+		if (last < first)
+		{
+			last = first;
+		}
+
+		newActiveFile = getIndexFileName(last, p);
+		newActiveFile.resize(newActiveFile.size() - getCompressionSuffixLength(newActiveFile));
+	}
+
+	priv->lastIndex = last;
+	priv->firstIndex = first;
+	int windowSize = priv->maxIndex - priv->minIndex + 1;
+
+	if (windowSize < last - first + 1)
+	{
+		priv->firstIndex = last - windowSize + 1;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(priv->backgroundMutex);
+		priv->purgedIndex = first;
+	}
+	queueBackgroundWork(ActionPtr(), priv->firstIndex, priv->lastIndex);
+
+	ActionPtr noAction;
+
+	return std::make_shared<RolloverDescription>(newActiveFile, append, noAction, noAction);
+}
+
+/**
+ * Start the next file of a monotonic window.
+ */
+RolloverDescriptionPtr FixedWindowRollingPolicy::rolloverMonotonic(
+	const LogString& currentActiveFile,
+	bool             append,
+	Pool&            p)
+{
+	int index = priv->lastIndex + 1;
+	LogString compressedName(getIndexFileName(index, p));
+	LogString renameTo(compressedName);
+	size_t suffixLength = getCompressionSuffixLength(compressedName);
+	renameTo.resize(renameTo.size() - suffixLength);
+
+	if (getCreateIntermediateDirectories())
+	{
+		File compressedFile(compressedName);
+		File compressedParent (compressedFile.getParent(p));
+		compressedParent.mkdirs(p);
+	}
+
+	LogString newActiveFile(currentActiveFile);
+	ActionPtr renameAction;
+
+	if (priv->explicitActiveFile)
+	{
+		renameAction = std::make_shared<FileRenameAction>(
+				File().setPath(currentActiveFile),
+				File().setPath(renameTo),
+				false);
+	}
+	else
+	{
+		// Logging continues in a new file, so the current file is the one to compress
+		newActiveFile = renameTo;
+		renameTo = currentActiveFile;
+		compressedName = currentActiveFile + compressedName.substr(compressedName.size() - suffixLength);
+	}
+
+	ActionPtr compressAction;
+
+	if (3 == suffixLength)
+	{
+		GZCompressActionPtr comp = std::make_shared<GZCompressAction>(
+					File().setPath(renameTo),
+					File().setPath(compressedName),
+					true);
+		comp->setThrowIOExceptionOnForkFailure(priv->throwIOExceptionOnForkFailure);
+		compressAction = comp;
+	}
+	else if (4 == suffixLength)
+	{
+		ZipCompressActionPtr comp = std::make_shared<ZipCompressAction>(
+					File().setPath(renameTo),
+					File().setPath(compressedName),
+					true);
+		comp->setThrowIOExceptionOnForkFailure(priv->throwIOExceptionOnForkFailure);
+		compressAction = comp;
+	}
+
+	priv->lastIndex = index;
+	int windowSize = priv->maxIndex - priv->minIndex + 1;
+
+	if (windowSize < priv->lastIndex - priv->firstIndex + 1)
+	{
+		priv->firstIndex = priv->lastIndex - windowSize + 1;
+	}
+
+	// Compression, deletion and the manifest update are done after the appender releases its lock.
+	// The window is copied as the action may run after the next rollover has changed it.
+	int firstIndex = priv->firstIndex;
+	int lastIndex = priv->lastIndex;
+	ActionPtr backgroundAction = std::make_shared<DeferredAction>([this, compressAction, firstIndex, lastIndex]()
+		{
+			queueBackgroundWork(compressAction, firstIndex, lastIndex);
+		});
+
+	return std::make_shared<RolloverDescription>(
+				newActiveFile, append,
+				renameAction, backgroundAction);
+}
+
+/**
+ * The name of the archive file for \c index.
+ */
+LogString FixedWindowRollingPolicy::getIndexFileName(int index, Pool& p) const
+{
+	LogString result;
+	ObjectPtr obj = std::make_shared<Integer>(index);
+	formatFileName(obj, result, p);
+	return result;
+}
+
+/**
+ * Does a compressed or uncompressed archive file exist for \c index?
+ */
+bool FixedWindowRollingPolicy::indexFileExists(int index, Pool& p) const
+{
+	LogString fileName(getIndexFileName(index, p));
+
+	if (File().setPath(fileName).exists(p))
+	{
+		return true;
+	}
+
+	size_t suffixLength = getCompressionSuffixLength(fileName);
+	return 0 < suffixLength
+		&& File().setPath(fileName.substr(0, fileName.size() - suffixLength)).exists(p);
+}
+
+/**
+ * Pass \c compressAction and the window from \c firstIndex to \c lastIndex to the background thread.
+ */
+void FixedWindowRollingPolicy::queueBackgroundWork(const ActionPtr& compressAction, int firstIndex, int lastIndex)
+{
+	std::lock_guard<std::mutex> lock(priv->backgroundMutex);
+
+	if (compressAction)
+	{
+		priv->pendingActions.push_back(compressAction);
+	}
+
+	priv->purgeLimit = firstIndex;
+	priv->manifestFirst = firstIndex;
+	priv->manifestLast = lastIndex;
+	priv->manifestChanged = true;
+
+	if (!priv->backgroundThread.joinable())
+	{
+		priv->backgroundThread = ThreadUtility::instance()->createThread(
+			LOG4CXX_STR("FixedWindowPurge"), &FixedWindowRollingPolicy::runBackgroundWork, this);
+	}
+
+	priv->backgroundChanged.notify_all();
+}
+
+/**
+ * Compress new archives, delete those outside the window and update the manifest
+ * until the policy is destroyed.
+ */
+void FixedWindowRollingPolicy::runBackgroundWork()
+{
+	Pool p;
+	std::unique_lock<std::mutex> lock(priv->backgroundMutex);
+
+	for (;;)
+	{
+		auto hasWork = [this]()
+		{
+			return !priv->pendingActions.empty()
+				|| priv->purgedIndex < priv->purgeLimit
+				|| priv->manifestChanged;
+		};
+		priv->backgroundChanged.wait(lock, [this, &hasWork]() { return priv->stopping || hasWork(); });
+
+		if (!hasWork())
+		{
+			break;
+		}
+
+		std::vector<ActionPtr> actions;
+		actions.swap(priv->pendingActions);
+		int purgeStart = priv->purgedIndex;
+		int purgeEnd = priv->purgeLimit;
+		priv->purgedIndex = std::max(purgeStart, purgeEnd);
+		bool manifestChanged = priv->manifestChanged;
+		priv->manifestChanged = false;
+		int first = priv->manifestFirst;
+		int last = priv->manifestLast;
+		lock.unlock();
+
+		for (auto& action : actions)
+		{
+			try
+			{
+				action->execute(p);
+			}
+			catch (std::exception& ex)
+			{
+				LOG4CXX_DECODE_CHAR(lsMsg, ex.what());
+				LogLog::warn(LOG4CXX_STR("Exception during rollover: ") + lsMsg);
+			}
+		}
+
+		for (int index = purgeStart; index < purgeEnd; ++index)
+		{
+			LogString fileName(getIndexFileName(index, p));
+			File().setPath(fileName).deleteFile(p);
+			size_t suffixLength = getCompressionSuffixLength(fileName);
+
+			if (0 < suffixLength)
+			{
+				fileName.resize(fileName.size() - suffixLength);
+				File().setPath(fileName).deleteFile(p);
+			}
+
+			LogFileIndex::deleteIndexFile(fileName, p);
+		}
+
+		if (manifestChanged)
+		{
+			writeManifest(priv->manifestFile, first, last, p);
+		}
+
+		lock.lock();
+	}
+}
+
 #define RULES_PUT(spec, cls) \
 	specs.insert(PatternMap::value_type(LogString(LOG4CXX_STR(spec)), (PatternConstructor) cls ::newInstance))
 
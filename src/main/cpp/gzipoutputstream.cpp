@@ -0,0 +1,186 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/private/gzipoutputstream.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/exception.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <zlib.h>
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::helpers;
+
+struct GZipOutputStream::GZipOutputStreamPrivate
+{
+	GZipOutputStreamPrivate(const OutputStreamPtr& os1, size_t frameSize1, std::chrono::milliseconds interval1)
+		: os(os1)
+		, frameSize(std::max(frameSize1, size_t(1)))
+		, interval(interval1)
+		, buffer(64 * 1024)
+	{
+		std::memset(&zs, 0, sizeof(zs));
+	}
+
+	/**
+	 * Compressed data is written to this stream.
+	 */
+	OutputStreamPtr os;
+
+	/**
+	 * The uncompressed size at which a member is completed.
+	 */
+	size_t frameSize;
+
+	/**
+	 * The maximum age of an incomplete member when data is written or flushed.
+	 */
+	std::chrono::milliseconds interval;
+
+	z_stream zs;
+	bool initialized = false;
+
+	/**
+	 * Has data been added to the current member?
+	 */
+	bool frameStarted = false;
+	size_t frameInput = 0;
+	std::chrono::steady_clock::time_point frameStart;
+
+	std::vector<char> buffer;
+
+	/**
+	 * Pass \c size bytes at \c data to the compressor
+	 * and write the output it produces.
+	 */
+	void deflateData(const char* data, size_t size, int mode, Pool& p)
+	{
+		zs.next_in = (Bytef*) data;
+		zs.avail_in = (uInt) size;
+		int result;
+
+		do
+		{
+			zs.next_out = (Bytef*) buffer.data();
+			zs.avail_out = (uInt) buffer.size();
+			result = deflate(&zs, mode);
+
+			if (result == Z_STREAM_ERROR)
+			{
+				throw IOException(LOG4CXX_STR("deflate failed"));
+			}
+
+			size_t have = buffer.size() - zs.avail_out;
+
+			if (0 < have)
+			{
+				ByteBuffer out(buffer.data(), have);
+				os->write(out, p);
+			}
+		}
+		while (zs.avail_out == 0 || (mode == Z_FINISH && result != Z_STREAM_END));
+	}
+};
+
+GZipOutputStream::GZipOutputStream(const OutputStreamPtr& os, size_t frameSize, std::chrono::milliseconds interval)
+	: m_priv(std::make_unique<GZipOutputStreamPrivate>(os, frameSize, interval))
+{
+	// A window size of 15 plus 16 selects the gzip format
+	if (Z_OK != deflateInit2(&m_priv->zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY))
+	{
+		throw IOException(LOG4CXX_STR("Unable to initialize the gzip compressor"));
+	}
+
+	m_priv->initialized = true;
+}
+
+GZipOutputStream::~GZipOutputStream()
+{
+	if (m_priv->initialized)
+	{
+		deflateEnd(&m_priv->zs);
+	}
+}
+
+void GZipOutputStream::write(ByteBuffer& buf, Pool& p)
+{
+	if (!m_priv->initialized)
+	{
+		throw IOException(LOG4CXX_STR("Write to a closed gzip stream"));
+	}
+
+	auto now = std::chrono::steady_clock::now();
+
+	if (!m_priv->frameStarted)
+	{
+		m_priv->frameStarted = true;
+		m_priv->frameStart = now;
+	}
+
+	// Limit each call to the capacity of the compressor's input counter
+	while (0 < buf.remaining())
+	{
+		size_t size = std::min(buf.remaining(), size_t(1024 * 1024 * 1024));
+		m_priv->deflateData(buf.current(), size, Z_NO_FLUSH, p);
+		m_priv->frameInput += size;
+		buf.position(buf.position() + size);
+	}
+
+	if (m_priv->frameSize <= m_priv->frameInput
+		|| m_priv->interval <= now - m_priv->frameStart)
+	{
+		finishFrame(p);
+	}
+}
+
+void GZipOutputStream::flush(Pool& p)
+{
+	if (m_priv->frameStarted
+		&& m_priv->interval <= std::chrono::steady_clock::now() - m_priv->frameStart)
+	{
+		finishFrame(p);
+	}
+}
+
+void GZipOutputStream::finishFrame(Pool& p)
+{
+	if (!m_priv->initialized || !m_priv->frameStarted)
+	{
+		return;
+	}
+
+	m_priv->deflateData(nullptr, 0, Z_FINISH, p);
+	deflateReset(&m_priv->zs);
+	m_priv->frameStarted = false;
+	m_priv->frameInput = 0;
+	m_priv->os->flush(p);
+}
+
+void GZipOutputStream::close(Pool& p)
+{
+	if (m_priv->initialized)
+	{
+		finishFrame(p);
+		deflateEnd(&m_priv->zs);
+		m_priv->initialized = false;
+	}
+
+	m_priv->os->close(p);
+}
@@ -0,0 +1,137 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/private/hazardpointer.h>
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::helpers;
+
+struct alignas(64) HazardPointer::Slot
+{
+	std::atomic<const void*> object{nullptr};
+	std::atomic<bool> owned{false};
+	Slot* next{nullptr};
+};
+
+namespace
+{
+using Slot = HazardPointer::Slot;
+
+// The slots of all threads. Slots are reused when a thread ends and are never deleted.
+class SlotList
+{
+	public:
+		static SlotList& instance()
+		{
+			// Not destroyed, so it remains usable while other static objects are destroyed
+			static SlotList* const result = new SlotList;
+			return *result;
+		}
+
+		Slot* acquire()
+		{
+			for (auto slot = m_head.load(std::memory_order_acquire); slot; slot = slot->next)
+			{
+				bool owned = false;
+				if (!slot->owned.load(std::memory_order_relaxed)
+					&& slot->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+					return slot;
+			}
+			auto slot = new Slot;
+			slot->owned.store(true, std::memory_order_relaxed);
+			slot->next = m_head.load(std::memory_order_relaxed);
+			while (!m_head.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed))
+				;
+			return slot;
+		}
+
+		void release(Slot* slot)
+		{
+			slot->object.store(nullptr, std::memory_order_relaxed);
+			slot->owned.store(false, std::memory_order_release);
+		}
+
+		bool isInUse(const void* object) const
+		{
+			for (auto slot = m_head.load(std::memory_order_acquire); slot; slot = slot->next)
+			{
+				if (slot->object.load(std::memory_order_seq_cst) == object)
+					return true;
+			}
+			return false;
+		}
+
+	private:
+		std::atomic<Slot*> m_head{nullptr};
+};
+
+// The slots of the current thread, one for each level of nesting
+struct ThreadSlots
+{
+	static const int MaxDepth = 8;
+	Slot* slots[MaxDepth] = {};
+	int depth = 0;
+
+	~ThreadSlots()
+	{
+		for (auto slot : slots)
+		{
+			if (slot)
+				SlotList::instance().release(slot);
+		}
+	}
+
+	static ThreadSlots& current()
+	{
+		thread_local ThreadSlots result;
+		return result;
+	}
+};
+} // namespace
+
+HazardPointer::HazardPointer()
+	: m_slot(nullptr)
+{
+	auto& threadSlots = ThreadSlots::current();
+	if (threadSlots.depth < ThreadSlots::MaxDepth)
+	{
+		auto& slot = threadSlots.slots[threadSlots.depth];
+		if (!slot)
+			slot = SlotList::instance().acquire();
+		m_slot = slot;
+		++threadSlots.depth;
+	}
+}
+
+HazardPointer::~HazardPointer()
+{
+	if (m_slot)
+	{
+		m_slot->object.store(nullptr, std::memory_order_release);
+		--ThreadSlots::current().depth;
+	}
+}
+
+void HazardPointer::announce(const void* object)
+{
+	m_slot->object.store(object, std::memory_order_seq_cst);
+}
+
+bool HazardPointer::isInUse(const void* object)
+{
+	return SlotList::instance().isInUse(object);
+}
@@ -31,6 +31,7 @@
 	#define LOG4CXX 1
 #endif
 #include <log4cxx/spi/rootlogger.h>
+#include <log4cxx/spi/callsite.h>
 #include <mutex>
 #include "assert.h"
 
@@ -123,6 +124,7 @@ void Hierarchy::clear()
 {
 	std::lock_guard<std::recursive_mutex> lock(m_priv->mutex);
 	m_priv->loggers.clear();
+	CallSite::invalidateAll();
 }
 
 void Hierarchy::emitNoAppenderWarning(const Logger* logger)
@@ -188,6 +190,7 @@ void Hierarchy::setThresholdInternal(const LevelPtr& l)
 {
 	m_priv->thresholdInt = l->toInt();
 	m_priv->threshold = l;
+	CallSite::invalidateAll();
 
 	if (m_priv->thresholdInt != Level::ALL_INT)
 	{
@@ -198,6 +201,7 @@ void Hierarchy::setThresholdInternal(const LevelPtr& l)
 void Hierarchy::fireAddAppenderEvent(const Logger* logger, const Appender* appender)
 {
 	setConfigured(true);
+	CallSite::invalidateAll();
 	HierarchyEventListenerList clonedList;
 	{
 		std::lock_guard<std::recursive_mutex> lock(m_priv->mutex);
@@ -211,6 +215,7 @@ void Hierarchy::fireAddAppenderEvent(const Logger* logger, const Appender* appen
 void Hierarchy::fireRemoveAppenderEvent(const Logger* logger, const Appender* appender)
 
 {
+	CallSite::invalidateAll();
 	HierarchyEventListenerList clonedList;
 	{
 		std::lock_guard<std::recursive_mutex> lock(m_priv->mutex);
@@ -496,6 +501,7 @@ bool Hierarchy::removeLogger(const LogString& name, bool ifNotUsed)
 			}
 		}
 		m_priv->loggers.erase(it);
+		CallSite::invalidateAll();
 		result = true;
 	}
 	return result;
@@ -30,52 +30,59 @@ using namespace LOG4CXX_NS::helpers;
 
 IMPLEMENT_LOG4CXX_OBJECT_WITH_CUSTOM_CLASS(Level, LevelClass)
 
+LevelPtr Level::makePermanent(Level* level)
+{
+	// Share ownership with an empty pointer so that no control block is allocated
+	// and copies of the result do not update a reference count.
+	return LevelPtr(LevelPtr(), level);
+}
+
 LevelPtr Level::getOff()
 {
-	static WideLife<LevelPtr> offLevel = std::make_shared<Level>(Level::OFF_INT, LOG4CXX_STR("OFF"), 0);
+	static WideLife<LevelPtr> offLevel = makePermanent(new Level(Level::OFF_INT, LOG4CXX_STR("OFF"), 0));
 	return offLevel;
 }
 
 LevelPtr Level::getFatal()
 {
-	static WideLife<LevelPtr> fatalLevel = std::make_shared<Level>(Level::FATAL_INT, LOG4CXX_STR("FATAL"), 0);
+	static WideLife<LevelPtr> fatalLevel = makePermanent(new Level(Level::FATAL_INT, LOG4CXX_STR("FATAL"), 0));
 	return fatalLevel;
 }
 
 LevelPtr Level::getError()
 {
-	static WideLife<LevelPtr> errorLevel = std::make_shared<Level>(Level::ERROR_INT, LOG4CXX_STR("ERROR"), 3);
+	static WideLife<LevelPtr> errorLevel = makePermanent(new Level(Level::ERROR_INT, LOG4CXX_STR("ERROR"), 3));
 	return errorLevel;
 }
 
 LevelPtr Level::getWarn()
 {
-	static WideLife<LevelPtr> warnLevel = std::make_shared<Level>(Level::WARN_INT, LOG4CXX_STR("WARN"), 4);
+	static WideLife<LevelPtr> warnLevel = makePermanent(new Level(Level::WARN_INT, LOG4CXX_STR("WARN"), 4));
 	return warnLevel;
 }
 
 LevelPtr Level::getInfo()
 {
-	static WideLife<LevelPtr> infoLevel = std::make_shared<Level>(Level::INFO_INT, LOG4CXX_STR("INFO"), 6);
+	static WideLife<LevelPtr> infoLevel = makePermanent(new Level(Level::INFO_INT, LOG4CXX_STR("INFO"), 6));
 	return infoLevel;
 }
 
 LevelPtr Level::getDebug()
 {
-	static WideLife<LevelPtr> debugLevel = std::make_shared<Level>(Level::DEBUG_INT, LOG4CXX_STR("DEBUG"), 7);
+	static WideLife<LevelPtr> debugLevel = makePermanent(new Level(Level::DEBUG_INT, LOG4CXX_STR("DEBUG"), 7));
 	return debugLevel;
 }
 
 LevelPtr Level::getTrace()
 {
-	static WideLife<LevelPtr> traceLevel = std::make_shared<Level>(Level::TRACE_INT, LOG4CXX_STR("TRACE"), 7);
+	static WideLife<LevelPtr> traceLevel = makePermanent(new Level(Level::TRACE_INT, LOG4CXX_STR("TRACE"), 7));
 	return traceLevel;
 }
 
 
 LevelPtr Level::getAll()
 {
-	static WideLife<LevelPtr> allLevel = std::make_shared<Level>(Level::ALL_INT, LOG4CXX_STR("ALL"), 7);
+	static WideLife<LevelPtr> allLevel = makePermanent(new Level(Level::ALL_INT, LOG4CXX_STR("ALL"), 7));
 	return allLevel;
 }
 
@@ -60,12 +60,14 @@ void LevelMatchFilter::setOption(const LogString& option,
 			LOG4CXX_STR("ACCEPTONMATCH"), LOG4CXX_STR("acceptonmatch")))
 	{
 		priv->acceptOnMatch = OptionConverter::toBoolean(value, priv->acceptOnMatch);
+		onFilterChange(*this);
 	}
 }
 
 void LevelMatchFilter::setLevelToMatch(const LogString& levelToMatch1)
 {
 	priv->levelToMatch = OptionConverter::toLevel(levelToMatch1, priv->levelToMatch);
+	onFilterChange(*this);
 }
 
 LogString LevelMatchFilter::getLevelToMatch() const
@@ -96,6 +98,7 @@ Filter::FilterDecision LevelMatchFilter::decide(
 void LevelMatchFilter::setAcceptOnMatch(bool acceptOnMatch1)
 {
 	priv->acceptOnMatch = acceptOnMatch1;
+	onFilterChange(*this);
 }
 
 bool LevelMatchFilter::getAcceptOnMatch() const
@@ -61,16 +61,19 @@ void LevelRangeFilter::setOption(const LogString& option,
 			LOG4CXX_STR("LEVELMIN"), LOG4CXX_STR("levelmin")))
 	{
 		priv->levelMin = OptionConverter::toLevel(value, priv->levelMin);
+		onFilterChange(*this);
 	}
 	else if (StringHelper::equalsIgnoreCase(option,
 			LOG4CXX_STR("LEVELMAX"), LOG4CXX_STR("levelmax")))
 	{
 		priv->levelMax = OptionConverter::toLevel(value, priv->levelMax);
+		onFilterChange(*this);
 	}
 	else if (StringHelper::equalsIgnoreCase(option,
 			LOG4CXX_STR("ACCEPTONMATCH"), LOG4CXX_STR("acceptonmatch")))
 	{
 		priv->acceptOnMatch = OptionConverter::toBoolean(value, priv->acceptOnMatch);
+		onFilterChange(*this);
 	}
 }
 
@@ -108,6 +111,7 @@ Filter::FilterDecision LevelRangeFilter::decide(
 void LevelRangeFilter::setLevelMin(const LevelPtr& levelMin1)
 {
 	priv->levelMin = levelMin1;
+	onFilterChange(*this);
 }
 
 const LevelPtr& LevelRangeFilter::getLevelMin() const
@@ -118,6 +122,7 @@ const LevelPtr& LevelRangeFilter::getLevelMin() const
 void LevelRangeFilter::setLevelMax(const LevelPtr& levelMax1)
 {
 	priv->levelMax = levelMax1;
+	onFilterChange(*this);
 }
 
 const LevelPtr& LevelRangeFilter::getLevelMax() const
@@ -128,6 +133,7 @@ const LevelPtr& LevelRangeFilter::getLevelMax() const
 void LevelRangeFilter::setAcceptOnMatch(bool acceptOnMatch1)
 {
 	priv->acceptOnMatch = acceptOnMatch1;
+	onFilterChange(*this);
 }
 
 bool LevelRangeFilter::getAcceptOnMatch() const
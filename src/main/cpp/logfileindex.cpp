@@ -0,0 +1,204 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/logfileindex.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/file.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::helpers;
+
+namespace
+{
+
+void putUInt64(char* dest, uint64_t value)
+{
+	for (int i = 0; i < 8; ++i)
+		dest[i] = char((value >> (8 * i)) & 0xFF);
+}
+
+void putUInt32(char* dest, uint32_t value)
+{
+	for (int i = 0; i < 4; ++i)
+		dest[i] = char((value >> (8 * i)) & 0xFF);
+}
+
+uint64_t getUInt64(const char* src)
+{
+	uint64_t result = 0;
+	for (int i = 7; 0 <= i; --i)
+		result = (result << 8) | (unsigned char)src[i];
+	return result;
+}
+
+uint32_t getUInt32(const char* src)
+{
+	uint32_t result = 0;
+	for (int i = 3; 0 <= i; --i)
+		result = (result << 8) | (unsigned char)src[i];
+	return result;
+}
+
+// Add [begin, end) to \c ranges, merging it with the last range if they meet
+void addRange(std::vector<LogFileIndex::Range>& ranges, uint64_t begin, uint64_t end)
+{
+	if (end <= begin)
+		return;
+	if (!ranges.empty() && begin <= ranges.back().second)
+		ranges.back().second = std::max(ranges.back().second, end);
+	else
+		ranges.push_back(LogFileIndex::Range(begin, end));
+}
+
+} // namespace
+
+LogString LogFileIndex::getIndexFileName(const LogString& logFileName)
+{
+	return logFileName + LOG4CXX_STR(".idx");
+}
+
+void LogFileIndex::deleteIndexFile(const LogString& logFileName, Pool& p)
+{
+	File indexFile;
+	indexFile.setPath(getIndexFileName(logFileName));
+
+	if (indexFile.exists(p))
+	{
+		indexFile.deleteFile(p);
+	}
+}
+
+uint32_t LogFileIndex::getLevelBit(const LevelPtr& level)
+{
+	// TRACE, DEBUG, INFO, WARN, ERROR and FATAL use bits 0 to 5
+	int value = level ? level->toInt() : Level::ALL_INT;
+	int index = value <= Level::TRACE_INT ? 0 : std::min(value / Level::DEBUG_INT, 31);
+	return uint32_t(1) << index;
+}
+
+uint32_t LogFileIndex::getLevelMask(const LevelPtr& threshold)
+{
+	uint32_t bit = getLevelBit(threshold);
+	return ~(bit - 1);
+}
+
+uint64_t LogFileIndex::getLoggerBits(const LogString& loggerName)
+{
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ULL;
+	for (auto ch : loggerName)
+	{
+		hash ^= uint64_t(ch);
+		hash *= 1099511628211ULL;
+	}
+	return (uint64_t(1) << (hash & 63)) | (uint64_t(1) << ((hash >> 6) & 63));
+}
+
+const char* LogFileIndex::getHeader()
+{
+	return "L4CXIDX1";
+}
+
+void LogFileIndex::encode(const Entry& entry, char* dest)
+{
+	putUInt64(dest, entry.offset);
+	putUInt64(dest + 8, entry.length);
+	putUInt64(dest + 16, uint64_t(entry.minimumTime));
+	putUInt64(dest + 24, uint64_t(entry.maximumTime));
+	putUInt64(dest + 32, entry.loggers);
+	putUInt32(dest + 40, entry.levels);
+	putUInt32(dest + 44, entry.eventCount);
+}
+
+void LogFileIndex::decode(const char* src, Entry& entry)
+{
+	entry.offset = getUInt64(src);
+	entry.length = getUInt64(src + 8);
+	entry.minimumTime = log4cxx_time_t(getUInt64(src + 16));
+	entry.maximumTime = log4cxx_time_t(getUInt64(src + 24));
+	entry.loggers = getUInt64(src + 32);
+	entry.levels = getUInt32(src + 40);
+	entry.eventCount = getUInt32(src + 44);
+}
+
+std::vector<LogFileIndex::Entry> LogFileIndex::read(const LogString& indexFileName, Pool&)
+{
+	LOG4CXX_ENCODE_CHAR(fileName, indexFileName);
+	std::ifstream input(fileName.c_str(), std::ios::binary);
+	char header[HeaderSize];
+
+	if (!input.read(header, HeaderSize) || 0 != std::memcmp(header, getHeader(), HeaderSize))
+	{
+		throw IOException(indexFileName + LOG4CXX_STR(" is not a log file index"));
+	}
+
+	std::vector<Entry> result;
+	char data[EntrySize];
+
+	while (input.read(data, EntrySize))
+	{
+		Entry entry;
+		decode(data, entry);
+		result.push_back(entry);
+	}
+
+	return result;
+}
+
+std::vector<LogFileIndex::Range> LogFileIndex::findRanges
+	( const std::vector<Entry>& entries
+	, log4cxx_time_t from
+	, log4cxx_time_t to
+	, uint32_t levelMask
+	, const LogString& loggerName
+	)
+{
+	std::vector<Entry> sorted(entries);
+	std::sort(sorted.begin(), sorted.end(), [](const Entry& lhs, const Entry& rhs)
+	{
+		return lhs.offset < rhs.offset;
+	});
+	uint64_t loggerBits = loggerName.empty() ? 0 : getLoggerBits(loggerName);
+	std::vector<Range> result;
+	uint64_t coveredEnd = 0;
+
+	for (auto& entry : sorted)
+	{
+		// Bytes not described by an entry may hold anything
+		addRange(result, coveredEnd, entry.offset);
+
+		if (from <= entry.maximumTime
+			&& entry.minimumTime <= to
+			&& 0 != (entry.levels & levelMask)
+			&& (entry.loggers & loggerBits) == loggerBits)
+		{
+			addRange(result, entry.offset, entry.offset + entry.length);
+		}
+
+		coveredEnd = std::max(coveredEnd, entry.offset + entry.length);
+	}
+
+	addRange(result, coveredEnd, UINT64_MAX);
+	return result;
+}
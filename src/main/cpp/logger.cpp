@@ -28,6 +28,8 @@
 #include <log4cxx/helpers/transcoder.h>
 #include <log4cxx/helpers/appenderattachableimpl.h>
 #include <log4cxx/helpers/exception.h>
+#include <algorithm>
+#include <unordered_set>
 #if !defined(LOG4CXX)
 	#define LOG4CXX 1
 #endif
@@ -112,17 +114,52 @@ void Logger::reconfigure( const std::vector<AppenderPtr>& appenders, bool additi
 {
 	m_priv->additive = additive1;
 
-	m_priv->aai.removeAllAppenders();
+	if (m_priv->aai.getAllAppenders() == appenders)
+		return;
 
-	for (auto const& item : appenders)
+	auto previous = m_priv->aai.replaceAppenders(appenders);
+	auto rep = getHierarchy();
+	AppenderList removed;
+	for (auto const& item : previous)
 	{
-		m_priv->aai.addAppender(item);
+		if (std::find(appenders.begin(), appenders.end(), item) == appenders.end())
+			removed.push_back(item);
+	}
 
-		if (auto rep = getHierarchy())
+	// Removed appenders that another logger still uses, found in one pass over the hierarchy
+	std::unordered_set<const Appender*> attachedElsewhere;
+	if (rep && !removed.empty())
+	{
+		auto loggers = rep->getCurrentLoggers();
+		loggers.push_back(rep->getRootLogger());
+		for (auto& logger : loggers)
 		{
-			rep->fireAddAppenderEvent(this, item.get());
+			if (logger.get() == this)
+				continue;
+			for (auto& item : logger->getAllAppenders())
+			{
+				if (std::find(removed.begin(), removed.end(), item) != removed.end())
+					attachedElsewhere.insert(item.get());
+			}
 		}
 	}
+
+	// Unlike removeAllAppenders, only an appender that is no longer used is closed
+	for (auto const& item : removed)
+	{
+		if (rep)
+			rep->fireRemoveAppenderEvent(this, item.get());
+		if (attachedElsewhere.find(item.get()) == attachedElsewhere.end())
+			item->close();
+	}
+
+	for (auto const& item : appenders)
+	{
+		if (!item || std::find(previous.begin(), previous.end(), item) != previous.end())
+			continue;
+		if (rep)
+			rep->fireAddAppenderEvent(this, item.get());
+	}
 }
 
 void Logger::callAppenders(const spi::LoggingEventPtr& event, Pool& p) const
@@ -547,6 +584,7 @@ void Logger::removeAppender(const LogString& name1)
 void Logger::removeHierarchy()
 {
 	m_priv->repositoryRaw = 0;
+	CallSite::invalidateAll();
 }
 
 void Logger::setAdditivity(bool additive1)
@@ -557,6 +595,7 @@ void Logger::setAdditivity(bool additive1)
 void Logger::setHierarchy(spi::LoggerRepository* repository1)
 {
 	m_priv->repositoryRaw = repository1;
+	CallSite::invalidateAll();
 }
 
 void Logger::setParent(LoggerPtr parentLogger)
@@ -579,6 +618,7 @@ void Logger::setLevel(const LevelPtr level1)
 void Logger::updateThreshold()
 {
 	m_threshold = getEffectiveLevel()->toInt();
+	CallSite::invalidateAll();
 }
 
 const LogString& Logger::getName() const
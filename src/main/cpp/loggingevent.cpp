@@ -98,6 +98,31 @@ struct LoggingEvent::LoggingEventPrivate
 	{
 	}
 
+	LoggingEventPrivate
+		( const LogString& logger1
+		, const LevelPtr& level1
+		, const LocationInfo& locationInfo1
+		, LogString&& message1
+		, log4cxx_time_t timeStamp1
+		, const LogString& threadName1
+		, const LogString& threadUserName1
+		) :
+		logger(logger1),
+		level(level1),
+		ndc(0),
+		mdcCopy(0),
+		properties(0),
+		ndcLookupRequired(false),
+		mdcCopyLookupRequired(false),
+		message(std::move(message1)),
+		timeStamp(timeStamp1),
+		locationInfo(locationInfo1),
+		threadName(threadName1),
+		threadUserName(threadUserName1),
+		chronoTimeStamp(std::chrono::microseconds(timeStamp))
+	{
+	}
+
 	~LoggingEventPrivate()
 	{
 		delete ndc;
@@ -149,7 +174,6 @@ struct LoggingEvent::LoggingEventPrivate
 	/** The is the location where this log statement was written. */
 	const LOG4CXX_NS::spi::LocationInfo locationInfo;
 
-
 	/** The identifier of thread in which this logging event
 	was generated.
 	*/
@@ -198,6 +222,24 @@ LoggingEvent::LoggingEvent(
 {
 }
 
+LoggingEvent::LoggingEvent
+	( const LogString&    logger
+	, const LevelPtr&     level
+	, const LocationInfo& location
+	, LogString&&         message
+	, log4cxx_time_t      timeStamp
+	, const LogString&    threadName
+	, const LogString&    threadUserName
+	, const LogString*    ndc
+	, MDC::Map&&          mdc
+	)
+	: m_priv(std::make_unique<LoggingEventPrivate>(logger, level, location, std::move(message), timeStamp, threadName, threadUserName))
+{
+	if (ndc)
+		m_priv->ndc = new LogString(*ndc);
+	m_priv->mdcCopy = new MDC::Map(std::move(mdc));
+}
+
 LoggingEvent::~LoggingEvent()
 {
 }
@@ -35,6 +35,7 @@
 #include <log4cxx/private/fileappender_priv.h>
 #include <log4cxx/rolling/timebasedrollingpolicy.h>
 #include <log4cxx/private/boost-std-configuration.h>
+#include <log4cxx/private/multiprocessrolloverstate.h>
 #include <mutex>
 
 using namespace LOG4CXX_NS;
@@ -67,8 +68,89 @@ struct MultiprocessRollingFileAppender::MultiprocessRollingFileAppenderPriv : pu
 	 *  save the loggingevent
 	 */
 	spi::LoggingEventPtr _event;
+
+	/**
+	 * The rollover generation and active file shared with other processes.
+	 */
+	MultiprocessRolloverState sharedState;
+
+	/**
+	 * The value of sharedState.getGeneration() when the active file was last opened.
+	 */
+	uint64_t generation = 0;
 };
 
+namespace
+{
+// The name from which the lock and control file names are derived, which is the same in all processes
+LogString getSharedBaseName(const RollingPolicyPtr& policy, const LogString& activeFile, Pool& p)
+{
+	LogString result(activeFile);
+	RollingPolicyBasePtr basePolicy = LOG4CXX_NS::cast<RollingPolicyBase>(policy);
+
+	if (basePolicy && basePolicy->getPatternConverterList().size())
+	{
+		result.clear();
+		ObjectPtr obj = std::make_shared<Date>(apr_time_now());
+		(*(basePolicy->getPatternConverterList().begin()))->format(obj, result, p);
+	}
+
+	return result;
+}
+
+// The name of a file for the current user that is derived from \c baseName
+std::string getSharedFileName(const LogString& baseName, const char* suffix, Pool& p)
+{
+	char szUid[MAX_FILE_LEN] = {'\0'};
+	apr_uid_t uid;
+	apr_gid_t groupid;
+	apr_status_t stat = apr_uid_current(&uid, &groupid, p.getAPRPool());
+
+	if (stat == APR_SUCCESS)
+	{
+#ifdef WIN32
+		snprintf(szUid, MAX_FILE_LEN, "%p", uid);
+#else
+		snprintf(szUid, MAX_FILE_LEN, "%u", (unsigned int)uid);
+#endif
+	}
+
+	LOG4CXX_ENCODE_CHAR(fileName, baseName);
+	LOG4CXX_NS::filesystem::path path = fileName;
+	const auto result = path.parent_path() / (path.filename().string() + szUid + suffix);
+	return result.string();
+}
+
+// Does \c fileName no longer refer to the file open in \c writer?
+bool isRenamed(const WriterPtr& writer, const LogString& fileName, Pool& p)
+{
+	const FileOutputStreamPtr fos = LOG4CXX_NS::cast<FileOutputStream>( writer );
+	if( !fos ){
+		LogLog::error( LOG4CXX_STR("Can't cast writer to FileOutputStream") );
+		return false;
+	}
+	apr_finfo_t finfo1, finfo2;
+	apr_file_t* _fd = fos->getFilePtr();
+	apr_status_t st1 = apr_file_info_get(&finfo1, APR_FINFO_IDENT, _fd);
+
+	if (st1 != APR_SUCCESS)
+	{
+		LogLog::warn(LOG4CXX_STR("apr_file_info_get failed"));
+	}
+
+	LOG4CXX_ENCODE_CHAR(fname, fileName);
+	apr_status_t st2 = apr_stat(&finfo2, fname.c_str(), APR_FINFO_IDENT, p.getAPRPool());
+
+	if (st2 != APR_SUCCESS)
+	{
+		LogLog::warn(LOG4CXX_STR("apr_stat failed. file:") + fileName);
+	}
+
+	return ((st1 == APR_SUCCESS) && (st2 == APR_SUCCESS)
+			&& ((finfo1.device != finfo2.device) || (finfo1.inode != finfo2.inode)));
+}
+} // namespace
+
 #define _priv static_cast<MultiprocessRollingFileAppenderPriv*>(m_priv.get())
 
 IMPLEMENT_LOG4CXX_OBJECT(MultiprocessRollingFileAppender)
@@ -158,6 +240,20 @@ void MultiprocessRollingFileAppender::activateOptions(Pool& p)
 			}
 
 			FileAppender::activateOptionsInternal(p);
+
+			auto controlFile = getSharedFileName(getSharedBaseName(_priv->rollingPolicy, getFile(), p), ".ctl", p);
+			if (_priv->sharedState.open(controlFile))
+			{
+				_priv->sharedState.setFileLength(_priv->fileLength);
+				_priv->generation = _priv->sharedState.getGeneration();
+
+				// Changes to the active file name are detected using the generation
+				TimeBasedRollingPolicyPtr timeBased = LOG4CXX_NS::cast<TimeBasedRollingPolicy>(_priv->rollingPolicy);
+				if (timeBased)
+				{
+					timeBased->setRefreshActiveFile(false);
+				}
+			}
 		}
 		catch (std::exception&)
 		{
@@ -214,44 +310,10 @@ bool MultiprocessRollingFileAppender::rolloverInternal(Pool& p)
 	{
 
 		{
-			LogString fileName(getFile());
-			RollingPolicyBasePtr basePolicy = LOG4CXX_NS::cast<RollingPolicyBase>(_priv->rollingPolicy);
-			apr_time_t n = apr_time_now();
-			ObjectPtr obj = std::make_shared<Date>(n);
-			LogString fileNamePattern;
-
-			if (basePolicy)
-			{
-				if (basePolicy->getPatternConverterList().size())
-				{
-					(*(basePolicy->getPatternConverterList().begin()))->format(obj, fileNamePattern, p);
-					fileName = std::string(fileNamePattern);
-				}
-			}
-
 			bool bAlreadyRolled = true;
-			char szDirName[MAX_FILE_LEN] = {'\0'};
-			char szBaseName[MAX_FILE_LEN] = {'\0'};
-			char szUid[MAX_FILE_LEN] = {'\0'};
-			memcpy(szDirName, fileName.c_str(), fileName.size() > MAX_FILE_LEN ? MAX_FILE_LEN : fileName.size());
-			memcpy(szBaseName, fileName.c_str(), fileName.size() > MAX_FILE_LEN ? MAX_FILE_LEN : fileName.size());
-			apr_uid_t uid;
-			apr_gid_t groupid;
-			apr_status_t stat = apr_uid_current(&uid, &groupid, p.getAPRPool());
-
-			if (stat == APR_SUCCESS)
-			{
-#ifdef WIN32
-				snprintf(szUid, MAX_FILE_LEN, "%p", uid);
-#else
-				snprintf(szUid, MAX_FILE_LEN, "%u", (unsigned int)uid);
-#endif
-			}
-
-			LOG4CXX_NS::filesystem::path path = szDirName;
-			const auto lockname = path.parent_path() / (path.filename().string() + szUid + ".lock");
+			const auto lockname = getSharedFileName(getSharedBaseName(_priv->rollingPolicy, getFile(), p), ".lock", p);
 			apr_file_t* lock_file;
-			stat = apr_file_open(&lock_file, lockname.string().c_str(), APR_CREATE | APR_READ | APR_WRITE, APR_OS_DEFAULT, p.getAPRPool());
+			apr_status_t stat = apr_file_open(&lock_file, lockname.c_str(), APR_CREATE | APR_READ | APR_WRITE, APR_OS_DEFAULT, p.getAPRPool());
 
 			if (stat != APR_SUCCESS)
 			{
@@ -283,32 +345,14 @@ bool MultiprocessRollingFileAppender::rolloverInternal(Pool& p)
 
 			if (bAlreadyRolled)
 			{
-				apr_finfo_t finfo1, finfo2;
-				apr_status_t st1, st2;
-				const WriterPtr writer = getWriter();
-				const FileOutputStreamPtr fos = LOG4CXX_NS::cast<FileOutputStream>( writer );
-				if( !fos ){
-					LogLog::error( LOG4CXX_STR("Can't cast writer to FileOutputStream") );
-					return false;
-				}
-				apr_file_t* _fd = fos->getFilePtr();
-				st1 = apr_file_info_get(&finfo1, APR_FINFO_IDENT, _fd);
-
-				if (st1 != APR_SUCCESS)
+				if (_priv->sharedState.isOpen())
 				{
-					LogLog::warn(LOG4CXX_STR("apr_file_info_get failed"));
+					bAlreadyRolled = _priv->sharedState.getGeneration() != _priv->generation;
 				}
-
-				LogString fname = getFile();
-				st2 = apr_stat(&finfo2, fname.c_str(), APR_FINFO_IDENT, p.getAPRPool());
-
-				if (st2 != APR_SUCCESS)
+				else
 				{
-					LogLog::warn(LOG4CXX_STR("apr_stat failed."));
+					bAlreadyRolled = isRenamed(getWriter(), getFile(), p);
 				}
-
-				bAlreadyRolled = ((st1 == APR_SUCCESS) && (st2 == APR_SUCCESS)
-						&& ((finfo1.device != finfo2.device) || (finfo1.inode != finfo2.inode)));
 			}
 
 			if (!bAlreadyRolled)
@@ -429,6 +473,12 @@ bool MultiprocessRollingFileAppender::rolloverInternal(Pool& p)
 							writeHeader(p);
 						}
 
+						if (_priv->sharedState.isOpen())
+						{
+							_priv->sharedState.publish(getFile(), File().setPath(getFile()).length(p));
+							_priv->generation = _priv->sharedState.getGeneration();
+						}
+
 						releaseFileLock(lock_file);
 						return true;
 					}
@@ -444,7 +494,7 @@ bool MultiprocessRollingFileAppender::rolloverInternal(Pool& p)
 			}
 			else
 			{
-				reopenLatestFile(p);
+				reopenActiveFile(p);
 			}
 
 			releaseFileLock(lock_file);
@@ -454,6 +504,26 @@ bool MultiprocessRollingFileAppender::rolloverInternal(Pool& p)
 	return false;
 }
 
+/**
+ * re-open the file published by the process that made the latest rollover
+ */
+void MultiprocessRollingFileAppender::reopenActiveFile(Pool& p)
+{
+	if (_priv->sharedState.isOpen())
+	{
+		uint64_t generation;
+		LogString activeFile = _priv->sharedState.getActiveFileName(generation);
+		_priv->generation = generation;
+
+		if (!activeFile.empty() && activeFile != getFile())
+		{
+			setFile(activeFile);
+		}
+	}
+
+	reopenLatestFile(p);
+}
+
 /**
  * re-open current file when its own handler has been renamed
  */
@@ -499,36 +569,16 @@ void MultiprocessRollingFileAppender::subAppend(const LoggingEventPtr& event, Po
 		}
 	}
 
-	//do re-check before every write
-	//
-	apr_finfo_t finfo1, finfo2;
-	apr_status_t st1, st2;
-	const WriterPtr writer = getWriter();
-	const FileOutputStreamPtr fos = LOG4CXX_NS::cast<FileOutputStream>( writer );
-	if( !fos ){
-		LogLog::error( LOG4CXX_STR("Can't cast writer to FileOutputStream") );
-		return;
-	}
-	apr_file_t* _fd = fos->getFilePtr();
-	st1 = apr_file_info_get(&finfo1, APR_FINFO_IDENT, _fd);
-
-	if (st1 != APR_SUCCESS)
-	{
-		LogLog::warn(LOG4CXX_STR("apr_file_info_get failed"));
-	}
-
-	st2 = apr_stat(&finfo2, std::string(getFile()).c_str(), APR_FINFO_IDENT, p.getAPRPool());
-
-	if (st2 != APR_SUCCESS)
+	// Another process may have rolled the file.
+	// When the control block is available, the file system is only checked after a rollover
+	if (_priv->sharedState.isOpen())
 	{
-		LogString err = "apr_stat failed. file:" + getFile();
-		LogLog::warn(err);
+		if (_priv->sharedState.getGeneration() != _priv->generation)
+		{
+			reopenActiveFile(p);
+		}
 	}
-
-	bool bAlreadyRolled = ((st1 == APR_SUCCESS) && (st2 == APR_SUCCESS)
-			&& ((finfo1.device != finfo2.device) || (finfo1.inode != finfo2.inode)));
-
-	if (bAlreadyRolled)
+	else if (isRenamed(getWriter(), getFile(), p))
 	{
 		reopenLatestFile(p);
 	}
@@ -582,7 +632,9 @@ void MultiprocessRollingFileAppender::setTriggeringPolicy(const TriggeringPolicy
  */
 void MultiprocessRollingFileAppender::close()
 {
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
 	FileAppender::close();
+	_priv->sharedState.close();
 }
 
 namespace LOG4CXX_NS
@@ -640,11 +692,12 @@ class CountingOutputStream : public OutputStream
 		 */
 		void write(ByteBuffer& buf, Pool& p)
 		{
+			auto byteCount = buf.remaining();
 			os->write(buf, p);
 
 			if (rfa != 0)
 			{
-				rfa->setFileLength(File().setPath(rfa->getFile()).length(p));
+				rfa->updateFileLength(byteCount, p);
 			}
 		}
 
@@ -667,7 +720,8 @@ class CountingOutputStream : public OutputStream
  */
 WriterPtr MultiprocessRollingFileAppender::createWriter(OutputStreamPtr& os)
 {
-	OutputStreamPtr cos = std::make_shared<CountingOutputStream>(os, this);
+	OutputStreamPtr dos = _priv->prepareFileStream(os);
+	OutputStreamPtr cos = std::make_shared<CountingOutputStream>(dos, this);
 	return FileAppender::createWriter(cos);
 }
 
@@ -685,6 +739,19 @@ void MultiprocessRollingFileAppender::setFileLength(size_t length)
 	_priv->fileLength = length;
 }
 
+void MultiprocessRollingFileAppender::updateFileLength(size_t byteCount, Pool& p)
+{
+	if (_priv->sharedState.isOpen())
+	{
+		// The control block accumulates the bytes written by all processes
+		_priv->fileLength = _priv->sharedState.addFileLength(byteCount);
+	}
+	else
+	{
+		_priv->fileLength = File().setPath(getFile()).length(p);
+	}
+}
+
 /**
  * Increments estimated byte length of current active log file.
  * @param increment additional bytes written to log file.
@@ -0,0 +1,193 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/private/multiprocessrolloverstate.h>
+#include <log4cxx/helpers/loglog.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <apr_file_io.h>
+#include <apr_mmap.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::rolling;
+using namespace LOG4CXX_NS::helpers;
+
+namespace
+{
+const uint32_t Magic = 0x5043344C; // "L4CP"
+const uint32_t Version = 1;
+const size_t MaxNameLength = 2048;
+}
+
+struct MultiprocessRolloverState::ControlBlock
+{
+	std::atomic<uint32_t> magic;
+	uint32_t version;
+	/** Odd while a rollover is being published */
+	std::atomic<uint64_t> sequence;
+	std::atomic<uint64_t> fileLength;
+	std::atomic<uint32_t> nameLength;
+	char name[MaxNameLength];
+};
+
+MultiprocessRolloverState::MultiprocessRolloverState()
+	: m_block(nullptr)
+	, m_file(nullptr)
+	, m_mmap(nullptr)
+{
+}
+
+MultiprocessRolloverState::~MultiprocessRolloverState()
+{
+	close();
+}
+
+bool MultiprocessRolloverState::open(const std::string& path)
+{
+	static_assert(std::atomic<uint64_t>::is_always_lock_free, "lock free 64 bit atomics are required in shared memory");
+	close();
+	apr_status_t stat = apr_file_open(&m_file, path.c_str(), APR_CREATE | APR_READ | APR_WRITE, APR_OS_DEFAULT, m_pool.getAPRPool());
+	if (stat != APR_SUCCESS)
+	{
+		LogString msg(LOG4CXX_STR("Unable to open rollover control file "));
+		Transcoder::decode(path, msg);
+		LogLog::warn(msg);
+		m_file = nullptr;
+		return false;
+	}
+
+	// A new file is zero filled, which is a valid initial state
+	apr_finfo_t finfo;
+	stat = apr_file_info_get(&finfo, APR_FINFO_SIZE, m_file);
+	if (stat == APR_SUCCESS && 0 < finfo.size && finfo.size < apr_off_t(sizeof (ControlBlock)))
+	{
+		// The file is always extended in one step, so this is not a control file
+		LogLog::warn(LOG4CXX_STR("Truncated rollover control file"));
+		close();
+		return false;
+	}
+	if (stat == APR_SUCCESS && 0 == finfo.size)
+		stat = apr_file_trunc(m_file, sizeof (ControlBlock));
+	if (stat == APR_SUCCESS)
+		stat = apr_mmap_create(&m_mmap, m_file, 0, sizeof (ControlBlock), APR_MMAP_WRITE | APR_MMAP_READ, m_pool.getAPRPool());
+	if (stat != APR_SUCCESS)
+	{
+		LogLog::warn(LOG4CXX_STR("Unable to map rollover control file"));
+		m_mmap = nullptr;
+		close();
+		return false;
+	}
+
+	auto block = static_cast<ControlBlock*>(m_mmap->mm);
+	uint32_t expected = 0;
+	if (block->magic.compare_exchange_strong(expected, Magic) || Magic == expected)
+	{
+		if (0 == block->version)
+			block->version = Version;
+	}
+	if (block->magic.load() != Magic || block->version != Version)
+	{
+		LogLog::warn(LOG4CXX_STR("Incompatible rollover control file"));
+		close();
+		return false;
+	}
+	if (MaxNameLength < block->nameLength.load())
+	{
+		LogLog::warn(LOG4CXX_STR("Corrupt rollover control file"));
+		close();
+		return false;
+	}
+	m_block = block;
+	return true;
+}
+
+void MultiprocessRolloverState::close()
+{
+	m_block = nullptr;
+	if (m_mmap)
+	{
+		apr_mmap_delete(m_mmap);
+		m_mmap = nullptr;
+	}
+	if (m_file)
+	{
+		apr_file_close(m_file);
+		m_file = nullptr;
+	}
+}
+
+bool MultiprocessRolloverState::isOpen() const
+{
+	return m_block != nullptr;
+}
+
+uint64_t MultiprocessRolloverState::getGeneration() const
+{
+	return m_block->sequence.load(std::memory_order_acquire);
+}
+
+LogString MultiprocessRolloverState::getActiveFileName(uint64_t& generation) const
+{
+	std::string name;
+	bool consistent = false;
+	for (int attempt = 0; !consistent && attempt < 1000; ++attempt)
+	{
+		generation = m_block->sequence.load(std::memory_order_acquire);
+		auto length = std::min(size_t(m_block->nameLength.load(std::memory_order_relaxed)), MaxNameLength);
+		name.assign(m_block->name, length);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		consistent = 0 == (generation & 1) && m_block->sequence.load(std::memory_order_relaxed) == generation;
+		if (!consistent) // A rollover is being published
+			std::this_thread::yield();
+	}
+	LogString result;
+	// A torn name (left by a process that ended while publishing) is not used
+	if (consistent)
+		Transcoder::decodeUTF8(name, result);
+	return result;
+}
+
+void MultiprocessRolloverState::publish(const LogString& activeFile, size_t fileLength)
+{
+	std::string name;
+	Transcoder::encodeUTF8(activeFile, name);
+	if (MaxNameLength < name.size())
+		name.clear();
+
+	// An odd value remains if a process ended while publishing
+	auto sequence = m_block->sequence.load(std::memory_order_relaxed) | 1;
+	m_block->sequence.store(sequence, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	std::memcpy(m_block->name, name.data(), name.size());
+	m_block->nameLength.store(uint32_t(name.size()), std::memory_order_relaxed);
+	m_block->fileLength.store(fileLength, std::memory_order_relaxed);
+	m_block->sequence.store(sequence + 1, std::memory_order_release);
+}
+
+size_t MultiprocessRolloverState::addFileLength(size_t byteCount)
+{
+	return size_t(m_block->fileLength.fetch_add(byteCount, std::memory_order_relaxed) + byteCount);
+}
+
+void MultiprocessRolloverState::setFileLength(size_t fileLength)
+{
+	m_block->fileLength.store(fileLength, std::memory_order_relaxed);
+}
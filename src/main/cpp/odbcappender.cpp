@@ -15,9 +15,11 @@
  * limitations under the License.
  */
 #include <log4cxx/db/odbcappender.h>
+#include <log4cxx/helpers/appendermetrics.h>
 #include <log4cxx/helpers/loglog.h>
 #include <log4cxx/helpers/optionconverter.h>
 #include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/threadutility.h>
 #include <log4cxx/helpers/transcoder.h>
 #include <log4cxx/patternlayout.h>
 #include <log4cxx/pattern/mdcpatternconverter.h>
@@ -57,6 +59,7 @@
 #endif
 #include <cstring>
 #include <algorithm>
+#include <iterator>
 
 
 using namespace LOG4CXX_NS;
@@ -125,6 +128,7 @@ ODBCAppender::ODBCAppender()
 			std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
 			if(_priv->closed)
 				return;
+			_priv->stopFlusher();
 			try
 			{
 				flushBuffer(_priv->pool);
@@ -177,6 +181,10 @@ void ODBCAppender::setOption(const LogString& option, const LogString& value)
 	{
 		setBufferSize((size_t)OptionConverter::toInt(value, 1));
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("BACKGROUNDFLUSH"), LOG4CXX_STR("backgroundflush")))
+	{
+		setBackgroundFlush(OptionConverter::toBoolean(value, false));
+	}
 	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("PASSWORD"), LOG4CXX_STR("password")))
 	{
 		setPassword(value);
@@ -250,6 +258,11 @@ void ODBCAppender::activateOptions(LOG4CXX_NS::helpers::Pool&)
 			_priv->parameterValue.push_back(paramData);
 		}
 	}
+	if (_priv->backgroundFlush && !_priv->flusher.joinable())
+	{
+		_priv->stopping = false;
+		_priv->flusher = ThreadUtility::instance()->createThread( LOG4CXX_STR("ODBCAppender"), &ODBCAppender::writePendingEvents, this );
+	}
 #endif
 }
 
@@ -257,11 +270,43 @@ void ODBCAppender::activateOptions(LOG4CXX_NS::helpers::Pool&)
 void ODBCAppender::append(const spi::LoggingEventPtr& event, LOG4CXX_NS::helpers::Pool& p)
 {
 #if LOG4CXX_HAVE_ODBC
+	if (_priv->backgroundFlush)
+	{
+		// Capture the diagnostic context of this thread
+		// as the event is formatted on the background thread.
+		LogString ndcVal;
+		event->getNDC(ndcVal);
+		event->getMDCCopy();
+	}
 	_priv->buffer.push_back(event);
 
-	if (_priv->buffer.size() >= _priv->bufferSize)
-	{
+	if (_priv->buffer.size() < _priv->bufferSize)
+		;
+	else if (!_priv->flusher.joinable())
 		flushBuffer(p);
+	else
+	{
+		// Hand the full buffer to the background thread
+		std::lock_guard<std::mutex> lock(_priv->queueMutex);
+		auto metrics = _priv->getMetrics();
+		// Limit the memory used when the database cannot keep up
+		if (std::max(_priv->bufferSize, size_t(1)) * 8 <= _priv->pending.size())
+		{
+			_priv->discardCount += _priv->buffer.size();
+			if (metrics)
+				metrics->add(AppenderMetrics::Discards, _priv->buffer.size());
+			_priv->buffer.clear();
+		}
+		else if (_priv->pending.empty())
+			std::swap(_priv->pending, _priv->buffer);
+		else
+		{
+			std::move(_priv->buffer.begin(), _priv->buffer.end(), std::back_inserter(_priv->pending));
+			_priv->buffer.clear();
+		}
+		if (metrics)
+			metrics->setQueueDepth(_priv->pending.size());
+		_priv->queueChanged.notify_all();
 	}
 
 #endif
@@ -378,6 +423,7 @@ void ODBCAppender::close()
 	{
 		return;
 	}
+	_priv->stopFlusher();
 
 	Pool p;
 
@@ -431,6 +477,34 @@ void ODBCAppender::ODBCAppenderPriv::setPreparedStatement(SQLHDBC con, Pool& p)
 		throw SQLException(SQL_HANDLE_STMT, this->preparedStatement, "Failed to prepare sql statement.", p);
 	}
 
+	this->arraySize = 1;
+	if (1 < this->bufferSize)
+	{
+		// Commit the events written by each flush in a single transaction
+		if (SQLSetConnectAttr(con, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER)SQL_AUTOCOMMIT_OFF, SQL_IS_UINTEGER) < 0)
+			LogLog::warn(LOG4CXX_STR("ODBCAppender could not disable autocommit"));
+		else
+			this->transactionConnection = con;
+
+		// Send a buffer of events in one execution using column-wise parameter arrays
+		SQLULEN actualSize = 1;
+		if (SQLSetStmtAttr(this->preparedStatement, SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER)SQL_PARAM_BIND_BY_COLUMN, 0) < 0
+			|| SQLSetStmtAttr(this->preparedStatement, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)this->bufferSize, 0) < 0
+			|| SQLGetStmtAttr(this->preparedStatement, SQL_ATTR_PARAMSET_SIZE, &actualSize, 0, 0) < 0
+			|| actualSize < 2)
+		{
+			SQLSetStmtAttr(this->preparedStatement, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)1, 0);
+			LogLog::warn(LOG4CXX_STR("ODBC driver does not support parameter arrays, events will be inserted individually"));
+		}
+		else
+		{
+			this->arraySize = std::min(size_t(actualSize), this->bufferSize);
+			this->paramStatus.assign(this->arraySize, 0);
+			SQLSetStmtAttr(this->preparedStatement, SQL_ATTR_PARAM_STATUS_PTR, this->paramStatus.data(), 0);
+			SQLSetStmtAttr(this->preparedStatement, SQL_ATTR_PARAMS_PROCESSED_PTR, &this->paramsProcessed, 0);
+		}
+	}
+
 	int parameterNumber = 0;
 	for (auto& item : this->parameterValue)
 	{
@@ -456,14 +530,12 @@ void ODBCAppender::ODBCAppenderPriv::setPreparedStatement(SQLHDBC con, Pool& p)
 			item.paramType = SQL_C_CHAR;
 			item.paramMaxCharCount = targetMaxCharCount;
 			item.paramValueSize = (SQLINTEGER)(item.paramMaxCharCount) * sizeof(char) + sizeof(char);
-			item.paramValue = (SQLPOINTER)p.palloc(item.paramValueSize + sizeof(char));
 		}
 		else if (SQL_WCHAR == targetType || SQL_WVARCHAR == targetType || SQL_WLONGVARCHAR == targetType)
 		{
 			item.paramType = SQL_C_WCHAR;
 			item.paramMaxCharCount = targetMaxCharCount;
 			item.paramValueSize = (SQLINTEGER)(targetMaxCharCount) * sizeof(wchar_t) + sizeof(wchar_t);
-			item.paramValue = (SQLPOINTER)p.palloc(item.paramValueSize + sizeof(wchar_t));
 		}
 		else if (SQL_TYPE_TIMESTAMP == targetType || SQL_TYPE_DATE == targetType || SQL_TYPE_TIME == targetType
 			|| SQL_DATETIME == targetType)
@@ -471,7 +543,6 @@ void ODBCAppender::ODBCAppenderPriv::setPreparedStatement(SQLHDBC con, Pool& p)
 			item.paramType = SQL_C_TYPE_TIMESTAMP;
 			item.paramMaxCharCount = (0 <= decimalDigits) ? decimalDigits : 6;
 			item.paramValueSize = sizeof(SQL_TIMESTAMP_STRUCT);
-			item.paramValue = (SQLPOINTER)p.palloc(item.paramValueSize);
 		}
 		else
 		{
@@ -488,14 +559,15 @@ void ODBCAppender::ODBCAppenderPriv::setPreparedStatement(SQLHDBC con, Pool& p)
 #if LOG4CXX_LOGCHAR_IS_UTF8
 			item.paramType = SQL_C_CHAR;
 			item.paramValueSize = (SQLINTEGER)(item.paramMaxCharCount) * sizeof(char);
-			item.paramValue = (SQLPOINTER)p.palloc(item.paramValueSize + sizeof(char));
 #else
 			item.paramType = SQL_C_WCHAR;
 			item.paramValueSize = (SQLINTEGER)(item.paramMaxCharCount) * sizeof(wchar_t);
-			item.paramValue = (SQLPOINTER)p.palloc(item.paramValueSize + sizeof(wchar_t));
 #endif
 		}
-		item.strLen_or_Ind = SQL_NTS;
+		// One value of paramValueSize bytes (plus room for a terminator) for each row
+		item.paramBuffer.assign(this->arraySize * item.paramValueSize + sizeof(wchar_t), 0);
+		item.paramValue = (SQLPOINTER)item.paramBuffer.data();
+		item.strLen_or_Ind.assign(this->arraySize, SQL_NTS);
 		ret = SQLBindParameter
 			( this->preparedStatement
 			, parameterNumber
@@ -506,7 +578,7 @@ void ODBCAppender::ODBCAppenderPriv::setPreparedStatement(SQLHDBC con, Pool& p)
 			, decimalDigits
 			, item.paramValue
 			, item.paramValueSize
-			, &item.strLen_or_Ind
+			, item.strLen_or_Ind.data()
 			);
 		if (ret < 0)
 		{
@@ -515,10 +587,11 @@ void ODBCAppender::ODBCAppenderPriv::setPreparedStatement(SQLHDBC con, Pool& p)
 	}
 }
 
-void ODBCAppender::ODBCAppenderPriv::setParameterValues(const spi::LoggingEventPtr& event, Pool& p)
+void ODBCAppender::ODBCAppenderPriv::setParameterValues(const spi::LoggingEventPtr& event, size_t row, Pool& p)
 {
 	for (auto& item : this->parameterValue)
 	{
+		auto value = (char*)item.paramValue + row * item.paramValueSize;
 		if (!item.paramValue || item.paramValueSize <= 0)
 			;
 		else if (SQL_C_WCHAR == item.paramType)
@@ -531,7 +604,7 @@ void ODBCAppender::ODBCAppenderPriv::setParameterValues(const spi::LoggingEventP
 			std::wstring tmp;
 			Transcoder::encode(sbuf, tmp);
 #endif
-			auto dst = (wchar_t*)item.paramValue;
+			auto dst = (wchar_t*)value;
 			auto charCount = std::min(size_t(item.paramMaxCharCount), tmp.size());
 			auto copySize = std::min(size_t(item.paramValueSize - 1), charCount * sizeof(wchar_t));
 			std::memcpy(dst, tmp.data(), copySize);
@@ -547,7 +620,7 @@ void ODBCAppender::ODBCAppenderPriv::setParameterValues(const spi::LoggingEventP
 			std::string tmp;
 			Transcoder::encode(sbuf, tmp);
 #endif
-			auto dst = (char*)item.paramValue;
+			auto dst = value;
 			auto sz = std::min(size_t(item.paramMaxCharCount), tmp.size());
 			auto copySize = std::min(size_t(item.paramValueSize - 1), sz * sizeof(char));
 			std::memcpy(dst, tmp.data(), copySize);
@@ -559,7 +632,7 @@ void ODBCAppender::ODBCAppenderPriv::setParameterValues(const spi::LoggingEventP
 			apr_status_t stat = this->timeZone->explode(&exploded, event->getTimeStamp());
 			if (stat == APR_SUCCESS)
 			{
-				auto dst = (SQL_TIMESTAMP_STRUCT*)item.paramValue;
+				auto dst = (SQL_TIMESTAMP_STRUCT*)value;
 				dst->year = 1900 + exploded.tm_year;
 				dst->month = 1 + exploded.tm_mon;
 				dst->day = exploded.tm_mday;
@@ -583,32 +656,113 @@ void ODBCAppender::ODBCAppenderPriv::setParameterValues(const spi::LoggingEventP
 
 void ODBCAppender::flushBuffer(Pool& p)
 {
-	for (auto& logEvent : _priv->buffer)
+	std::vector<spi::LoggingEventPtr> events;
+	std::swap(events, _priv->buffer);
+	writeEvents(events, p);
+}
+
+void ODBCAppender::writeEvents(const std::vector<spi::LoggingEventPtr>& events, Pool& p)
+{
+	if (events.empty())
+		return;
+	if (_priv->parameterValue.empty())
 	{
-		if (_priv->parameterValue.empty())
-			_priv->errorHandler->error(LOG4CXX_STR("ODBCAppender column mappings not defined"));
+		_priv->errorHandler->error(LOG4CXX_STR("ODBCAppender column mappings not defined"));
+		return;
+	}
 #if LOG4CXX_HAVE_ODBC
-		else try
+	std::lock_guard<std::mutex> lock(_priv->statementMutex);
+	try
+	{
+		if (0 == _priv->preparedStatement)
+			_priv->setPreparedStatement(getConnection(p), p);
+	}
+	catch (SQLException& e)
+	{
+		_priv->errorHandler->error(LOG4CXX_STR("Failed to execute sql"), e,
+			ErrorCode::FLUSH_FAILURE);
+		return;
+	}
+
+	for (size_t start = 0; start < events.size(); start += _priv->arraySize)
+	{
+		auto rowCount = std::min(_priv->arraySize, events.size() - start);
+		for (size_t row = 0; row < rowCount; ++row)
+			_priv->setParameterValues(events[start + row], row, p);
+		if (1 < _priv->arraySize)
 		{
-			if (0 == _priv->preparedStatement)
-				_priv->setPreparedStatement(getConnection(p), p);
-			_priv->setParameterValues(logEvent, p);
-			auto ret = SQLExecute(_priv->preparedStatement);
-			if (ret < 0)
-			{
-				throw SQLException(SQL_HANDLE_STMT, _priv->preparedStatement, "Failed to execute prepared statement", p);
-			}
+			SQLSetStmtAttr(_priv->preparedStatement, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)rowCount, 0);
+			std::fill(_priv->paramStatus.begin(), _priv->paramStatus.end(), SQLUSMALLINT(SQL_PARAM_UNUSED));
+		}
+		auto ret = SQLExecute(_priv->preparedStatement);
+		size_t errorCount = (ret < 0) ? rowCount : 0;
+		if (1 < _priv->arraySize && (ret < 0 || SQL_SUCCESS_WITH_INFO == ret))
+		{
+			auto processed = std::count_if(_priv->paramStatus.begin(), _priv->paramStatus.begin() + rowCount
+				, [](SQLUSMALLINT status) { return SQL_PARAM_SUCCESS == status || SQL_PARAM_SUCCESS_WITH_INFO == status; });
+			errorCount = rowCount - processed;
 		}
-		catch (SQLException& e)
+		if (0 < errorCount)
 		{
+			std::string prolog = "Failed to insert " + std::to_string(errorCount)
+				+ " of " + std::to_string(rowCount) + " events";
+			SQLException e(SQL_HANDLE_STMT, _priv->preparedStatement, prolog.c_str(), p);
 			_priv->errorHandler->error(LOG4CXX_STR("Failed to execute sql"), e,
 				ErrorCode::FLUSH_FAILURE);
 		}
+	}
+
+	if (_priv->transactionConnection
+		&& SQLEndTran(SQL_HANDLE_DBC, _priv->transactionConnection, SQL_COMMIT) < 0)
+	{
+		SQLException e(SQL_HANDLE_DBC, _priv->transactionConnection, "Failed to commit", p);
+		_priv->errorHandler->error(LOG4CXX_STR("Failed to execute sql"), e,
+			ErrorCode::FLUSH_FAILURE);
+	}
 #endif
+}
+
+void ODBCAppender::writePendingEvents()
+{
+	std::vector<spi::LoggingEventPtr> events;
+	bool finished = false;
+	while (!finished)
+	{
+		size_t discards = 0;
+		{
+			std::unique_lock<std::mutex> lock(_priv->queueMutex);
+			_priv->queueChanged.wait(lock, [this]()
+				{ return _priv->stopping || !_priv->pending.empty(); });
+			std::swap(events, _priv->pending);
+			std::swap(discards, _priv->discardCount);
+			finished = _priv->stopping;
+			if (auto metrics = _priv->getMetrics())
+				metrics->setQueueDepth(0);
+		}
+
+		// Memory used for error messages is released after each batch
+		Pool p;
+		if (0 < discards)
+		{
+			LogString msg;
+			StringHelper::toString(discards, p, msg);
+			msg += LOG4CXX_STR(" events discarded by [") + _priv->name + LOG4CXX_STR("] as the database was too slow.");
+			LogLog::warn(msg);
+		}
+		writeEvents(events, p);
+		events.clear();
 	}
+}
 
-	// clear the buffer of reported events
-	_priv->buffer.clear();
+void ODBCAppender::ODBCAppenderPriv::stopFlusher()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->queueMutex);
+		this->stopping = true;
+		this->queueChanged.notify_all();
+	}
+	if (this->flusher.joinable())
+		this->flusher.join();
 }
 
 void ODBCAppender::setSql(const LogString& s)
@@ -699,3 +853,13 @@ size_t ODBCAppender::getBufferSize() const
 	return _priv->bufferSize;
 }
 
+void ODBCAppender::setBackgroundFlush(bool newValue)
+{
+	_priv->backgroundFlush = newValue;
+}
+
+bool ODBCAppender::getBackgroundFlush() const
+{
+	return _priv->backgroundFlush;
+}
+
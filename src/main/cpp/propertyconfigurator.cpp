@@ -48,6 +48,50 @@ using namespace LOG4CXX_NS::config;
 using namespace LOG4CXX_NS::rolling;
 
 #include <log4cxx/helpers/filewatchdog.h>
+namespace
+{
+bool loadProperties(const File& configFileName, Properties& props)
+{
+	try
+	{
+		InputStreamPtr inputStream = InputStreamPtr( new FileInputStream(configFileName) );
+		props.load(inputStream);
+	}
+	catch (const IOException& ex)
+	{
+		LOG4CXX_DECODE_CHAR(lsMsg, ex.what());
+		LogLog::error(((LogString) LOG4CXX_STR("Could not read configuration file ["))
+			+ configFileName.getPath() + LOG4CXX_STR("]: ") + lsMsg);
+		return false;
+	}
+	return true;
+}
+
+// Are the values of \c key and the keys that start with \c key + "." the same in \c lhs and \c rhs?
+bool isSameDefinition(const Properties& lhs, const Properties& rhs, const LogString& key)
+{
+	auto isPartOf = [&key](const LogString& name) -> bool
+	{
+		return name == key
+			|| (key.size() < name.size() && name.compare(0, key.size(), key) == 0 && name[key.size()] == 0x2E /* '.' */);
+	};
+	std::map<LogString, LogString> lhsDefinition;
+	for (auto& name : lhs.propertyNames())
+	{
+		if (isPartOf(name))
+			lhsDefinition[name] = lhs.getProperty(name);
+	}
+	std::map<LogString, LogString> rhsDefinition;
+	for (auto& name : rhs.propertyNames())
+	{
+		if (isPartOf(name))
+			rhsDefinition[name] = rhs.getProperty(name);
+	}
+	return lhsDefinition == rhsDefinition;
+}
+
+} // namespace
+
 namespace LOG4CXX_NS
 {
 class PropertyWatchdog  : public FileWatchdog
@@ -61,12 +105,36 @@ class PropertyWatchdog  : public FileWatchdog
 		Call PropertyConfigurator#doConfigure(const String& configFileName,
 		const spi::LoggerRepositoryPtr& hierarchy) with the
 		<code>filename</code> to reconfigure log4cxx.
+
+		When the <b>log4j.incrementalReload</b> option is true,
+		use PropertyConfigurator#doReconfigure
+		to apply only the changes made since the previous load.
 		*/
 		void doOnChange()
 		{
-			PropertyConfigurator().doConfigure(file(),
-				LogManager::getLoggerRepository());
+			static const WideLife<LogString> INCREMENTAL_KEY(LOG4CXX_STR("log4j.incrementalReload"));
+			auto current = std::make_unique<Properties>();
+			if (!loadProperties(file(), *current))
+				return;
+			LogLog::debug(LOG4CXX_STR("Loading configuration file [")
+				+ file().getPath() + LOG4CXX_STR("]."));
+			try
+			{
+				if (previous && OptionConverter::toBoolean(current->getProperty(INCREMENTAL_KEY), false))
+					PropertyConfigurator().doReconfigure(*previous, *current, LogManager::getLoggerRepository());
+				else
+					PropertyConfigurator().doConfigure(*current, LogManager::getLoggerRepository());
+				previous = std::move(current);
+			}
+			catch (const std::exception& ex)
+			{
+				LogLog::error(((LogString) LOG4CXX_STR("Could not parse configuration file ["))
+					+ file().getPath() + LOG4CXX_STR("]: "), ex);
+			}
 		}
+
+	private:
+		std::unique_ptr<Properties> previous; //!< The most recently applied configuration
 };
 }
 
@@ -91,16 +159,8 @@ spi::ConfigurationStatus PropertyConfigurator::doConfigure(const File& configFil
 
 	Properties props;
 
-	try
+	if (!loadProperties(configFileName, props))
 	{
-		InputStreamPtr inputStream = InputStreamPtr( new FileInputStream(configFileName) );
-		props.load(inputStream);
-	}
-	catch (const IOException& ex)
-	{
-		LOG4CXX_DECODE_CHAR(lsMsg, ex.what());
-		LogLog::error(((LogString) LOG4CXX_STR("Could not read configuration file ["))
-			+ configFileName.getPath() + LOG4CXX_STR("]: ") + lsMsg);
 		return spi::ConfigurationStatus::NotConfigured;
 	}
 
@@ -213,6 +273,64 @@ spi::ConfigurationStatus PropertyConfigurator::doConfigure(helpers::Properties&
 	return spi::ConfigurationStatus::Configured;
 }
 
+spi::ConfigurationStatus PropertyConfigurator::doReconfigure(helpers::Properties& previous,
+	helpers::Properties& current, spi::LoggerRepositoryPtr hierarchy)
+{
+	static const WideLife<LogString> APPENDER_PREFIX(LOG4CXX_STR("log4j.appender."));
+	static const WideLife<LogString> CATEGORY_PREFIX(LOG4CXX_STR("log4j.category."));
+	static const WideLife<LogString> LOGGER_PREFIX(LOG4CXX_STR("log4j.logger."));
+	static const WideLife<LogString> THRESHOLD_PREFIX(LOG4CXX_STR("log4j.threshold"));
+
+	// Retain the attached appenders that have an unchanged definition
+	auto loggers = hierarchy->getCurrentLoggers();
+	loggers.push_back(hierarchy->getRootLogger());
+	for (auto& logger : loggers)
+	{
+		for (auto& appender : logger->getAllAppenders())
+		{
+			auto appenderName = appender->getName();
+			if (appenderName.empty() || registry->find(appenderName) != registry->end())
+				continue;
+			if (isSameDefinition(previous, current, APPENDER_PREFIX.value() + appenderName))
+			{
+				LogLog::debug((LogString) LOG4CXX_STR("Retaining unchanged appender \"")
+					+ appenderName + LOG4CXX_STR("\"."));
+				registryPut(appender);
+			}
+		}
+	}
+
+	// Restore the default state of loggers that are no longer configured
+	for (auto& key : previous.propertyNames())
+	{
+		LogString loggerName;
+		if (key.find(CATEGORY_PREFIX) == 0)
+			loggerName = key.substr(CATEGORY_PREFIX.value().length());
+		else if (key.find(LOGGER_PREFIX) == 0)
+			loggerName = key.substr(LOGGER_PREFIX.value().length());
+		else
+			continue;
+		if (!current.getProperty(CATEGORY_PREFIX.value() + loggerName).empty()
+			|| !current.getProperty(LOGGER_PREFIX.value() + loggerName).empty())
+			continue;
+		if (auto logger = hierarchy->exists(loggerName))
+		{
+			LogLog::debug((LogString) LOG4CXX_STR("Resetting unconfigured logger \"")
+				+ loggerName + LOG4CXX_STR("\"."));
+			logger->setLevel(0);
+			logger->reconfigure(std::vector<AppenderPtr>(), true);
+		}
+	}
+
+	if (!previous.getProperty(THRESHOLD_PREFIX).empty()
+		&& current.getProperty(THRESHOLD_PREFIX).empty())
+	{
+		hierarchy->setThreshold(Level::getAll());
+	}
+
+	return doConfigure(current, hierarchy);
+}
+
 void PropertyConfigurator::configureLoggerFactory(helpers::Properties& props)
 {
 	static const WideLife<LogString> LOGGER_FACTORY_KEY(LOG4CXX_STR("log4j.loggerFactory"));
@@ -26,8 +26,17 @@
 #include <log4cxx/rolling/timebasedrollingpolicy.h>
 #include <log4cxx/rolling/sizebasedtriggeringpolicy.h>
 #include <log4cxx/helpers/transcoder.h>
+#include <log4cxx/helpers/bufferedwriter.h>
+#include <log4cxx/helpers/threadutility.h>
 #include <log4cxx/private/fileappender_priv.h>
+#include <log4cxx/private/log4cxx_private.h>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
+#if LOG4CXX_HAS_FALLOCATE
+#include <fcntl.h>
+#include <apr_portable.h>
+#endif
 
 using namespace LOG4CXX_NS;
 using namespace LOG4CXX_NS::rolling;
@@ -59,12 +68,210 @@ struct RollingFileAppender::RollingFileAppenderPriv : public FileAppenderPriv
 	 *  save the loggingevent
 	 */
 	spi::LoggingEventPtr _event;
+
+	~RollingFileAppenderPriv()
+	{
+		stopHelper();
+	}
+
+	/**
+	 * Is the next active file created before it is required?
+	 */
+	bool preOpenNextFile = false;
+
+	/**
+	 * The number of bytes reserved in the next active file.
+	 */
+	size_t preallocateSize = 0;
+
+	/**
+	 * The file (and its name) to use at the next rollover.
+	 */
+	OutputStreamPtr spareStream;
+	LogString spareFileName;
+
+	/**
+	 * The name of the file the helper thread should create.
+	 */
+	LogString requestedFileName;
+
+	/**
+	 * Asynchronous rollover actions waiting for the helper thread.
+	 */
+	std::vector<ActionPtr> pendingActions;
+
+	bool stopping = false;
+	std::mutex helperMutex;
+	std::condition_variable helperChanged;
+	std::thread helper;
+
+	/**
+	 * Create the spare file and run asynchronous rollover actions until stopHelper is called.
+	 */
+	void prepareFiles();
+
+	/**
+	 * Wait for pending actions to complete then remove any spare file.
+	 */
+	void stopHelper();
+
+	/**
+	 * Ask the helper thread to create a spare file in the directory of \c activeFile.
+	 */
+	void requestSpareFile(const LogString& activeFile);
+
+	void restoreSpareFile(const OutputStreamPtr& stream, const LogString& fileName);
+
+	void queueAsynchronousAction(const RolloverDescriptionPtr& rollover1);
 };
 
 #define _priv static_cast<RollingFileAppenderPriv*>(m_priv.get())
 
-IMPLEMENT_LOG4CXX_OBJECT(RollingFileAppender)
+void RollingFileAppender::RollingFileAppenderPriv::prepareFiles()
+{
+	Pool p;
+	std::unique_lock<std::mutex> lock(helperMutex);
+
+	for (;;)
+	{
+		helperChanged.wait(lock, [this]()
+		{
+			return stopping || !pendingActions.empty() || !requestedFileName.empty();
+		});
+
+		if (stopping && pendingActions.empty())
+		{
+			break;
+		}
+
+		std::vector<ActionPtr> actions;
+		actions.swap(pendingActions);
+		LogString fileName;
+		fileName.swap(requestedFileName);
+		lock.unlock();
+
+		for (auto& action : actions)
+		{
+			try
+			{
+				action->execute(p);
+			}
+			catch (std::exception& ex)
+			{
+				LOG4CXX_DECODE_CHAR(lsMsg, ex.what());
+				LogLog::warn(LOG4CXX_STR("Exception during rollover: ") + lsMsg);
+			}
+		}
+
+		OutputStreamPtr stream;
+
+		if (!fileName.empty())
+		{
+			try
+			{
+				auto fos = std::make_shared<FileOutputStream>(fileName, false);
+#if LOG4CXX_HAS_FALLOCATE
+				apr_os_file_t fd;
+
+				if (0 < preallocateSize && APR_SUCCESS == apr_os_file_get(&fd, fos->getFilePtr()))
+				{
+					// Reserve the space without changing the file length
+					if (0 != fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, (off_t)preallocateSize))
+					{
+						LogLog::debug(LOG4CXX_STR("fallocate failed for ") + fileName);
+					}
+				}
+#endif
+				stream = fos;
+			}
+			catch (std::exception&)
+			{
+				LogLog::warn(LOG4CXX_STR("Unable to create ") + fileName);
+			}
+		}
+
+		lock.lock();
+
+		if (stream)
+		{
+			spareStream = stream;
+			spareFileName = fileName;
+		}
+	}
+}
+
+void RollingFileAppender::RollingFileAppenderPriv::stopHelper()
+{
+	{
+		std::lock_guard<std::mutex> lock(helperMutex);
+		stopping = true;
+		helperChanged.notify_all();
+	}
+
+	if (helper.joinable())
+	{
+		helper.join();
+	}
+
+	if (spareStream)
+	{
+		Pool p;
+
+		try
+		{
+			spareStream->close(p);
+		}
+		catch (std::exception&)
+		{
+		}
+
+		File().setPath(spareFileName).deleteFile(p);
+		spareStream.reset();
+		spareFileName.clear();
+	}
+}
+
+void RollingFileAppender::RollingFileAppenderPriv::requestSpareFile(const LogString& activeFile)
+{
+	std::lock_guard<std::mutex> lock(helperMutex);
+
+	stopping = false;
 
+	if (!helper.joinable())
+	{
+		helper = ThreadUtility::instance()->createThread( LOG4CXX_STR("RollingFileAppender"), &RollingFileAppenderPriv::prepareFiles, this );
+	}
+
+	requestedFileName = activeFile + LOG4CXX_STR(".next");
+	helperChanged.notify_all();
+}
+
+/**
+ * Return an unused spare file to the helper thread.
+ */
+void RollingFileAppender::RollingFileAppenderPriv::restoreSpareFile(const OutputStreamPtr& stream, const LogString& fileName)
+{
+	std::lock_guard<std::mutex> lock(helperMutex);
+	spareStream = stream;
+	spareFileName = fileName;
+}
+
+/**
+ * Have the helper thread do the compression and other asynchronous actions of \c rollover1.
+ */
+void RollingFileAppender::RollingFileAppenderPriv::queueAsynchronousAction(const RolloverDescriptionPtr& rollover1)
+{
+	ActionPtr asyncAction(rollover1->getAsynchronous());
+
+	if (asyncAction != NULL)
+	{
+		std::lock_guard<std::mutex> lock(helperMutex);
+		pendingActions.push_back(asyncAction);
+		helperChanged.notify_all();
+	}
+}
+
+IMPLEMENT_LOG4CXX_OBJECT(RollingFileAppender)
 
 /**
  * Construct a new instance.
@@ -95,6 +302,16 @@ void RollingFileAppender::setOption(const LogString& option, const LogString& va
 	{
 		setDatePattern(value);
 	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXX_STR("PREOPENNEXTFILE"), LOG4CXX_STR("preopennextfile")))
+	{
+		setPreOpenNextFile(OptionConverter::toBoolean(value, false));
+	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXX_STR("PREALLOCATESIZE"), LOG4CXX_STR("preallocatesize")))
+	{
+		setPreallocateSize((size_t)OptionConverter::toFileSize(value, 0));
+	}
 	else
 	{
 		FileAppender::setOption(option, value);
@@ -145,6 +362,28 @@ void RollingFileAppender::setMaxFileSize(const LogString& value)
 	setMaximumFileSize(OptionConverter::toFileSize(value, long(getMaximumFileSize() + 1)));
 }
 
+bool RollingFileAppender::getPreOpenNextFile() const
+{
+	return _priv->preOpenNextFile;
+}
+
+void RollingFileAppender::setPreOpenNextFile(bool newValue)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->preOpenNextFile = newValue;
+}
+
+size_t RollingFileAppender::getPreallocateSize() const
+{
+	return _priv->preallocateSize;
+}
+
+void RollingFileAppender::setPreallocateSize(size_t newValue)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->preallocateSize = newValue;
+}
+
 LogString RollingFileAppender::makeFileNamePattern(const LogString& datePattern)
 {
 	LogString result(getFile());
@@ -264,6 +503,11 @@ void RollingFileAppender::activateOptions(Pool& p)
 			File activeFile;
 			activeFile.setPath(getFile());
 
+			if (_priv->preOpenNextFile)
+			{
+				_priv->requestSpareFile(getFile());
+			}
+
 			if (getAppend())
 			{
 				_priv->fileLength = activeFile.length(p);
@@ -302,6 +546,7 @@ void RollingFileAppender::activateOptions(Pool& p)
 bool RollingFileAppender::rollover(Pool& p)
 {
 	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	AppenderMetrics::ScopedTimer timer(_priv->getMetrics(), AppenderMetrics::RolloverDuration);
 	return rolloverInternal(p);
 }
 
@@ -320,6 +565,11 @@ bool RollingFileAppender::rolloverInternal(Pool& p)
 
 					if (rollover1 != NULL)
 					{
+						if (_priv->preOpenNextFile && rolloverToSpareFile(rollover1, p))
+						{
+							return true;
+						}
+
 						if (rollover1->getActiveFileName() == getFile())
 						{
 							closeWriter();
@@ -466,6 +716,7 @@ void RollingFileAppender::subAppend(const LoggingEventPtr& event, Pool& p)
 		try
 		{
 			_priv->_event = event;
+			AppenderMetrics::ScopedTimer timer(_priv->getMetrics(), AppenderMetrics::RolloverDuration);
 			rolloverInternal(p);
 		}
 		catch (std::exception& ex)
@@ -519,6 +770,102 @@ void RollingFileAppender::setTriggeringPolicy(const TriggeringPolicyPtr& policy)
 void RollingFileAppender::close()
 {
 	FileAppender::close();
+	_priv->stopHelper();
+}
+
+/**
+ * Switch to the file prepared by the helper thread.
+ * @return false if no file was available and the writer is unchanged.
+ */
+bool RollingFileAppender::rolloverToSpareFile(const RolloverDescriptionPtr& rollover1, Pool& p)
+{
+	OutputStreamPtr spareStream;
+	LogString spareFileName;
+	{
+		std::lock_guard<std::mutex> lock(_priv->helperMutex);
+		spareStream.swap(_priv->spareStream);
+		spareFileName.swap(_priv->spareFileName);
+	}
+
+	const LogString& activeFileName = rollover1->getActiveFileName();
+
+	if (!spareStream)
+	{
+		_priv->requestSpareFile(activeFileName);
+		return false;
+	}
+
+	closeWriter();
+
+	bool success = true;
+
+	if (rollover1->getSynchronous() != NULL)
+	{
+		success = false;
+
+		try
+		{
+			success = rollover1->getSynchronous()->execute(p);
+		}
+		catch (std::exception& ex)
+		{
+			LOG4CXX_DECODE_CHAR(lsMsg, ex.what());
+			LogString errorMsg = LOG4CXX_STR("Exception on rollover: ");
+			errorMsg.append(lsMsg);
+			LogLog::error(errorMsg);
+			_priv->errorHandler->error(lsMsg, ex, 0);
+		}
+	}
+
+	if (!success)
+	{
+		// As in rolloverInternal, keep appending to the file that could not be rolled
+		_priv->restoreSpareFile(spareStream, spareFileName);
+		setFileInternal(activeFileName, true, _priv->bufferedIO, _priv->bufferSize, p);
+		_priv->fileLength = File().setPath(activeFileName).length(p);
+		return true;
+	}
+
+	// The spare file replaces the active file only when nothing would be overwritten
+	File activeFile;
+	activeFile.setPath(activeFileName);
+
+	if (activeFile.exists(p)
+		|| !File().setPath(spareFileName).renameTo(activeFile, p))
+	{
+		_priv->restoreSpareFile(spareStream, spareFileName);
+		setFileInternal(activeFileName, rollover1->getAppend(), _priv->bufferedIO, _priv->bufferSize, p);
+		_priv->fileLength = rollover1->getAppend()
+			? File().setPath(activeFileName).length(p)
+			: 0;
+		_priv->queueAsynchronousAction(rollover1);
+		return true;
+	}
+
+	if (!_priv->gzip && StringHelper::equalsIgnoreCase(getEncoding(),
+			LOG4CXX_STR("utf-16"), LOG4CXX_STR("UTF-16")))
+	{
+		char bom[] = { (char) 0xFE, (char) 0xFF };
+		ByteBuffer buf(bom, 2);
+		spareStream->write(buf, p);
+	}
+
+	WriterPtr newWriter(createWriter(spareStream));
+
+	if (_priv->bufferedIO && !_priv->drainStream)
+	{
+		newWriter = std::make_shared<BufferedWriter>(newWriter, _priv->bufferSize);
+	}
+
+	setFileInternal(activeFileName);
+	setWriterInternal(newWriter);
+	_priv->fileLength = 0;
+	writeHeader(p);
+
+	_priv->queueAsynchronousAction(rollover1);
+	_priv->requestSpareFile(activeFileName);
+
+	return true;
 }
 
 namespace LOG4CXX_NS
@@ -598,7 +945,8 @@ class CountingOutputStream : public OutputStream
  */
 WriterPtr RollingFileAppender::createWriter(OutputStreamPtr& os)
 {
-	OutputStreamPtr cos = std::make_shared<CountingOutputStream>(os, this);
+	OutputStreamPtr dos = _priv->prepareFileStream(os);
+	OutputStreamPtr cos = std::make_shared<CountingOutputStream>(dos, this);
 	return FileAppender::createWriter(cos);
 }
 
@@ -0,0 +1,694 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/routingappender.h>
+#include <log4cxx/fileappender.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/helpers/appendermetrics.h>
+#include <log4cxx/helpers/class.h>
+#include <log4cxx/helpers/loglog.h>
+#include <log4cxx/helpers/optionconverter.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/threadutility.h>
+#include <log4cxx/private/appenderskeleton_priv.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::helpers;
+using namespace LOG4CXX_NS::spi;
+
+namespace
+{
+
+// Nanoseconds, so the least recently used route is seldom ambiguous
+int64_t currentTime()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>
+		(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// FNV-1a, which does not depend on the character type of LogString
+size_t getHash(const LogString& key)
+{
+	uint64_t result = 14695981039346656037ULL;
+	for (auto ch : key)
+	{
+		result ^= uint64_t(ch);
+		result *= 1099511628211ULL;
+	}
+	return size_t(result);
+}
+
+// The output of a route key
+struct Route
+{
+	Route(const LogString& key1, size_t hash1)
+		: key(key1)
+		, hash(hash1)
+		, lastUsed(0)
+	{
+	}
+
+	const LogString key;
+	const size_t hash;
+	/** Guards appender and opened */
+	std::mutex mutex;
+	/** Null while the file is closed */
+	FileAppenderPtr appender;
+	/** Has the file been opened before? */
+	bool opened = false;
+	/** The steady clock time (in nanoseconds) of the last event */
+	std::atomic<int64_t> lastUsed;
+};
+
+// The options in effect since activateOptions was called, which are read without a lock
+struct RouteOptions
+{
+	LayoutPtr routeLayout;
+	LayoutPtr layout;
+	LogString fileNamePattern;
+	LogString defaultRoute;
+	const Class* appenderClass;
+	std::vector<std::pair<LogString, LogString>> childOptions;
+	size_t maxOpenFiles;
+	size_t maxRoutes;
+	int idleTimeout;
+};
+
+// An open addressing hash table that is read without a lock
+struct RouteTable
+{
+	RouteTable(size_t capacity)
+		: mask(capacity - 1)
+		, slots(new std::atomic<Route*>[capacity])
+		, count(0)
+	{
+		for (size_t i = 0; i < capacity; ++i)
+			slots[i].store(nullptr, std::memory_order_relaxed);
+	}
+
+	Route* find(const LogString& key, size_t hash) const
+	{
+		for (auto i = hash & mask;; i = (i + 1) & mask)
+		{
+			auto route = slots[i].load(std::memory_order_acquire);
+			if (!route || (route->hash == hash && route->key == key))
+				return route;
+		}
+	}
+
+	void insert(Route* route)
+	{
+		auto i = route->hash & mask;
+		while (slots[i].load(std::memory_order_relaxed))
+			i = (i + 1) & mask;
+		slots[i].store(route, std::memory_order_release);
+		++count;
+	}
+
+	const size_t mask;
+	std::unique_ptr<std::atomic<Route*>[]> slots;
+	size_t count;
+};
+
+} // namespace
+
+struct RoutingAppender::RoutingAppenderPriv : public AppenderSkeleton::AppenderSkeletonPrivate
+{
+	RoutingAppenderPriv()
+		: AppenderSkeletonPrivate()
+		, defaultRoute(LOG4CXX_STR("default"))
+		, appenderClass(LOG4CXX_STR("FileAppender"))
+		, options(nullptr)
+		, table(nullptr)
+		, openCount(0)
+		, active(false)
+	{
+	}
+
+	~RoutingAppenderPriv()
+	{
+		stopCloser();
+	}
+
+	LogString routePattern;
+	LogString fileNamePattern;
+	LogString defaultRoute;
+	LogString appenderClass;
+	int maxOpenFiles = 100;
+	int maxRoutes = 1000;
+	int idleTimeout = 0;
+	/** The options applied to each FileAppender */
+	std::vector<std::pair<LogString, LogString>> childOptions;
+
+	/** The options used by events, replaced by activateOptions */
+	std::atomic<const RouteOptions*> options;
+	/** Each version of the options, retained so a concurrent event's version remains valid */
+	std::vector<std::unique_ptr<const RouteOptions>> optionVersions;
+
+	/** The current version of the route table */
+	std::atomic<RouteTable*> table;
+	/** Guards routes, tables and overflowReported */
+	std::mutex routesMutex;
+	/** Every route, at most MaxRoutes plus the default route */
+	std::vector<std::unique_ptr<Route>> routes;
+	/** Each version of the route table, retained so a reader's version remains valid.
+	 *  Each version doubles the size of the previous one, so their total size is bounded by MaxRoutes. */
+	std::vector<std::unique_ptr<RouteTable>> tables;
+	/** Has the use of the default route for keys beyond MaxRoutes been reported? */
+	bool overflowReported = false;
+
+	/** Guards openRoutes */
+	std::mutex lruMutex;
+	/** The routes with an open file */
+	std::vector<Route*> openRoutes;
+	std::atomic<size_t> openCount;
+
+	/** Are events accepted? Cleared by close() */
+	std::atomic<bool> active;
+
+	bool stopping = false;
+	std::mutex closerMutex;
+	std::condition_variable closerWakeup;
+	std::thread closer;
+
+	Route* getRoute(const RouteOptions& opts, const LoggingEventPtr& event, Pool& p);
+	Route* addRoute(const RouteOptions& opts, const LogString& key, size_t hash);
+	/** Called with routesMutex held */
+	Route* addRouteInternal(const LogString& key, size_t hash);
+	void route(const LoggingEventPtr& event, Pool& p);
+	FileAppenderPtr createAppender(const RouteOptions& opts, Route& route, Pool& p);
+	LogString getFileName(const RouteOptions& opts, const LogString& key) const;
+	void closeLeastRecentlyUsed(const RouteOptions& opts);
+	void closeIdleFiles();
+	void closeAll();
+	void stopCloser();
+};
+
+IMPLEMENT_LOG4CXX_OBJECT(RoutingAppender)
+
+#define _priv static_cast<RoutingAppenderPriv*>(m_priv.get())
+
+RoutingAppender::RoutingAppender()
+	: AppenderSkeleton(std::make_unique<RoutingAppenderPriv>())
+{
+}
+
+RoutingAppender::~RoutingAppender()
+{
+	finalize();
+}
+
+void RoutingAppender::setOption(const LogString& option, const LogString& value)
+{
+	if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("ROUTE"), LOG4CXX_STR("route")))
+	{
+		setRoute(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("FILENAMEPATTERN"), LOG4CXX_STR("filenamepattern")))
+	{
+		setFileNamePattern(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("DEFAULTROUTE"), LOG4CXX_STR("defaultroute")))
+	{
+		setDefaultRoute(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("APPENDERCLASS"), LOG4CXX_STR("appenderclass")))
+	{
+		setAppenderClass(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("MAXOPENFILES"), LOG4CXX_STR("maxopenfiles")))
+	{
+		setMaxOpenFiles(OptionConverter::toInt(value, 100));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("MAXROUTES"), LOG4CXX_STR("maxroutes")))
+	{
+		setMaxRoutes(OptionConverter::toInt(value, 1000));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("IDLETIMEOUT"), LOG4CXX_STR("idletimeout")))
+	{
+		setIdleTimeout(OptionConverter::toInt(value, 0));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("THRESHOLD"), LOG4CXX_STR("threshold"))
+		|| StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("METRICS"), LOG4CXX_STR("metrics"))
+		|| StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("METRICSLOGGER"), LOG4CXX_STR("metricslogger"))
+		|| StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("METRICSINTERVAL"), LOG4CXX_STR("metricsinterval")))
+	{
+		AppenderSkeleton::setOption(option, value);
+	}
+	else
+	{
+		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+		_priv->childOptions.emplace_back(option, value);
+	}
+}
+
+void RoutingAppender::activateOptions(Pool& p)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->active = false;
+	_priv->stopCloser();
+	_priv->closeAll();
+	if (_priv->routePattern.empty())
+	{
+		_priv->errorHandler->error(LOG4CXX_STR("No Route is set for RoutingAppender named [")
+			+ _priv->name + LOG4CXX_STR("]."));
+		return;
+	}
+	if (_priv->fileNamePattern.empty())
+	{
+		_priv->errorHandler->error(LOG4CXX_STR("No FileNamePattern is set for RoutingAppender named [")
+			+ _priv->name + LOG4CXX_STR("]."));
+		return;
+	}
+	auto sample = OptionConverter::instantiateByClassName(_priv->appenderClass, FileAppender::getStaticClass(), ObjectPtr());
+	if (!sample)
+	{
+		_priv->errorHandler->error(LOG4CXX_STR("AppenderClass [") + _priv->appenderClass
+			+ LOG4CXX_STR("] of RoutingAppender named [") + _priv->name + LOG4CXX_STR("] is not a FileAppender."));
+		return;
+	}
+	auto opts = std::make_unique<RouteOptions>();
+	opts->routeLayout = std::make_shared<PatternLayout>(_priv->routePattern);
+	opts->layout = _priv->layout;
+	opts->fileNamePattern = _priv->fileNamePattern;
+	opts->defaultRoute = _priv->defaultRoute;
+	opts->appenderClass = &sample->getClass();
+	opts->childOptions = _priv->childOptions;
+	opts->maxOpenFiles = size_t(_priv->maxOpenFiles);
+	opts->maxRoutes = size_t(_priv->maxRoutes);
+	opts->idleTimeout = _priv->idleTimeout;
+	_priv->options.store(opts.get(), std::memory_order_release);
+	_priv->optionVersions.push_back(std::move(opts));
+	{
+		// Existing routes are kept as a concurrent event may hold one
+		std::lock_guard<std::mutex> routesLock(_priv->routesMutex);
+		if (_priv->tables.empty())
+		{
+			_priv->tables.push_back(std::make_unique<RouteTable>(64));
+			_priv->table.store(_priv->tables.back().get(), std::memory_order_release);
+		}
+	}
+	if (0 < _priv->idleTimeout)
+	{
+		_priv->stopping = false;
+		_priv->closer = ThreadUtility::instance()->createThread( LOG4CXX_STR("RoutingAppender"), &RoutingAppenderPriv::closeIdleFiles, _priv );
+	}
+	_priv->active = true;
+	AppenderSkeleton::activateOptions(p);
+}
+
+void RoutingAppender::doAppend(const LoggingEventPtr& event, Pool& p)
+{
+	// Only the lock of the event's route is taken
+	if (!_priv->isAccepted(event))
+		return;
+	if (!_priv->active.load(std::memory_order_acquire))
+	{
+		LogLog::error(LOG4CXX_STR("Attempted to append to closed or inactive appender named [")
+			+ _priv->name + LOG4CXX_STR("]."));
+		return;
+	}
+	auto metrics = _priv->getMetrics();
+	{
+		AppenderMetrics::ScopedTimer timer(metrics, AppenderMetrics::AppendLatency);
+		_priv->route(event, p);
+	}
+	if (metrics)
+	{
+		metrics->add(AppenderMetrics::EventsAppended);
+		_priv->reportMetricsIfDue();
+	}
+}
+
+void RoutingAppender::append(const LoggingEventPtr& event, Pool& p)
+{
+	if (_priv->active.load(std::memory_order_acquire))
+		_priv->route(event, p);
+}
+
+void RoutingAppender::close()
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	if (_priv->closed)
+		return;
+	_priv->closed = true;
+	_priv->active = false;
+	_priv->stopCloser();
+	_priv->closeAll();
+}
+
+void RoutingAppender::RoutingAppenderPriv::route(const LoggingEventPtr& event, Pool& p)
+{
+	auto opts = options.load(std::memory_order_acquire);
+	if (!opts)
+		return;
+	auto pRoute = getRoute(*opts, event, p);
+	if (!pRoute)
+		return;
+	bool added = false;
+	size_t count = 0;
+	{
+		std::lock_guard<std::mutex> lock(pRoute->mutex);
+		if (!pRoute->appender)
+		{
+			if (!active.load(std::memory_order_acquire))
+				return;
+			pRoute->appender = createAppender(*opts, *pRoute, p);
+			pRoute->opened = true;
+			std::lock_guard<std::mutex> lruLock(lruMutex);
+			openRoutes.push_back(pRoute);
+			added = true;
+			// Counted while the route is locked so a concurrent close is counted afterwards
+			count = ++openCount;
+		}
+		pRoute->lastUsed.store(currentTime(), std::memory_order_relaxed);
+		pRoute->appender->doAppend(event, p);
+	}
+	if (added && opts->maxOpenFiles < count)
+		closeLeastRecentlyUsed(*opts);
+}
+
+Route* RoutingAppender::RoutingAppenderPriv::getRoute(const RouteOptions& opts, const LoggingEventPtr& event, Pool& p)
+{
+	LogString key;
+	opts.routeLayout->format(key, event, p);
+	if (key.empty())
+		key = opts.defaultRoute;
+	auto hash = getHash(key);
+	auto pTable = table.load(std::memory_order_acquire);
+	if (!pTable)
+		return nullptr;
+	auto result = pTable->find(key, hash);
+	if (!result)
+		result = addRoute(opts, key, hash);
+	return result;
+}
+
+Route* RoutingAppender::RoutingAppenderPriv::addRoute(const RouteOptions& opts, const LogString& key, size_t hash)
+{
+	std::lock_guard<std::mutex> lock(routesMutex);
+	if (tables.empty())
+		return nullptr;
+	auto pTable = tables.back().get();
+	if (auto result = pTable->find(key, hash))
+		return result;
+	if (opts.maxRoutes <= routes.size() && key != opts.defaultRoute)
+	{
+		// Further keys share the file of the default route
+		if (!overflowReported)
+		{
+			overflowReported = true;
+			LogLog::warn(LOG4CXX_STR("RoutingAppender named [") + name
+				+ LOG4CXX_STR("] has reached MaxRoutes, so new route keys use the default route."));
+		}
+		auto defaultHash = getHash(opts.defaultRoute);
+		if (auto result = pTable->find(opts.defaultRoute, defaultHash))
+			return result;
+		return addRouteInternal(opts.defaultRoute, defaultHash);
+	}
+	return addRouteInternal(key, hash);
+}
+
+Route* RoutingAppender::RoutingAppenderPriv::addRouteInternal(const LogString& key, size_t hash)
+{
+	auto pTable = tables.back().get();
+	routes.push_back(std::make_unique<Route>(key, hash));
+	auto result = routes.back().get();
+	// Keep at least half the slots empty so probe sequences stay short
+	if (pTable->mask + 1 < (pTable->count + 1) * 2)
+	{
+		tables.push_back(std::make_unique<RouteTable>((pTable->mask + 1) * 2));
+		pTable = tables.back().get();
+		for (auto& item : routes)
+			pTable->insert(item.get());
+		table.store(pTable, std::memory_order_release);
+	}
+	else
+		pTable->insert(result);
+	return result;
+}
+
+FileAppenderPtr RoutingAppender::RoutingAppenderPriv::createAppender(const RouteOptions& opts, Route& route, Pool& p)
+{
+	auto result = LOG4CXX_NS::cast<FileAppender>(ObjectPtr(opts.appenderClass->newInstance()));
+	result->setName(name + LOG4CXX_STR(".") + route.key);
+	result->setLayout(opts.layout);
+	// Set first, as a subclass may derive option values (such as backup file names) from it
+	result->setFile(getFileName(opts, route.key));
+	for (auto& option : opts.childOptions)
+		result->setOption(option.first, option.second);
+	if (route.opened)
+		result->setAppend(true);
+	result->activateOptions(p);
+	return result;
+}
+
+LogString RoutingAppender::RoutingAppenderPriv::getFileName(const RouteOptions& opts, const LogString& key) const
+{
+	// Prevent the key from selecting another directory
+	LogString safeKey(key);
+	for (auto& ch : safeKey)
+	{
+		if (ch == 0x2F /* '/' */ || ch == 0x5C /* '\\' */ || ch == 0x3A /* ':' */ || ch < 0x20)
+			ch = 0x5F; // '_'
+	}
+	if (!safeKey.empty() && safeKey[0] == 0x2E /* '.' */)
+		safeKey[0] = 0x5F;
+
+	const LogString placeholder(LOG4CXX_STR("{route}"));
+	LogString result(opts.fileNamePattern);
+	for (auto pos = result.find(placeholder); pos != LogString::npos; pos = result.find(placeholder, pos + safeKey.size()))
+		result.replace(pos, placeholder.size(), safeKey);
+	return result;
+}
+
+void RoutingAppender::RoutingAppenderPriv::closeLeastRecentlyUsed(const RouteOptions& opts)
+{
+	Route* victim = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(lruMutex);
+		if (openRoutes.size() <= opts.maxOpenFiles)
+			return;
+		auto pVictim = openRoutes.begin();
+		for (auto pItem = openRoutes.begin(); pItem != openRoutes.end(); ++pItem)
+		{
+			if ((*pItem)->lastUsed.load(std::memory_order_relaxed) < (*pVictim)->lastUsed.load(std::memory_order_relaxed))
+				pVictim = pItem;
+		}
+		victim = *pVictim;
+		*pVictim = openRoutes.back();
+		openRoutes.pop_back();
+	}
+	// The route lock is not taken while holding lruMutex, which is taken while holding a route lock
+	FileAppenderPtr appender;
+	{
+		std::lock_guard<std::mutex> lock(victim->mutex);
+		std::swap(appender, victim->appender);
+	}
+	if (appender)
+	{
+		--openCount;
+		appender->close();
+	}
+}
+
+void RoutingAppender::RoutingAppenderPriv::closeIdleFiles()
+{
+	std::unique_lock<std::mutex> lock(closerMutex);
+	auto idleTimeout = options.load(std::memory_order_acquire)->idleTimeout;
+	auto interval = std::chrono::milliseconds(std::max(idleTimeout / 2, 10));
+	while (!stopping)
+	{
+		closerWakeup.wait_for(lock, interval);
+		if (stopping)
+			break;
+		auto cutoff = currentTime() - int64_t(idleTimeout) * 1000000;
+		std::vector<Route*> idleRoutes;
+		{
+			std::lock_guard<std::mutex> lruLock(lruMutex);
+			for (auto pItem = openRoutes.begin(); pItem != openRoutes.end();)
+			{
+				if ((*pItem)->lastUsed.load(std::memory_order_relaxed) < cutoff)
+				{
+					idleRoutes.push_back(*pItem);
+					*pItem = openRoutes.back();
+					openRoutes.pop_back();
+				}
+				else
+					++pItem;
+			}
+		}
+		for (auto pRoute : idleRoutes)
+		{
+			FileAppenderPtr appender;
+			{
+				std::lock_guard<std::mutex> routeLock(pRoute->mutex);
+				if (cutoff <= pRoute->lastUsed.load(std::memory_order_relaxed))
+				{
+					// Used since it was selected
+					std::lock_guard<std::mutex> lruLock(lruMutex);
+					openRoutes.push_back(pRoute);
+					continue;
+				}
+				std::swap(appender, pRoute->appender);
+			}
+			if (appender)
+			{
+				--openCount;
+				appender->close();
+			}
+		}
+	}
+}
+
+void RoutingAppender::RoutingAppenderPriv::closeAll()
+{
+	std::vector<FileAppenderPtr> appenders;
+	{
+		std::lock_guard<std::mutex> routesLock(routesMutex);
+		for (auto& pRoute : routes)
+		{
+			std::lock_guard<std::mutex> lock(pRoute->mutex);
+			if (pRoute->appender)
+			{
+				appenders.push_back(std::move(pRoute->appender));
+				pRoute->appender.reset();
+			}
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lruLock(lruMutex);
+		openRoutes.clear();
+	}
+	openCount -= appenders.size();
+	for (auto& appender : appenders)
+		appender->close();
+}
+
+void RoutingAppender::RoutingAppenderPriv::stopCloser()
+{
+	{
+		std::lock_guard<std::mutex> lock(closerMutex);
+		stopping = true;
+		closerWakeup.notify_all();
+	}
+	if (closer.joinable())
+		closer.join();
+}
+
+void RoutingAppender::setRoute(const LogString& pattern)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->routePattern = pattern;
+}
+
+LogString RoutingAppender::getRoute() const
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	return _priv->routePattern;
+}
+
+void RoutingAppender::setFileNamePattern(const LogString& pattern)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->fileNamePattern = pattern;
+}
+
+LogString RoutingAppender::getFileNamePattern() const
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	return _priv->fileNamePattern;
+}
+
+void RoutingAppender::setDefaultRoute(const LogString& key)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->defaultRoute = key;
+}
+
+LogString RoutingAppender::getDefaultRoute() const
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	return _priv->defaultRoute;
+}
+
+void RoutingAppender::setAppenderClass(const LogString& className)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->appenderClass = className;
+}
+
+LogString RoutingAppender::getAppenderClass() const
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	return _priv->appenderClass;
+}
+
+void RoutingAppender::setMaxOpenFiles(int count)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->maxOpenFiles = std::max(count, 1);
+}
+
+int RoutingAppender::getMaxOpenFiles() const
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	return _priv->maxOpenFiles;
+}
+
+void RoutingAppender::setMaxRoutes(int count)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->maxRoutes = std::max(count, 1);
+}
+
+int RoutingAppender::getMaxRoutes() const
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	return _priv->maxRoutes;
+}
+
+void RoutingAppender::setIdleTimeout(int milliseconds)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->idleTimeout = std::max(milliseconds, 0);
+}
+
+int RoutingAppender::getIdleTimeout() const
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	return _priv->idleTimeout;
+}
+
+size_t RoutingAppender::getRouteCount() const
+{
+	std::lock_guard<std::mutex> lock(_priv->routesMutex);
+	return _priv->routes.size();
+}
+
+size_t RoutingAppender::getOpenFileCount() const
+{
+	return _priv->openCount.load(std::memory_order_relaxed);
+}
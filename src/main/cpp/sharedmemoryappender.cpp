@@ -0,0 +1,190 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/net/sharedmemoryappender.h>
+#include <log4cxx/net/binaryeventencoder.h>
+#include <log4cxx/helpers/appendermetrics.h>
+#include <log4cxx/helpers/loglog.h>
+#include <log4cxx/helpers/optionconverter.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/private/appenderskeleton_priv.h>
+#include <log4cxx/private/sharedmemoryring.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::helpers;
+using namespace LOG4CXX_NS::net;
+
+struct SharedMemoryAppender::SharedMemoryAppenderPriv : public AppenderSkeleton::AppenderSkeletonPrivate
+{
+	SharedMemoryAppenderPriv()
+		: AppenderSkeletonPrivate()
+		, sharedMemoryName(LOG4CXX_STR("/log4cxx"))
+		, bufferSize(4 * 1024 * 1024)
+	{
+		// Each record must be decodable on its own.
+		// Without a name table, encode() does not modify the encoder
+		// so concurrent threads can use it.
+		encoder.setInternNames(false);
+	}
+
+	LogString sharedMemoryName;
+	size_t bufferSize;
+	BinaryEventEncoder encoder;
+
+	/**
+	The mapping that events are added to, or null when closed.
+	Read without the appender lock.
+	*/
+	std::atomic<SharedMemoryRing*> ring{nullptr};
+
+	/**
+	Each mapping made by activateOptions.
+	Retained until the appender is destroyed, as a logging thread may still be using a replaced mapping.
+	*/
+	std::vector<std::unique_ptr<SharedMemoryRing>> rings;
+};
+
+IMPLEMENT_LOG4CXX_OBJECT(SharedMemoryAppender)
+
+#define _priv static_cast<SharedMemoryAppenderPriv*>(m_priv.get())
+
+SharedMemoryAppender::SharedMemoryAppender()
+	: AppenderSkeleton(std::make_unique<SharedMemoryAppenderPriv>())
+{
+}
+
+SharedMemoryAppender::~SharedMemoryAppender()
+{
+	finalize();
+}
+
+void SharedMemoryAppender::setOption(const LogString& option, const LogString& value)
+{
+	if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("SHAREDMEMORYNAME"), LOG4CXX_STR("sharedmemoryname")))
+	{
+		setSharedMemoryName(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("BUFFERSIZE"), LOG4CXX_STR("buffersize")))
+	{
+		setBufferSize(OptionConverter::toFileSize(value, 4 * 1024 * 1024));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("LOCATIONINFO"), LOG4CXX_STR("locationinfo")))
+	{
+		setLocationInfo(OptionConverter::toBoolean(value, false));
+	}
+	else
+	{
+		AppenderSkeleton::setOption(option, value);
+	}
+}
+
+void SharedMemoryAppender::activateOptions(Pool& p)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	try
+	{
+		_priv->rings.push_back(std::make_unique<SharedMemoryRing>(_priv->sharedMemoryName, _priv->bufferSize));
+		_priv->ring.store(_priv->rings.back().get(), std::memory_order_release);
+	}
+	catch (IOException& e)
+	{
+		_priv->ring.store(nullptr, std::memory_order_release);
+		_priv->errorHandler->error(LOG4CXX_STR("Unable to open shared memory ") + _priv->sharedMemoryName, e, spi::ErrorCode::FILE_OPEN_FAILURE);
+	}
+	AppenderSkeleton::activateOptions(p);
+}
+
+void SharedMemoryAppender::close()
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->closed = true;
+	_priv->ring.store(nullptr, std::memory_order_release);
+}
+
+void SharedMemoryAppender::doAppend(const spi::LoggingEventPtr& event, Pool& p)
+{
+	// The ring buffer reserves space for each writer, so the appender lock is not needed
+	if (!_priv->ring.load(std::memory_order_acquire) || !_priv->isAccepted(event))
+		return;
+
+	auto metrics = _priv->getMetrics();
+	{
+		AppenderMetrics::ScopedTimer timer(metrics, AppenderMetrics::AppendLatency);
+		append(event, p);
+	}
+	if (metrics)
+	{
+		metrics->add(AppenderMetrics::EventsAppended);
+		_priv->reportMetricsIfDue();
+	}
+}
+
+void SharedMemoryAppender::append(const spi::LoggingEventPtr& event, Pool& /* p */)
+{
+	auto ring = _priv->ring.load(std::memory_order_acquire);
+	if (!ring)
+		return;
+	thread_local std::string bytes;
+	bytes.clear();
+	_priv->encoder.encode(event, bytes);
+	if (!ring->publish(bytes.data(), bytes.size()))
+	{
+		if (auto metrics = _priv->getMetrics())
+			metrics->add(AppenderMetrics::Discards);
+	}
+}
+
+void SharedMemoryAppender::setSharedMemoryName(const LogString& name)
+{
+	_priv->sharedMemoryName = name;
+}
+
+LogString SharedMemoryAppender::getSharedMemoryName() const
+{
+	return _priv->sharedMemoryName;
+}
+
+void SharedMemoryAppender::setBufferSize(size_t byteCount)
+{
+	_priv->bufferSize = byteCount;
+}
+
+size_t SharedMemoryAppender::getBufferSize() const
+{
+	return _priv->bufferSize;
+}
+
+void SharedMemoryAppender::setLocationInfo(bool newValue)
+{
+	_priv->encoder.setLocationInfo(newValue);
+}
+
+bool SharedMemoryAppender::getLocationInfo() const
+{
+	return _priv->encoder.getLocationInfo();
+}
+
+uint64_t SharedMemoryAppender::getDiscardCount() const
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	auto ring = _priv->ring.load(std::memory_order_acquire);
+	return ring ? ring->getDiscardCount() : 0;
+}
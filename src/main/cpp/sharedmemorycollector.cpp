@@ -0,0 +1,158 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/net/sharedmemorycollector.h>
+#include <log4cxx/net/binaryeventdecoder.h>
+#include <log4cxx/net/binaryeventencoder.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/helpers/loglog.h>
+#include <log4cxx/helpers/threadutility.h>
+#include <log4cxx/private/sharedmemoryring.h>
+#include <log4cxx/logger.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::helpers;
+using namespace LOG4CXX_NS::net;
+using namespace LOG4CXX_NS::spi;
+
+namespace
+{
+// The longest (in milliseconds) the background thread waits when there are no events
+const int MaximumPollInterval = 20;
+// The number of events passed to the appenders between checks for closure
+const size_t BatchSize = 1000;
+}
+
+struct SharedMemoryCollector::SharedMemoryCollectorPrivate
+{
+	SharedMemoryCollectorPrivate(const LogString& name, const LoggerRepositoryPtr& repository)
+		: name(name)
+		, repository(repository)
+		, bufferSize(4 * 1024 * 1024)
+		, closed(false)
+		, eventCount(0)
+	{}
+
+	// Prepare the decoder for a sequence of self-contained records
+	void resetDecoder()
+	{
+		decoder.reset();
+		std::string header;
+		BinaryEventEncoder::encodeHeader(header);
+		decoder.append(header.data(), header.size());
+	}
+
+	LogString name;
+	LoggerRepositoryPtr repository;
+	size_t bufferSize;
+	std::unique_ptr<SharedMemoryRing> ring;
+	BinaryEventDecoder decoder;
+	std::atomic<bool> closed;
+	std::atomic<size_t> eventCount;
+	std::thread collector;
+	Pool pool;
+};
+
+SharedMemoryCollector::SharedMemoryCollector(const LogString& name, const LoggerRepositoryPtr& repository)
+	: m_priv(std::make_unique<SharedMemoryCollectorPrivate>(name, repository))
+{
+}
+
+SharedMemoryCollector::~SharedMemoryCollector()
+{
+	close();
+}
+
+void SharedMemoryCollector::setBufferSize(size_t byteCount)
+{
+	m_priv->bufferSize = byteCount;
+}
+
+void SharedMemoryCollector::start()
+{
+	if (m_priv->collector.joinable())
+		return;
+	m_priv->ring = std::make_unique<SharedMemoryRing>(m_priv->name, m_priv->bufferSize);
+	m_priv->resetDecoder();
+	m_priv->closed = false;
+	m_priv->collector = ThreadUtility::instance()->createThread( LOG4CXX_STR("SharedMemoryCollector"), &SharedMemoryCollector::collectEvents, this );
+}
+
+void SharedMemoryCollector::close()
+{
+	m_priv->closed = true;
+	if (m_priv->collector.joinable())
+		m_priv->collector.join();
+	if (m_priv->ring)
+	{
+		while (0 < drain(BatchSize))
+			;
+		m_priv->ring.reset();
+	}
+}
+
+size_t SharedMemoryCollector::getEventCount() const
+{
+	return m_priv->eventCount;
+}
+
+uint64_t SharedMemoryCollector::getDiscardCount() const
+{
+	return m_priv->ring ? m_priv->ring->getDiscardCount() : 0;
+}
+
+void SharedMemoryCollector::collectEvents()
+{
+	int pollInterval = 1;
+	while (!m_priv->closed)
+	{
+		if (0 < drain(BatchSize))
+			pollInterval = 1;
+		else
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(pollInterval));
+			pollInterval = std::min(pollInterval * 2, MaximumPollInterval);
+		}
+	}
+}
+
+size_t SharedMemoryCollector::drain(size_t maxRecords)
+{
+	return m_priv->ring->consume([this](const char* data, size_t size)
+	{
+		try
+		{
+			m_priv->decoder.append(data, size);
+			while (auto event = m_priv->decoder.next())
+			{
+				++m_priv->eventCount;
+				auto logger = m_priv->repository->getLogger(event->getLoggerName());
+				if (event->getLevel()->isGreaterOrEqual(logger->getEffectiveLevel()))
+					logger->callAppenders(event, m_priv->pool);
+			}
+		}
+		catch (IOException& e)
+		{
+			LogLog::warn(LOG4CXX_STR("Discarded an invalid shared memory record"), e);
+			m_priv->resetDecoder();
+		}
+	}, maxRecords);
+}
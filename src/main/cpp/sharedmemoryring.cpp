@@ -0,0 +1,413 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/private/sharedmemoryring.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/helpers/loglog.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::helpers;
+
+namespace
+{
+// The value of RingHeader::magic once the ring is initialized ("L4SR")
+const uint32_t Magic = 0x5253344C;
+const uint32_t Version = 2;
+const size_t MinimumCapacity = 4096;
+// Each record starts with an 8 byte word holding the record state and the data size
+const size_t RecordHeaderSize = sizeof(uint64_t);
+const uint64_t Reserved = 1;
+const uint64_t Committed = 2;
+const uint64_t Padding = 3;
+// How long an uncommitted record can block the reader before the writers are checked
+const std::chrono::seconds AbandonedRecordTimeout(5);
+// The number of SharedMemoryRing instances that can have the ring open for writing
+const size_t MaxWriters = 64;
+// The WriterSlot::pid value while the reader releases the slot of a process that ended
+const int32_t ReleasingSlot = -1;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory requires lock-free atomics");
+
+// The writers in each epoch that may be writing to the record area
+struct alignas(64) WriterSlot
+{
+	std::atomic<int32_t> pid;
+	std::atomic<uint32_t> active[2];
+};
+
+// The start of the shared memory object. The record area follows.
+struct RingHeader
+{
+	std::atomic<uint32_t> magic;
+	uint32_t version;
+	uint64_t capacity;
+	// The write position, where the next record will be reserved
+	alignas(64) std::atomic<uint64_t> reserved;
+	// The read position, the start of the oldest record
+	alignas(64) std::atomic<uint64_t> readPosition;
+	alignas(64) std::atomic<uint64_t> discards;
+	// Incremented by the reader before it checks which writers are still active
+	alignas(64) std::atomic<uint64_t> epoch;
+	WriterSlot writers[MaxWriters];
+};
+const size_t DataOffset = (sizeof(RingHeader) + 63) & ~size_t(63);
+
+uint64_t recordWord(uint64_t state, size_t size)
+{
+	return (state << 32) | uint64_t(size);
+}
+
+size_t recordSize(size_t dataSize)
+{
+	return (RecordHeaderSize + dataSize + 7) & ~size_t(7);
+}
+
+bool processEnded(int32_t pid)
+{
+	return kill(pid_t(pid), 0) != 0 && ESRCH == errno;
+}
+
+// Decrements the writer count when publish returns
+struct ActiveWriter
+{
+	std::atomic<uint32_t>* count;
+	~ActiveWriter()
+	{
+		count->fetch_sub(1, std::memory_order_release);
+	}
+};
+
+} // namespace
+
+struct SharedMemoryRing::SharedMemoryRingPrivate
+{
+	RingHeader* header = nullptr;
+	char* data = nullptr;
+	size_t mapSize = 0;
+	uint64_t mask = 0;
+	// The slot that counts the active publish calls of this instance
+	WriterSlot* slot = nullptr;
+	// The position at which the reader was last blocked and when it started
+	uint64_t blockedPosition = UINT64_MAX;
+	std::chrono::steady_clock::time_point blockedSince;
+	// The epoch whose writers the reader is waiting on and the write position when it ended
+	bool draining = false;
+	uint64_t drainingEpoch = 0;
+	uint64_t fencePosition = 0;
+
+	std::atomic<uint64_t>* recordHeader(uint64_t offset)
+	{
+		return reinterpret_cast<std::atomic<uint64_t>*>(data + offset);
+	}
+
+	WriterSlot* claimWriterSlot();
+
+	bool writersFinished(uint64_t position);
+
+	void clear(uint64_t position, uint64_t length);
+};
+
+/**
+ * Use a free slot or one left by a process that ended.
+ */
+WriterSlot* SharedMemoryRing::SharedMemoryRingPrivate::claimWriterSlot()
+{
+	auto self = int32_t(getpid());
+	for (auto& slot : header->writers)
+	{
+		auto pid = slot.pid.load(std::memory_order_acquire);
+		if ((0 == pid || (0 < pid && processEnded(pid)))
+			&& slot.pid.compare_exchange_strong(pid, self, std::memory_order_acq_rel))
+		{
+			slot.active[0].store(0, std::memory_order_relaxed);
+			slot.active[1].store(0, std::memory_order_release);
+			return &slot;
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * Has every writer that could be writing the record at \c position finished or ended?
+ *
+ * A writer can be descheduled for any length of time between reserving space and committing it,
+ * so the record is only abandoned when no live process has a publish call
+ * that started before the reader last changed the epoch.
+ */
+bool SharedMemoryRing::SharedMemoryRingPrivate::writersFinished(uint64_t position)
+{
+	auto now = std::chrono::steady_clock::now();
+	if (blockedPosition != position)
+	{
+		blockedPosition = position;
+		blockedSince = now;
+		return false;
+	}
+	if (now - blockedSince < AbandonedRecordTimeout)
+		return false;
+	if (!draining)
+	{
+		// Space reserved before this position was reserved in the current epoch or earlier
+		fencePosition = header->reserved.load(std::memory_order_seq_cst);
+		drainingEpoch = header->epoch.fetch_add(1, std::memory_order_seq_cst);
+		draining = true;
+	}
+	auto index = drainingEpoch & 1;
+	for (auto& slot : header->writers)
+	{
+		auto pid = slot.pid.load(std::memory_order_acquire);
+		if (pid <= 0 || 0 == slot.active[index].load(std::memory_order_seq_cst))
+			continue;
+		if (!processEnded(pid))
+			return false;
+		// Release the slot of the process that ended
+		if (slot.pid.compare_exchange_strong(pid, ReleasingSlot, std::memory_order_acq_rel))
+		{
+			slot.active[0].store(0, std::memory_order_relaxed);
+			slot.active[1].store(0, std::memory_order_relaxed);
+			slot.pid.store(0, std::memory_order_release);
+		}
+	}
+	draining = false;
+	// A record reserved after the epoch changed needs another check
+	return position < fencePosition;
+}
+
+/**
+ * Zero fill the record area from \c position, as writers require.
+ */
+void SharedMemoryRing::SharedMemoryRingPrivate::clear(uint64_t position, uint64_t length)
+{
+	auto offset = position & mask;
+	auto contiguous = std::min(length, mask + 1 - offset);
+	std::memset(data + offset, 0, size_t(contiguous));
+	std::memset(data, 0, size_t(length - contiguous));
+}
+
+SharedMemoryRing::SharedMemoryRing(const LogString& name, size_t requestedCapacity)
+	: m_priv(std::make_unique<SharedMemoryRingPrivate>())
+{
+	LOG4CXX_ENCODE_CHAR(objectName, name);
+	bool created = true;
+	int fd = shm_open(objectName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0 && EEXIST == errno)
+	{
+		created = false;
+		fd = shm_open(objectName.c_str(), O_RDWR, 0600);
+	}
+	if (fd < 0)
+		throw IOException(errno);
+
+	size_t capacity = MinimumCapacity;
+	while (capacity < requestedCapacity)
+		capacity *= 2;
+	if (created)
+	{
+		m_priv->mapSize = DataOffset + capacity;
+		if (ftruncate(fd, m_priv->mapSize) != 0)
+		{
+			auto err = errno;
+			::close(fd);
+			shm_unlink(objectName.c_str());
+			throw IOException(err);
+		}
+	}
+	else
+	{
+		// Wait for the creating process to set the size
+		struct stat info;
+		for (int i = 0; i < 100 && fstat(fd, &info) == 0 && info.st_size < off_t(DataOffset + MinimumCapacity); ++i)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		m_priv->mapSize = size_t(info.st_size);
+		if (m_priv->mapSize < DataOffset + MinimumCapacity)
+		{
+			::close(fd);
+			throw IOException(LOG4CXX_STR("Shared memory object ") + name + LOG4CXX_STR(" is not a ring buffer"));
+		}
+	}
+
+	auto address = mmap(nullptr, m_priv->mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	auto err = errno;
+	::close(fd);
+	if (MAP_FAILED == address)
+		throw IOException(err);
+	m_priv->header = static_cast<RingHeader*>(address);
+	m_priv->data = static_cast<char*>(address) + DataOffset;
+
+	auto h = m_priv->header;
+	if (created)
+	{
+		// The object is zero filled, so only the size fields need to be set
+		h->version = Version;
+		h->capacity = capacity;
+		h->magic.store(Magic, std::memory_order_release);
+	}
+	else
+	{
+		for (int i = 0; i < 100 && h->magic.load(std::memory_order_acquire) != Magic; ++i)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		if (h->magic.load(std::memory_order_acquire) != Magic
+			|| h->version != Version
+			|| m_priv->mapSize < DataOffset + h->capacity)
+		{
+			munmap(address, m_priv->mapSize);
+			throw IOException(LOG4CXX_STR("Shared memory object ") + name + LOG4CXX_STR(" is not a compatible ring buffer"));
+		}
+		capacity = size_t(h->capacity);
+	}
+	m_priv->mask = capacity - 1;
+	m_priv->slot = m_priv->claimWriterSlot();
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+	if (m_priv->slot)
+		m_priv->slot->pid.store(0, std::memory_order_release);
+	munmap(m_priv->header, m_priv->mapSize);
+}
+
+bool SharedMemoryRing::publish(const char* bytes, size_t size)
+{
+	auto h = m_priv->header;
+	auto capacity = m_priv->mask + 1;
+	auto required = recordSize(size);
+	auto slot = m_priv->slot;
+	if (!slot || UINT32_MAX < size || capacity < required)
+	{
+		h->discards.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	// Count this call in the current epoch so the reader waits for it
+	auto epoch = h->epoch.load(std::memory_order_seq_cst);
+	for (;;)
+	{
+		slot->active[epoch & 1].fetch_add(1, std::memory_order_seq_cst);
+		auto current = h->epoch.load(std::memory_order_seq_cst);
+		if (current == epoch)
+			break;
+		slot->active[epoch & 1].fetch_sub(1, std::memory_order_release);
+		epoch = current;
+	}
+	ActiveWriter active{&slot->active[epoch & 1]};
+
+	// Reserve the space, including any padding needed to avoid wrapping the record
+	auto position = h->reserved.load(std::memory_order_relaxed);
+	uint64_t offset, total;
+	do
+	{
+		offset = position & m_priv->mask;
+		auto contiguous = capacity - offset;
+		total = (required <= contiguous) ? required : contiguous + required;
+		if (capacity < position + total - h->readPosition.load(std::memory_order_acquire))
+		{
+			h->discards.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+	}
+	while (!h->reserved.compare_exchange_weak(position, position + total, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+	if (total != required)
+	{
+		m_priv->recordHeader(offset)->store(recordWord(Padding, size_t(total - required)), std::memory_order_release);
+		offset = 0;
+	}
+	auto recordHeader = m_priv->recordHeader(offset);
+	recordHeader->store(recordWord(Reserved, size), std::memory_order_relaxed);
+	std::memcpy(m_priv->data + offset + RecordHeaderSize, bytes, size);
+	recordHeader->store(recordWord(Committed, size), std::memory_order_release);
+	return true;
+}
+
+size_t SharedMemoryRing::consume(const std::function<void(const char*, size_t)>& consumer, size_t maxRecords)
+{
+	auto h = m_priv->header;
+	auto position = h->readPosition.load(std::memory_order_relaxed);
+	size_t count = 0;
+	while (count < maxRecords && position != h->reserved.load(std::memory_order_acquire))
+	{
+		auto offset = position & m_priv->mask;
+		auto word = m_priv->recordHeader(offset)->load(std::memory_order_acquire);
+		auto state = word >> 32;
+		auto size = size_t(word & UINT32_MAX);
+		size_t length;
+		if (Padding == state)
+			length = size;
+		else if (Committed == state)
+		{
+			length = recordSize(size);
+			consumer(m_priv->data + offset + RecordHeaderSize, size);
+			++count;
+		}
+		else
+		{
+			// The record is being written
+			if (!m_priv->writersFinished(position))
+				break;
+			word = m_priv->recordHeader(offset)->load(std::memory_order_acquire);
+			state = word >> 32;
+			if (Committed == state || Padding == state)
+				continue;
+			if (Reserved == state)
+			{
+				LogLog::warn(LOG4CXX_STR("Skipped a shared memory record that was not committed"));
+				length = recordSize(size_t(word & UINT32_MAX));
+			}
+			else
+			{
+				// The writer ended before recording the size, so the following records cannot be found
+				LogLog::warn(LOG4CXX_STR("Skipped shared memory records that followed a record with no header"));
+				length = m_priv->fencePosition - position;
+			}
+			h->discards.fetch_add(1, std::memory_order_relaxed);
+		}
+		// Writers require the space to be zero filled
+		m_priv->clear(position, length);
+		position += length;
+		h->readPosition.store(position, std::memory_order_release);
+	}
+	return count;
+}
+
+size_t SharedMemoryRing::getCapacity() const
+{
+	return size_t(m_priv->mask + 1);
+}
+
+uint64_t SharedMemoryRing::getDiscardCount() const
+{
+	return m_priv->header->discards.load(std::memory_order_relaxed);
+}
+
+void SharedMemoryRing::unlink(const LogString& name)
+{
+	LOG4CXX_ENCODE_CHAR(objectName, name);
+	shm_unlink(objectName.c_str());
+}
@@ -24,6 +24,7 @@
 #include <log4cxx/helpers/stringtokenizer.h>
 #include <log4cxx/helpers/transcoder.h>
 #include <log4cxx/helpers/loader.h>
+#include <log4cxx/helpers/threadutility.h>
 #if !defined(LOG4CXX)
 	#define LOG4CXX 1
 #endif
@@ -32,6 +33,10 @@
 
 
 #include <apr_strings.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 using namespace LOG4CXX_NS;
@@ -381,7 +386,8 @@ struct SMTPAppender::SMTPPriv : public AppenderSkeletonPrivate
 		bufferSize(512),
 		locationInfo(false),
 		cb(bufferSize),
-		evaluator(new DefaultEvaluator()) {}
+		evaluator(new DefaultEvaluator()),
+		spare(bufferSize) {}
 
 	SMTPPriv(spi::TriggeringEventEvaluatorPtr evaluator) :
 		AppenderSkeletonPrivate(),
@@ -389,7 +395,8 @@ struct SMTPAppender::SMTPPriv : public AppenderSkeletonPrivate
 		bufferSize(512),
 		locationInfo(false),
 		cb(bufferSize),
-		evaluator(evaluator) {}
+		evaluator(evaluator),
+		spare(bufferSize) {}
 
 	LogString to;
 	LogString cc;
@@ -404,6 +411,29 @@ struct SMTPAppender::SMTPPriv : public AppenderSkeletonPrivate
 	bool locationInfo;
 	helpers::CyclicBuffer cb;
 	spi::TriggeringEventEvaluatorPtr evaluator;
+
+	using Clock = std::chrono::steady_clock;
+	/** Send e-mail on a background thread? */
+	bool backgroundSend = false;
+	/** Milliseconds to collect further triggering events before sending */
+	int coalesceInterval = 0;
+	/** Minimum milliseconds between e-mails */
+	int minimumSendInterval = 0;
+
+	/** The buffer exchanged with cb when sending in the background */
+	helpers::CyclicBuffer spare;
+	/** Guards cb, spare and the trigger state when sending in the background */
+	std::mutex bufferMutex;
+	std::condition_variable bufferChanged;
+	bool triggered = false;
+	bool stopping = false;
+	Clock::time_point firstTrigger;
+	Clock::time_point lastSend;
+	std::thread sender;
+
+	void send(helpers::CyclicBuffer& events, Pool& p);
+	void sendTriggeredBuffers();
+	void stopSender();
 };
 
 #define _priv static_cast<SMTPPriv*>(m_priv.get())
@@ -562,6 +592,18 @@ void SMTPAppender::setOption(const LogString& option,
 	{
 		setSMTPPort(OptionConverter::toInt(value, 25));
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("BACKGROUNDSEND"), LOG4CXX_STR("backgroundsend")))
+	{
+		setBackgroundSend(OptionConverter::toBoolean(value, false));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("COALESCEINTERVAL"), LOG4CXX_STR("coalesceinterval")))
+	{
+		setCoalesceInterval(OptionConverter::toInt(value, 0));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("MINIMUMSENDINTERVAL"), LOG4CXX_STR("minimumsendinterval")))
+	{
+		setMinimumSendInterval(OptionConverter::toInt(value, 0));
+	}
 	else
 	{
 		AppenderSkeleton::setOption(option, value);
@@ -630,6 +672,12 @@ void SMTPAppender::activateOptions(Pool& p)
 	if (activate)
 	{
 		AppenderSkeleton::activateOptions(p);
+		if (_priv->backgroundSend && !_priv->sender.joinable())
+		{
+			_priv->stopping = false;
+			_priv->lastSend = SMTPPriv::Clock::time_point();
+			_priv->sender = ThreadUtility::instance()->createThread( LOG4CXX_STR("SMTPAppender"), &SMTPPriv::sendTriggeredBuffers, _priv );
+		}
 	}
 }
 
@@ -650,6 +698,20 @@ void SMTPAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 	// Get a copy of this thread's MDC.
 	event->getMDCCopy();
 
+	if (_priv->sender.joinable())
+	{
+		bool trigger = _priv->evaluator->isTriggeringEvent(event);
+		std::lock_guard<std::mutex> lock(_priv->bufferMutex);
+		_priv->cb.add(event);
+		if (trigger && !_priv->triggered)
+		{
+			_priv->triggered = true;
+			_priv->firstTrigger = SMTPPriv::Clock::now();
+			_priv->bufferChanged.notify_all();
+		}
+		return;
+	}
+
 	_priv->cb.add(event);
 
 	if (_priv->evaluator->isTriggeringEvent(event))
@@ -697,6 +759,7 @@ bool SMTPAppender::checkEntryConditions()
 
 void SMTPAppender::close()
 {
+	_priv->stopSender();
 	_priv->closed = true;
 }
 
@@ -735,39 +798,97 @@ Send the contents of the cyclic buffer as an e-mail message.
 */
 void SMTPAppender::sendBuffer(Pool& p)
 {
-#if LOG4CXX_HAVE_LIBESMTP
-
 	// Note: this code already owns the monitor for this
 	// appender. This frees us from needing to synchronize on 'cb'.
+	_priv->send(_priv->cb, p);
+}
+
+/**
+Send and remove the content of \c events as an e-mail message.
+*/
+void SMTPAppender::SMTPPriv::send(CyclicBuffer& events, Pool& p)
+{
+#if LOG4CXX_HAVE_LIBESMTP
 	try
 	{
 		LogString sbuf;
-		_priv->layout->appendHeader(sbuf, p);
+		this->layout->appendHeader(sbuf, p);
 
-		int len = _priv->cb.length();
+		int len = events.length();
 
 		for (int i = 0; i < len; i++)
 		{
-			LoggingEventPtr event = _priv->cb.get();
-			_priv->layout->format(sbuf, event, p);
+			LoggingEventPtr event = events.get();
+			this->layout->format(sbuf, event, p);
 		}
 
-		_priv->layout->appendFooter(sbuf, p);
+		this->layout->appendFooter(sbuf, p);
 
-		SMTPSession session(_priv->smtpHost, _priv->smtpPort, _priv->smtpUsername, _priv->smtpPassword, p);
+		SMTPSession session(this->smtpHost, this->smtpPort, this->smtpUsername, this->smtpPassword, p);
 
-		SMTPMessage message(session, _priv->from, _priv->to, _priv->cc,
-			_priv->bcc, _priv->subject, sbuf, p);
+		SMTPMessage message(session, this->from, this->to, this->cc,
+			this->bcc, this->subject, sbuf, p);
 
 		session.send(p);
 
 	}
 	catch (std::exception& e)
 	{
-		_priv->errorHandler->error(LOG4CXX_STR("Error occured while sending e-mail to [") + _priv->smtpHost + LOG4CXX_STR("]."), e, 0);
+		this->errorHandler->error(LOG4CXX_STR("Error occured while sending e-mail to [") + this->smtpHost + LOG4CXX_STR("]."), e, 0);
 	}
-
 #endif
+	while (0 < events.length())
+		events.get();
+}
+
+/**
+Wait for a triggering event, then send the buffered events
+once the coalesce and minimum send intervals have elapsed.
+The buffer is exchanged with an empty one
+so logging threads are not delayed while the e-mail is sent.
+*/
+void SMTPAppender::SMTPPriv::sendTriggeredBuffers()
+{
+	std::unique_lock<std::mutex> lock(this->bufferMutex);
+	while (this->triggered || !this->stopping)
+	{
+		if (!this->triggered)
+		{
+			this->bufferChanged.wait(lock);
+			continue;
+		}
+		auto sendTime = std::max
+			( this->firstTrigger + std::chrono::milliseconds(this->coalesceInterval)
+			, this->lastSend + std::chrono::milliseconds(this->minimumSendInterval)
+			);
+		if (!this->stopping && Clock::now() < sendTime)
+		{
+			this->bufferChanged.wait_until(lock, sendTime);
+			continue;
+		}
+		if (this->spare.getMaxSize() != this->bufferSize)
+			this->spare.resize(this->bufferSize);
+		this->cb.swap(this->spare);
+		this->triggered = false;
+		lock.unlock();
+
+		Pool p;
+		send(this->spare, p);
+
+		lock.lock();
+		this->lastSend = Clock::now();
+	}
+}
+
+void SMTPAppender::SMTPPriv::stopSender()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->bufferMutex);
+		this->stopping = true;
+		this->bufferChanged.notify_all();
+	}
+	if (this->sender.joinable())
+		this->sender.join();
 }
 
 /**
@@ -797,6 +918,7 @@ buffer. By default the size of the cyclic buffer is 512 events.
 */
 void SMTPAppender::setBufferSize(int sz)
 {
+	std::lock_guard<std::mutex> lock(_priv->bufferMutex);
 	_priv->bufferSize = sz;
 	_priv->cb.resize(sz);
 }
@@ -818,3 +940,33 @@ int SMTPAppender::getBufferSize() const
 {
 	return _priv->bufferSize;
 }
+
+void SMTPAppender::setBackgroundSend(bool newValue)
+{
+	_priv->backgroundSend = newValue;
+}
+
+bool SMTPAppender::getBackgroundSend() const
+{
+	return _priv->backgroundSend;
+}
+
+void SMTPAppender::setCoalesceInterval(int milliseconds)
+{
+	_priv->coalesceInterval = milliseconds;
+}
+
+int SMTPAppender::getCoalesceInterval() const
+{
+	return _priv->coalesceInterval;
+}
+
+void SMTPAppender::setMinimumSendInterval(int milliseconds)
+{
+	_priv->minimumSendInterval = milliseconds;
+}
+
+int SMTPAppender::getMinimumSendInterval() const
+{
+	return _priv->minimumSendInterval;
+}
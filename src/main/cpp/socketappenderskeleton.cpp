@@ -23,11 +23,13 @@
 #include <log4cxx/spi/loggingevent.h>
 #include <log4cxx/helpers/transcoder.h>
 #include <log4cxx/helpers/bytearrayoutputstream.h>
+#include <log4cxx/helpers/bytebuffer.h>
 #include <log4cxx/helpers/threadutility.h>
 #include <log4cxx/private/appenderskeleton_priv.h>
 #include <log4cxx/private/socketappenderskeleton_priv.h>
 #include <functional>
 #include <chrono>
+#include <algorithm>
 
 using namespace LOG4CXX_NS;
 using namespace LOG4CXX_NS::helpers;
@@ -35,6 +37,12 @@ using namespace LOG4CXX_NS::net;
 
 #define _priv static_cast<SocketAppenderSkeletonPriv*>(m_priv.get())
 
+namespace
+{
+// The size of the buffer used to combine queued events into a single send
+const size_t MaxBatchSize = 64 * 1024;
+}
+
 SocketAppenderSkeleton::SocketAppenderSkeleton(int defaultPort, int reconnectionDelay)
     : AppenderSkeleton(std::make_unique<SocketAppenderSkeletonPriv>(defaultPort, reconnectionDelay))
 {
@@ -63,7 +71,24 @@ SocketAppenderSkeleton::~SocketAppenderSkeleton()
 void SocketAppenderSkeleton::activateOptions(Pool& p)
 {
 	AppenderSkeleton::activateOptions(p);
-	connect(p);
+	if (_priv->backgroundSend && _priv->address == 0)
+	{
+		LogLog::error(LogString(LOG4CXX_STR("No remote host is set for Appender named \"")) +
+			_priv->name + LOG4CXX_STR("\"."));
+	}
+	else if (_priv->backgroundSend)
+	{
+		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+		cleanUp(p);
+		if (!_priv->thread.joinable())
+		{
+			_priv->thread = ThreadUtility::instance()->createThread( LOG4CXX_STR("SocketSend"), &SocketAppenderSkeleton::sendQueuedEvents, this );
+		}
+	}
+	else
+	{
+		connect(p);
+	}
 }
 
 void SocketAppenderSkeleton::close()
@@ -141,6 +166,18 @@ void SocketAppenderSkeleton::setOption(const LogString& option, const LogString&
 	{
 		setReconnectionDelay(OptionConverter::toInt(value, getDefaultDelay()));
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("BACKGROUNDSEND"), LOG4CXX_STR("backgroundsend")))
+	{
+		setBackgroundSend(OptionConverter::toBoolean(value, false));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("MAXQUEUESIZE"), LOG4CXX_STR("maxqueuesize")))
+	{
+		setMaxQueueSize((size_t) OptionConverter::toFileSize(value, 1024 * 1024));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("REPLAYBUFFERSIZE"), LOG4CXX_STR("replaybuffersize")))
+	{
+		setReplayBufferSize((size_t) OptionConverter::toFileSize(value, 64 * 1024));
+	}
 	else
 	{
 		AppenderSkeleton::setOption(option, value);
@@ -216,6 +253,167 @@ bool SocketAppenderSkeleton::is_closed()
 	return _priv->closed;
 }
 
+bool SocketAppenderSkeleton::enqueue(std::string&& bytes)
+{
+	std::lock_guard<std::mutex> lock(_priv->interrupt_mutex);
+	if (_priv->maxQueueSize < _priv->queuedBytes + bytes.size())
+	{
+		++_priv->discardCount;
+		if (auto metrics = _priv->getMetrics())
+			metrics->add(AppenderMetrics::Discards);
+		return false;
+	}
+	_priv->queuedBytes += bytes.size();
+	_priv->queue.push_back(std::move(bytes));
+	if (auto metrics = _priv->getMetrics())
+		metrics->setQueueDepth(_priv->queue.size());
+	if (1 == _priv->queue.size())
+		_priv->interrupt.notify_all();
+	return true;
+}
+
+void SocketAppenderSkeleton::sendQueuedEvents()
+{
+	Pool p;
+	SocketPtr socket;
+	std::deque<std::string> batch;
+	std::vector<char> buffer;
+	size_t replayBytes = 0;
+	bool headerRequired = false;
+	bool finished = false;
+
+	while (!finished)
+	{
+		if (!socket)
+		{
+			if (is_closed())
+				break;
+			try
+			{
+				socket = Socket::create(_priv->address, _priv->port);
+				LogLog::debug(LOG4CXX_STR("Connection established to [")
+					+ _priv->address->toString() + LOG4CXX_STR("]."));
+			}
+			catch (IOException& e)
+			{
+				LogString msg(LOG4CXX_STR("Could not connect to [")
+					+ _priv->address->toString() + LOG4CXX_STR(":"));
+				StringHelper::toString(_priv->port, p, msg);
+				msg += LOG4CXX_STR("].");
+				LogLog::error(msg, e);
+
+				// Without reconnection, the events are discarded once the queue is full
+				std::unique_lock<std::mutex> lock( _priv->interrupt_mutex );
+				if (_priv->reconnectionDelay <= 0)
+					_priv->interrupt.wait( lock, std::bind(&SocketAppenderSkeleton::is_closed, this) );
+				else
+					_priv->interrupt.wait_for( lock, std::chrono::milliseconds( _priv->reconnectionDelay ),
+						std::bind(&SocketAppenderSkeleton::is_closed, this) );
+				continue;
+			}
+
+			// Resend the events that may not have been processed by the server
+			std::lock_guard<std::mutex> lock(_priv->interrupt_mutex);
+			for (auto item = _priv->replay.rbegin(); item != _priv->replay.rend(); ++item)
+			{
+				_priv->queuedBytes += item->size();
+				_priv->queue.push_front(std::move(*item));
+			}
+			_priv->replay.clear();
+			replayBytes = 0;
+			headerRequired = !_priv->streamHeader.empty();
+		}
+
+		size_t discardCount = 0;
+		{
+			std::unique_lock<std::mutex> lock( _priv->interrupt_mutex );
+			_priv->interrupt.wait( lock, [this]() { return !_priv->queue.empty() || is_closed(); } );
+			size_t batchSize = 0;
+			while (!_priv->queue.empty()
+				&& (batch.empty() || batchSize + _priv->queue.front().size() <= MaxBatchSize))
+			{
+				batchSize += _priv->queue.front().size();
+				batch.push_back(std::move(_priv->queue.front()));
+				_priv->queue.pop_front();
+			}
+			_priv->queuedBytes -= batchSize;
+			std::swap(discardCount, _priv->discardCount);
+			finished = _priv->queue.empty() && is_closed();
+		}
+
+		if (0 < discardCount)
+		{
+			LogString msg;
+			StringHelper::toString(discardCount, p, msg);
+			msg += LOG4CXX_STR(" events discarded by [") + _priv->name + LOG4CXX_STR("] as the queue was full.");
+			LogLog::warn(msg);
+		}
+
+		buffer.clear();
+		if (headerRequired)
+			buffer.insert(buffer.end(), _priv->streamHeader.begin(), _priv->streamHeader.end());
+		for (auto& item : batch)
+			buffer.insert(buffer.end(), item.begin(), item.end());
+
+		try
+		{
+			if (!buffer.empty())
+			{
+				ByteBuffer buf(buffer.data(), buffer.size());
+				socket->write(buf);
+				headerRequired = false;
+			}
+		}
+		catch (IOException& e)
+		{
+			LogLog::warn(LOG4CXX_STR("Detected problem with connection: "), e);
+			try
+			{
+				socket->close();
+			}
+			catch (IOException&)
+			{
+			}
+			socket.reset();
+
+			// Retry the unsent events after reconnecting
+			std::lock_guard<std::mutex> lock(_priv->interrupt_mutex);
+			for (auto item = batch.rbegin(); item != batch.rend(); ++item)
+			{
+				_priv->queuedBytes += item->size();
+				_priv->queue.push_front(std::move(*item));
+			}
+			batch.clear();
+			finished = is_closed();
+			continue;
+		}
+
+		// Retain the most recently sent events for replay
+		for (auto& item : batch)
+		{
+			replayBytes += item.size();
+			_priv->replay.push_back(std::move(item));
+		}
+		batch.clear();
+		while (!_priv->replay.empty() && _priv->replayBufferSize < replayBytes)
+		{
+			replayBytes -= _priv->replay.front().size();
+			_priv->replay.pop_front();
+		}
+	}
+
+	if (socket)
+	{
+		try
+		{
+			socket->close();
+		}
+		catch (IOException&)
+		{
+		}
+	}
+}
+
 void SocketAppenderSkeleton::setRemoteHost(const LogString& host)
 {
 	_priv->address = helpers::InetAddress::getByName(host);
@@ -256,3 +454,39 @@ int SocketAppenderSkeleton::getReconnectionDelay() const
 {
 	return _priv->reconnectionDelay;
 }
+
+void SocketAppenderSkeleton::setStreamHeader(const std::string& bytes)
+{
+	_priv->streamHeader = bytes;
+}
+
+void SocketAppenderSkeleton::setBackgroundSend(bool newValue)
+{
+	_priv->backgroundSend = newValue;
+}
+
+bool SocketAppenderSkeleton::getBackgroundSend() const
+{
+	return _priv->backgroundSend;
+}
+
+void SocketAppenderSkeleton::setMaxQueueSize(size_t newValue)
+{
+	std::lock_guard<std::mutex> lock(_priv->interrupt_mutex);
+	_priv->maxQueueSize = newValue;
+}
+
+size_t SocketAppenderSkeleton::getMaxQueueSize() const
+{
+	return _priv->maxQueueSize;
+}
+
+void SocketAppenderSkeleton::setReplayBufferSize(size_t newValue)
+{
+	_priv->replayBufferSize = newValue;
+}
+
+size_t SocketAppenderSkeleton::getReplayBufferSize() const
+{
+	return _priv->replayBufferSize;
+}
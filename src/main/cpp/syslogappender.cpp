@@ -23,6 +23,10 @@
 #include <log4cxx/level.h>
 #include <log4cxx/helpers/transcoder.h>
 #include <log4cxx/helpers/optionconverter.h>
+#include <log4cxx/helpers/threadutility.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/inetaddress.h>
+#include <chrono>
 #if !defined(LOG4CXX)
 	#define LOG4CXX 1
 #endif
@@ -69,7 +73,16 @@ SyslogAppender::~SyslogAppender()
 /** Release any resources held by this SyslogAppender.*/
 void SyslogAppender::close()
 {
-	_priv->closed = true;
+	{
+		std::lock_guard<std::mutex> lock(_priv->queueMutex);
+		_priv->closed = true;
+		_priv->queueChanged.notify_all();
+	}
+
+	if (_priv->sender.joinable())
+	{
+		_priv->sender.join();
+	}
 
 	if (_priv->sw)
 	{
@@ -282,7 +295,39 @@ void SyslogAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 	std::string encoded;
 	_priv->layout->format(msg, event, p);
 
-	Transcoder::encode(msg, encoded);
+	// A stream transport sends the whole message in an RFC 6587 octet-counted frame
+	if (_priv->tcp)
+	{
+		LogString sbuf(1, 0x3C /* '<' */);
+		StringHelper::toString((_priv->syslogFacility | event->getLevel()->getSyslogEquivalent()), p, sbuf);
+		sbuf.append(1, (logchar) 0x3E /* '>' */);
+
+		if (_priv->facilityPrinting)
+		{
+			sbuf.append(_priv->facilityStr);
+		}
+
+		sbuf.append(msg);
+		Transcoder::encode(sbuf, encoded);
+		auto length = std::to_string(encoded.size());
+		length.append(1, ' ');
+
+		std::lock_guard<std::mutex> lock(_priv->queueMutex);
+		size_t frameSize = length.size() + encoded.size();
+		if (_priv->maxQueueSize < _priv->pending.size() + frameSize)
+		{
+			++_priv->discardCount;
+			if (auto metrics = _priv->getMetrics())
+				metrics->add(AppenderMetrics::Discards);
+			return;
+		}
+		bool wasEmpty = _priv->pending.empty();
+		_priv->pending.append(length);
+		_priv->pending.append(encoded);
+		if (wasEmpty)
+			_priv->queueChanged.notify_all();
+		return;
+	}
 
 	// Split up the message if it is over maxMessageLength in size.
 	// According to RFC 3164, the max message length is 1024, however
@@ -369,6 +414,105 @@ void SyslogAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 
 void SyslogAppender::activateOptions(Pool&)
 {
+	if (_priv->tcp && !_priv->sender.joinable())
+	{
+		if (_priv->syslogHost.empty())
+		{
+			LogLog::error(LOG4CXX_STR("No syslog host is set for SyslogAppender named \"") +
+				_priv->name + LOG4CXX_STR("\"."));
+			return;
+		}
+		_priv->sw = nullptr;
+		_priv->sender = ThreadUtility::instance()->createThread( LOG4CXX_STR("SyslogSend")
+			, &SyslogAppenderPriv::sendPendingFrames, _priv );
+	}
+}
+
+void SyslogAppender::SyslogAppenderPriv::sendPendingFrames()
+{
+	Pool p;
+	int port = 0 <= syslogHostPort ? syslogHostPort : SYSLOG_PORT;
+	SocketPtr socket;
+	std::string batch;
+
+	while (true)
+	{
+		size_t discards = 0;
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			queueChanged.wait(lock, [this]() { return closed || !pending.empty(); });
+			if (pending.empty())
+				break;
+			std::swap(batch, pending);
+			std::swap(discards, discardCount);
+		}
+
+		if (0 < discards)
+		{
+			LogString msg;
+			StringHelper::toString(discards, p, msg);
+			msg += LOG4CXX_STR(" messages discarded by [") + name + LOG4CXX_STR("] as the queue was full.");
+			LogLog::warn(msg);
+		}
+
+		while (!batch.empty())
+		{
+			try
+			{
+				if (!socket)
+				{
+					auto address = InetAddress::getByName(syslogHost);
+					socket = Socket::create(address, port);
+				}
+				ByteBuffer buf(&batch[0], batch.size());
+				socket->write(buf);
+				batch.clear();
+			}
+			catch (IOException& e)
+			{
+				LogString msg(LOG4CXX_STR("Could not send to syslog host [") + syslogHost + LOG4CXX_STR(":"));
+				StringHelper::toString(port, p, msg);
+				msg += LOG4CXX_STR("].");
+				LogLog::warn(msg, e);
+				if (socket)
+				{
+					try
+					{
+						socket->close();
+					}
+					catch (IOException&)
+					{
+					}
+					socket.reset();
+				}
+
+				// Retry the whole batch on a new connection
+				std::unique_lock<std::mutex> lock(queueMutex);
+				auto isClosed = [this]() { return closed; };
+				bool closing = true;
+				if (reconnectionDelay <= 0)
+					queueChanged.wait(lock, isClosed);
+				else
+					closing = queueChanged.wait_for(lock, std::chrono::milliseconds(reconnectionDelay), isClosed);
+				if (closing)
+				{
+					LogLog::warn(LOG4CXX_STR("Syslog messages discarded on close as the host is unavailable."));
+					batch.clear();
+				}
+			}
+		}
+	}
+
+	if (socket)
+	{
+		try
+		{
+			socket->close();
+		}
+		catch (IOException&)
+		{
+		}
+	}
 }
 
 void SyslogAppender::setOption(const LogString& option, const LogString& value)
@@ -385,6 +529,18 @@ void SyslogAppender::setOption(const LogString& option, const LogString& value)
 	{
 		setMaxMessageLength(OptionConverter::toInt(value, 1024));
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("PROTOCOL"), LOG4CXX_STR("protocol")))
+	{
+		setProtocol(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("MAXQUEUESIZE"), LOG4CXX_STR("maxqueuesize")))
+	{
+		setMaxQueueSize((size_t) OptionConverter::toFileSize(value, 1024 * 1024));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("RECONNECTIONDELAY"), LOG4CXX_STR("reconnectiondelay")))
+	{
+		setReconnectionDelay(OptionConverter::toInt(value, 30000));
+	}
 	else
 	{
 		AppenderSkeleton::setOption(option, value);
@@ -483,3 +639,47 @@ int SyslogAppender::getMaxMessageLength() const
 	return _priv->maxMessageLength;
 }
 
+
+void SyslogAppender::setProtocol(const LogString& protocol)
+{
+	if (StringHelper::equalsIgnoreCase(protocol, LOG4CXX_STR("TCP"), LOG4CXX_STR("tcp")))
+	{
+		_priv->tcp = true;
+	}
+	else if (StringHelper::equalsIgnoreCase(protocol, LOG4CXX_STR("UDP"), LOG4CXX_STR("udp")))
+	{
+		_priv->tcp = false;
+	}
+	else
+	{
+		LogLog::error(LOG4CXX_STR("[") + protocol +
+			LOG4CXX_STR("] is an unknown syslog protocol. Defaulting to [UDP]."));
+		_priv->tcp = false;
+	}
+}
+
+LogString SyslogAppender::getProtocol() const
+{
+	return _priv->tcp ? LOG4CXX_STR("TCP") : LOG4CXX_STR("UDP");
+}
+
+void SyslogAppender::setMaxQueueSize(size_t newValue)
+{
+	std::lock_guard<std::mutex> lock(_priv->queueMutex);
+	_priv->maxQueueSize = newValue;
+}
+
+size_t SyslogAppender::getMaxQueueSize() const
+{
+	return _priv->maxQueueSize;
+}
+
+void SyslogAppender::setReconnectionDelay(int newValue)
+{
+	_priv->reconnectionDelay = newValue;
+}
+
+int SyslogAppender::getReconnectionDelay() const
+{
+	return _priv->reconnectionDelay;
+}
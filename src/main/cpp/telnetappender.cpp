@@ -23,7 +23,16 @@
 #include <log4cxx/helpers/bytebuffer.h>
 #include <log4cxx/helpers/threadutility.h>
 #include <log4cxx/private/appenderskeleton_priv.h>
+#include <log4cxx/private/aprserversocket.h>
+#include <log4cxx/private/aprsocket.h>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <iterator>
 #include <mutex>
+#include "apr_network_io.h"
+#include "apr_poll.h"
+#include "apr_signal.h"
 
 using namespace LOG4CXX_NS;
 using namespace LOG4CXX_NS::helpers;
@@ -31,6 +40,15 @@ using namespace LOG4CXX_NS::net;
 
 IMPLEMENT_LOG4CXX_OBJECT(TelnetAppender)
 
+namespace
+{
+// Encoded output shared by the queues of all clients
+using SharedBytes = std::shared_ptr<const std::vector<char>>;
+
+// The default maximum number of bytes waiting to be sent to a client
+const size_t DEFAULT_QUEUE_SIZE = 256 * 1024;
+}
+
 struct TelnetAppender::TelnetAppenderPriv : public AppenderSkeletonPrivate
 {
 	TelnetAppenderPriv( int port, int maxConnections ) : AppenderSkeletonPrivate(),
@@ -39,7 +57,35 @@ struct TelnetAppender::TelnetAppenderPriv : public AppenderSkeletonPrivate
 		encoding(LOG4CXX_STR("UTF-8")),
 		encoder(CharsetEncoder::getUTF8Encoder()),
 		sh(),
-		activeConnections(0) {}
+		activeConnections(0),
+		maxQueueSize(DEFAULT_QUEUE_SIZE),
+		pollset(nullptr),
+		wakeupPending(false) {}
+
+	/**
+	 * The state of a connected client.
+	 */
+	struct Client
+	{
+		Client(const SocketPtr& socket, apr_socket_t* handle)
+			: socket(socket)
+			, handle(handle)
+			, queuedBytes(0)
+			, sentBytes(0)
+			, discardCount(0)
+			, pollForWrite(false)
+			, isOpen(true)
+		{}
+		SocketPtr socket;
+		apr_socket_t* handle;
+		std::deque<SharedBytes> queue;  //!< Guarded by queueMutex
+		size_t queuedBytes;             //!< Guarded by queueMutex
+		size_t sentBytes;               //!< The number of bytes of queue.front() already sent
+		size_t discardCount;            //!< Guarded by queueMutex
+		bool pollForWrite;              //!< Is the pollset waiting for this socket to be writable?
+		std::atomic<bool> isOpen;
+	};
+	using ClientPtr = std::unique_ptr<Client>;
 
 	int port;
 	ConnectionList connections;
@@ -47,7 +93,56 @@ struct TelnetAppender::TelnetAppenderPriv : public AppenderSkeletonPrivate
 	LOG4CXX_NS::helpers::CharsetEncoderPtr encoder;
 	std::unique_ptr<helpers::ServerSocket> serverSocket;
 	std::thread sh;
-	size_t activeConnections;
+	std::atomic<size_t> activeConnections;
+
+	/**
+	 * The maximum number of bytes waiting to be sent to a client.
+	 */
+	size_t maxQueueSize;
+
+	/**
+	 * The connected clients. Only the connection thread adds or removes entries.
+	 */
+	std::vector<ClientPtr> clients;
+	std::mutex queueMutex;
+
+	/**
+	 * Used by the connection thread to wait for connections, client input and writable sockets.
+	 */
+	Pool pollPool;
+	apr_pollset_t* pollset;
+
+	/**
+	 * Has the connection thread been asked to send queued output?
+	 */
+	std::atomic<bool> wakeupPending;
+
+	void wakeup()
+	{
+		if (pollset && !wakeupPending.exchange(true))
+			apr_pollset_wakeup(pollset);
+	}
+
+	void setPollEvents(Client& client, bool forWrite)
+	{
+		apr_pollfd_t descriptor;
+		descriptor.p = pollPool.getAPRPool();
+		descriptor.desc_type = APR_POLL_SOCKET;
+		descriptor.reqevents = APR_POLLIN;
+		descriptor.rtnevents = 0;
+		descriptor.desc.s = client.handle;
+		descriptor.client_data = &client;
+		apr_pollset_remove(pollset, &descriptor);
+		if (forWrite)
+			descriptor.reqevents |= APR_POLLOUT;
+		apr_pollset_add(pollset, &descriptor);
+		client.pollForWrite = forWrite;
+	}
+
+	void addClient(const SocketPtr& socket);
+	void receive(Client& client);
+	void send(Client& client);
+	void removeClosedClients();
 };
 
 #define _priv static_cast<TelnetAppenderPriv*>(m_priv.get())
@@ -76,7 +171,21 @@ void TelnetAppender::activateOptions(Pool& /* p */)
 		_priv->serverSocket->setSoTimeout(1000);
 	}
 
-	_priv->sh = ThreadUtility::instance()->createThread( LOG4CXX_STR("TelnetAppender"), &TelnetAppender::acceptConnections, this );
+	if (!_priv->pollset)
+	{
+		apr_status_t stat = apr_pollset_create(&_priv->pollset
+			, (apr_uint32_t)_priv->connections.size() + 1
+			, _priv->pollPool.getAPRPool()
+			, APR_POLLSET_WAKEABLE);
+		if (stat != APR_SUCCESS)
+		{
+			_priv->pollset = nullptr;
+			throw SocketException(stat);
+		}
+	}
+
+	if (!_priv->sh.joinable())
+		_priv->sh = ThreadUtility::instance()->createThread( LOG4CXX_STR("TelnetAppender"), &TelnetAppender::acceptConnections, this );
 }
 
 void TelnetAppender::setOption(const LogString& option,
@@ -90,6 +199,10 @@ void TelnetAppender::setOption(const LogString& option,
 	{
 		setEncoding(value);
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("MAXQUEUESIZE"), LOG4CXX_STR("maxqueuesize")))
+	{
+		setMaxQueueSize((size_t)OptionConverter::toFileSize(value, (long)DEFAULT_QUEUE_SIZE));
+	}
 	else
 	{
 		AppenderSkeleton::setOption(option, value);
@@ -109,6 +222,17 @@ void TelnetAppender::setEncoding(const LogString& value)
 	_priv->encoding = value;
 }
 
+size_t TelnetAppender::getMaxQueueSize() const
+{
+	return _priv->maxQueueSize;
+}
+
+void TelnetAppender::setMaxQueueSize(size_t byteCount)
+{
+	std::lock_guard<std::mutex> lock(_priv->queueMutex);
+	_priv->maxQueueSize = byteCount;
+}
+
 
 void TelnetAppender::close()
 {
@@ -121,15 +245,13 @@ void TelnetAppender::close()
 
 	_priv->closed = true;
 
-	SocketPtr nullSocket;
+	// The connection thread closes the client connections
+	if (_priv->pollset)
+		apr_pollset_wakeup(_priv->pollset);
 
-	for (auto& item : _priv->connections)
+	if ( _priv->sh.joinable() )
 	{
-		if (item)
-		{
-			item->close();
-			item = nullSocket;
-		}
+		_priv->sh.join();
 	}
 
 	if (_priv->serverSocket != NULL)
@@ -143,9 +265,10 @@ void TelnetAppender::close()
 		}
 	}
 
-	if ( _priv->sh.joinable() )
+	if (_priv->pollset)
 	{
-		_priv->sh.join();
+		apr_pollset_destroy(_priv->pollset);
+		_priv->pollset = nullptr;
 	}
 
 	_priv->activeConnections = 0;
@@ -154,42 +277,75 @@ void TelnetAppender::close()
 
 void TelnetAppender::write(ByteBuffer& buf)
 {
-	for (auto& item :_priv->connections)
+	auto bytes = std::make_shared<std::vector<char>>(buf.current(), buf.current() + buf.remaining());
+	bool added = false;
 	{
-		if (item)
+		std::lock_guard<std::mutex> lock(_priv->queueMutex);
+		for (auto& client : _priv->clients)
 		{
-			try
+			if (!client->isOpen)
+				continue;
+			if (_priv->maxQueueSize < client->queuedBytes + bytes->size())
 			{
-				ByteBuffer b(buf.current(), buf.remaining());
-				item->write(b);
+				++client->discardCount;
+				continue;
 			}
-			catch (Exception&)
+			if (0 < client->discardCount)
 			{
-				// The client has closed the connection, remove it from our list:
-				item.reset();
-				_priv->activeConnections--;
+				// Tell the client about the gap in the output
+				LogString msg(LOG4CXX_STR("["));
+				Pool p;
+				StringHelper::toString(client->discardCount, p, msg);
+				msg.append(LOG4CXX_STR(" messages discarded]\r\n"));
+				auto notice = std::make_shared<std::vector<char>>();
+				encode(msg, *notice);
+				client->queuedBytes += notice->size();
+				client->queue.push_back(notice);
+				client->discardCount = 0;
 			}
+			client->queuedBytes += bytes->size();
+			client->queue.push_back(bytes);
+			added = true;
 		}
 	}
+	if (added)
+		_priv->wakeup();
 }
 
-void TelnetAppender::writeStatus(const SocketPtr& socket, const LogString& msg, Pool& p)
+void TelnetAppender::encode(const LogString& msg, std::vector<char>& dest)
 {
-	size_t bytesSize = msg.size() * 2;
-	char* bytes = p.pstralloc(bytesSize);
-
+	char chunk[1024];
+	ByteBuffer buf(chunk, sizeof (chunk));
 	LogString::const_iterator msgIter(msg.begin());
-	ByteBuffer buf(bytes, bytesSize);
 
 	while (msgIter != msg.end())
 	{
-		_priv->encoder->encode(msg, msgIter, buf);
+		log4cxx_status_t stat = _priv->encoder->encode(msg, msgIter, buf);
 		buf.flip();
-		socket->write(buf);
+		dest.insert(dest.end(), buf.current(), buf.current() + buf.remaining());
 		buf.clear();
+
+		if (CharsetEncoder::isError(stat))
+		{
+			LogString unrepresented(1, 0x3F /* '?' */);
+			LogString::const_iterator unrepresentedIter(unrepresented.begin());
+			stat = _priv->encoder->encode(unrepresented, unrepresentedIter, buf);
+			buf.flip();
+			dest.insert(dest.end(), buf.current(), buf.current() + buf.remaining());
+			buf.clear();
+			msgIter++;
+		}
 	}
 }
 
+void TelnetAppender::writeStatus(const SocketPtr& socket, const LogString& msg, Pool& /* p */)
+{
+	std::vector<char> bytes;
+	encode(msg, bytes);
+	ByteBuffer buf(bytes.data(), bytes.size());
+	socket->write(buf);
+}
+
 void TelnetAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 {
 	size_t count = _priv->activeConnections;
@@ -197,110 +353,214 @@ void TelnetAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 	if (count > 0)
 	{
 		LogString msg;
-		_priv->layout->format(msg, event, _priv->pool);
+		_priv->layout->format(msg, event, p);
 		msg.append(LOG4CXX_STR("\r\n"));
-		size_t bytesSize = msg.size() * 2;
-		char* bytes = p.pstralloc(bytesSize);
+		// Encode once, then share the bytes with each client queue
+		std::vector<char> bytes;
+		encode(msg, bytes);
+		ByteBuffer buf(bytes.data(), bytes.size());
+		write(buf);
+	}
+}
 
-		LogString::const_iterator msgIter(msg.begin());
-		ByteBuffer buf(bytes, bytesSize);
+void TelnetAppender::TelnetAppenderPriv::addClient(const SocketPtr& newClient)
+{
+	auto aprSocket = std::dynamic_pointer_cast<APRSocket>(newClient);
+	apr_socket_t* handle = aprSocket ? aprSocket->getSocketHandle() : nullptr;
+	if (!handle
+		|| apr_socket_opt_set(handle, APR_SO_NONBLOCK, 1) != APR_SUCCESS
+		|| apr_socket_timeout_set(handle, 0) != APR_SUCCESS)
+	{
+		LogLog::warn(LOG4CXX_STR("TelnetAppender: unable to use a non-blocking connection"));
+		newClient->close();
+		return;
+	}
+	auto client = std::make_unique<Client>(newClient, handle);
+	setPollEvents(*client, false);
+	std::lock_guard<std::mutex> lock(queueMutex);
+	clients.push_back(std::move(client));
+	++activeConnections;
+}
 
-		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+void TelnetAppender::TelnetAppenderPriv::receive(Client& client)
+{
+	// Input is discarded. A zero length read or an error indicates the client has gone.
+	char buf[256];
+	apr_size_t len = sizeof (buf);
+	apr_status_t stat = apr_socket_recv(client.handle, buf, &len);
+	if (stat != APR_SUCCESS && !APR_STATUS_IS_EAGAIN(stat))
+		client.isOpen = false;
+}
 
-		while (msgIter != msg.end())
+void TelnetAppender::TelnetAppenderPriv::send(Client& client)
+{
+	while (client.isOpen)
+	{
+		SharedBytes bytes;
 		{
-			log4cxx_status_t stat = _priv->encoder->encode(msg, msgIter, buf);
-			buf.flip();
-			write(buf);
-			buf.clear();
-
-			if (CharsetEncoder::isError(stat))
-			{
-				LogString unrepresented(1, 0x3F /* '?' */);
-				LogString::const_iterator unrepresentedIter(unrepresented.begin());
-				stat = _priv->encoder->encode(unrepresented, unrepresentedIter, buf);
-				buf.flip();
-				write(buf);
-				buf.clear();
-				msgIter++;
-			}
+			std::lock_guard<std::mutex> lock(queueMutex);
+			if (client.queue.empty())
+				break;
+			bytes = client.queue.front();
+		}
+		apr_size_t len = bytes->size() - client.sentBytes;
+		// while writing to the socket, we need to ignore the SIGPIPE
+		// signal. Otherwise, when the client has closed the connection,
+		// the send() function would not return an error but call the
+		// SIGPIPE handler.
+#if APR_HAVE_SIGACTION
+		apr_sigfunc_t* old = apr_signal(SIGPIPE, SIG_IGN);
+		apr_status_t stat = apr_socket_send(client.handle, bytes->data() + client.sentBytes, &len);
+		apr_signal(SIGPIPE, old);
+#else
+		apr_status_t stat = apr_socket_send(client.handle, bytes->data() + client.sentBytes, &len);
+#endif
+		client.sentBytes += len;
+		if (client.sentBytes == bytes->size())
+		{
+			std::lock_guard<std::mutex> lock(queueMutex);
+			client.queue.pop_front();
+			client.queuedBytes -= bytes->size();
+			client.sentBytes = 0;
+		}
+		if (APR_STATUS_IS_EAGAIN(stat))
+		{
+			// The socket buffer is full, so wait for it to become writable
+			if (!client.pollForWrite)
+				setPollEvents(client, true);
+			return;
 		}
+		if (stat != APR_SUCCESS)
+			client.isOpen = false;
 	}
+	if (client.isOpen && client.pollForWrite)
+		setPollEvents(client, false);
 }
 
-void TelnetAppender::acceptConnections()
+void TelnetAppender::TelnetAppenderPriv::removeClosedClients()
 {
-
-	// main loop; is left when This->closed is != 0 after an accept()
-	while (true)
+	std::vector<ClientPtr> closedClients;
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		auto pClosed = std::stable_partition(clients.begin(), clients.end()
+			, [](const ClientPtr& client) { return client->isOpen.load(); });
+		std::move(pClosed, clients.end(), std::back_inserter(closedClients));
+		clients.erase(pClosed, clients.end());
+	}
+	for (auto& client : closedClients)
 	{
+		apr_pollfd_t descriptor;
+		descriptor.p = pollPool.getAPRPool();
+		descriptor.desc_type = APR_POLL_SOCKET;
+		descriptor.reqevents = APR_POLLIN;
+		descriptor.rtnevents = 0;
+		descriptor.desc.s = client->handle;
+		descriptor.client_data = client.get();
+		apr_pollset_remove(pollset, &descriptor);
 		try
 		{
-			SocketPtr newClient = _priv->serverSocket->accept();
-			bool done = _priv->closed;
-
-			if (done)
-			{
-				Pool p;
-				writeStatus(newClient, LOG4CXX_STR("Log closed.\r\n"), p);
-				newClient->close();
-
-				break;
-			}
+			client->socket->close();
+		}
+		catch (Exception&)
+		{
+		}
+		--activeConnections;
+	}
+}
 
-			size_t count = _priv->activeConnections;
+void TelnetAppender::acceptConnections()
+{
+	auto serverSocket = dynamic_cast<APRServerSocket*>(_priv->serverSocket.get());
+	if (!serverSocket || !_priv->pollset)
+	{
+		LogLog::error(LOG4CXX_STR("TelnetAppender requires an APR server socket"));
+		return;
+	}
+	apr_pollfd_t listener;
+	listener.p = _priv->pollPool.getAPRPool();
+	listener.desc_type = APR_POLL_SOCKET;
+	listener.reqevents = APR_POLLIN;
+	listener.rtnevents = 0;
+	listener.desc.s = serverSocket->getSocketHandle();
+	listener.client_data = nullptr;
+	apr_pollset_add(_priv->pollset, &listener);
+
+	// main loop; is left when This->closed is != 0
+	while (!_priv->closed)
+	{
+		apr_int32_t count = 0;
+		const apr_pollfd_t* descriptors = nullptr;
+		apr_status_t stat = apr_pollset_poll(_priv->pollset, apr_time_from_sec(1), &count, &descriptors);
+		_priv->wakeupPending = false;
+		if (_priv->closed)
+			break;
+		if (stat != APR_SUCCESS && !APR_STATUS_IS_EINTR(stat) && !APR_STATUS_IS_TIMEUP(stat))
+		{
+			LogLog::error(LOG4CXX_STR("Encountered error while in SocketHandler loop."), SocketException(stat));
+			break;
+		}
 
-			if (count >= _priv->connections.size())
-			{
-				Pool p;
-				writeStatus(newClient, LOG4CXX_STR("Too many connections.\r\n"), p);
-				newClient->close();
-			}
-			else
+		for (apr_int32_t i = 0; i < count; ++i)
+		{
+			auto& item = descriptors[i];
+			if (!item.client_data)
 			{
-				//
-				//   find unoccupied connection
-				//
-				std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
-
-				for (auto& item : _priv->connections)
+				try
 				{
-					if (!item)
+					SocketPtr newClient = _priv->serverSocket->accept();
+					if (_priv->activeConnections >= _priv->connections.size())
 					{
-						item = newClient;
-						_priv->activeConnections++;
-
-						break;
+						Pool p;
+						writeStatus(newClient, LOG4CXX_STR("Too many connections.\r\n"), p);
+						newClient->close();
+					}
+					else
+					{
+						Pool p;
+						LogString oss(LOG4CXX_STR("TelnetAppender v1.0 ("));
+						StringHelper::toString((int) _priv->activeConnections + 1, p, oss);
+						oss += LOG4CXX_STR(" active connections)\r\n\r\n");
+						writeStatus(newClient, oss, p);
+						_priv->addClient(newClient);
 					}
 				}
-
-				Pool p;
-				LogString oss(LOG4CXX_STR("TelnetAppender v1.0 ("));
-				StringHelper::toString((int) count + 1, p, oss);
-				oss += LOG4CXX_STR(" active connections)\r\n\r\n");
-				writeStatus(newClient, oss, p);
+				catch (InterruptedIOException&)
+				{
+				}
+				catch (Exception& e)
+				{
+					LogLog::error(LOG4CXX_STR("Encountered error while in SocketHandler loop."), e);
+				}
 			}
+			else if (item.rtnevents & (APR_POLLIN | APR_POLLHUP | APR_POLLERR))
+				_priv->receive(*static_cast<TelnetAppenderPriv::Client*>(item.client_data));
 		}
-		catch (InterruptedIOException&)
+
+		// Send whatever each client socket will accept without blocking
+		for (auto& client : _priv->clients)
+			_priv->send(*client);
+		_priv->removeClosedClients();
+	}
+
+	// Close all client connections
+	{
+		std::lock_guard<std::mutex> lock(_priv->queueMutex);
+		for (auto& client : _priv->clients)
+			client->isOpen = false;
+	}
+	Pool p;
+	for (auto& client : _priv->clients)
+	{
+		try
 		{
-			if (_priv->closed)
-			{
-				break;
-			}
+			writeStatus(client->socket, LOG4CXX_STR("Log closed.\r\n"), p);
 		}
-		catch (Exception& e)
+		catch (Exception&)
 		{
-			if (!_priv->closed)
-			{
-				LogLog::error(LOG4CXX_STR("Encountered error while in SocketHandler loop."), e);
-			}
-			else
-			{
-				break;
-			}
 		}
 	}
-
+	_priv->removeClosedClients();
+	apr_pollset_remove(_priv->pollset, &listener);
 }
 
 int TelnetAppender::getPort() const
@@ -19,6 +19,7 @@
 #include <log4cxx/logstring.h>
 #include <log4cxx/rolling/timebasedrollingpolicy.h>
 #include <log4cxx/pattern/filedatepatternconverter.h>
+#include <log4cxx/helpers/logfileindex.h>
 #include <log4cxx/helpers/date.h>
 #include <log4cxx/rolling/filerenameaction.h>
 #include <log4cxx/helpers/loglog.h>
@@ -29,7 +30,15 @@
 #include <log4cxx/helpers/optionconverter.h>
 #include <log4cxx/fileappender.h>
 #include <log4cxx/private/boost-std-configuration.h>
+#include <log4cxx/private/deferredaction.h>
+#include <log4cxx/pattern/literalpatternconverter.h>
+#include <log4cxx/helpers/threadutility.h>
 #include <iostream>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <apr_mmap.h>
 
 using namespace LOG4CXX_NS;
@@ -113,9 +122,99 @@ struct TimeBasedRollingPolicy::TimeBasedRollingPolicyPrivate{
 
 		bool multiprocess = false;
 		bool throwIOExceptionOnForkFailure = true;
+
+		/*
+		 * Should isTriggeringEvent update the appender file name from the mmap file?
+		 * */
+		bool refreshActiveFile = true;
+
+		/*
+		 * Retention options
+		 * */
+		int maxHistory = 0;
+		size_t totalSizeCap = 0;
+		bool cleanHistoryOnStart = false;
+
+		/*
+		 * A rolled over file known to the cleaner thread
+		 * */
+		struct Archive
+		{
+			LogString fileName;
+			size_t length;
+		};
+
+		/*
+		 * The archived files, oldest first, and their total length.
+		 * Only used by the cleaner thread.
+		 * */
+		std::deque<Archive> archives;
+		size_t archiveLength = 0;
+
+		/*
+		 * The text either side of each date in FileNamePattern
+		 * and the directory to scan for existing archives
+		 * */
+		std::vector<LogString> archivePattern;
+		LogString archiveDirectory;
+		LogString activeArchiveName;
+		bool scanRequested = false;
+
+		/*
+		 * Rolled over files (and their compression action) waiting for the cleaner thread
+		 * */
+		std::vector<std::pair<ActionPtr, LogString>> pendingArchives;
+		bool stopping = false;
+		std::mutex cleanerMutex;
+		std::condition_variable cleanerChanged;
+		std::thread cleaner;
 };
 
 
+namespace
+{
+
+// Does \c fileName consist of the \c segments separated by any text?
+bool matchesPattern(const LogString& fileName, const std::vector<LogString>& segments)
+{
+	if (segments.empty())
+	{
+		return false;
+	}
+
+	const LogString& first = segments.front();
+	const LogString& last = segments.back();
+
+	if (fileName.size() < first.size() || fileName.compare(0, first.size(), first) != 0)
+	{
+		return false;
+	}
+
+	if (segments.size() == 1)
+	{
+		return fileName.size() == first.size();
+	}
+
+	size_t pos = first.size();
+
+	for (size_t i = 1; i + 1 < segments.size(); ++i)
+	{
+		pos = fileName.find(segments[i], pos);
+
+		if (pos == LogString::npos)
+		{
+			return false;
+		}
+
+		pos += segments[i].size();
+	}
+
+	return pos + last.size() <= fileName.size()
+		&& fileName.compare(fileName.size() - last.size(), last.size(), last) == 0;
+}
+
+} // namespace
+
 #define MMAP_FILE_SUFFIX ".map"
 #define LOCK_FILE_SUFFIX ".maplck"
 #define MAX_FILE_LEN 2048
@@ -273,7 +372,18 @@ TimeBasedRollingPolicy::TimeBasedRollingPolicy() :
 {
 }
 
-TimeBasedRollingPolicy::~TimeBasedRollingPolicy(){}
+TimeBasedRollingPolicy::~TimeBasedRollingPolicy()
+{
+	if (m_priv->cleaner.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_priv->cleanerMutex);
+			m_priv->stopping = true;
+		}
+		m_priv->cleanerChanged.notify_all();
+		m_priv->cleaner.join();
+	}
+}
 
 void TimeBasedRollingPolicy::activateOptions(LOG4CXX_NS::helpers::Pool& pool)
 {
@@ -340,6 +450,222 @@ void TimeBasedRollingPolicy::activateOptions(LOG4CXX_NS::helpers::Pool& pool)
 			m_priv->suffixLength = 4;
 		}
 	}
+
+	if (0 < m_priv->maxHistory || 0 < m_priv->totalSizeCap)
+	{
+		// Split the pattern at each date so existing archives can be recognized
+		std::vector<LogString> segments(1);
+
+		for (auto& converter : getPatternConverterList())
+		{
+			if (LOG4CXX_NS::cast<LiteralPatternConverter>(converter))
+			{
+				converter->format(obj, segments.back(), pool);
+			}
+			else
+			{
+				segments.push_back(LogString());
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(m_priv->cleanerMutex);
+		m_priv->archivePattern = segments;
+		m_priv->archiveDirectory = File().setPath(m_priv->lastFileName).getParent(pool);
+		m_priv->activeArchiveName = m_priv->lastFileName;
+		m_priv->scanRequested = true;
+
+		if (!m_priv->cleaner.joinable())
+		{
+			m_priv->cleaner = ThreadUtility::instance()->createThread(
+				LOG4CXX_STR("TimeBasedCleaner"), &TimeBasedRollingPolicy::runCleaner, this);
+		}
+
+		m_priv->cleanerChanged.notify_all();
+	}
+}
+
+void TimeBasedRollingPolicy::queueArchive(const ActionPtr& compressAction, const LogString& archiveName)
+{
+	std::lock_guard<std::mutex> lock(m_priv->cleanerMutex);
+	m_priv->pendingArchives.push_back(std::make_pair(compressAction, archiveName));
+	m_priv->cleanerChanged.notify_all();
+}
+
+void TimeBasedRollingPolicy::runCleaner()
+{
+	Pool p;
+	std::unique_lock<std::mutex> lock(m_priv->cleanerMutex);
+
+	for (;;)
+	{
+		m_priv->cleanerChanged.wait(lock, [this]()
+		{
+			return m_priv->stopping || m_priv->scanRequested || !m_priv->pendingArchives.empty();
+		});
+
+		if (!m_priv->scanRequested && m_priv->pendingArchives.empty())
+		{
+			break;
+		}
+
+		bool scanRequested = m_priv->scanRequested;
+		m_priv->scanRequested = false;
+		std::vector<LogString> segments(m_priv->archivePattern);
+		LogString directory(m_priv->archiveDirectory);
+		LogString activeArchiveName(m_priv->activeArchiveName);
+		std::vector<std::pair<ActionPtr, LogString>> pending;
+		pending.swap(m_priv->pendingArchives);
+		lock.unlock();
+
+		bool cleanRequired = !pending.empty();
+
+		if (scanRequested)
+		{
+			// Load the list of archives from the file system (only done at startup)
+			struct Found
+			{
+				log4cxx_time_t modified;
+				TimeBasedRollingPolicyPrivate::Archive archive;
+			};
+			std::vector<Found> found;
+			LogString prefix;
+
+			if (!directory.empty())
+			{
+				prefix = directory + LOG4CXX_STR("/");
+			}
+
+			for (auto& name : File().setPath(directory.empty() ? LOG4CXX_STR(".") : directory).list(p))
+			{
+				LogString fileName(prefix + name);
+
+				if (fileName == activeArchiveName || !matchesPattern(fileName, segments))
+				{
+					continue;
+				}
+
+				File file;
+				file.setPath(fileName);
+				found.push_back({file.lastModified(p), {fileName, file.length(p)}});
+			}
+
+			std::sort(found.begin(), found.end(), [](const Found& l, const Found& r)
+			{
+				return l.modified < r.modified
+					|| (l.modified == r.modified && l.archive.fileName < r.archive.fileName);
+			});
+
+			m_priv->archives.clear();
+			m_priv->archiveLength = 0;
+
+			for (auto& item : found)
+			{
+				m_priv->archives.push_back(item.archive);
+				m_priv->archiveLength += item.archive.length;
+			}
+
+			if (m_priv->cleanHistoryOnStart)
+			{
+				cleanRequired = true;
+			}
+		}
+
+		for (auto& item : pending)
+		{
+			if (item.first)
+			{
+				try
+				{
+					item.first->execute(p);
+				}
+				catch (std::exception& ex)
+				{
+					LOG4CXX_DECODE_CHAR(lsMsg, ex.what());
+					LogLog::warn(LOG4CXX_STR("Exception during rollover: ") + lsMsg);
+				}
+			}
+
+			LogString fileName(item.second);
+			File archive;
+
+			// Use the uncompressed file if compression failed
+			if (!archive.setPath(fileName).exists(p) && 0 < m_priv->suffixLength)
+			{
+				fileName.resize(fileName.size() - m_priv->suffixLength);
+				archive.setPath(fileName);
+			}
+
+			auto previous = std::find_if(m_priv->archives.begin(), m_priv->archives.end(),
+				[&fileName](const TimeBasedRollingPolicyPrivate::Archive& a)
+				{
+					return a.fileName == fileName;
+				});
+
+			if (previous != m_priv->archives.end())
+			{
+				m_priv->archiveLength -= previous->length;
+				m_priv->archives.erase(previous);
+			}
+
+			size_t length = archive.length(p);
+			m_priv->archives.push_back({fileName, length});
+			m_priv->archiveLength += length;
+		}
+
+		if (cleanRequired)
+		{
+			size_t maxHistory = 0 < m_priv->maxHistory ? size_t(m_priv->maxHistory) : 0;
+
+			while (!m_priv->archives.empty()
+				&& ((0 < maxHistory && maxHistory < m_priv->archives.size())
+					|| (0 < m_priv->totalSizeCap && m_priv->totalSizeCap < m_priv->archiveLength)))
+			{
+				auto& oldest = m_priv->archives.front();
+
+				if (!File().setPath(oldest.fileName).deleteFile(p))
+				{
+					LogLog::warn(LOG4CXX_STR("Unable to delete ") + oldest.fileName);
+				}
+
+				LogFileIndex::deleteIndexFile(oldest.fileName, p);
+
+				m_priv->archiveLength -= oldest.length;
+				m_priv->archives.pop_front();
+			}
+		}
+
+		lock.lock();
+	}
+}
+
+int TimeBasedRollingPolicy::getMaxHistory() const
+{
+	return m_priv->maxHistory;
+}
+
+void TimeBasedRollingPolicy::setMaxHistory(int newValue)
+{
+	m_priv->maxHistory = newValue;
+}
+
+size_t TimeBasedRollingPolicy::getTotalSizeCap() const
+{
+	return m_priv->totalSizeCap;
+}
+
+void TimeBasedRollingPolicy::setTotalSizeCap(size_t newValue)
+{
+	m_priv->totalSizeCap = newValue;
+}
+
+bool TimeBasedRollingPolicy::getCleanHistoryOnStart() const
+{
+	return m_priv->cleanHistoryOnStart;
+}
+
+void TimeBasedRollingPolicy::setCleanHistoryOnStart(bool newValue)
+{
+	m_priv->cleanHistoryOnStart = newValue;
 }
 
 
@@ -472,6 +798,17 @@ RolloverDescriptionPtr TimeBasedRollingPolicy::rollover(
 		compressAction = comp;
 	}
 
+	if (0 < m_priv->maxHistory || 0 < m_priv->totalSizeCap)
+	{
+		// Compression and the removal of old archives are done by the cleaner thread
+		LogString archiveName(m_priv->lastFileName);
+		ActionPtr archiveAction(compressAction);
+		compressAction = std::make_shared<DeferredAction>([this, archiveAction, archiveName]()
+			{
+				queueArchive(archiveAction, archiveName);
+			});
+	}
+
 	if( m_priv->multiprocess ){
 #if LOG4CXX_HAS_MULTIPROCESS_ROLLING_FILE_APPENDER
 		if (m_priv->_mmap && !isMapFileEmpty(m_priv->_mmapPool))
@@ -502,7 +839,7 @@ bool TimeBasedRollingPolicy::isTriggeringEvent(
 {
 	if( m_priv->multiprocess ){
 #if LOG4CXX_HAS_MULTIPROCESS_ROLLING_FILE_APPENDER
-		if (m_priv->bRefreshCurFile && m_priv->_mmap && !isMapFileEmpty(m_priv->_mmapPool))
+		if (m_priv->refreshActiveFile && m_priv->bRefreshCurFile && m_priv->_mmap && !isMapFileEmpty(m_priv->_mmapPool))
 		{
 			lockMMapFile(APR_FLOCK_SHARED);
 			LogString mapCurrent((char*)m_priv->_mmap->mm);
@@ -532,6 +869,11 @@ void TimeBasedRollingPolicy::setMultiprocess(bool multiprocess){
 #endif
 }
 
+void TimeBasedRollingPolicy::setRefreshActiveFile(bool newValue)
+{
+	m_priv->refreshActiveFile = newValue;
+}
+
 void TimeBasedRollingPolicy::setOption(const LogString& option,
 	const LogString& value)
 {
@@ -541,6 +883,24 @@ void TimeBasedRollingPolicy::setOption(const LogString& option,
 	{
 		m_priv->throwIOExceptionOnForkFailure = OptionConverter::toBoolean(value, true);
 	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXX_STR("MAXHISTORY"),
+			LOG4CXX_STR("maxhistory")))
+	{
+		m_priv->maxHistory = OptionConverter::toInt(value, 0);
+	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXX_STR("TOTALSIZECAP"),
+			LOG4CXX_STR("totalsizecap")))
+	{
+		m_priv->totalSizeCap = (size_t)OptionConverter::toFileSize(value, 0);
+	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXX_STR("CLEANHISTORYONSTART"),
+			LOG4CXX_STR("cleanhistoryonstart")))
+	{
+		m_priv->cleanHistoryOnStart = OptionConverter::toBoolean(value, false);
+	}
 	else
 	{
 		RollingPolicyBase::setOption(option, value);
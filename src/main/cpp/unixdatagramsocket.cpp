@@ -0,0 +1,140 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/private/unixdatagramsocket.h>
+#include <log4cxx/private/log4cxx_private.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <algorithm>
+#include <cstring>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::helpers;
+
+#if LOG4CXX_HAS_SENDMMSG
+namespace
+{
+// The number of messages passed to the kernel in each call
+const size_t MaxBatchSize = 256;
+}
+#endif
+
+UnixDatagramSocket::UnixDatagramSocket()
+	: m_fd(-1)
+{
+}
+
+UnixDatagramSocket::~UnixDatagramSocket()
+{
+	close();
+}
+
+void UnixDatagramSocket::connect(const LogString& path, bool seqPacket, int sendBufferSize)
+{
+	close();
+	LOG4CXX_ENCODE_CHAR(socketPath, path);
+	struct sockaddr_un address;
+	std::memset(&address, 0, sizeof (address));
+	address.sun_family = AF_UNIX;
+	if (sizeof (address.sun_path) <= socketPath.size())
+		throw SocketException(LOG4CXX_STR("Socket path is too long: ") + path);
+	std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+
+	int fd = ::socket(AF_UNIX, seqPacket ? SOCK_SEQPACKET : SOCK_DGRAM, 0);
+	if (fd < 0)
+		throw SocketException(errno);
+	if (0 < sendBufferSize)
+		::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sendBufferSize, sizeof (sendBufferSize));
+	if (::connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof (address)) != 0)
+	{
+		auto err = errno;
+		::close(fd);
+		throw SocketException(err);
+	}
+	m_fd = fd;
+}
+
+size_t UnixDatagramSocket::send(const std::vector<std::string>& messages, size_t start, bool wait, size_t& rejected)
+{
+	if (m_fd < 0)
+		throw ClosedChannelException();
+	int flags = wait ? 0 : MSG_DONTWAIT;
+#ifdef MSG_NOSIGNAL
+	flags |= MSG_NOSIGNAL;
+#endif
+	size_t sent = 0;
+	size_t index = start;
+#if LOG4CXX_HAS_SENDMMSG
+	struct iovec iov[MaxBatchSize];
+	struct mmsghdr headers[MaxBatchSize];
+#endif
+	while (index < messages.size())
+	{
+#if LOG4CXX_HAS_SENDMMSG
+		auto count = std::min(MaxBatchSize, messages.size() - index);
+		std::memset(headers, 0, count * sizeof (headers[0]));
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto& message = messages[index + i];
+			iov[i].iov_base = const_cast<char*>(message.data());
+			iov[i].iov_len = message.size();
+			headers[i].msg_hdr.msg_iov = &iov[i];
+			headers[i].msg_hdr.msg_iovlen = 1;
+		}
+		int result = ::sendmmsg(m_fd, headers, unsigned(count), flags);
+#else
+		auto& message = messages[index];
+		int result = ::send(m_fd, message.data(), message.size(), flags) < 0 ? -1 : 1;
+#endif
+		if (0 < result)
+		{
+			index += size_t(result);
+			sent += size_t(result);
+		}
+		else if (EINTR == errno)
+			;
+		else if (EMSGSIZE == errno)
+		{
+			++rejected;
+			++index;
+		}
+		else if (EAGAIN == errno || EWOULDBLOCK == errno)
+			break;
+		else
+			throw SocketException(errno);
+	}
+	return sent;
+}
+
+void UnixDatagramSocket::close()
+{
+	if (0 <= m_fd)
+	{
+		::close(m_fd);
+		m_fd = -1;
+	}
+}
+
+bool UnixDatagramSocket::isClosed() const
+{
+	return m_fd < 0;
+}
@@ -0,0 +1,341 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/net/unixsocketappender.h>
+#include <log4cxx/helpers/appendermetrics.h>
+#include <log4cxx/helpers/loglog.h>
+#include <log4cxx/helpers/optionconverter.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/threadutility.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <log4cxx/private/appenderskeleton_priv.h>
+#include <log4cxx/private/unixdatagramsocket.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace LOG4CXX_NS;
+using namespace LOG4CXX_NS::helpers;
+using namespace LOG4CXX_NS::net;
+
+struct UnixSocketAppender::UnixSocketAppenderPriv : public AppenderSkeleton::AppenderSkeletonPrivate
+{
+	UnixSocketAppenderPriv()
+		: AppenderSkeletonPrivate()
+		, discardCount(0)
+	{
+	}
+
+	LogString socketPath;
+	bool seqPacket = false;
+	int sendBufferSize = 0;
+	/** The maximum number of messages in each system call */
+	int bufferSize = 1;
+	/** The maximum milliseconds a message waits to be sent */
+	int flushInterval = 100;
+	bool blocking = true;
+	int reconnectionDelay = 30000;
+	/** Only used by the sending thread */
+	UnixDatagramSocket socket;
+	std::chrono::steady_clock::time_point nextConnectTime;
+	std::atomic<uint64_t> discardCount;
+
+	/** Messages waiting to be sent, guarded by bufferMutex */
+	std::vector<std::string> buffer;
+	bool stopping = false;
+	std::mutex bufferMutex;
+	std::condition_variable bufferChanged;
+	std::thread sender;
+
+	bool connect();
+	void send(std::vector<std::string>& messages);
+	void sendBufferedMessages();
+	void discard(size_t count);
+	void stopSender();
+};
+
+IMPLEMENT_LOG4CXX_OBJECT(UnixSocketAppender)
+
+#define _priv static_cast<UnixSocketAppenderPriv*>(m_priv.get())
+
+UnixSocketAppender::UnixSocketAppender()
+	: AppenderSkeleton(std::make_unique<UnixSocketAppenderPriv>())
+{
+}
+
+UnixSocketAppender::~UnixSocketAppender()
+{
+	finalize();
+}
+
+void UnixSocketAppender::setOption(const LogString& option, const LogString& value)
+{
+	if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("SOCKETPATH"), LOG4CXX_STR("socketpath")))
+	{
+		setSocketPath(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("SOCKETTYPE"), LOG4CXX_STR("sockettype")))
+	{
+		setSeqPacket(StringHelper::equalsIgnoreCase(value, LOG4CXX_STR("SEQPACKET"), LOG4CXX_STR("seqpacket")));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("SENDBUFFERSIZE"), LOG4CXX_STR("sendbuffersize")))
+	{
+		setSendBufferSize(int(OptionConverter::toFileSize(value, 0)));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("BUFFERSIZE"), LOG4CXX_STR("buffersize")))
+	{
+		setBufferSize(OptionConverter::toInt(value, 1));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("FLUSHINTERVAL"), LOG4CXX_STR("flushinterval")))
+	{
+		setFlushInterval(OptionConverter::toInt(value, 100));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("BLOCKING"), LOG4CXX_STR("blocking")))
+	{
+		setBlocking(OptionConverter::toBoolean(value, true));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("RECONNECTIONDELAY"), LOG4CXX_STR("reconnectiondelay")))
+	{
+		setReconnectionDelay(OptionConverter::toInt(value, 30000));
+	}
+	else
+	{
+		AppenderSkeleton::setOption(option, value);
+	}
+}
+
+void UnixSocketAppender::activateOptions(Pool& p)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->stopSender();
+	if (_priv->socketPath.empty())
+	{
+		_priv->errorHandler->error(LOG4CXX_STR("No socket path is set for UnixSocketAppender named [")
+			+ _priv->name + LOG4CXX_STR("]."));
+		return;
+	}
+	_priv->socket.close();
+	_priv->nextConnectTime = std::chrono::steady_clock::time_point();
+	_priv->connect();
+	if (1 < _priv->bufferSize)
+	{
+		_priv->stopping = false;
+		_priv->sender = ThreadUtility::instance()->createThread( LOG4CXX_STR("UnixSocketAppender"), &UnixSocketAppenderPriv::sendBufferedMessages, _priv );
+	}
+	AppenderSkeleton::activateOptions(p);
+}
+
+void UnixSocketAppender::close()
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	if (_priv->closed)
+		return;
+	_priv->closed = true;
+	_priv->stopSender();
+	_priv->socket.close();
+}
+
+void UnixSocketAppender::append(const spi::LoggingEventPtr& event, Pool& p)
+{
+	LogString msg;
+	_priv->layout->format(msg, event, p);
+	std::string encoded;
+	Transcoder::encode(msg, encoded);
+
+	if (_priv->sender.joinable())
+	{
+		std::lock_guard<std::mutex> lock(_priv->bufferMutex);
+		// Limit the memory used when the receiver cannot keep up
+		if (size_t(_priv->bufferSize) * 8 <= _priv->buffer.size())
+		{
+			_priv->discard(1);
+			return;
+		}
+		_priv->buffer.push_back(std::move(encoded));
+		if (_priv->buffer.size() == size_t(_priv->bufferSize))
+			_priv->bufferChanged.notify_all();
+		return;
+	}
+
+	std::vector<std::string> messages(1, std::move(encoded));
+	_priv->send(messages);
+}
+
+bool UnixSocketAppender::UnixSocketAppenderPriv::connect()
+{
+	auto now = std::chrono::steady_clock::now();
+	if (now < nextConnectTime)
+		return false;
+	try
+	{
+		socket.connect(socketPath, seqPacket, sendBufferSize);
+		return true;
+	}
+	catch (SocketException& e)
+	{
+		nextConnectTime = now + std::chrono::milliseconds(reconnectionDelay);
+		LogString msg = LOG4CXX_STR("Could not connect to ") + socketPath;
+		LogLog::warn(msg, e);
+		errorHandler->error(msg, e, spi::ErrorCode::GENERIC_FAILURE);
+	}
+	return false;
+}
+
+void UnixSocketAppender::UnixSocketAppenderPriv::send(std::vector<std::string>& messages)
+{
+	if (socket.isClosed() && !connect())
+	{
+		discard(messages.size());
+		messages.clear();
+		return;
+	}
+	size_t sent = 0;
+	size_t rejected = 0;
+	try
+	{
+		sent = socket.send(messages, 0, blocking, rejected);
+	}
+	catch (SocketException& e)
+	{
+		socket.close();
+		// Try to reconnect immediately as the receiver may have restarted
+		nextConnectTime = std::chrono::steady_clock::time_point();
+		LogString msg = LOG4CXX_STR("Could not send to ") + socketPath;
+		LogLog::warn(msg, e);
+		errorHandler->error(msg, e, spi::ErrorCode::WRITE_FAILURE);
+	}
+	discard(messages.size() - sent);
+	messages.clear();
+}
+
+void UnixSocketAppender::UnixSocketAppenderPriv::sendBufferedMessages()
+{
+	std::vector<std::string> messages;
+	bool finished = false;
+	while (!finished)
+	{
+		{
+			std::unique_lock<std::mutex> lock(bufferMutex);
+			bufferChanged.wait_for(lock, std::chrono::milliseconds(flushInterval), [this]()
+				{ return stopping || size_t(bufferSize) <= buffer.size(); });
+			std::swap(messages, buffer);
+			finished = stopping;
+		}
+		if (auto metrics = getMetrics())
+			metrics->setQueueDepth(messages.size());
+		if (!messages.empty())
+			send(messages);
+	}
+}
+
+void UnixSocketAppender::UnixSocketAppenderPriv::discard(size_t count)
+{
+	if (0 == count)
+		return;
+	discardCount.fetch_add(count, std::memory_order_relaxed);
+	if (auto metrics = getMetrics())
+		metrics->add(AppenderMetrics::Discards, count);
+}
+
+void UnixSocketAppender::UnixSocketAppenderPriv::stopSender()
+{
+	{
+		std::lock_guard<std::mutex> lock(bufferMutex);
+		stopping = true;
+		bufferChanged.notify_all();
+	}
+	if (sender.joinable())
+		sender.join();
+}
+
+void UnixSocketAppender::setSocketPath(const LogString& path)
+{
+	_priv->socketPath = path;
+}
+
+LogString UnixSocketAppender::getSocketPath() const
+{
+	return _priv->socketPath;
+}
+
+void UnixSocketAppender::setSeqPacket(bool newValue)
+{
+	_priv->seqPacket = newValue;
+}
+
+bool UnixSocketAppender::getSeqPacket() const
+{
+	return _priv->seqPacket;
+}
+
+void UnixSocketAppender::setSendBufferSize(int byteCount)
+{
+	_priv->sendBufferSize = (byteCount < 0) ? 0 : byteCount;
+}
+
+int UnixSocketAppender::getSendBufferSize() const
+{
+	return _priv->sendBufferSize;
+}
+
+void UnixSocketAppender::setBufferSize(int newValue)
+{
+	_priv->bufferSize = (newValue < 1) ? 1 : newValue;
+}
+
+int UnixSocketAppender::getBufferSize() const
+{
+	return _priv->bufferSize;
+}
+
+void UnixSocketAppender::setFlushInterval(int milliseconds)
+{
+	_priv->flushInterval = (milliseconds < 1) ? 1 : milliseconds;
+}
+
+int UnixSocketAppender::getFlushInterval() const
+{
+	return _priv->flushInterval;
+}
+
+void UnixSocketAppender::setBlocking(bool newValue)
+{
+	_priv->blocking = newValue;
+}
+
+bool UnixSocketAppender::getBlocking() const
+{
+	return _priv->blocking;
+}
+
+void UnixSocketAppender::setReconnectionDelay(int milliseconds)
+{
+	_priv->reconnectionDelay = (milliseconds < 0) ? 0 : milliseconds;
+}
+
+int UnixSocketAppender::getReconnectionDelay() const
+{
+	return _priv->reconnectionDelay;
+}
+
+uint64_t UnixSocketAppender::getDiscardCount() const
+{
+	return _priv->discardCount.load(std::memory_order_relaxed);
+}
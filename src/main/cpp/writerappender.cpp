@@ -19,6 +19,7 @@
 #include <log4cxx/helpers/loglog.h>
 #include <log4cxx/layout.h>
 #include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/optionconverter.h>
 #include <log4cxx/private/appenderskeleton_priv.h>
 #include <log4cxx/private/writerappender_priv.h>
 #include <mutex>
@@ -88,6 +89,115 @@ void WriterAppender::activateOptions(Pool& p)
 
 
 
+void WriterAppender::doAppend(const spi::LoggingEventPtr& event, Pool& pool1)
+{
+	LayoutPtr layout(_priv->layout);
+
+	if (!_priv->concurrentFormat || !layout)
+	{
+		AppenderSkeleton::doAppend(event, pool1);
+		return;
+	}
+
+	// Events rejected by the threshold or a filter are not formatted
+	if (!_priv->isAccepted(event))
+	{
+		return;
+	}
+
+	// Format without holding the appender lock
+	LogString msg;
+	layout->format(msg, event, pool1);
+	{
+		std::lock_guard<std::mutex> lock(_priv->pendingMutex);
+		_priv->pendingEvents.emplace_back(event, std::move(msg));
+	}
+
+	auto metrics = _priv->getMetrics();
+	std::chrono::steady_clock::time_point start;
+	if (metrics)
+		start = std::chrono::steady_clock::now();
+	{
+		std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+		if (metrics)
+			metrics->record(AppenderMetrics::LockWait, std::chrono::steady_clock::now() - start);
+
+		// The event may have been written by the previous lock holder
+		AppenderMetrics::ScopedTimer timer(metrics, AppenderMetrics::AppendLatency);
+		appendPendingEvents(pool1);
+	}
+	if (metrics)
+	{
+		metrics->add(AppenderMetrics::EventsAppended);
+		_priv->reportMetricsIfDue();
+	}
+}
+
+/**
+   Append the events formatted by all threads, in the order they were queued,
+   and write their combined output.
+*/
+void WriterAppender::appendPendingEvents(Pool& p)
+{
+	std::vector<std::pair<spi::LoggingEventPtr, LogString>> events;
+	{
+		std::lock_guard<std::mutex> lock(_priv->pendingMutex);
+		events.swap(_priv->pendingEvents);
+	}
+
+	if (events.empty())
+	{
+		return;
+	}
+
+	if (_priv->closed)
+	{
+		LogLog::error(((LogString) LOG4CXX_STR("Attempted to append to closed appender named ["))
+			+ _priv->name + LOG4CXX_STR("]."));
+		return;
+	}
+
+	_priv->combining = true;
+
+	for (auto& item : events)
+	{
+		_priv->preformatted = &item.second;
+
+		try
+		{
+			append(item.first, p);
+		}
+		catch (std::exception&)
+		{
+			_priv->preformatted = nullptr;
+			_priv->combining = false;
+			throw;
+		}
+	}
+
+	_priv->preformatted = nullptr;
+	_priv->combining = false;
+	writeCombinedOutput(p);
+}
+
+/**
+   Write the output of the events appended since the last write.
+*/
+void WriterAppender::writeCombinedOutput(Pool& p)
+{
+	if (!_priv->combinedOutput.empty() && _priv->writer != NULL)
+	{
+		_priv->writer->write(_priv->combinedOutput, p);
+
+		if (_priv->immediateFlush)
+		{
+			_priv->writer->flush(p);
+		}
+	}
+
+	_priv->combinedOutput.clear();
+}
+
 void WriterAppender::append(const spi::LoggingEventPtr& event, Pool& pool1)
 {
 
@@ -188,6 +298,7 @@ void WriterAppender::closeWriter()
 			//   Using the object's pool since this is a one-shot operation
 			//    and pool is likely to be reclaimed soon when appender is destructed.
 			//
+			writeCombinedOutput(_priv->pool);
 			writeFooter(_priv->pool);
 			_priv->writer->close(_priv->pool);
 			_priv->writer = 0;
@@ -252,10 +363,24 @@ void WriterAppender::setEncoding(const LogString& enc)
 
 void WriterAppender::subAppend(const spi::LoggingEventPtr& event, Pool& p)
 {
-	LogString msg;
-	_priv->layout->format(msg, event, p);
+	LogString formatted;
+	const LogString* pMsg = _priv->preformatted;
 
-	if (_priv->writer != NULL)
+	if (!pMsg)
+	{
+		_priv->layout->format(formatted, event, p);
+		pMsg = &formatted;
+	}
+
+	const LogString& msg = *pMsg;
+
+	if (_priv->writer != NULL && _priv->combining)
+	{
+		_priv->combinedOutput.append(msg);
+		if (auto metrics = _priv->getMetrics())
+			metrics->add(AppenderMetrics::BytesWritten, msg.size() * sizeof(logchar));
+	}
+	else if (_priv->writer != NULL)
 	{
 		_priv->writer->write(msg, p);
 
@@ -263,6 +388,8 @@ void WriterAppender::subAppend(const spi::LoggingEventPtr& event, Pool& p)
 		{
 			_priv->writer->flush(p);
 		}
+		if (auto metrics = _priv->getMetrics())
+			metrics->add(AppenderMetrics::BytesWritten, msg.size() * sizeof(logchar));
 	}
 }
 
@@ -310,6 +437,10 @@ void WriterAppender::setOption(const LogString& option, const LogString& value)
 	{
 		setEncoding(value);
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("CONCURRENTFORMAT"), LOG4CXX_STR("concurrentformat")))
+	{
+		setConcurrentFormat(OptionConverter::toBoolean(value, false));
+	}
 	else
 	{
 		AppenderSkeleton::setOption(option, value);
@@ -317,6 +448,17 @@ void WriterAppender::setOption(const LogString& option, const LogString& value)
 }
 
 
+void WriterAppender::setConcurrentFormat(bool value)
+{
+	std::lock_guard<std::recursive_mutex> lock(_priv->mutex);
+	_priv->concurrentFormat = value;
+}
+
+bool WriterAppender::getConcurrentFormat() const
+{
+	return _priv->concurrentFormat;
+}
+
 void WriterAppender::setImmediateFlush(bool value)
 {
 	_priv->immediateFlush = value;
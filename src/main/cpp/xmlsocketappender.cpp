@@ -123,7 +123,15 @@ void XMLSocketAppender::cleanUp(Pool& p)
 
 void XMLSocketAppender::append(const spi::LoggingEventPtr& event, LOG4CXX_NS::helpers::Pool& p)
 {
-	if (_priv->writer)
+	if (_priv->backgroundSend)
+	{
+		LogString output;
+		_priv->layout->format(output, event, p);
+		std::string bytes;
+		Transcoder::encodeUTF8(output, bytes);
+		enqueue(std::move(bytes));
+	}
+	else if (_priv->writer)
 	{
 		LogString output;
 		_priv->layout->format(output, event, p);
@@ -22,6 +22,7 @@
 #include <log4cxx/helpers/transcoder.h>
 #include <log4cxx/private/action_priv.h>
 #include <log4cxx/helpers/loglog.h>
+#include <log4cxx/helpers/logfileindex.h>
 
 using namespace LOG4CXX_NS;
 using namespace LOG4CXX_NS::rolling;
@@ -144,6 +145,8 @@ bool ZipCompressAction::execute(LOG4CXX_NS::helpers::Pool& p) const
 	if (priv->deleteSource)
 	{
 		priv->source.deleteFile(p);
+		// The time index does not describe the compressed file
+		LogFileIndex::deleteIndexFile(priv->source.getPath(), p);
 	}
 
 	return true;
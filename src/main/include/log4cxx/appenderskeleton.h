@@ -24,6 +24,7 @@
 #include <log4cxx/spi/filter.h>
 #include <log4cxx/helpers/object.h>
 #include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/appendermetrics.h>
 #include <log4cxx/level.h>
 
 namespace LOG4CXX_NS
@@ -34,6 +35,13 @@ namespace LOG4CXX_NS
 *
 *  This class provides the code for common functionality, such as
 *  support for threshold filtering and support for general filters.
+*
+*  Filters are called by the logging thread before it acquires the appender lock,
+*  so several threads may be in the same filter at once.
+*  Only the leading filter::LevelMatchFilter, filter::LevelRangeFilter
+*  and filter::DenyAllFilter instances are exempt, as their decision is precomputed.
+*  A custom filter that keeps state between calls (for example, a counter or the previous event)
+*  is no longer serialized by the appender lock and must protect that state itself.
 * */
 class LOG4CXX_EXPORT AppenderSkeleton :
 	public virtual Appender,
@@ -83,6 +91,11 @@ class LOG4CXX_EXPORT AppenderSkeleton :
 		Supported options | Supported values | Default value
 		-------------- | ---------------- | ---------------
 		Threshold | Trace,Debug,Info,Warn,Error,Fatal,Off,All | All
+		Metrics | True,False | False
+		MetricsLogger | {any} | -
+		MetricsInterval | {int} | 0
+
+		\sa setMetricsEnabled, setMetricsLogger, setMetricsInterval
 		*/
 		void setOption(const LogString& option, const LogString& value) override;
 
@@ -144,6 +157,11 @@ class LOG4CXX_EXPORT AppenderSkeleton :
 		* This method performs threshold checks and invokes filters before
 		* delegating actual logging to the subclasses specific
 		* AppenderSkeleton#append method.
+		*
+		* The threshold and filters are checked before the appender lock is acquired,
+		* so spi::Filter::decide implementations must allow concurrent calls.
+		* The decision of leading filter::LevelMatchFilter, filter::LevelRangeFilter and filter::DenyAllFilter instances
+		* is precomputed for each built-in level, so requires no virtual function call.
 		* */
 		void doAppend(const spi::LoggingEventPtr& event, helpers::Pool& pool) override;
 
@@ -174,6 +192,50 @@ class LOG4CXX_EXPORT AppenderSkeleton :
 		*/
 		void setThreshold(const LevelPtr& threshold);
 
+		/**
+		Use \c newValue to control whether measurements of the activity of this appender are collected.
+
+		When enabled, the number of events appended, bytes written and events denied by filters
+		along with the distribution of the time spent waiting for and holding the appender lock
+		are available from #getMetrics.
+		Collection adds a few clock reads to each logging request. The default is false.
+
+		<p>In configuration files this option is specified by setting the
+		value of the <b>Metrics</b> option to true or false.
+		*/
+		void setMetricsEnabled(bool newValue);
+
+		/**
+		Are measurements of the activity of this appender collected?
+		*/
+		bool getMetricsEnabled() const;
+
+		/**
+		The measurements of the activity of this appender.
+		The return value is <code>nullptr</code> when metrics are not enabled.
+		*/
+		helpers::AppenderMetricsPtr getMetrics() const;
+
+		/**
+		Use \c loggerName as the name of the logger that receives a periodic summary of the metrics.
+
+		<p>In configuration files this option is specified by setting the
+		value of the <b>MetricsLogger</b> option.
+		*/
+		void setMetricsLogger(const LogString& loggerName);
+
+		/**
+		Send a summary of the metrics to the metrics logger at intervals of \c milliseconds.
+
+		The summary is sent at the INFO level by the first logging request
+		after the interval elapses, so an idle appender sends no summary.
+		Zero (the default) disables the summary.
+
+		<p>In configuration files this option is specified by setting the
+		value of the <b>MetricsInterval</b> option.
+		*/
+		void setMetricsInterval(int milliseconds);
+
 }; // class AppenderSkeleton
 }  // namespace log4cxx
 
@@ -185,6 +185,41 @@ class LOG4CXX_EXPORT AsyncAppender :
 		 */
 		bool getBlocking() const;
 
+		/**
+		 * Sets whether undispatched events are written when the process receives
+		 * a fatal signal (SIGSEGV, SIGABRT and similar).
+		 *
+		 * As formatting is not possible in a signal handler,
+		 * each event is written as a line holding the time (in seconds since 1970),
+		 * level, logger name and message
+		 * to the <b>EmergencyFile</b> or, when that is empty, the standard error stream.
+		 * Events already passed to a FileAppender with the <b>EmergencyDrain</b> option
+		 * are written to its file first.
+		 * Signal handling is not available on Windows.
+		 *
+		 * @param value true if undispatched events should be written.
+		 */
+		void setEmergencyDrain(bool value);
+
+		/**
+		 * Gets whether undispatched events are written when the process receives a fatal signal.
+		 */
+		bool getEmergencyDrain() const;
+
+		/**
+		 * Sets the file to which the undispatched events are appended
+		 * when the process receives a fatal signal.
+		 *
+		 * @param fileName the file name, or empty for the standard error stream.
+		 */
+		void setEmergencyFile(const LogString& fileName);
+
+		/**
+		 * Gets the file to which the undispatched events are appended
+		 * when the process receives a fatal signal.
+		 */
+		LogString getEmergencyFile() const;
+
 
 		/**
 		\copybrief AppenderSkeleton::setOption()
@@ -194,6 +229,12 @@ class LOG4CXX_EXPORT AsyncAppender :
 		LocationInfo | True,False | False
 		BufferSize | int  | 128
 		Blocking | True,False | True
+		EmergencyDrain | True,False | False
+		EmergencyFile | {any} | -
+
+		When the <b>Metrics</b> option is enabled,
+		the number of undispatched events and the number of discarded events
+		are also measured, which can be used to choose a suitable <b>BufferSize</b>.
 
 		\sa AppenderSkeleton::setOption()
 		 */
@@ -33,6 +33,32 @@ namespace LOG4CXX_NS
 * or use the cmake directive `LOG4CXX_FORCE_WIDE_CONSOLE=ON` when building Log4cxx
 * to force Log4cxx to use <a href="https://en.cppreference.com/w/c/io/fputws">fputws</a>.
 * If doing this ensure the cmake directive `LOG4CXX_WCHAR_T` is also enabled.
+*
+* When the <b>DirectWrite</b> option is enabled, each event is encoded into a reusable buffer
+* and passed to the operating system in a single write call (bypassing the C stdio buffer),
+* so lines from different processes sharing a pipe are not interleaved
+* (provided each event is shorter than PIPE_BUF bytes).
+* When <b>ImmediateFlush</b> is disabled, events are collected
+* until <b>BufferSize</b> bytes are waiting or <b>FlushInterval</b> milliseconds have elapsed,
+* so several events are written by one call.
+* Where PIPE_BUF is defined, collected output longer than PIPE_BUF bytes
+* is split into writes that each end at a line boundary, so events are still not interleaved.
+* When <b>BackgroundWrite</b> is enabled, the write calls are made by a dedicated thread,
+* so a slow reader (e.g. a container runtime) does not delay the logging threads.
+* Up to eight times <b>BufferSize</b> bytes are then held while the reader is busy;
+* further events are discarded.
+* <b>DirectWrite</b> is not used when the target stream is wide oriented.
+*
+* Here is an example configuration:
+* ~~~{.xml}
+* <appender name="STDOUT" class="ConsoleAppender">
+*   <param name="DirectWrite" value="true" />
+*   <param name="ImmediateFlush" value="false" />
+*   <param name="FlushInterval" value="200" />
+*   <param name="BackgroundWrite" value="true" />
+*   <layout class="JSONLayout" />
+* </appender>
+* ~~~
 */
 class LOG4CXX_EXPORT ConsoleAppender : public WriterAppender
 {
@@ -94,6 +120,14 @@ class LOG4CXX_EXPORT ConsoleAppender : public WriterAppender
 		Supported options | Supported values | Default value
 		-------------- | ---------------- | ---------------
 		Target | System.err,System.out | System.out
+		DirectWrite | True,False | False
+		ImmediateFlush | True,False | True
+		BufferSize | (\ref consoleSz "1") | 8 KB
+		FlushInterval | int | 1000
+		BackgroundWrite | True,False | False
+
+		\anchor consoleSz (1) An integer with an optional KB, MB or GB suffix.
+		Only used when <b>DirectWrite</b> is enabled.
 
 		\sa WriterAppender::setOption()
 		 */
@@ -109,6 +143,53 @@ class LOG4CXX_EXPORT ConsoleAppender : public WriterAppender
 		*/
 		static const LogString& getSystemErr();
 
+		/**
+		* Write each event using a single operating system call when \c newValue is true.
+		*/
+		void setDirectWrite(bool newValue);
+
+		/**
+		* Is each event written using a single operating system call?
+		*/
+		bool getDirectWrite() const;
+
+		/**
+		* Write when \c byteCount bytes are waiting (when <b>ImmediateFlush</b> is false).
+		*/
+		void setBufferSize(size_t byteCount);
+
+		/**
+		* The number of bytes collected before writing.
+		*/
+		size_t getBufferSize() const;
+
+		/**
+		* Write collected events at least every \c milliseconds.
+		*/
+		void setFlushInterval(int milliseconds);
+
+		/**
+		* The maximum milliseconds an event waits to be written.
+		*/
+		int getFlushInterval() const;
+
+		/**
+		* Use a dedicated thread to write the output when \c newValue is true.
+		*/
+		void setBackgroundWrite(bool newValue);
+
+		/**
+		* Is the output written by a dedicated thread?
+		*/
+		bool getBackgroundWrite() const;
+
+		/**
+		* Write any collected output and close this appender.
+		*/
+		void close() override;
+
+	protected:
+		void subAppend(const spi::LoggingEventPtr& event, helpers::Pool& p) override;
 
 	private:
 		void targetWarn(const LogString& val);
@@ -109,6 +109,14 @@ namespace db
  *   <param name="ColumnMapping" value="message"/>
  * </appender>
  * ~~~
+ *
+ * When <code>BufferSize</code> is greater than one, events are formatted on the logging thread
+ * and written by a background thread, so a slow database does not delay the application.
+ * The background thread inserts the buffered rows in a single transaction
+ * when <code>BufferSize</code> rows are waiting or <code>FlushInterval</code> milliseconds have elapsed.
+ * Rows that cannot be inserted are reported once per batch.
+ * Up to <code>MaxPendingRows</code> rows (by default eight times <code>BufferSize</code>)
+ * are held while the database is busy; further events are discarded.
  */
 class LOG4CXX_EXPORT DBAppender : public AppenderSkeleton
 {
@@ -132,8 +140,13 @@ class LOG4CXX_EXPORT DBAppender : public AppenderSkeleton
                 DatabaseName | {any} | -
                 SQL | {any} | -
                 ColumnMapping | (\ref rep "^") | -
+                BufferSize | int | 1
+                FlushInterval | int | 1000
+                MaxPendingRows | int | (\ref pendingRows "*")
 
                 \anchor rep (^) One value for each '%%' character in the SQL value.
+
+                \anchor pendingRows (*) Eight times the BufferSize value.
                 \sa AppenderSkeleton::setOption()
                 */
                 void setOption(const LogString& option, const LogString& value) override;
@@ -168,6 +181,40 @@ class LOG4CXX_EXPORT DBAppender : public AppenderSkeleton
                 */
                 const LogString& getSql() const;
 
+                /**
+                * Use a background thread to insert \c newValue rows in each transaction
+                * when \c newValue is greater than one.
+                * Takes effect when activateOptions() is called.
+                */
+                void setBufferSize(int newValue);
+
+                /**
+                * The number of rows inserted in each transaction.
+                */
+                int getBufferSize() const;
+
+                /**
+                * Insert buffered rows at least every \c milliseconds.
+                */
+                void setFlushInterval(int milliseconds);
+
+                /**
+                * The maximum milliseconds a buffered row waits to be inserted.
+                */
+                int getFlushInterval() const;
+
+                /**
+                * Discard events when \c count rows are waiting to be inserted.
+                * Zero (the default) uses eight times the buffer size.
+                */
+                void setMaxPendingRows(int count);
+
+                /**
+                * The number of waiting rows at which events are discarded,
+                * or zero when it is eight times the buffer size.
+                */
+                int getMaxPendingRows() const;
+
         private:
                 DBAppender(const DBAppender&);
                 DBAppender& operator=(const DBAppender&);
@@ -72,6 +72,13 @@ The following <b>param</b> elements are optional:
   Delay executing the sql until this many logging events are available.
   One by default, meaning an sql statement is executed
   whenever a logging event is appended.
+  When greater than one, the buffered events are inserted in a single transaction
+  and, if the ODBC driver supports parameter arrays, a single execution of the sql statement.
+- <b>BackgroundFlush</b> -
+  Insert full buffers on a background thread
+  so the logging thread does not wait for the database.
+  Up to eight buffers are held while the database is busy;
+  further events are discarded.
 - <b>ColumnMapping</b> -
   One element for each "?" in the <b>sql</b> statement
   in a sequence corresponding to the columns in the insert statement.
@@ -162,6 +169,7 @@ class LOG4CXX_EXPORT ODBCAppender : public AppenderSkeleton
 		Supported options | Supported values | Default value
 		:-------------- | :----------------: | :---------------:
 		BufferSize | {int} | 1
+		BackgroundFlush | True,False | False
 		ConnectionString | {any} | -
 		URL | {any} | -
 		DSN | {any} | -
@@ -225,11 +233,8 @@ class LOG4CXX_EXPORT ODBCAppender : public AppenderSkeleton
 		void close() override;
 
 		/**
-		* loops through the buffer of LoggingEvents, gets a
-		* sql string from getLogStatement() and sends it to execute().
+		* Inserts the buffered LoggingEvents using the prepared sql statement.
 		* Errors are sent to the errorHandler.
-		*
-		* If a statement fails the LoggingEvent stays in the buffer!
 		*/
 		virtual void flushBuffer(LOG4CXX_NS::helpers::Pool& p);
 
@@ -264,6 +269,17 @@ class LOG4CXX_EXPORT ODBCAppender : public AppenderSkeleton
 		const LogString& getPassword() const;
 
 		size_t getBufferSize() const;
+
+		/**
+		* Use a background thread to insert the buffered events when \c newValue is true.
+		* Takes effect when activateOptions() is called.
+		*/
+		void setBackgroundFlush(bool newValue);
+
+		/**
+		* Are buffered events inserted by a background thread?
+		*/
+		bool getBackgroundFlush() const;
 	private:
 		ODBCAppender(const ODBCAppender&);
 		ODBCAppender& operator=(const ODBCAppender&);
@@ -273,6 +289,8 @@ class LOG4CXX_EXPORT ODBCAppender : public AppenderSkeleton
 #endif
 		static void encode(unsigned short** dest, const LogString& src,
 			LOG4CXX_NS::helpers::Pool& p);
+		void writeEvents(const std::vector<spi::LoggingEventPtr>& events, LOG4CXX_NS::helpers::Pool& p);
+		void writePendingEvents();
 
 	protected:
 		struct ODBCAppenderPriv;
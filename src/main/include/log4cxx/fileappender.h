@@ -132,6 +132,12 @@ class LOG4CXX_EXPORT FileAppender : public WriterAppender
 		BufferedIO | True,False | False
 		ImmediateFlush | True,False | False
 		BufferSize | (\ref fileSz1 "1") | 8 KB
+		Durability | None,GroupCommit | None
+		Compression | None,GZip | None
+		CompressionFrameSize | (\ref fileSz1 "1") | 1 MB
+		CompressionInterval | {int} | 1000
+		IndexInterval | (\ref fileSz1 "1") | 0
+		EmergencyDrain | True,False | False
 
 		\anchor fileSz1 (1) An integer in the range 0 - 2^63.
 		 You can specify the value with the suffixes "KB", "MB" or "GB" so that the integer is
@@ -142,6 +148,124 @@ class LOG4CXX_EXPORT FileAppender : public WriterAppender
 		*/
 		void setOption(const LogString& option, const LogString& value) override;
 
+		/**
+		Use \c value (None or GroupCommit) as the <b>Durability</b> option.
+
+		With GroupCommit, a thread logging to this appender does not continue
+		until the output is on stable storage.
+		A single syncer thread flushes buffered output and issues one fdatasync
+		for all the events written while the previous one was in progress,
+		so throughput grows with the number of logging threads.
+
+		\sa setOption
+		*/
+		void setDurability(const LogString& value);
+
+		/**
+		Get the value of the <b>Durability</b> option.
+		*/
+		LogString getDurability() const;
+
+		/**
+		Use \c value (None or GZip) as the <b>Compression</b> option.
+
+		With GZip, output is compressed as it is written, into a sequence of gzip members
+		that can each be decompressed independently, so a truncated file
+		can be read up to the last completed member.
+		A member is completed when it holds <b>CompressionFrameSize</b> bytes of output,
+		on the first write or flush <b>CompressionInterval</b> milliseconds after it was started,
+		and when the file is closed.
+		A background thread also checks every <b>CompressionInterval</b> milliseconds
+		for a member that has been open longer than the interval,
+		so the output of an idle appender is completed within twice the interval.
+
+		GZip is only available when log4cxx is built with zlib.
+
+		\sa setOption
+		*/
+		void setCompression(const LogString& value);
+
+		/**
+		Get the value of the <b>Compression</b> option.
+		*/
+		LogString getCompression() const;
+
+		/**
+		Use \c value as the uncompressed size of a gzip member.
+		*/
+		void setCompressionFrameSize(size_t value);
+
+		/**
+		Get the value of the <b>CompressionFrameSize</b> option.
+		*/
+		size_t getCompressionFrameSize() const;
+
+		/**
+		Use \c milliseconds as the maximum age of a started gzip member
+		when output is written or flushed, and as the period
+		of the check for an idle member.
+		*/
+		void setCompressionInterval(int milliseconds);
+
+		/**
+		Get the value of the <b>CompressionInterval</b> option.
+		*/
+		int getCompressionInterval() const;
+
+		/**
+		Use \c value as the size of the log file blocks described by a time index.
+
+		When non-zero, an index file (the log file name plus ".idx") is maintained
+		which holds the range of timestamps, the levels and a bloom filter of the logger names
+		for each block of (roughly) \c value bytes of the log file.
+		helpers::LogFileIndex reads the index and finds the parts of the file
+		that can hold events of interest.
+		A rollover that renames the log file also renames its index.
+
+		An index is not maintained for compressed output.
+
+		\sa setOption
+		*/
+		void setIndexInterval(size_t value);
+
+		/**
+		Get the value of the <b>IndexInterval</b> option.
+		*/
+		size_t getIndexInterval() const;
+
+		/**
+		Use \c value as the <b>EmergencyDrain</b> option.
+
+		When true and <b>BufferedIO</b> is true, output is held in a byte buffer
+		which a handler for fatal signals (SIGSEGV, SIGABRT and similar)
+		writes to the file before the process ends,
+		so the events that explain a crash are not lost.
+		The buffer holds (roughly) <b>BufferSize</b> bytes.
+		Compressed output is not drained.
+		Signal handling is not available on Windows.
+
+		\sa setOption
+		*/
+		void setEmergencyDrain(bool value);
+
+		/**
+		Get the value of the <b>EmergencyDrain</b> option.
+		*/
+		bool getEmergencyDrain() const;
+
+		/**
+		\copybrief AppenderSkeleton::doAppend()
+
+		When the <b>Durability</b> option is GroupCommit,
+		this returns once \c event is on stable storage.
+		*/
+		void doAppend(const spi::LoggingEventPtr& event, helpers::Pool& p) override;
+
+		/**
+		\copybrief WriterAppender::close()
+		*/
+		void close() override;
+
 		/**
 		Get the value of the <b>BufferedIO</b> option.
 
@@ -195,6 +319,10 @@ class LOG4CXX_EXPORT FileAppender : public WriterAppender
 	protected:
 		void activateOptionsInternal(LOG4CXX_NS::helpers::Pool& p);
 
+		void subAppend(const spi::LoggingEventPtr& event, LOG4CXX_NS::helpers::Pool& p) override;
+
+		helpers::WriterPtr createWriter(helpers::OutputStreamPtr& os) override;
+
 		/**
 		Sets and <i>opens</i> the file where the log output will
 		go. The specified file must be writable.
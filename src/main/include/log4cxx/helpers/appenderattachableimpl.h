@@ -101,6 +101,13 @@ class LOG4CXX_EXPORT AppenderAttachableImpl :
 		 */
 		void removeAppender(const LogString& name) override;
 
+		/**
+		 * Replace the attached appenders with \c newList in a single step.
+		 * Removed appenders are not closed.
+		 * @returns the previously attached appenders.
+		 */
+		AppenderList replaceAppenders(const AppenderList& newList);
+
 	private:
 		LOG4CXX_DECLARE_PRIVATE_MEMBER_PTR(priv_data, m_priv)
 
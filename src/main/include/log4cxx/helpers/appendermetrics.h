@@ -0,0 +1,225 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_HELPERS_APPENDER_METRICS_H
+#define _LOG4CXX_HELPERS_APPENDER_METRICS_H
+
+#include <log4cxx/logstring.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace LOG4CXX_NS
+{
+namespace helpers
+{
+
+/**
+Counters and latency histograms describing the activity of an appender.
+
+Updates are made to one of a number of shards selected by the calling thread,
+so threads logging concurrently seldom write to the same cache line.
+The shards are combined when a snapshot is taken.
+
+Latencies are held in log-linear buckets (in the manner of an HDR histogram)
+that have a relative error of at most 12.5%.
+*/
+class LOG4CXX_EXPORT AppenderMetrics
+{
+	public:
+		/**
+		The values accumulated by #add.
+		*/
+		enum Counter
+		{
+			EventsAppended,   //!< Events passed to the appender implementation
+			BytesWritten,     //!< Size of the formatted output before character set encoding
+			FilterDenials,    //!< Events rejected by the threshold or a filter
+			Discards,         //!< Events dropped due to a full buffer
+			CounterCount
+		};
+
+		/**
+		The durations recorded by #record.
+		*/
+		enum Histogram
+		{
+			AppendLatency,    //!< Time to process an event once the appender lock is held
+			LockWait,         //!< Time waiting for the appender lock (HistogramSnapshot::getTotal is the time spent waiting)
+			RolloverDuration, //!< Time to roll over the output file
+			HistogramCount
+		};
+
+		/**
+		The distribution of the durations recorded in a histogram.
+		*/
+		class LOG4CXX_EXPORT HistogramSnapshot
+		{
+			public:
+				HistogramSnapshot();
+
+				/**
+				The number of durations recorded.
+				*/
+				uint64_t getCount() const;
+
+				/**
+				The sum of the recorded durations in nanoseconds.
+				*/
+				uint64_t getTotal() const;
+
+				/**
+				The largest recorded duration in nanoseconds.
+				*/
+				uint64_t getMaximum() const;
+
+				/**
+				The mean of the recorded durations in nanoseconds.
+				*/
+				uint64_t getMean() const;
+
+				/**
+				An upper bound of the duration (in nanoseconds)
+				at or below which \c percentile percent of the recorded durations fall.
+				*/
+				uint64_t getValueAtPercentile(double percentile) const;
+
+				/**
+				The number of durations in each bucket.
+				*/
+				const std::vector<uint64_t>& getBuckets() const;
+
+			private:
+				friend class AppenderMetrics;
+				uint64_t m_count;
+				uint64_t m_total;
+				uint64_t m_maximum;
+				std::vector<uint64_t> m_buckets;
+		};
+
+		/**
+		The combined values of all shards at a point in time.
+		*/
+		struct Snapshot
+		{
+			uint64_t counters[CounterCount];
+			HistogramSnapshot histograms[HistogramCount];
+			uint64_t queueDepth;        //!< The number of undispatched events when last measured
+			uint64_t maximumQueueDepth; //!< The largest number of undispatched events
+		};
+
+		/**
+		Records the time from construction to destruction in a histogram.
+		*/
+		class ScopedTimer
+		{
+			public:
+				/**
+				Measure the duration of the current scope if \c metrics is not null.
+				*/
+				ScopedTimer(AppenderMetrics* metrics, Histogram histogram)
+					: m_metrics(metrics)
+					, m_histogram(histogram)
+				{
+					if (m_metrics)
+						m_start = std::chrono::steady_clock::now();
+				}
+
+				~ScopedTimer()
+				{
+					if (m_metrics)
+						m_metrics->record(m_histogram, std::chrono::steady_clock::now() - m_start);
+				}
+
+			private:
+				AppenderMetrics* m_metrics;
+				Histogram m_histogram;
+				std::chrono::steady_clock::time_point m_start;
+				ScopedTimer(const ScopedTimer&);
+				ScopedTimer& operator=(const ScopedTimer&);
+		};
+
+		AppenderMetrics();
+		~AppenderMetrics();
+
+		/**
+		Increase \c counter by \c value.
+		*/
+		void add(Counter counter, uint64_t value = 1);
+
+		/**
+		Add \c duration to \c histogram.
+		*/
+		void record(Histogram histogram, std::chrono::nanoseconds duration);
+
+		/**
+		Set the number of undispatched events to \c depth.
+		*/
+		void setQueueDepth(uint64_t depth);
+
+		/**
+		The current values.
+		*/
+		Snapshot getSnapshot() const;
+
+		/**
+		Set all values to zero.
+		*/
+		void reset();
+
+		/**
+		Append a single line summary of \c snapshot to \c dest.
+		*/
+		static void format(LogString& dest, const Snapshot& snapshot);
+
+		/**
+		The name of \c counter.
+		*/
+		static LogString getName(Counter counter);
+
+		/**
+		The name of \c histogram.
+		*/
+		static LogString getName(Histogram histogram);
+
+		/**
+		The number of buckets in a histogram.
+		*/
+		static size_t getBucketCount();
+
+		/**
+		The index of the bucket that holds a duration of \c nanoseconds.
+		*/
+		static size_t getBucketIndex(uint64_t nanoseconds);
+
+		/**
+		The largest duration (in nanoseconds) held by the bucket at \c index.
+		*/
+		static uint64_t getBucketUpperBound(size_t index);
+
+	private:
+		LOG4CXX_DECLARE_PRIVATE_MEMBER_PTR(AppenderMetricsPrivate, m_priv)
+		AppenderMetrics(const AppenderMetrics&);
+		AppenderMetrics& operator=(const AppenderMetrics&);
+};
+LOG4CXX_PTR_DEF(AppenderMetrics);
+
+} // namespace helpers
+} // namespace LOG4CXX_NS
+
+#endif //_LOG4CXX_HELPERS_APPENDER_METRICS_H
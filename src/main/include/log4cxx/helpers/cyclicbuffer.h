@@ -81,6 +81,11 @@ class LOG4CXX_EXPORT CyclicBuffer
 		@throws IllegalArgumentException if <code>newSize</code> is negative.
 		*/
 		void resize(int newSize);
+
+		/**
+		Exchange the content and maximum size of this buffer with \c other.
+		*/
+		void swap(CyclicBuffer& other);
 }; // class CyclicBuffer
 }  //namespace helpers
 } //namespace log4cxx
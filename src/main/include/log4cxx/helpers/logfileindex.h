@@ -0,0 +1,152 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _LOG4CXX_HELPERS_LOG_FILE_INDEX_H
+#define _LOG4CXX_HELPERS_LOG_FILE_INDEX_H
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/level.h>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace LOG4CXX_NS
+{
+namespace helpers
+{
+class Pool;
+
+/**
+The format of the time index that FileAppender writes beside a log file
+when the <b>IndexInterval</b> option is set,
+and functions to find the parts of a log file that hold the events of interest.
+
+An index file starts with an eight byte signature which is followed by
+an entry for each block of (roughly) <b>IndexInterval</b> bytes of the log file.
+An entry holds the position and length of the block,
+the range of event timestamps in the block,
+the set of levels in the block and a bloom filter of logger names.
+
+Entries are written when a block is complete,
+so parts of the log file may not be described by an entry
+(for example the last block of a file that was not closed).
+Those parts are always included in the result of #findRanges.
+*/
+class LOG4CXX_EXPORT LogFileIndex
+{
+	public:
+		/**
+		The content of an index entry.
+		*/
+		struct Entry
+		{
+			uint64_t offset;              //!< The position of the first byte of the block
+			uint64_t length;              //!< The number of bytes in the block
+			log4cxx_time_t minimumTime;   //!< The earliest event timestamp in the block
+			log4cxx_time_t maximumTime;   //!< The latest event timestamp in the block
+			uint64_t loggers;             //!< A bloom filter of the logger names in the block
+			uint32_t levels;              //!< Bit getLevelBit(level) is set for each level in the block
+			uint32_t eventCount;          //!< The number of events in the block
+		};
+
+		/**
+		The size in bytes of an encoded entry.
+		*/
+		static const size_t EntrySize = 48;
+
+		/**
+		The size in bytes of the signature at the start of an index file.
+		*/
+		static const size_t HeaderSize = 8;
+
+		/**
+		A byte range [first, second) of a log file.
+		A \c second value of UINT64_MAX is the end of the file.
+		*/
+		typedef std::pair<uint64_t, uint64_t> Range;
+
+		/**
+		The name of the index file for \c logFileName.
+		*/
+		static LogString getIndexFileName(const LogString& logFileName);
+
+		/**
+		Remove the index file of \c logFileName, if there is one.
+		*/
+		static void deleteIndexFile(const LogString& logFileName, Pool& p);
+
+		/**
+		The bit used to record events of \c level.
+		*/
+		static uint32_t getLevelBit(const LevelPtr& level);
+
+		/**
+		The bits of levels as severe as \c threshold.
+		*/
+		static uint32_t getLevelMask(const LevelPtr& threshold);
+
+		/**
+		The bloom filter bits of \c loggerName.
+		*/
+		static uint64_t getLoggerBits(const LogString& loggerName);
+
+		/**
+		The signature at the start of an index file.
+		*/
+		static const char* getHeader();
+
+		/**
+		Store \c entry in the EntrySize bytes at \c dest.
+		*/
+		static void encode(const Entry& entry, char* dest);
+
+		/**
+		Load the EntrySize bytes at \c src into \c entry.
+		*/
+		static void decode(const char* src, Entry& entry);
+
+		/**
+		The entries in the index file \c indexFileName, in the order they were written.
+		An incomplete final entry is ignored.
+
+		@throws IOException if the file cannot be read or does not start with the signature.
+		*/
+		static std::vector<Entry> read(const LogString& indexFileName, Pool& p);
+
+		/**
+		The ranges of the log file described by \c entries that may hold events
+		with a timestamp in [\c from, \c to], a level in \c levelMask
+		and (unless \c loggerName is empty) the logger \c loggerName.
+		Adjacent ranges are merged.
+		*/
+		static std::vector<Range> findRanges
+			( const std::vector<Entry>& entries
+			, log4cxx_time_t from
+			, log4cxx_time_t to
+			, uint32_t levelMask = UINT32_MAX
+			, const LogString& loggerName = LogString()
+			);
+
+	private:
+		LogFileIndex();
+};
+
+} // namespace helpers
+} // namespace LOG4CXX_NS
+
+#endif //_LOG4CXX_HELPERS_LOG_FILE_INDEX_H
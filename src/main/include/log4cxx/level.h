@@ -240,6 +240,17 @@ class LOG4CXX_EXPORT Level : public helpers::Object
 		static LevelPtr getTrace();
 		static LevelPtr getOff();
 
+		/**
+		A pointer to \c level that is never deleted.
+
+		Copying the result does not update a reference count,
+		so a level passed between threads with every logging request
+		(e.g. a custom level held in a function scope static)
+		should be created using this method.
+		The built-in levels are created this way.
+		*/
+		static LevelPtr makePermanent(Level* level);
+
 
 		/**
 		Two levels are equal if their level fields are equal.
@@ -22,6 +22,7 @@
 #include <log4cxx/level.h>
 #include <log4cxx/helpers/pool.h>
 #include <log4cxx/spi/location/locationinfo.h>
+#include <log4cxx/spi/callsite.h>
 #include <log4cxx/helpers/resourcebundle.h>
 #include <log4cxx/helpers/messagebuffer.h>
 
@@ -2028,6 +2029,12 @@ class LOG4CXX_EXPORT Logger :
 		/**
 		 * Reconfigure this logger by configuring all of the appenders.
 		 *
+		 * The attached appenders are replaced in a single step,
+		 * so logging requests on other threads always see either the old or the new set.
+		 * Only a removed appender that is not attached to another logger is closed.
+		 * An appender in both the current and the new set is neither closed nor reattached,
+		 * whereas removeAllAppenders followed by addAppender closes every current appender.
+		 *
 		 * @param appenders The appenders to set.  Any currently existing appenders are removed.
 		 * @param additivity The additivity of this logger
 		 */
@@ -2151,7 +2158,8 @@ LOG4CXX_DEBUG(m_log, "AddMesh:"
 
 */
 #define LOG4CXX_DEBUG(logger, message) do { \
-		if (LOG4CXX_UNLIKELY(::LOG4CXX_NS::Logger::isDebugEnabledFor(logger))) {\
+		LOG4CXX_CALL_SITE(DEBUG_INT) \
+		if (LOG4CXX_UNLIKELY(LOG4CXX_CALL_SITE_IS_ENABLED(logger, Debug))) {\
 			::LOG4CXX_NS::helpers::MessageBuffer oss_; \
 			logger->addDebugEvent(oss_.extract_str(oss_ << message), LOG4CXX_LOCATION); }} while (0)
 
@@ -2175,7 +2183,8 @@ LOG4CXX_DEBUG_FMT(m_log, "AddMesh: name {} type 0x{x} materialName {} visible? {
 @param ... the variable parts of the message.
 */
 #define LOG4CXX_DEBUG_FMT(logger, fmt, ...) do { \
-		if (LOG4CXX_UNLIKELY(::LOG4CXX_NS::Logger::isDebugEnabledFor(logger))) {\
+		LOG4CXX_CALL_SITE(DEBUG_INT) \
+		if (LOG4CXX_UNLIKELY(LOG4CXX_CALL_SITE_IS_ENABLED(logger, Debug))) {\
 			logger->addDebugEvent(::LOG4CXX_FORMAT_NS::format(fmt LOG4CXX_FMT_VA_ARG(__VA_ARGS__) ), LOG4CXX_LOCATION); }} while (0)
 #else
 #define LOG4CXX_DEBUG(logger, message)
@@ -2195,7 +2204,8 @@ Add a new logging event containing \c message to attached appender(s) if \c logg
 @param message a valid r-value expression of an <code>operator<<(std::ostream&. ...)</code> overload.
 */
 #define LOG4CXX_TRACE(logger, message) do { \
-		if (LOG4CXX_UNLIKELY(::LOG4CXX_NS::Logger::isTraceEnabledFor(logger))) {\
+		LOG4CXX_CALL_SITE(TRACE_INT) \
+		if (LOG4CXX_UNLIKELY(LOG4CXX_CALL_SITE_IS_ENABLED(logger, Trace))) {\
 			::LOG4CXX_NS::helpers::MessageBuffer oss_; \
 			logger->addTraceEvent(oss_.extract_str(oss_ << message), LOG4CXX_LOCATION); }} while (0)
 
@@ -2212,7 +2222,8 @@ Add a new logging event containing a message defined by \c fmt and <code>...</co
 @param ... the variable parts of the message.
 */
 #define LOG4CXX_TRACE_FMT(logger, fmt, ...) do { \
-		if (LOG4CXX_UNLIKELY(::LOG4CXX_NS::Logger::isTraceEnabledFor(logger))) {\
+		LOG4CXX_CALL_SITE(TRACE_INT) \
+		if (LOG4CXX_UNLIKELY(LOG4CXX_CALL_SITE_IS_ENABLED(logger, Trace))) {\
 			logger->addTraceEvent(::LOG4CXX_FORMAT_NS::format(fmt LOG4CXX_FMT_VA_ARG(__VA_ARGS__)), LOG4CXX_LOCATION); }} while (0)
 #else
 #define LOG4CXX_TRACE(logger, message)
@@ -2237,7 +2248,8 @@ LOG4CXX_INFO(m_log, surface->GetName()
 @param message a valid r-value expression of an <code>operator<<(std::ostream&. ...)</code> overload.
 */
 #define LOG4CXX_INFO(logger, message) do { \
-		if (::LOG4CXX_NS::Logger::isInfoEnabledFor(logger)) {\
+		LOG4CXX_CALL_SITE(INFO_INT) \
+		if (LOG4CXX_CALL_SITE_IS_ENABLED(logger, Info)) {\
 			::LOG4CXX_NS::helpers::MessageBuffer oss_; \
 			logger->addInfoEvent(oss_.extract_str(oss_ << message), LOG4CXX_LOCATION); }} while (0)
 
@@ -2258,7 +2270,8 @@ LOG4CXX_INFO_FMT(m_log, "{} successfully planned {:.1f}% planned area {:.4f}m^2
 @param ... the variable parts of the message.
 */
 #define LOG4CXX_INFO_FMT(logger, fmt, ...) do { \
-		if (::LOG4CXX_NS::Logger::isInfoEnabledFor(logger)) {\
+		LOG4CXX_CALL_SITE(INFO_INT) \
+		if (LOG4CXX_CALL_SITE_IS_ENABLED(logger, Info)) {\
 			logger->addInfoEvent(::LOG4CXX_FORMAT_NS::format(fmt LOG4CXX_FMT_VA_ARG(__VA_ARGS__)), LOG4CXX_LOCATION); }} while (0)
 #else
 #define LOG4CXX_INFO(logger, message)
@@ -2281,7 +2294,8 @@ catch (const std::exception& ex)
 @param message a valid r-value expression of an <code>operator<<(std::ostream&. ...)</code> overload.
 */
 #define LOG4CXX_WARN(logger, message) do { \
-		if (::LOG4CXX_NS::Logger::isWarnEnabledFor(logger)) {\
+		LOG4CXX_CALL_SITE(WARN_INT) \
+		if (LOG4CXX_CALL_SITE_IS_ENABLED(logger, Warn)) {\
 			::LOG4CXX_NS::helpers::MessageBuffer oss_; \
 			logger->addEvent(::LOG4CXX_NS::Level::getWarn(), oss_.extract_str(oss_ << message), LOG4CXX_LOCATION); }} while (0)
 
@@ -2301,7 +2315,8 @@ catch (const std::exception& ex)
 @param ... the variable parts of the message.
 */
 #define LOG4CXX_WARN_FMT(logger, fmt, ...) do { \
-		if (::LOG4CXX_NS::Logger::isWarnEnabledFor(logger)) {\
+		LOG4CXX_CALL_SITE(WARN_INT) \
+		if (LOG4CXX_CALL_SITE_IS_ENABLED(logger, Warn)) {\
 			logger->addEvent(::LOG4CXX_NS::Level::getWarn(), ::LOG4CXX_FORMAT_NS::format(fmt LOG4CXX_FMT_VA_ARG(__VA_ARGS__)), LOG4CXX_LOCATION); }} while (0)
 #else
 #define LOG4CXX_WARN(logger, message)
@@ -2324,7 +2339,8 @@ catch (std::exception& ex)
 @param message a valid r-value expression of an <code>operator<<(std::ostream&. ...)</code> overload.
 */
 #define LOG4CXX_ERROR(logger, message) do { \
-		if (::LOG4CXX_NS::Logger::isErrorEnabledFor(logger)) {\
+		LOG4CXX_CALL_SITE(ERROR_INT) \
+		if (LOG4CXX_CALL_SITE_IS_ENABLED(logger, Error)) {\
 			::LOG4CXX_NS::helpers::MessageBuffer oss_; \
 			logger->addEvent(::LOG4CXX_NS::Level::getError(), oss_.extract_str(oss_ << message), LOG4CXX_LOCATION); }} while (0)
 
@@ -2344,7 +2360,8 @@ catch (std::exception& ex)
 @param ... the variable parts of the message.
 */
 #define LOG4CXX_ERROR_FMT(logger, fmt, ...) do { \
-		if (::LOG4CXX_NS::Logger::isErrorEnabledFor(logger)) {\
+		LOG4CXX_CALL_SITE(ERROR_INT) \
+		if (LOG4CXX_CALL_SITE_IS_ENABLED(logger, Error)) {\
 			logger->addEvent(::LOG4CXX_NS::Level::getError(), ::LOG4CXX_FORMAT_NS::format(fmt LOG4CXX_FMT_VA_ARG(__VA_ARGS__)), LOG4CXX_LOCATION); }} while (0)
 
 /**
@@ -2395,7 +2412,8 @@ LOG4CXX_FATAL(m_log, m_renderSystem->getName() << " is not supported");
 @param message a valid r-value expression of an <code>operator<<(std::ostream&. ...)</code> overload.
 */
 #define LOG4CXX_FATAL(logger, message) do { \
-		if (::LOG4CXX_NS::Logger::isFatalEnabledFor(logger)) {\
+		LOG4CXX_CALL_SITE(FATAL_INT) \
+		if (LOG4CXX_CALL_SITE_IS_ENABLED(logger, Fatal)) {\
 			::LOG4CXX_NS::helpers::MessageBuffer oss_; \
 			logger->addEvent(::LOG4CXX_NS::Level::getFatal(), oss_.extract_str(oss_ << message), LOG4CXX_LOCATION); }} while (0)
 
@@ -2412,7 +2430,8 @@ LOG4CXX_FATAL_FMT(m_log, "{} is not supported", m_renderSystem->getName());
 
 */
 #define LOG4CXX_FATAL_FMT(logger, fmt, ...) do { \
-		if (::LOG4CXX_NS::Logger::isFatalEnabledFor(logger)) {\
+		LOG4CXX_CALL_SITE(FATAL_INT) \
+		if (LOG4CXX_CALL_SITE_IS_ENABLED(logger, Fatal)) {\
 			logger->addEvent(::LOG4CXX_NS::Level::getFatal(), ::LOG4CXX_FORMAT_NS::format(fmt LOG4CXX_FMT_VA_ARG(__VA_ARGS__)), LOG4CXX_LOCATION); }} while (0)
 #else
 #define LOG4CXX_FATAL(logger, message)
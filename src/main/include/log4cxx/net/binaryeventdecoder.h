@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_NET_BINARY_EVENT_DECODER_H
+#define _LOG4CXX_NET_BINARY_EVENT_DECODER_H
+
+#include <log4cxx/spi/loggingevent.h>
+
+namespace LOG4CXX_NS
+{
+namespace net
+{
+
+/**
+Rebuilds spi::LoggingEvent objects from data produced by a BinaryEventEncoder.
+
+Data can be provided in fragments of any size:
+~~~{.cpp}
+decoder.append(buffer, bytesRead);
+while (auto event = decoder.next())
+	logger->callAppenders(event, pool);
+~~~
+*/
+class LOG4CXX_EXPORT BinaryEventDecoder
+{
+	public:
+		BinaryEventDecoder();
+		~BinaryEventDecoder();
+
+		/**
+		Add \c size bytes at \c data to the data to be decoded.
+		*/
+		void append(const char* data, size_t size);
+
+		/**
+		The next event, or null if more data is required.
+
+		Throws helpers::IOException if the data is not a valid stream.
+		*/
+		spi::LoggingEventPtr next();
+
+		/**
+		Discard any pending data and the logger names received.
+		Call this before decoding a new stream.
+		*/
+		void reset();
+
+	private:
+		LOG4CXX_DECLARE_PRIVATE_MEMBER_PTR(BinaryEventDecoderPrivate, m_priv)
+		BinaryEventDecoder(const BinaryEventDecoder&);
+		BinaryEventDecoder& operator=(const BinaryEventDecoder&);
+};
+
+} // namespace net
+} // namespace LOG4CXX_NS
+
+#endif // _LOG4CXX_NET_BINARY_EVENT_DECODER_H
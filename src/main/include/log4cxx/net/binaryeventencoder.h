@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_NET_BINARY_EVENT_ENCODER_H
+#define _LOG4CXX_NET_BINARY_EVENT_ENCODER_H
+
+#include <log4cxx/spi/loggingevent.h>
+#include <string>
+
+namespace LOG4CXX_NS
+{
+namespace net
+{
+
+/**
+Converts spi::LoggingEvent objects to a compact binary representation.
+
+A stream starts with the four bytes "L4CB" followed by a version byte (see #encodeHeader).
+It is followed by a sequence of records,
+each of which is an unsigned varint holding the record length and the record body.
+The first byte of the body is the record type:
+- 1 (name): an unsigned varint index and a string.
+  The index can be used in place of the logger name in later event records.
+- 2 (event): an unsigned varint holding the presence flags, then
+  the zigzag varint level,
+  the logger name (a string when flag 0x08 is set, otherwise a name index),
+  the zigzag varint timestamp (in microseconds since 01.01.1970),
+  the thread identifier string, the thread name string, the message string and
+  the optional sections:
+  - NDC (flag 0x01): a string.
+  - MDC (flag 0x02): an unsigned varint count followed by key and value strings.
+  - Location (flag 0x04): the file name string, the qualified method name string and an unsigned varint line number.
+
+Strings are an unsigned varint byte count followed by UTF-8 bytes
+(the file and method names are sent as provided by the compiler).
+Varints hold 7 bits per byte, least significant group first,
+with the top bit set in all but the last byte.
+
+\sa BinaryEventDecoder
+*/
+class LOG4CXX_EXPORT BinaryEventEncoder
+{
+	public:
+		/**
+		The value of the version byte in the stream header.
+		*/
+		static const int VERSION = 1;
+
+		BinaryEventEncoder();
+		~BinaryEventEncoder();
+
+		/**
+		Use \c newValue to specify whether each logger name is sent only once
+		(and later events refer to it by index).
+
+		Disable this when encoded events are not all delivered to the decoder in order,
+		for example when they are resent after a reconnection.
+		*/
+		void setInternNames(bool newValue);
+
+		/**
+		Are logger names sent only once?
+		*/
+		bool getInternNames() const;
+
+		/**
+		Use \c newValue to specify whether source code location is included.
+		*/
+		void setLocationInfo(bool newValue);
+
+		/**
+		Is source code location included?
+		*/
+		bool getLocationInfo() const;
+
+		/**
+		Append the representation of \c event to \c dest.
+		*/
+		void encode(const spi::LoggingEventPtr& event, std::string& dest);
+
+		/**
+		Start a new stream, forgetting the logger names sent.
+		*/
+		void reset();
+
+		/**
+		Append the bytes that start a stream to \c dest.
+		*/
+		static void encodeHeader(std::string& dest);
+
+	private:
+		LOG4CXX_DECLARE_PRIVATE_MEMBER_PTR(BinaryEventEncoderPrivate, m_priv)
+		BinaryEventEncoder(const BinaryEventEncoder&);
+		BinaryEventEncoder& operator=(const BinaryEventEncoder&);
+};
+
+} // namespace net
+} // namespace LOG4CXX_NS
+
+#endif // _LOG4CXX_NET_BINARY_EVENT_ENCODER_H
@@ -0,0 +1,123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _LOG4CXX_NET_BINARY_SOCKET_APPENDER_H
+#define _LOG4CXX_NET_BINARY_SOCKET_APPENDER_H
+
+#include <log4cxx/net/socketappenderskeleton.h>
+
+namespace LOG4CXX_NS
+{
+namespace net
+{
+
+/**
+Sends spi::LoggingEvent elements to a remote log server
+in the compact binary format described in BinaryEventEncoder.
+
+Compared with XMLSocketAppender, an event typically needs
+a fraction of the bytes and no escaping, so both the sender and
+the server spend less time per event.
+The server can use BinaryEventDecoder (or BinarySocketReceiver)
+to rebuild the events and pass them to its own appenders.
+
+Each logger name is sent once per connection, unless
+the <b>BackgroundSend</b> option is enabled
+(because events resent after a reconnection must be self-contained).
+
+Here is an example configuration:
+~~~{.xml}
+<log4j:configuration xmlns:log4j="http://jakarta.apache.org/log4j/">
+<appender name="A1" class="BinarySocketAppender">
+  <param name="RemoteHost"     value="collector.example.com" />
+  <param name="Port"           value="4562" />
+  <param name="BackgroundSend" value="true" />
+</appender>
+<root>
+  <priority value ="INFO" />
+  <appender-ref ref="A1" />
+</root>
+</log4j:configuration>
+~~~
+
+See XMLSocketAppender for the connection behaviour
+and SocketAppenderSkeleton::setOption for the supported options.
+A layout is not used.
+*/
+class LOG4CXX_EXPORT BinarySocketAppender : public SocketAppenderSkeleton
+{
+	public:
+		/**
+		The default port number of remote logging server (4562).
+		*/
+		static int DEFAULT_PORT;
+
+		/**
+		The default reconnection delay (30000 milliseconds or 30 seconds).
+		*/
+		static int DEFAULT_RECONNECTION_DELAY;
+
+		DECLARE_LOG4CXX_OBJECT(BinarySocketAppender)
+		BEGIN_LOG4CXX_CAST_MAP()
+		LOG4CXX_CAST_ENTRY(BinarySocketAppender)
+		LOG4CXX_CAST_ENTRY_CHAIN(AppenderSkeleton)
+		END_LOG4CXX_CAST_MAP()
+
+		BinarySocketAppender();
+		~BinarySocketAppender();
+
+		/**
+		Connects to remote server at <code>address</code> and <code>port</code>.
+		*/
+		BinarySocketAppender(helpers::InetAddressPtr address, int port);
+
+		/**
+		Connects to remote server at <code>host</code> and <code>port</code>.
+		*/
+		BinarySocketAppender(const LogString& host, int port);
+
+		/**
+		\copybrief SocketAppenderSkeleton::activateOptions()
+		*/
+		void activateOptions(helpers::Pool& p) override;
+
+	protected:
+		void setSocket(LOG4CXX_NS::helpers::SocketPtr& socket, helpers::Pool& p) override;
+
+		void cleanUp(helpers::Pool& p) override;
+
+		int getDefaultDelay() const override;
+
+		int getDefaultPort() const override;
+
+		void append(const spi::LoggingEventPtr& event, helpers::Pool& pool) override;
+
+	private:
+		//  prevent copy and assignment statements
+		BinarySocketAppender(const BinarySocketAppender&);
+		BinarySocketAppender& operator=(const BinarySocketAppender&);
+
+		struct BinarySocketAppenderPriv;
+}; // class BinarySocketAppender
+
+LOG4CXX_PTR_DEF(BinarySocketAppender);
+
+} // namespace net
+} // namespace LOG4CXX_NS
+
+#endif // _LOG4CXX_NET_BINARY_SOCKET_APPENDER_H
@@ -0,0 +1,104 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _LOG4CXX_NET_BINARY_SOCKET_RECEIVER_H
+#define _LOG4CXX_NET_BINARY_SOCKET_RECEIVER_H
+
+#include <log4cxx/spi/loggerrepository.h>
+#include <log4cxx/helpers/socket.h>
+#include <atomic>
+
+namespace LOG4CXX_NS
+{
+namespace net
+{
+
+/**
+Accepts connections from BinarySocketAppender instances
+and passes the received events to the appenders of a local logger hierarchy.
+
+Each event is logged by the logger of the same name in the repository,
+provided the event level is enabled for that logger.
+Each connection is read by its own thread.
+Connections beyond #setMaxConnections are closed as soon as they are accepted.
+
+~~~{.cpp}
+net::BinarySocketReceiver receiver(4562, LogManager::getLoggerRepository());
+receiver.start();
+~~~
+*/
+class LOG4CXX_EXPORT BinarySocketReceiver
+{
+	public:
+		/**
+		Listen for connections on \c port when #start is called
+		and log the received events using \c repository.
+		*/
+		BinarySocketReceiver(int port, const spi::LoggerRepositoryPtr& repository);
+
+		/**
+		Calls #close.
+		*/
+		~BinarySocketReceiver();
+
+		/**
+		Start accepting connections on a background thread.
+
+		Throws helpers::SocketException if the port is not available.
+		*/
+		void start();
+
+		/**
+		Stop accepting connections, disconnect the clients and
+		wait for the background threads to finish.
+		*/
+		void close();
+
+		/**
+		The number of events received.
+		*/
+		size_t getEventCount() const;
+
+		/**
+		Accept at most \c count concurrent connections. The default is 64.
+		*/
+		void setMaxConnections(size_t count);
+
+		/**
+		The maximum number of concurrent connections.
+		*/
+		size_t getMaxConnections() const;
+
+		/**
+		The number of connections closed because #getMaxConnections were already open.
+		*/
+		size_t getRejectedCount() const;
+
+	private:
+		void acceptConnections();
+		void receiveEvents(helpers::SocketPtr socket, std::atomic<bool>* finished);
+
+		LOG4CXX_DECLARE_PRIVATE_MEMBER_PTR(BinarySocketReceiverPrivate, m_priv)
+		BinarySocketReceiver(const BinarySocketReceiver&);
+		BinarySocketReceiver& operator=(const BinarySocketReceiver&);
+};
+
+} // namespace net
+} // namespace LOG4CXX_NS
+
+#endif // _LOG4CXX_NET_BINARY_SOCKET_RECEIVER_H
@@ -0,0 +1,170 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _LOG4CXX_NET_SHARED_MEMORY_APPENDER_H
+#define _LOG4CXX_NET_SHARED_MEMORY_APPENDER_H
+
+#include <log4cxx/appenderskeleton.h>
+
+namespace LOG4CXX_NS
+{
+namespace net
+{
+
+/**
+Adds spi::LoggingEvent elements to a ring buffer in POSIX shared memory
+from which a separate process (see SharedMemoryCollector) passes them to its appenders.
+
+The logging thread only encodes the event (in the format described in BinaryEventEncoder)
+and copies it into shared memory, so file and network delays do not affect the application.
+Any number of threads and processes can use the same ring buffer.
+Events already in shared memory are delivered by the collector
+even if the application ends abnormally.
+
+When the ring buffer is full, events are discarded.
+The number discarded is available from the appender metrics
+and SharedMemoryCollector::getDiscardCount.
+
+Here is an example configuration:
+~~~{.xml}
+<log4j:configuration xmlns:log4j="http://jakarta.apache.org/log4j/">
+<appender name="A1" class="SharedMemoryAppender">
+  <param name="SharedMemoryName" value="/myapp-log" />
+  <param name="BufferSize"       value="16MB" />
+</appender>
+<root>
+  <priority value ="INFO" />
+  <appender-ref ref="A1" />
+</root>
+</log4j:configuration>
+~~~
+
+A layout is not used.
+This appender is not available on Windows.
+*/
+class LOG4CXX_EXPORT SharedMemoryAppender : public AppenderSkeleton
+{
+	public:
+		DECLARE_LOG4CXX_OBJECT(SharedMemoryAppender)
+		BEGIN_LOG4CXX_CAST_MAP()
+		LOG4CXX_CAST_ENTRY(SharedMemoryAppender)
+		LOG4CXX_CAST_ENTRY_CHAIN(AppenderSkeleton)
+		END_LOG4CXX_CAST_MAP()
+
+		SharedMemoryAppender();
+		~SharedMemoryAppender();
+
+		/**
+		\copybrief AppenderSkeleton::setOption()
+
+		Supported options | Supported values | Default value
+		:-------------- | :----------------: | :---------------:
+		SharedMemoryName | (\ref shmName "1") | /log4cxx
+		BufferSize | (\ref shmSize "2") | 4MB
+		LocationInfo | True,False | False
+
+		\anchor shmName (1) The name of the POSIX shared memory object, starting with '/'.
+
+		\anchor shmSize (2) An integer with an optional KB, MB or GB suffix,
+		rounded up to a power of two.
+		Only used by the process that creates the shared memory object.
+
+		\sa AppenderSkeleton::setOption()
+		*/
+		void setOption(const LogString& option, const LogString& value) override;
+
+		/**
+		Map the shared memory, creating it if it does not exist.
+		*/
+		void activateOptions(helpers::Pool& p) override;
+
+		/**
+		Stop adding events to shared memory.
+		Events already added remain available to the collector.
+		The mapping is released when this appender is destroyed.
+		*/
+		void close() override;
+
+		/**
+		\copybrief AppenderSkeleton::doAppend()
+
+		The appender lock is not taken,
+		so threads encode and add their events concurrently.
+		*/
+		void doAppend(const spi::LoggingEventPtr& event, helpers::Pool& pool) override;
+
+		/**
+		A layout is not used.
+		*/
+		bool requiresLayout() const override
+		{
+			return false;
+		}
+
+		/**
+		Use the shared memory object named \c name.
+		*/
+		void setSharedMemoryName(const LogString& name);
+
+		/**
+		The name of the shared memory object.
+		*/
+		LogString getSharedMemoryName() const;
+
+		/**
+		Create the shared memory object with room for \c byteCount bytes of encoded events.
+		*/
+		void setBufferSize(size_t byteCount);
+
+		/**
+		The requested size of the shared memory object.
+		*/
+		size_t getBufferSize() const;
+
+		/**
+		Use \c newValue to specify whether source code location is included.
+		*/
+		void setLocationInfo(bool newValue);
+
+		/**
+		Is source code location included?
+		*/
+		bool getLocationInfo() const;
+
+		/**
+		The number of events that could not be added because the ring buffer was full
+		(by any process using the same shared memory object).
+		*/
+		uint64_t getDiscardCount() const;
+
+	protected:
+		void append(const spi::LoggingEventPtr& event, helpers::Pool& p) override;
+
+	private:
+		SharedMemoryAppender(const SharedMemoryAppender&);
+		SharedMemoryAppender& operator=(const SharedMemoryAppender&);
+
+		struct SharedMemoryAppenderPriv;
+}; // class SharedMemoryAppender
+
+LOG4CXX_PTR_DEF(SharedMemoryAppender);
+
+} // namespace net
+} // namespace LOG4CXX_NS
+
+#endif // _LOG4CXX_NET_SHARED_MEMORY_APPENDER_H
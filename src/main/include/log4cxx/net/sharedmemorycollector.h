@@ -0,0 +1,102 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _LOG4CXX_NET_SHARED_MEMORY_COLLECTOR_H
+#define _LOG4CXX_NET_SHARED_MEMORY_COLLECTOR_H
+
+#include <log4cxx/spi/loggerrepository.h>
+
+namespace LOG4CXX_NS
+{
+namespace net
+{
+
+/**
+Removes the events added by SharedMemoryAppender instances (in any process)
+from a shared memory ring buffer and passes them to the appenders of a local logger hierarchy.
+
+Each event is logged by the logger of the same name in the repository,
+provided the event level is enabled for that logger.
+The events are removed by a background thread.
+The shared memory object is not removed when the collector is closed,
+so events added while the collector is not running are delivered when it is restarted.
+
+~~~{.cpp}
+net::SharedMemoryCollector collector(LOG4CXX_STR("/myapp-log"), LogManager::getLoggerRepository());
+collector.start();
+~~~
+
+This class is not available on Windows.
+*/
+class LOG4CXX_EXPORT SharedMemoryCollector
+{
+	public:
+		/**
+		Remove events from the shared memory object \c name when #start is called
+		and log them using \c repository.
+		*/
+		SharedMemoryCollector(const LogString& name, const spi::LoggerRepositoryPtr& repository);
+
+		/**
+		Calls #close.
+		*/
+		~SharedMemoryCollector();
+
+		/**
+		Use \c byteCount as the size of the shared memory object if this collector creates it.
+		*/
+		void setBufferSize(size_t byteCount);
+
+		/**
+		Map the shared memory (creating it if it does not exist)
+		and start removing events on a background thread.
+
+		Throws helpers::IOException if the shared memory cannot be mapped.
+		*/
+		void start();
+
+		/**
+		Pass the events currently in the shared memory to the appenders
+		and stop the background thread.
+		*/
+		void close();
+
+		/**
+		The number of events removed.
+		*/
+		size_t getEventCount() const;
+
+		/**
+		The number of events SharedMemoryAppender instances
+		could not add because the ring buffer was full.
+		*/
+		uint64_t getDiscardCount() const;
+
+	private:
+		void collectEvents();
+		size_t drain(size_t maxRecords);
+
+		LOG4CXX_DECLARE_PRIVATE_MEMBER_PTR(SharedMemoryCollectorPrivate, m_priv)
+		SharedMemoryCollector(const SharedMemoryCollector&);
+		SharedMemoryCollector& operator=(const SharedMemoryCollector&);
+};
+
+} // namespace net
+} // namespace LOG4CXX_NS
+
+#endif // _LOG4CXX_NET_SHARED_MEMORY_COLLECTOR_H
@@ -63,6 +63,18 @@ The following <b>param</b> elements  are optional:
   By default an email is sent
   when the level of the logging event
   is greater or equal to <b>ERROR</b>.
+- <b>BackgroundSend</b> -
+  When true, e-mail is sent by a background thread
+  instead of the thread that logged the triggering event.
+  By default e-mail is sent by the logging thread.
+- <b>CoalesceInterval</b> -
+  When sending in the background, the milliseconds to wait after a triggering event
+  so that further triggering events are included in the same e-mail.
+  By default e-mail is sent immediately.
+- <b>MinimumSendInterval</b> -
+  When sending in the background, the minimum milliseconds between e-mails.
+  Triggering events that occur sooner are included in the next e-mail.
+  By default there is no limit.
 
   An example configuration is:
   \include async-example.xml
@@ -121,6 +133,9 @@ class LOG4CXX_EXPORT SMTPAppender : public AppenderSkeleton
 		subject | {any} | -
 		subject | {any} | -
 		buffersize | {int} | 512
+		BackgroundSend | True,False | False
+		CoalesceInterval | {int} | 0
+		MinimumSendInterval | {int} | 0
 		evaluatorClass | (\ref AppenderSkeleton "2") | -
 
 		\anchor asciiCheck (1) Only ASCII charaters
@@ -316,6 +331,38 @@ class LOG4CXX_EXPORT SMTPAppender : public AppenderSkeleton
 		Returns value of the <b>LocationInfo</b> option.
 		*/
 		bool getLocationInfo() const;
+
+		/**
+		Use a background thread to send e-mail when \c newValue is true.
+		Takes effect when activateOptions() is called.
+		*/
+		void setBackgroundSend(bool newValue);
+
+		/**
+		Returns value of the <b>BackgroundSend</b> option.
+		*/
+		bool getBackgroundSend() const;
+
+		/**
+		Include triggering events that occur within \c milliseconds
+		of the first in the same e-mail.
+		*/
+		void setCoalesceInterval(int milliseconds);
+
+		/**
+		Returns value of the <b>CoalesceInterval</b> option.
+		*/
+		int getCoalesceInterval() const;
+
+		/**
+		Send at most one e-mail in each period of \c milliseconds.
+		*/
+		void setMinimumSendInterval(int milliseconds);
+
+		/**
+		Returns value of the <b>MinimumSendInterval</b> option.
+		*/
+		int getMinimumSendInterval() const;
 }; // class SMTPAppender
 
 LOG4CXX_PTR_DEF(SMTPAppender);
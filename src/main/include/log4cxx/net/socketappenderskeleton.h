@@ -31,6 +31,19 @@ namespace net
 
 /**
  *  Abstract base class for SocketAppender and XMLSocketAppender
+
+When the <b>BackgroundSend</b> option is enabled,
+logging threads only add the encoded event to a bounded in-memory queue.
+A dedicated thread establishes the connection and
+writes as many queued events as are available (up to 64 KiB) in each send,
+so logging never waits for the network.
+When the queue is full, events are discarded and the number discarded is
+reported by LogLog.
+
+A copy of the most recently sent events (up to <b>ReplayBufferSize</b> bytes)
+is retained and resent ahead of any waiting events when a connection is re-established.
+As TCP does not indicate how much of the sent data the server processed,
+the server may receive some events twice after a reconnection.
  */
 class LOG4CXX_EXPORT SocketAppenderSkeleton : public AppenderSkeleton
 {
@@ -122,6 +135,41 @@ class LOG4CXX_EXPORT SocketAppenderSkeleton : public AppenderSkeleton
 		*/
 		int getReconnectionDelay() const;
 
+		/**
+		Use \c newValue to specify whether a background thread
+		connects to the server and sends the formatted events.
+
+		The change takes effect when activateOptions is called.
+		*/
+		void setBackgroundSend(bool newValue);
+
+		/**
+		Returns value of the <b>BackgroundSend</b> option.
+		*/
+		bool getBackgroundSend() const;
+
+		/**
+		Use \c newValue as the maximum number of bytes
+		waiting to be sent by the background thread.
+		*/
+		void setMaxQueueSize(size_t newValue);
+
+		/**
+		Returns value of the <b>MaxQueueSize</b> option.
+		*/
+		size_t getMaxQueueSize() const;
+
+		/**
+		Use \c newValue as the number of recently sent bytes
+		that are resent when the connection is re-established.
+		*/
+		void setReplayBufferSize(size_t newValue);
+
+		/**
+		Returns value of the <b>ReplayBufferSize</b> option.
+		*/
+		size_t getReplayBufferSize() const;
+
 		void fireConnector();
 
 		/**
@@ -132,11 +180,20 @@ class LOG4CXX_EXPORT SocketAppenderSkeleton : public AppenderSkeleton
 		RemoteHost |  (\ref inetAddress "1") | -
 		Port | {int} | (\ref defaultPort "2")
 		LocationInfo | True,False | False
+		ReconnectionDelay | {int} | 30000
+		BackgroundSend | True,False | False
+		MaxQueueSize | (\ref socketQueueSize "3") | 1 MB
+		ReplayBufferSize | (\ref socketQueueSize "3") | 64 KB
 
 		\anchor inetAddress (1) A valid internet address.
 
 		\anchor defaultPort (2) Provided by the derived class.
 
+		\anchor socketQueueSize (3) An integer in the range 0 - 2^63.
+		 You can specify the value with the suffixes "KB", "MB" or "GB" so that the integer is
+		 interpreted being expressed respectively in kilobytes, megabytes
+		 or gigabytes. For example, the value "10KB" will be interpreted as 10240.
+
 		\sa AppenderSkeleton::setOption()
 		*/
 		void setOption(const LogString& option, const LogString& value) override;
@@ -152,6 +209,18 @@ class LOG4CXX_EXPORT SocketAppenderSkeleton : public AppenderSkeleton
 
 		virtual int getDefaultPort() const = 0;
 
+		/**
+		Add \c bytes to the data sent by the background thread.
+		Returns false if the queue is full.
+		*/
+		bool enqueue(std::string&& bytes);
+
+		/**
+		Use \c bytes as the data the background thread sends
+		at the start of each connection.
+		*/
+		void setStreamHeader(const std::string& bytes);
+
 	private:
 		void connect(LOG4CXX_NS::helpers::Pool& p);
 		/**
@@ -166,6 +235,12 @@ class LOG4CXX_EXPORT SocketAppenderSkeleton : public AppenderSkeleton
 
 		void monitor();
 		bool is_closed();
+
+		/**
+		Connect to the server and send the queued events
+		until the appender is closed.
+		*/
+		void sendQueuedEvents();
 		SocketAppenderSkeleton(const SocketAppenderSkeleton&);
 		SocketAppenderSkeleton& operator=(const SocketAppenderSkeleton&);
 
@@ -37,6 +37,15 @@ namespace net
  * When the message is too large for the current MaxMessageLength,
  * the packet number and total # will be appended to the end of the
  * message like this: (5/10)
+ *
+ * When the <b>Protocol</b> option is TCP, messages are sent whole
+ * (MaxMessageLength is not used) over a persistent connection
+ * using the octet-counting framing of RFC 6587.
+ * Logging threads only add the framed message to a bounded in-memory queue.
+ * A background thread sends all the queued frames in a single write
+ * and re-establishes the connection after an error.
+ * Messages are discarded when the queue is full,
+ * and the number discarded is reported by LogLog.
  */
 class LOG4CXX_EXPORT SyslogAppender : public AppenderSkeleton
 {
@@ -78,7 +87,7 @@ class LOG4CXX_EXPORT SyslogAppender : public AppenderSkeleton
 		/**
 		\copybrief AppenderSkeleton::activateOptions()
 
-		No action is performed in this implementation.
+		Starts the background thread when the <b>Protocol</b> option is TCP.
 		*/
 		void activateOptions(helpers::Pool& p) override;
 
@@ -90,11 +99,19 @@ class LOG4CXX_EXPORT SyslogAppender : public AppenderSkeleton
 		SysLogHost |  (\ref sysLogAddress "1") | -
 		Facility | (\ref facility "2") | -
 		MaxMessageLength | {int} | 1024
+		Protocol | UDP,TCP | UDP
+		MaxQueueSize | (\ref syslogQueueSize "3") | 1 MB
+		ReconnectionDelay | {int} | 30000
 
 		\anchor sysLogAddress (1) A valid internet address, optionally with the port number as a suffix after a ':'.
 
 		\anchor facility (2) One of kern,user,mail,daemon,auth,syslog,lpr,news,uucp,cron,ftp,local0,local1,local2,local3,local4,local5,local6,local7
 
+		\anchor syslogQueueSize (3) An integer in the range 0 - 2^63.
+		 You can specify the value with the suffixes "KB", "MB" or "GB" so that the integer is
+		 interpreted being expressed respectively in kilobytes, megabytes
+		 or gigabytes. For example, the value "10KB" will be interpreted as 10240.
+
 		\sa AppenderSkeleton::setOption()
 		*/
 		void setOption(const LogString& option, const LogString& value) override;
@@ -152,6 +169,40 @@ class LOG4CXX_EXPORT SyslogAppender : public AppenderSkeleton
 
 		int getMaxMessageLength() const;
 
+		/**
+		Use \c protocol (UDP or TCP) to send the messages.
+		The change takes effect when activateOptions is called.
+		*/
+		void setProtocol(const LogString& protocol);
+
+		/**
+		Returns the value of the <b>Protocol</b> option.
+		*/
+		LogString getProtocol() const;
+
+		/**
+		Use \c newValue as the maximum number of bytes
+		waiting to be sent over the TCP connection.
+		*/
+		void setMaxQueueSize(size_t newValue);
+
+		/**
+		Returns the value of the <b>MaxQueueSize</b> option.
+		*/
+		size_t getMaxQueueSize() const;
+
+		/**
+		Use \c newValue as the number of milliseconds to wait
+		between TCP connection attempts.
+		Setting this option to zero turns off reconnection.
+		*/
+		void setReconnectionDelay(int newValue);
+
+		/**
+		Returns the value of the <b>ReconnectionDelay</b> option.
+		*/
+		int getReconnectionDelay() const;
+
 	protected:
 		void initSyslogFacilityStr();
 
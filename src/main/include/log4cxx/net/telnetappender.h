@@ -59,7 +59,22 @@ servlet.
 <td>optional</td>
 <td>This parameter determines the port to use for announcing log events.  The default port is 23 (telnet).</td>
 <td>5875</td>
+</tr>
+
+<tr>
+<td>MaxQueueSize</td>
+<td>optional</td>
+<td>The maximum number of bytes waiting to be sent to a client. The default is 256KB.</td>
+<td>1MB</td>
+</tr>
 </table>
+
+<p>Logging threads do not write to the client sockets.
+Each event is formatted and encoded once and the bytes are added to a queue for each client.
+A background thread sends the queued bytes using non-blocking sockets,
+so a slow or stalled client does not delay the logging threads.
+When the queue of a client is full, events are discarded for that client
+and it is sent a count of the discarded events when space becomes available.
 */
 class LOG4CXX_EXPORT TelnetAppender : public AppenderSkeleton
 {
@@ -115,12 +130,29 @@ class LOG4CXX_EXPORT TelnetAppender : public AppenderSkeleton
 		Supported options | Supported values | Default value
 		-------------- | ---------------- | ---------------
 		Port | {int} | 23
+		MaxQueueSize | (\ref telnetQueueSize "1") | 256 KB
 		Encoding | C,UTF-8,UTF-16,UTF-16BE,UTF-16LE,646,US-ASCII,ISO646-US,ANSI_X3.4-1968,ISO-8859-1,ISO-LATIN-1 | UTF-8
 
+		\anchor telnetQueueSize (1) An integer number of bytes.
+		 You can specify the value with the suffixes "KB", "MB" or "GB" so that the integer is
+		 interpreted being expressed respectively in kilobytes, megabytes
+		 or gigabytes.
+
 		\sa AppenderSkeleton::setOption()
 		*/
 		void setOption(const LogString& option, const LogString& value) override;
 
+		/**
+		Returns value of the <b>MaxQueueSize</b> option.
+		*/
+		size_t getMaxQueueSize() const;
+
+		/**
+		The <b>MaxQueueSize</b> option is the number of bytes that may be waiting
+		to be sent to a client before events are discarded for that client.
+		*/
+		void setMaxQueueSize(size_t byteCount);
+
 		/**
 		Returns value of the <b>Port</b> option.
 		*/
@@ -149,6 +181,7 @@ class LOG4CXX_EXPORT TelnetAppender : public AppenderSkeleton
 		TelnetAppender& operator=(const TelnetAppender&);
 
 		void write(LOG4CXX_NS::helpers::ByteBuffer&);
+		void encode(const LogString& msg, std::vector<char>& dest);
 		void writeStatus(const LOG4CXX_NS::helpers::SocketPtr& socket, const LogString& msg, LOG4CXX_NS::helpers::Pool& p);
 		void acceptConnections();
 
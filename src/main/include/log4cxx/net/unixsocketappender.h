@@ -0,0 +1,213 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _LOG4CXX_NET_UNIX_SOCKET_APPENDER_H
+#define _LOG4CXX_NET_UNIX_SOCKET_APPENDER_H
+
+#include <log4cxx/appenderskeleton.h>
+
+namespace LOG4CXX_NS
+{
+namespace net
+{
+
+/**
+Sends the layout output of each spi::LoggingEvent as one message
+on a Unix domain socket, typically to a log agent on the same host.
+
+Each message is sent as a datagram (<b>SocketType</b> Datagram)
+or as a record on a SOCK_SEQPACKET connection (<b>SocketType</b> SeqPacket).
+Compared with SyslogAppender over UDP, there is no loopback IP processing.
+
+When <b>BufferSize</b> is greater than one, events are formatted on the logging thread
+and sent by a background thread, which passes up to <b>BufferSize</b> messages
+to the kernel in one system call (sendmmsg, where available).
+The background thread sends the pending messages
+when <b>BufferSize</b> messages are waiting or <b>FlushInterval</b> milliseconds have elapsed.
+Up to eight times <b>BufferSize</b> messages are held while the receiver is busy;
+further events are discarded.
+
+When <b>Blocking</b> is false, messages that do not fit in the socket buffer are discarded
+instead of waiting for the receiver.
+Messages larger than the socket allows are also discarded.
+The number of discarded events is available from #getDiscardCount and the appender metrics.
+
+If the socket cannot be reached, a connection is attempted
+every <b>ReconnectionDelay</b> milliseconds
+and the events sent in the meantime are discarded.
+
+Here is an example configuration:
+~~~{.xml}
+<log4j:configuration xmlns:log4j="http://jakarta.apache.org/log4j/">
+<appender name="A1" class="UnixSocketAppender">
+  <param name="SocketPath" value="/var/run/vector/log.sock" />
+  <param name="BufferSize" value="64" />
+  <param name="Blocking"   value="false" />
+  <layout class="JSONLayout" />
+</appender>
+<root>
+  <priority value ="INFO" />
+  <appender-ref ref="A1" />
+</root>
+</log4j:configuration>
+~~~
+
+This appender is not available on Windows.
+*/
+class LOG4CXX_EXPORT UnixSocketAppender : public AppenderSkeleton
+{
+	public:
+		DECLARE_LOG4CXX_OBJECT(UnixSocketAppender)
+		BEGIN_LOG4CXX_CAST_MAP()
+		LOG4CXX_CAST_ENTRY(UnixSocketAppender)
+		LOG4CXX_CAST_ENTRY_CHAIN(AppenderSkeleton)
+		END_LOG4CXX_CAST_MAP()
+
+		UnixSocketAppender();
+		~UnixSocketAppender();
+
+		/**
+		\copybrief AppenderSkeleton::setOption()
+
+		Supported options | Supported values | Default value
+		:-------------- | :----------------: | :---------------:
+		SocketPath | {any} | -
+		SocketType | Datagram,SeqPacket | Datagram
+		SendBufferSize | (\ref unixSendBuffer "1") | 0
+		BufferSize | int | 1
+		FlushInterval | int | 100
+		Blocking | True,False | True
+		ReconnectionDelay | int | 30000
+
+		\anchor unixSendBuffer (1) An integer with an optional KB, MB or GB suffix.
+		Zero leaves the system default in effect.
+
+		\sa AppenderSkeleton::setOption()
+		*/
+		void setOption(const LogString& option, const LogString& value) override;
+
+		/**
+		Connect to the socket and, when <b>BufferSize</b> is greater than one,
+		start the background thread.
+		*/
+		void activateOptions(helpers::Pool& p) override;
+
+		/**
+		Send any pending messages and close the socket.
+		*/
+		void close() override;
+
+		/**
+		A layout is required.
+		*/
+		bool requiresLayout() const override
+		{
+			return true;
+		}
+
+		/**
+		Send messages to the socket bound to \c path.
+		*/
+		void setSocketPath(const LogString& path);
+
+		/**
+		The path of the receiving socket.
+		*/
+		LogString getSocketPath() const;
+
+		/**
+		Use a SOCK_SEQPACKET connection when \c newValue is true, otherwise datagrams.
+		*/
+		void setSeqPacket(bool newValue);
+
+		/**
+		Is a SOCK_SEQPACKET connection used?
+		*/
+		bool getSeqPacket() const;
+
+		/**
+		Set the socket send buffer size to \c byteCount (when not zero).
+		*/
+		void setSendBufferSize(int byteCount);
+
+		/**
+		The requested socket send buffer size.
+		*/
+		int getSendBufferSize() const;
+
+		/**
+		Use a background thread to send up to \c newValue messages in each system call.
+		*/
+		void setBufferSize(int newValue);
+
+		/**
+		The maximum number of messages sent in each system call.
+		*/
+		int getBufferSize() const;
+
+		/**
+		Send buffered messages at least every \c milliseconds.
+		*/
+		void setFlushInterval(int milliseconds);
+
+		/**
+		The maximum milliseconds a buffered message waits to be sent.
+		*/
+		int getFlushInterval() const;
+
+		/**
+		Wait for room in the socket buffer when \c newValue is true, otherwise discard the message.
+		*/
+		void setBlocking(bool newValue);
+
+		/**
+		Does sending wait for room in the socket buffer?
+		*/
+		bool getBlocking() const;
+
+		/**
+		Attempt to connect every \c milliseconds while the socket is unavailable.
+		*/
+		void setReconnectionDelay(int milliseconds);
+
+		/**
+		The milliseconds between connection attempts.
+		*/
+		int getReconnectionDelay() const;
+
+		/**
+		The number of events that were not sent.
+		*/
+		uint64_t getDiscardCount() const;
+
+	protected:
+		void append(const spi::LoggingEventPtr& event, helpers::Pool& p) override;
+
+	private:
+		UnixSocketAppender(const UnixSocketAppender&);
+		UnixSocketAppender& operator=(const UnixSocketAppender&);
+
+		struct UnixSocketAppenderPriv;
+}; // class UnixSocketAppender
+
+LOG4CXX_PTR_DEF(UnixSocketAppender);
+
+} // namespace net
+} // namespace LOG4CXX_NS
+
+#endif // _LOG4CXX_NET_UNIX_SOCKET_APPENDER_H
@@ -63,7 +63,13 @@ then event transmission is resumed transparently. This
 transparent reconneciton is performed by a <em>connector</em>
 thread which periodically attempts to connect to the server.
 
-- Logging events are automatically <em>buffered</em> by the
+- When the <b>BackgroundSend</b> option is enabled,
+logging events are queued and sent by a dedicated thread,
+so the client is never blocked by the network.
+Events are discarded when the queue is full.
+See SocketAppenderSkeleton for the related options.
+
+- Otherwise, logging events are automatically <em>buffered</em> by the
 native TCP implementation. This means that if the link to server
 is slow but still faster than the rate of (log) event production
 by the client, the client will not be affected by the slow
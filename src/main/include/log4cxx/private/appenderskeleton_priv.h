@@ -20,7 +20,11 @@
 
 #include <log4cxx/appenderskeleton.h>
 #include <log4cxx/helpers/onlyonceerrorhandler.h>
+#include <log4cxx/helpers/appendermetrics.h>
+#include <log4cxx/private/filter_priv.h>
+#include <atomic>
 #include <memory>
+#include <vector>
 
 namespace LOG4CXX_NS
 {
@@ -63,6 +67,75 @@ struct AppenderSkeleton::AppenderSkeletonPrivate
 	/** The last filter in the filter chain. */
 	spi::FilterPtr tailFilter;
 
+	/**
+	The integer value of the threshold, which can be read without holding the mutex.
+	*/
+	std::atomic<int> thresholdInt{Level::ALL_INT};
+
+	/**
+	An immutable copy of the filter chain.
+	*/
+	struct FilterChain
+	{
+		/**
+		The #filterGeneration value when this was compiled.
+		*/
+		unsigned generation;
+
+		/**
+		The number of leading filters which depend only on the level of the event.
+		Their combined decision for each built-in level is held in #denyMask and #acceptMask.
+		*/
+		size_t levelFilterCount;
+
+		/**
+		The bits of the built-in levels for which the leading level filters return DENY.
+		*/
+		unsigned denyMask;
+
+		/**
+		The bits of the built-in levels for which the leading level filters return ACCEPT.
+		*/
+		unsigned acceptMask;
+
+		/**
+		The built-in levels, in the order of the bits of #denyMask and #acceptMask.
+		*/
+		const Level* levels[8];
+
+		/**
+		The filters in the order they were added.
+		*/
+		std::vector<spi::FilterPtr> filters;
+
+		/**
+		The combined decision of the filters for \c event.
+		*/
+		spi::Filter::FilterDecision decide(const spi::LoggingEventPtr& event) const;
+	};
+
+	/**
+	Changed by addFilter, clearFilters and a change to a filter in #filterChain.
+	*/
+	spi::FilterGenerationPtr filterGeneration{std::make_shared<spi::FilterGeneration>(0u)};
+
+	/**
+	The current version of the filter chain.
+	Null until the first event is appended.
+	*/
+	std::atomic<const FilterChain*> filterChain{nullptr};
+
+	/**
+	The version of the filter chain in #filterChain.
+	*/
+	std::unique_ptr<const FilterChain> currentFilterChain;
+
+	/**
+	Replaced versions of the filter chain, which are deleted
+	once no thread is using them.
+	*/
+	std::vector<std::unique_ptr<const FilterChain>> retiredFilterChains;
+
 	/**
 	Is this appender closed?
 	*/
@@ -70,6 +143,53 @@ struct AppenderSkeleton::AppenderSkeletonPrivate
 
 	LOG4CXX_NS::helpers::Pool pool;
 	mutable std::recursive_mutex mutex;
+
+	/**
+	Measurements of appender activity. Created when metrics are first enabled.
+	*/
+	helpers::AppenderMetricsPtr metrics;
+
+	/**
+	The measurements to update. Null while metrics are disabled.
+	*/
+	std::atomic<helpers::AppenderMetrics*> activeMetrics{nullptr};
+
+	/**
+	The name of the logger that receives periodic metrics reports.
+	*/
+	LogString metricsLoggerName;
+
+	/**
+	Milliseconds between metrics reports. Zero disables reporting.
+	*/
+	std::atomic<int> metricsInterval{0};
+
+	/**
+	The steady clock time (in milliseconds) after which the next report is due.
+	*/
+	std::atomic<int64_t> nextMetricsReport{0};
+
+	helpers::AppenderMetrics* getMetrics() const
+	{
+		return activeMetrics.load(std::memory_order_relaxed);
+	}
+
+	/**
+	Send the current metrics to the metrics logger if the report interval has elapsed.
+	*/
+	void reportMetricsIfDue();
+
+	/**
+	Does \c event pass the threshold and filter chain?
+	The mutex is only used when the filter chain needs to be compiled.
+	*/
+	bool isAccepted(const spi::LoggingEventPtr& event);
+
+	/**
+	Publish a new version of the filter chain if the current version is out of date.
+	Requires the mutex to be held.
+	*/
+	const FilterChain* compileFilters();
 };
 
 }
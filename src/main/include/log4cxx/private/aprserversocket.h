@@ -20,6 +20,8 @@
 
 #include <log4cxx/helpers/serversocket.h>
 
+struct apr_socket_t;
+
 namespace LOG4CXX_NS
 {
 namespace helpers
@@ -37,6 +39,9 @@ class LOG4CXX_EXPORT APRServerSocket : public helpers::ServerSocket
 
 	    SocketPtr accept() override;
 
+	    /** The underlying APR socket. Null after close() is called. */
+	    apr_socket_t* getSocketHandle() const;
+
 	private:
 		struct APRServerSocketPriv;
 };
@@ -38,9 +38,22 @@ class LOG4CXX_EXPORT APRSocket : public helpers::Socket
 
 		virtual size_t write(ByteBuffer&);
 
+		/** Add the available bytes (up to buf.remaining()) to \c buf.
+		Returns the number of bytes added, zero at the end of the stream.
+		Throws SocketTimeoutException if no data arrives within the SO_TIMEOUT period.
+		*/
+		size_t read(ByteBuffer& buf);
+
+		/** Enable/disable SO_TIMEOUT with the specified timeout, in milliseconds.
+		*/
+		void setSoTimeout(int timeout);
+
 		/** Closes this socket. */
 		virtual void close();
 
+		/** The underlying APR socket. Null after close() is called. */
+		apr_socket_t* getSocketHandle() const;
+
 	private:
 		struct APRSocketPriv;
 };
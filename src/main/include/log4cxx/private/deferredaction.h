@@ -0,0 +1,65 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef LOG4CXX_DEFERRED_ACTION_H
+#define LOG4CXX_DEFERRED_ACTION_H
+
+#include <log4cxx/rolling/action.h>
+#include <functional>
+
+namespace LOG4CXX_NS
+{
+namespace rolling
+{
+
+/**
+ * An action that runs a function, used by a rolling policy
+ * to pass rollover work to its own background thread
+ * when the appender executes the asynchronous rollover action.
+ */
+class DeferredAction : public Action
+{
+	public:
+		DECLARE_ABSTRACT_LOG4CXX_OBJECT(DeferredAction)
+		BEGIN_LOG4CXX_CAST_MAP()
+		LOG4CXX_CAST_ENTRY(DeferredAction)
+		LOG4CXX_CAST_ENTRY_CHAIN(Action)
+		END_LOG4CXX_CAST_MAP()
+
+		/**
+		 * Constructor.
+		 */
+		DeferredAction(const std::function<void()>& f);
+
+		/**
+		 * Call the function.
+		 *
+		 * @return true.
+		 */
+		bool execute(LOG4CXX_NS::helpers::Pool& pool) const override;
+
+	private:
+		std::function<void()> m_function;
+};
+
+LOG4CXX_PTR_DEF(DeferredAction);
+
+}
+}
+
+#endif // LOG4CXX_DEFERRED_ACTION_H
@@ -0,0 +1,134 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef LOG4CXX_EMERGENCY_DRAIN_H
+#define LOG4CXX_EMERGENCY_DRAIN_H
+
+#include <log4cxx/helpers/outputstream.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <atomic>
+#include <memory>
+
+namespace LOG4CXX_NS
+{
+namespace helpers
+{
+
+/**
+A fixed size table of actions that write pending output
+when the process receives a fatal signal (SIGSEGV, SIGBUS, SIGFPE, SIGILL or SIGABRT).
+
+The signal handler runs each action, output buffers before event queues,
+then restores the previous disposition of the signal and raises it again.
+Actions must only use async-signal-safe functions (such as write(2))
+and must not allocate memory or take locks.
+Output may be repeated when the signal interrupts a thread that is writing the same data.
+
+The signal handlers are not installed on Windows.
+*/
+class LOG4CXX_EXPORT EmergencyDrain
+{
+	public:
+		/**
+		An async-signal-safe function that writes the output held by \c context.
+		*/
+		typedef void (*Action)(void* context);
+
+		/**
+		The order in which actions are run.
+		*/
+		enum Order
+		{
+			Buffers, //!< Formatted output not yet written to its file
+			Queues   //!< Events not yet passed to an appender
+		};
+
+		/**
+		Install the signal handlers if they are not already installed.
+		Returns false if signal handling is not available.
+		*/
+		static bool install();
+
+		/**
+		Run \c action with \c context when a fatal signal is received.
+		Returns an identifier for #remove, or -1 (with a warning) if the table is full.
+		*/
+		static int add(Action action, void* context, Order order);
+
+		/**
+		Stop using the action identified by \c id (when not negative).
+		*/
+		static void remove(int id);
+
+		/**
+		Run each action once. Called by the signal handler.
+		*/
+		static void drain();
+
+		/**
+		Write \c size bytes at \c data to \c fd, retrying interrupted and partial writes.
+		*/
+		static void write(int fd, const char* data, size_t size);
+
+		/**
+		Write a line holding the time, level, logger name and message of \c event to \c fd
+		without allocating memory.
+		*/
+		static void write(int fd, const spi::LoggingEvent& event);
+
+		/**
+		The maximum number of actions.
+		*/
+		static size_t getCapacity();
+};
+
+/**
+An OutputStream that holds up to a fixed number of bytes
+before passing them to the underlying stream in one write.
+The held bytes are written directly to the file descriptor of the underlying file
+by the EmergencyDrain signal handler.
+*/
+class DrainableOutputStream : public OutputStream
+{
+	public:
+		/**
+		Hold up to \c capacity bytes destined for \c os, whose file descriptor is \c fd.
+		*/
+		DrainableOutputStream(const OutputStreamPtr& os, int fd, size_t capacity);
+		~DrainableOutputStream();
+
+		void close(Pool& p) override;
+		void flush(Pool& p) override;
+		void write(ByteBuffer& buf, Pool& p) override;
+
+		/**
+		The number of bytes held.
+		*/
+		size_t getLength() const;
+
+	private:
+		LOG4CXX_DECLARE_PRIVATE_MEMBER_PTR(DrainableOutputStreamPrivate, m_priv)
+		DrainableOutputStream(const DrainableOutputStream&);
+		DrainableOutputStream& operator=(const DrainableOutputStream&);
+};
+LOG4CXX_PTR_DEF(DrainableOutputStream);
+
+} // namespace helpers
+} // namespace LOG4CXX_NS
+
+#endif // LOG4CXX_EMERGENCY_DRAIN_H
@@ -20,9 +20,21 @@
 
 #include <log4cxx/private/writerappender_priv.h>
 #include <log4cxx/fileappender.h>
+#include <log4cxx/helpers/fileoutputstream.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace LOG4CXX_NS
 {
+namespace helpers
+{
+class GZipOutputStream;
+class FileIndexWriter;
+class DrainableOutputStream;
+}
 
 struct FileAppender::FileAppenderPriv : public WriterAppender::WriterAppenderPriv
 {
@@ -40,6 +52,11 @@ struct FileAppender::FileAppenderPriv : public WriterAppender::WriterAppenderPri
 		, bufferSize(_bufferSize)
 		{}
 
+	~FileAppenderPriv()
+	{
+		stopSyncer();
+	}
+
 	/** Append to or truncate the file? The default value for this
 	variable is <code>true</code>, meaning that by default a
 	<code>FileAppender</code> will append to an existing file and
@@ -60,6 +77,123 @@ struct FileAppender::FileAppenderPriv : public WriterAppender::WriterAppenderPri
 	/**
 	How big should the IO buffer be? Default is 8K. */
 	int bufferSize;
+
+	/**
+	Is output compressed into gzip members? */
+	bool gzip = false;
+
+	/**
+	The uncompressed size of a gzip member. */
+	size_t compressionFrameSize = 1024 * 1024;
+
+	/**
+	The maximum milliseconds before a started gzip member is completed. */
+	int compressionInterval = 1000;
+
+	/**
+	The compressor for the open file. */
+	std::shared_ptr<helpers::GZipOutputStream> gzipStream;
+
+	/**
+	The size of the log file blocks described by the time index, or zero for no index. */
+	size_t indexInterval = 0;
+
+	/**
+	The time index of the open file. */
+	std::shared_ptr<helpers::FileIndexWriter> index;
+
+	/**
+	Is buffered output written by the fatal signal handler? */
+	bool emergencyDrain = false;
+
+	/**
+	The buffer of the open file that the fatal signal handler writes,
+	used instead of a BufferedWriter. */
+	std::shared_ptr<helpers::DrainableOutputStream> drainStream;
+
+	/**
+	Do callers wait until their events are on stable storage? */
+	bool groupCommit = false;
+
+	/**
+	The open file that the syncer thread flushes to the storage device. */
+	helpers::FileOutputStreamPtr syncFile;
+
+	/**
+	The number of events passed to subAppend. */
+	std::atomic<uint64_t> writtenCount{0};
+
+	/**
+	The writtenCount value a caller is waiting for. */
+	uint64_t requestedCount = 0;
+
+	/**
+	The writtenCount value at the last successful synchronization. */
+	uint64_t durableCount = 0;
+
+	/**
+	The writtenCount value at the last failed synchronization.
+	Callers waiting for these events continue, as they cannot be made durable. */
+	uint64_t failedCount = 0;
+
+	/**
+	The writtenCount value at the last synchronization, successful or not.
+	Requires syncMutex to be held. */
+	uint64_t getCompletedCount() const
+	{
+		return std::max(durableCount, failedCount);
+	}
+
+	/**
+	The milliseconds between checks for a gzip member that has been open
+	longer than the compression interval, or zero for no checks. */
+	int frameCheckInterval = 0;
+
+	bool stopping = false;
+	std::mutex syncMutex;
+	std::condition_variable syncRequested;
+	std::condition_variable syncCompleted;
+	std::thread syncer;
+
+	/**
+	Start the syncer thread if it is not running.
+	Called with the appender lock held. */
+	void startSyncer();
+
+	/**
+	Complete outstanding requests and end the syncer thread. */
+	void stopSyncer();
+
+	/**
+	Block until the events passed to subAppend so far are on stable storage. */
+	void waitUntilDurable();
+
+	/**
+	Write buffered output and flush the file to the storage device
+	once for each group of waiting callers. */
+	void runSyncer();
+
+	/**
+	Pass \c status, the reason the file could not be flushed to the storage device,
+	to the error handler. Requires the appender lock to be held. */
+	void reportSyncFailure(log4cxx_status_t status);
+
+	/**
+	Complete the gzip member when it was started more than the compression interval ago,
+	so an idle file can be read completely. */
+	void finishIdleFrame(helpers::Pool& p);
+
+	/**
+	When group commit is in effect and \c os is a file,
+	a stream that flushes the file to the storage device when closed,
+	otherwise \c os. */
+	helpers::OutputStreamPtr makeDurable(const helpers::OutputStreamPtr& os);
+
+	/**
+	When \c os is a file, the stream returned by #makeDurable
+	wrapped in a buffer that the fatal signal handler writes
+	if the <b>EmergencyDrain</b> option applies, otherwise \c os. */
+	helpers::OutputStreamPtr prepareFileStream(const helpers::OutputStreamPtr& os);
 };
 
 }
@@ -18,12 +18,23 @@
 #define LOG4CXX_FILTER_PRIVATE_H
 
 #include <log4cxx/spi/filter.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace LOG4CXX_NS
 {
 namespace spi
 {
 
+/**
+A number which an appender compares to the value saved with its compiled filter chain
+to detect when the chain needs to be recompiled.
+*/
+using FilterGeneration = std::atomic<unsigned>;
+using FilterGenerationPtr = std::shared_ptr<FilterGeneration>;
+
 struct Filter::FilterPrivate
 {
 	virtual ~FilterPrivate(){}
@@ -32,8 +43,26 @@ struct Filter::FilterPrivate
 	Points to the next filter in the filter chain.
 	*/
 	FilterPtr next;
+
+	/**
+	The generation of each appender that has compiled this filter into its filter chain.
+	*/
+	std::vector<std::weak_ptr<FilterGeneration>> owners;
+	std::mutex ownersMutex;
 };
 
+/**
+Change the generation of each appender using \c filter.
+Called when \c filter is linked to another filter
+or, for a level filter, an option is changed.
+*/
+void onFilterChange(Filter& filter);
+
+/**
+Include \c generation in those changed by onFilterChange(\c filter).
+*/
+void addFilterOwner(Filter& filter, const FilterGenerationPtr& generation);
+
 }
 }
 
@@ -0,0 +1,68 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef LOG4CXX_GZIP_OUTPUT_STREAM_H
+#define LOG4CXX_GZIP_OUTPUT_STREAM_H
+
+#include <log4cxx/helpers/outputstream.h>
+#include <chrono>
+
+namespace LOG4CXX_NS
+{
+namespace helpers
+{
+
+/**
+ * Wrapper for OutputStream that compresses the data written to it
+ * into a sequence of gzip members, each of which can be decompressed on its own.
+ *
+ * A member is completed once it holds \c frameSize bytes of uncompressed data,
+ * on the first write or flush after \c interval has elapsed since it was started,
+ * and when the stream is closed.
+ * A gzip reader can recover the content of a truncated file
+ * up to the last completed member.
+ */
+class GZipOutputStream : public OutputStream
+{
+	public:
+		/**
+		 * Compress data written to \c os.
+		 * @throws IOException if the compressor cannot be initialized.
+		 */
+		GZipOutputStream(const OutputStreamPtr& os, size_t frameSize, std::chrono::milliseconds interval);
+		~GZipOutputStream();
+
+		void close(Pool& p) override;
+		void flush(Pool& p) override;
+		void write(ByteBuffer& buf, Pool& p) override;
+
+		/**
+		 * Complete the current member and write it to the wrapped stream.
+		 */
+		void finishFrame(Pool& p);
+
+	private:
+		LOG4CXX_DECLARE_PRIVATE_MEMBER_PTR(GZipOutputStreamPrivate, m_priv)
+		GZipOutputStream(const GZipOutputStream&);
+		GZipOutputStream& operator=(const GZipOutputStream&);
+};
+
+} // namespace helpers
+} // namespace LOG4CXX_NS
+
+#endif // LOG4CXX_GZIP_OUTPUT_STREAM_H
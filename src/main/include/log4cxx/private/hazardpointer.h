@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef LOG4CXX_HAZARD_POINTER_H
+#define LOG4CXX_HAZARD_POINTER_H
+
+#include <log4cxx/log4cxx.h>
+#include <atomic>
+
+namespace LOG4CXX_NS
+{
+namespace helpers
+{
+
+/**
+Prevents the deletion of an immutable object published through an atomic pointer
+while the current thread is using it, without a lock or a shared reference count.
+
+The thread announces the object in a slot of its own (on a separate cache line),
+so readers on different cores do not contend.
+A writer that replaces the published pointer keeps the previous object
+until isInUse() returns false for it.
+
+Each thread has a small number of slots, used by nested instances.
+When they are all in use, hasSlot() is false and the caller must use a lock instead.
+*/
+class HazardPointer
+{
+	public:
+		/**
+		Reserve the next slot of the current thread.
+		*/
+		HazardPointer();
+
+		/**
+		Release the slot.
+		*/
+		~HazardPointer();
+
+		/**
+		Is an object protected by this instance?
+		*/
+		bool hasSlot() const
+		{
+			return m_slot != nullptr;
+		}
+
+		/**
+		The current value of \c source, which is not deleted before this instance is destroyed.
+		Requires hasSlot() to be true.
+		*/
+		template <typename T>
+		T* protect(const std::atomic<T*>& source)
+		{
+			T* result;
+			do
+			{
+				result = source.load(std::memory_order_acquire);
+				announce(result);
+			} while (result != source.load(std::memory_order_seq_cst));
+			return result;
+		}
+
+		/**
+		Is a thread using \c object?
+		Call after the pointer to \c object has been replaced (with a sequentially consistent store).
+		*/
+		static bool isInUse(const void* object);
+
+		/**
+		Where a thread announces the object it is using.
+		*/
+		struct Slot;
+
+	private:
+		void announce(const void* object);
+		Slot* m_slot;
+		HazardPointer(const HazardPointer&);
+		HazardPointer& operator=(const HazardPointer&);
+};
+
+} // namespace helpers
+} // namespace LOG4CXX_NS
+
+#endif // LOG4CXX_HAZARD_POINTER_H
@@ -0,0 +1,111 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef LOG4CXX_MULTIPROCESS_ROLLOVER_STATE_H
+#define LOG4CXX_MULTIPROCESS_ROLLOVER_STATE_H
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/pool.h>
+#include <cstdint>
+#include <string>
+
+struct apr_file_t;
+struct apr_mmap_t;
+
+namespace LOG4CXX_NS
+{
+namespace rolling
+{
+
+/**
+A small memory mapped file through which processes writing to the same log file
+learn of a rollover made by another process.
+
+The process making a rollover (while holding the rollover lock) increments a generation counter
+and publishes the new active file name.
+Other processes compare the counter with the value they last saw on each event,
+so the file system is only consulted after a rollover.
+The control block also holds the length of the active file,
+which each process increases by the number of bytes it writes.
+*/
+class LOG4CXX_EXPORT MultiprocessRolloverState
+{
+	public:
+		MultiprocessRolloverState();
+		~MultiprocessRolloverState();
+
+		/**
+		Map the control file at \c path, creating it if it does not exist.
+		Returns false (after logging a warning) if the file cannot be used
+		or does not hold a valid control block.
+		*/
+		bool open(const std::string& path);
+
+		/**
+		Release the mapping.
+		*/
+		void close();
+
+		/**
+		Is the control file mapped?
+		*/
+		bool isOpen() const;
+
+		/**
+		A value that changes when a rollover is published.
+		*/
+		uint64_t getGeneration() const;
+
+		/**
+		The active file name of the most recent rollover
+		(empty if none has been published or it could not be read consistently)
+		and the corresponding generation in \c generation.
+		*/
+		LogString getActiveFileName(uint64_t& generation) const;
+
+		/**
+		Make \c activeFile (which now holds \c fileLength bytes) the active file
+		and change the generation.
+		Only call this while holding the rollover lock.
+		*/
+		void publish(const LogString& activeFile, size_t fileLength);
+
+		/**
+		Add \c byteCount to the active file length, returning the new length.
+		*/
+		size_t addFileLength(size_t byteCount);
+
+		/**
+		Set the active file length to \c fileLength.
+		*/
+		void setFileLength(size_t fileLength);
+
+	private:
+		struct ControlBlock;
+		ControlBlock* m_block;
+		apr_file_t* m_file;
+		apr_mmap_t* m_mmap;
+		helpers::Pool m_pool;
+		MultiprocessRolloverState(const MultiprocessRolloverState&);
+		MultiprocessRolloverState& operator=(const MultiprocessRolloverState&);
+};
+
+} // namespace rolling
+} // namespace LOG4CXX_NS
+
+#endif // LOG4CXX_MULTIPROCESS_ROLLOVER_STATE_H
@@ -21,6 +21,9 @@
 #include <log4cxx/db/odbcappender.h>
 #include <log4cxx/pattern/loggingeventpatternconverter.h>
 #include "appenderskeleton_priv.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #if !defined(LOG4CXX)
 	#define LOG4CXX 1
@@ -38,6 +41,7 @@
 	typedef int64_t SQLLEN;
 	typedef long SQLINTEGER;
 	typedef short SQLSMALLINT;
+	typedef unsigned short SQLUSMALLINT;
 #endif
 
 #if LOG4CXX_EVENTS_AT_EXIT
@@ -61,6 +65,12 @@ struct ODBCAppender::ODBCAppenderPriv : public AppenderSkeleton::AppenderSkeleto
 		, env(0)
 		, preparedStatement(0)
 		, bufferSize(1)
+		, backgroundFlush(false)
+		, stopping(false)
+		, discardCount(0)
+		, arraySize(1)
+		, paramsProcessed(0)
+		, transactionConnection(0)
 		, timeZone(helpers::TimeZone::getDefault())
 #if LOG4CXX_EVENTS_AT_EXIT
 		, atExitRegistryRaii(std::move(atExitActivated))
@@ -107,6 +117,38 @@ struct ODBCAppender::ODBCAppenderPriv : public AppenderSkeleton::AppenderSkeleto
 	*/
 	std::vector<spi::LoggingEventPtr> buffer;
 
+	/**
+	* Write the events on a background thread?
+	*/
+	bool backgroundFlush;
+
+	/**
+	* Full buffers waiting for the background thread, guarded by queueMutex
+	*/
+	std::vector<spi::LoggingEventPtr> pending;
+	bool stopping;
+	size_t discardCount;
+	std::mutex queueMutex;
+	std::condition_variable queueChanged;
+	std::thread flusher;
+
+	/**
+	* Serializes use of the prepared statement
+	*/
+	std::mutex statementMutex;
+
+	/**
+	* The number of rows in each bound parameter array
+	*/
+	size_t arraySize;
+	std::vector<SQLUSMALLINT> paramStatus;
+	SQLULEN paramsProcessed;
+
+	/**
+	* The connection on which autocommit is disabled, if any
+	*/
+	SQLHDBC transactionConnection;
+
 	/** Provides timestamp components
 	*/
 	helpers::TimeZonePtr timeZone;
@@ -123,14 +165,16 @@ struct ODBCAppender::ODBCAppenderPriv : public AppenderSkeleton::AppenderSkeleto
 		SQLULEN      paramMaxCharCount;
 		SQLPOINTER   paramValue;
 		SQLINTEGER   paramValueSize;
-		SQLLEN       strLen_or_Ind;
+		std::vector<char>   paramBuffer;   // arraySize values of paramValueSize bytes
+		std::vector<SQLLEN> strLen_or_Ind; // arraySize indicators
 	};
 	std::vector<LogString>   mappedName;
 	std::vector<DataBinding> parameterValue;
 #if LOG4CXX_HAVE_ODBC
 	void setPreparedStatement(SQLHDBC con, helpers::Pool& p);
-	void setParameterValues(const spi::LoggingEventPtr& event, helpers::Pool& p);
+	void setParameterValues(const spi::LoggingEventPtr& event, size_t row, helpers::Pool& p);
 #endif
+	void stopFlusher();
 
 #if LOG4CXX_EVENTS_AT_EXIT
 	helpers::AtExitRegistry::Raii atExitRegistryRaii;
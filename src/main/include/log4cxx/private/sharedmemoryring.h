@@ -0,0 +1,104 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef LOG4CXX_SHARED_MEMORY_RING_H
+#define LOG4CXX_SHARED_MEMORY_RING_H
+
+#include <log4cxx/logstring.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace LOG4CXX_NS
+{
+namespace helpers
+{
+
+/**
+A bounded queue of variable length records held in a POSIX shared memory object,
+to which any number of threads and processes can add records
+and from which one process removes them.
+
+A record is added by reserving space using an atomic compare-and-swap on the write position,
+copying the data into the reserved space and then marking the record as committed.
+Records are removed in the order in which the space was reserved.
+A committed record remains available to the reader after the writing process ends.
+
+Each instance uses one of 64 writer slots in the shared memory object
+while it is open, in which publish counts its active calls.
+When an uncommitted record has blocked the reader for five seconds,
+the reader starts a new epoch and waits until every live process has finished
+the calls it started in the previous epoch.
+The record is then skipped, as its writer must have ended.
+A writer that ended before storing the record size also causes
+the records reserved after it (before the epoch changed) to be skipped.
+A slow writer is never skipped, so a record is not written into space the reader has reused.
+*/
+class LOG4CXX_EXPORT SharedMemoryRing
+{
+	public:
+		/**
+		Map the shared memory object \c name (which should start with '/'),
+		creating it with room for at least \c capacity bytes of records if it does not exist.
+
+		Throws IOException if the object cannot be created or mapped
+		or does not contain a ring.
+		*/
+		SharedMemoryRing(const LogString& name, size_t capacity);
+		~SharedMemoryRing();
+
+		/**
+		Add a record containing the \c size bytes at \c data.
+		Returns false (and increments the discard count) if there is no room
+		or all writer slots were in use when this instance was created.
+		*/
+		bool publish(const char* data, size_t size);
+
+		/**
+		Pass up to \c maxRecords available records, oldest first, to \c consumer and remove them.
+		Returns the number of records passed to \c consumer.
+		Only one thread (in one process) may call this at a time.
+		*/
+		size_t consume(const std::function<void(const char* data, size_t size)>& consumer, size_t maxRecords = SIZE_MAX);
+
+		/**
+		The number of bytes available for records.
+		*/
+		size_t getCapacity() const;
+
+		/**
+		The number of records that could not be added or were skipped by the reader.
+		*/
+		uint64_t getDiscardCount() const;
+
+		/**
+		Remove the shared memory object \c name.
+		Mappings in existing processes remain valid.
+		*/
+		static void unlink(const LogString& name);
+
+	private:
+		LOG4CXX_DECLARE_PRIVATE_MEMBER_PTR(SharedMemoryRingPrivate, m_priv)
+		SharedMemoryRing(const SharedMemoryRing&);
+		SharedMemoryRing& operator=(const SharedMemoryRing&);
+};
+
+} // namespace helpers
+} // namespace LOG4CXX_NS
+
+#endif // LOG4CXX_SHARED_MEMORY_RING_H
@@ -20,6 +20,8 @@
 #include <log4cxx/net/socketappenderskeleton.h>
 #include <log4cxx/private/appenderskeleton_priv.h>
 #include <log4cxx/helpers/inetaddress.h>
+#include <deque>
+#include <string>
 
 namespace LOG4CXX_NS
 {
@@ -35,7 +37,12 @@ struct SocketAppenderSkeleton::SocketAppenderSkeletonPriv : public AppenderSkele
 		port(defaultPort),
 		reconnectionDelay(reconnectionDelay),
 		locationInfo(false),
-		thread() {}
+		thread(),
+		backgroundSend(false),
+		maxQueueSize(1024 * 1024),
+		replayBufferSize(64 * 1024),
+		queuedBytes(0),
+		discardCount(0) {}
 
 	SocketAppenderSkeletonPriv(helpers::InetAddressPtr address, int defaultPort, int reconnectionDelay) :
 		AppenderSkeletonPrivate(),
@@ -44,7 +51,12 @@ struct SocketAppenderSkeleton::SocketAppenderSkeletonPriv : public AppenderSkele
 		port(defaultPort),
 		reconnectionDelay(reconnectionDelay),
 		locationInfo(false),
-		thread() {}
+		thread(),
+		backgroundSend(false),
+		maxQueueSize(1024 * 1024),
+		replayBufferSize(64 * 1024),
+		queuedBytes(0),
+		discardCount(0) {}
 
 	SocketAppenderSkeletonPriv(const LogString& host, int port, int delay) :
 		AppenderSkeletonPrivate(),
@@ -53,7 +65,12 @@ struct SocketAppenderSkeleton::SocketAppenderSkeletonPriv : public AppenderSkele
 		port(port),
 		reconnectionDelay(delay),
 		locationInfo(false),
-		thread() {}
+		thread(),
+		backgroundSend(false),
+		maxQueueSize(1024 * 1024),
+		replayBufferSize(64 * 1024),
+		queuedBytes(0),
+		discardCount(0) {}
 
 	/**
 	host name
@@ -71,6 +88,38 @@ struct SocketAppenderSkeleton::SocketAppenderSkeletonPriv : public AppenderSkele
 	std::thread thread;
 	std::condition_variable interrupt;
 	std::mutex interrupt_mutex;
+
+	/**
+	Is formatted output sent by a background thread?
+	*/
+	bool backgroundSend;
+
+	/**
+	The maximum number of bytes waiting to be sent.
+	*/
+	size_t maxQueueSize;
+
+	/**
+	The number of recently sent bytes that are resent after a reconnection.
+	*/
+	size_t replayBufferSize;
+
+	/**
+	Encoded events waiting to be sent, guarded by interrupt_mutex.
+	*/
+	std::deque<std::string> queue;
+	size_t queuedBytes;
+	size_t discardCount;
+
+	/**
+	Recently sent events, used only by the sending thread.
+	*/
+	std::deque<std::string> replay;
+
+	/**
+	Bytes sent by the background thread at the start of each connection.
+	*/
+	std::string streamHeader;
 };
 
 } // namespace net
@@ -20,6 +20,11 @@
 #include "appenderskeleton_priv.h"
 
 #include <log4cxx/private/log4cxx_private.h>
+#include <log4cxx/helpers/socket.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
 
 #if LOG4CXX_HAVE_SYSLOG
 	#include <syslog.h>
@@ -60,7 +65,12 @@ struct SyslogAppender::SyslogAppenderPriv : public AppenderSkeleton::AppenderSke
 		AppenderSkeletonPrivate(),
 		syslogFacility(LOG_USER),
 		facilityPrinting(false),
-		maxMessageLength(1024)
+		syslogHostPort(-1),
+		maxMessageLength(1024),
+		tcp(false),
+		maxQueueSize(1024 * 1024),
+		reconnectionDelay(30000),
+		discardCount(0)
 	{
 
 	}
@@ -69,7 +79,12 @@ struct SyslogAppender::SyslogAppenderPriv : public AppenderSkeleton::AppenderSke
 		AppenderSkeletonPrivate (layout),
 		syslogFacility(syslogFacility),
 		facilityPrinting(false),
-		maxMessageLength(1024)
+		syslogHostPort(-1),
+		maxMessageLength(1024),
+		tcp(false),
+		maxQueueSize(1024 * 1024),
+		reconnectionDelay(30000),
+		discardCount(0)
 	{
 
 	}
@@ -79,7 +94,12 @@ struct SyslogAppender::SyslogAppenderPriv : public AppenderSkeleton::AppenderSke
 		AppenderSkeletonPrivate(layout),
 		syslogFacility(syslogFacility),
 		facilityPrinting(false),
-		maxMessageLength(1024)
+		syslogHostPort(-1),
+		maxMessageLength(1024),
+		tcp(false),
+		maxQueueSize(1024 * 1024),
+		reconnectionDelay(30000),
+		discardCount(0)
 	{
 
 	}
@@ -91,6 +111,36 @@ struct SyslogAppender::SyslogAppenderPriv : public AppenderSkeleton::AppenderSke
 	LogString syslogHost;
 	int syslogHostPort;
 	int maxMessageLength;
+
+	/**
+	Are messages sent over a TCP connection?
+	*/
+	bool tcp;
+
+	/**
+	The maximum number of bytes waiting to be sent over the TCP connection.
+	*/
+	size_t maxQueueSize;
+
+	/**
+	The number of milliseconds between TCP connection attempts.
+	*/
+	int reconnectionDelay;
+
+	/**
+	Octet-counted frames waiting to be sent, guarded by queueMutex.
+	*/
+	std::string pending;
+	size_t discardCount;
+	std::mutex queueMutex;
+	std::condition_variable queueChanged;
+
+	/**
+	Sends the pending frames.
+	*/
+	std::thread sender;
+
+	void sendPendingFrames();
 };
 
 }
@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef LOG4CXX_UNIX_DATAGRAM_SOCKET_H
+#define LOG4CXX_UNIX_DATAGRAM_SOCKET_H
+
+#include <log4cxx/logstring.h>
+#include <string>
+#include <vector>
+
+namespace LOG4CXX_NS
+{
+namespace helpers
+{
+
+/**
+A connected Unix domain socket that sends each message as one datagram
+(SOCK_DGRAM) or one record (SOCK_SEQPACKET).
+
+A batch of messages is passed to the kernel in a single sendmmsg call where available.
+*/
+class UnixDatagramSocket
+{
+	public:
+		UnixDatagramSocket();
+		~UnixDatagramSocket();
+
+		/**
+		Connect to the socket bound to \c path using a SOCK_SEQPACKET connection
+		when \c seqPacket is true, otherwise using datagrams.
+		The send buffer size is set to \c sendBufferSize bytes when it is positive.
+
+		Throws SocketException on failure.
+		*/
+		void connect(const LogString& path, bool seqPacket, int sendBufferSize);
+
+		/**
+		Send \c messages[start] onwards, returning the number of messages accepted by the kernel.
+
+		When \c wait is false, sending stops when the socket buffer is full
+		instead of waiting for the receiver.
+		A message that is too large for the socket is counted in \c rejected and skipped.
+
+		Throws SocketException if the connection fails.
+		*/
+		size_t send(const std::vector<std::string>& messages, size_t start, bool wait, size_t& rejected);
+
+		/** Close the connection. */
+		void close();
+
+		/** Is the socket not connected? */
+		bool isClosed() const;
+
+	private:
+		int m_fd;
+		UnixDatagramSocket(const UnixDatagramSocket&);
+		UnixDatagramSocket& operator=(const UnixDatagramSocket&);
+};
+
+} // namespace helpers
+} // namespace LOG4CXX_NS
+
+#endif // LOG4CXX_UNIX_DATAGRAM_SOCKET_H
@@ -18,6 +18,8 @@
 #include <log4cxx/helpers/writer.h>
 #include <log4cxx/writerappender.h>
 #include <atomic>
+#include <mutex>
+#include <vector>
 
 #include "appenderskeleton_priv.h"
 
@@ -98,6 +100,32 @@ struct WriterAppender::WriterAppenderPriv : public AppenderSkeleton::AppenderSke
 	*/
 	LOG4CXX_NS::helpers::WriterPtr writer;
 
+	/**
+	Are events formatted before the appender lock is taken?
+	*/
+	bool concurrentFormat = false;
+
+	/**
+	Formatted events waiting for a thread holding the appender lock.
+	*/
+	std::vector<std::pair<spi::LoggingEventPtr, LogString>> pendingEvents;
+	std::mutex pendingMutex;
+
+	/**
+	The layout output for the event being appended, when already formatted.
+	*/
+	const LogString* preformatted = nullptr;
+
+	/**
+	Is subAppend adding to combinedOutput instead of writing?
+	*/
+	bool combining = false;
+
+	/**
+	Output from a group of events, written in one call.
+	*/
+	LogString combinedOutput;
+
 #if LOG4CXX_EVENTS_AT_EXIT
 	helpers::AtExitRegistry::Raii atExitRegistryRaii;
 #endif
@@ -138,6 +138,23 @@ class LOG4CXX_EXPORT PropertyConfigurator :
 		to the lowest possible value, namely the level <code>ALL</code>.
 		</p>
 
+		<h3>Incremental reload</h3>
+
+		<p>When the configuration file is being watched (see #configureAndWatch),
+		a change normally re-creates every configured appender.
+		Set the following option to instead apply only the differences
+		between the previous and the changed file:
+
+		<pre>
+		log4j.incrementalReload=true
+		</pre>
+
+		<p>Logger levels and additivity are updated in place,
+		appenders with unchanged options continue to be used
+		and appenders with changed options are replaced in a single step.
+		See #doReconfigure.
+		</p>
+
 
 		<h3>Appender configuration</h3>
 
@@ -338,6 +355,20 @@ class LOG4CXX_EXPORT PropertyConfigurator :
 		spi::ConfigurationStatus doConfigure(helpers::Properties& properties,
 			spi::LoggerRepositoryPtr hierarchy);
 
+		/**
+		Apply to \c hierarchy the differences between
+		the <code>previous</code> and <code>current</code> configuration options.
+
+		An attached appender is retained when all the options prefixed by
+		<b>log4j.appender.</b><i>appenderName</i> are the same in both.
+		Loggers that are configured only in <code>previous</code>
+		have their level and appenders removed.
+		The remaining loggers are then configured from <code>current</code>
+		as in {@link PropertyConfigurator#doConfigure doConfigure}.
+		*/
+		spi::ConfigurationStatus doReconfigure(helpers::Properties& previous,
+			helpers::Properties& current, spi::LoggerRepositoryPtr hierarchy);
+
 		// --------------------------------------------------------------------------
 		// Internal stuff
 		// --------------------------------------------------------------------------
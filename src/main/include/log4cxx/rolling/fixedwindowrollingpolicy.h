@@ -19,6 +19,7 @@
 #define _LOG4CXX_ROLLING_FIXED_WINDOW_ROLLING_POLICY_H
 
 #include <log4cxx/rolling/rollingpolicybase.h>
+#include <log4cxx/rolling/action.h>
 
 
 
@@ -64,6 +65,20 @@ namespace rolling
  * current implementation will automatically reduce the window size to 12 when
  * larger values are specified by the user.
  *
+ * <p>When the <b>MonotonicIndex</b> option is true, archived files are instead
+ * given increasing index values and are never renamed after they are created.
+ * The active file <code>foo.log</code> is renamed as <code>foo.<em>n</em>.log</code>
+ * where <em>n</em> is one more than the index of the previous archive,
+ * or when there is no <b>ActiveFile</b>, logging simply continues
+ * in <code>foo.<em>n</em>.log</code>.
+ * The files whose index is more than <em>max</em> - <em>min</em> below <em>n</em>
+ * are deleted and any compression is done by a background thread,
+ * so a rollover requires at most one rename regardless of the window size.
+ * The oldest and newest index values are kept in a file with the name of the
+ * active file (or the <em>min</em> archive file) plus the extension ".manifest"
+ * so that numbering continues when the application restarts.
+ * The window size limit does not apply in this mode.
+ *
  *
  *
  *
@@ -85,6 +100,13 @@ class LOG4CXX_EXPORT FixedWindowRollingPolicy : public RollingPolicyBase
 
 		bool purge(int purgeStart, int maxIndex, LOG4CXX_NS::helpers::Pool& p) const;
 
+		RolloverDescriptionPtr initializeMonotonic(const LogString& currentActiveFile, bool append, helpers::Pool& p);
+		RolloverDescriptionPtr rolloverMonotonic(const LogString& currentActiveFile, bool append, helpers::Pool& p);
+		LogString getIndexFileName(int index, helpers::Pool& p) const;
+		bool indexFileExists(int index, helpers::Pool& p) const;
+		void queueBackgroundWork(const ActionPtr& compressAction, int firstIndex, int lastIndex);
+		void runBackgroundWork();
+
 	public:
 
 		FixedWindowRollingPolicy();
@@ -105,9 +127,12 @@ class LOG4CXX_EXPORT FixedWindowRollingPolicy : public RollingPolicyBase
 		Supported options | Supported values | Default value
 		:-------------- | :----------------: | :---------------:
 		MinIndex | 1-12 | 1
-		MaxIndex | 1-12 | 7
+		MaxIndex | 1-12 (see below) | 7
+		MonotonicIndex | True,False | False
 		ThrowIOExceptionOnForkFailure | True,False | True
 
+		MaxIndex may be any value not less than MinIndex when MonotonicIndex is true.
+
 		\sa RollingPolicyBase::setOption()
 		*/
 		void setOption(const LogString& option, const LogString& value) override;
@@ -121,6 +146,17 @@ class LOG4CXX_EXPORT FixedWindowRollingPolicy : public RollingPolicyBase
 		void setMaxIndex(int newVal);
 		void setMinIndex(int newVal);
 
+		/**
+		 * Are archived files given increasing index values instead of being renamed on each rollover?
+		 */
+		bool getMonotonicIndex() const;
+
+		/**
+		 * Use \c newValue to give archived files increasing index values
+		 * instead of renaming them on each rollover.
+		 */
+		void setMonotonicIndex(bool newValue);
+
 		/**
 		 * {@inheritDoc}
 		 */
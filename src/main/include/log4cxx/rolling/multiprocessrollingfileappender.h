@@ -33,6 +33,12 @@ namespace rolling
 
 /**
  * A special version of the RollingFileAppender that acts properly with multiple processes
+ *
+ * The processes share a small memory mapped control file (next to the lock file)
+ * holding a rollover generation number, the active file name and the active file length.
+ * The process that rolls the file publishes the new generation,
+ * so the others only check whether their file was renamed after a rollover
+ * instead of on every event.
  */
 class LOG4CXX_EXPORT MultiprocessRollingFileAppender : public FileAppender
 {
@@ -136,6 +142,11 @@ class LOG4CXX_EXPORT MultiprocessRollingFileAppender : public FileAppender
 		 */
 		void setFileLength(size_t length);
 
+		/**
+		 * Update the active file length after writing \c byteCount bytes.
+		 */
+		void updateFileLength(size_t byteCount, LOG4CXX_NS::helpers::Pool& p);
+
 		/**
 		 *  Release the file lock
 		 * @return void
@@ -147,6 +158,11 @@ class LOG4CXX_EXPORT MultiprocessRollingFileAppender : public FileAppender
 		 */
 		void reopenLatestFile(LOG4CXX_NS::helpers::Pool& p);
 
+		/**
+		 * re-open the active file after another process has rolled it
+		 */
+		void reopenActiveFile(LOG4CXX_NS::helpers::Pool& p);
+
 		friend class CountingOutputStream;
 
 };
@@ -127,6 +127,33 @@ class LOG4CXX_EXPORT RollingFileAppender : public FileAppender
 
 		LogString makeFileNamePattern(const LogString& datePattern);
 
+		/**
+		 * Is the next active file created by a background thread before it is required?
+		 */
+		bool getPreOpenNextFile() const;
+
+		/**
+		 * Use \c newValue to create the next active file in a background thread.
+		 *
+		 * When true, a file named after the active file with the extension ".next"
+		 * is created and opened ahead of time.
+		 * A rollover then runs the synchronous rollover action (usually a rename),
+		 * renames the prepared file to the new active file name and switches to it.
+		 * Asynchronous rollover actions (such as compression) are done by the background thread.
+		 */
+		void setPreOpenNextFile(bool newValue);
+
+		/**
+		 * The number of bytes reserved in the prepared file.
+		 */
+		size_t getPreallocateSize() const;
+
+		/**
+		 * Reserve \c newValue bytes of disk space in the prepared file
+		 * (using fallocate where available) without changing its length.
+		 */
+		void setPreallocateSize(size_t newValue);
+
 		/**
 		\copybrief FileAppender::setOption()
 
@@ -135,6 +162,8 @@ class LOG4CXX_EXPORT RollingFileAppender : public FileAppender
 		FileDatePattern | (\ref dateChars "1") | -
 		MaxBackupIndex | 1-12 | 0
 		MaxFileSize | (\ref fileSz "2") | 10 MB
+		PreOpenNextFile | True,False | False
+		PreallocateSize | (\ref fileSz "2") | 0
 
 		\anchor dateChars (1) A pattern compatible with
 		  java.text.SimpleDateFormat, "ABSOLUTE", "DATE" or "ISO8601".
@@ -181,6 +210,9 @@ class LOG4CXX_EXPORT RollingFileAppender : public FileAppender
 
 		bool rolloverInternal(LOG4CXX_NS::helpers::Pool& p);
 
+	private:
+		bool rolloverToSpareFile(const RolloverDescriptionPtr& rollover1, LOG4CXX_NS::helpers::Pool& p);
+
 	public:
 		/**
 		 * The policy that implements the scheme for rolling over a log file.
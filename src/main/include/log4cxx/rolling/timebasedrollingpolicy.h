@@ -100,6 +100,18 @@ namespace rolling
  *   </tr>
  * </table>
  *
+ * <h2>Removing old archived files</h2>
+ * When the <b>MaxHistory</b> or <b>TotalSizeCap</b> option is set,
+ * a background thread keeps a list of the archived files
+ * and deletes the oldest when there are more than <b>MaxHistory</b> files
+ * or their total size exceeds <b>TotalSizeCap</b>.
+ * The list is loaded once, when the options are activated,
+ * from the files in the directory of the archived files whose names match <b>FileNamePattern</b>.
+ * Subsequent archives are added as they are rolled over,
+ * so the directory is never scanned again.
+ * Any file compression is also done by the background thread.
+ * Unless <b>CleanHistoryOnStart</b> is true, files are first deleted at the next rollover.
+ *
  * <h2>Decoupling the location of the active log file and the archived log files</h2>
  * <p>The <em>active file</em> is defined as the log file for the current period
  * whereas <em>archived files</em> are thos files which have been rolled over
@@ -165,6 +177,45 @@ class LOG4CXX_EXPORT TimeBasedRollingPolicy : public virtual RollingPolicyBase,
 
 		void setMultiprocess(bool multiprocess);
 
+		/**
+		 * Use \c false when the appender detects a change of the active file name
+		 * made by another process, so the shared file name is not checked on every event.
+		 * By default the name is checked on every event when multiprocess is enabled.
+		 */
+		void setRefreshActiveFile(bool newValue);
+
+		/**
+		 * The number of archived files retained (0 means all files are retained).
+		 */
+		int getMaxHistory() const;
+
+		/**
+		 * Retain at most \c newValue archived files (0 means all files are retained).
+		 */
+		void setMaxHistory(int newValue);
+
+		/**
+		 * The maximum total size of the archived files (0 means no limit).
+		 */
+		size_t getTotalSizeCap() const;
+
+		/**
+		 * Delete the oldest archived files when their total size exceeds \c newValue bytes
+		 * (0 means no limit).
+		 */
+		void setTotalSizeCap(size_t newValue);
+
+		/**
+		 * Are old archived files deleted when the options are activated?
+		 */
+		bool getCleanHistoryOnStart() const;
+
+		/**
+		 * Use \c true to delete old archived files when the options are activated
+		 * instead of at the next rollover.
+		 */
+		void setCleanHistoryOnStart(bool newValue);
+
 		/**
 		 * {@inheritDoc}
 		 */
@@ -204,6 +255,14 @@ class LOG4CXX_EXPORT TimeBasedRollingPolicy : public virtual RollingPolicyBase,
 		Supported options | Supported values | Default value
 		:-------------- | :----------------: | :---------------:
 		ThrowIOExceptionOnForkFailure | True,False | True
+		MaxHistory | int | 0
+		TotalSizeCap | (\ref retentionSz1 "1") | 0
+		CleanHistoryOnStart | True,False | False
+
+		\anchor retentionSz1 (1) An integer in the range 0 - 2^63.
+		 You can specify the value with the suffixes "KB", "MB" or "GB" so that the integer is
+		 interpreted being expressed respectively in kilobytes, megabytes
+		 or gigabytes. For example, the value "10KB" will be interpreted as 10240.
 
 		\sa RollingPolicyBase::setOption()
 		 */
@@ -249,6 +308,16 @@ class LOG4CXX_EXPORT TimeBasedRollingPolicy : public virtual RollingPolicyBase,
 		 */
 		const std::string createFile(const std::string& filename, const std::string& suffix, LOG4CXX_NS::helpers::Pool& pool);
 
+		/**
+		 *   pass a rolled over file to the cleaner thread
+		 */
+		void queueArchive(const ActionPtr& compressAction, const LogString& archiveName);
+
+		/**
+		 *   compress archives and delete old archives until the policy is destroyed
+		 */
+		void runCleaner();
+
 };
 
 LOG4CXX_PTR_DEF(TimeBasedRollingPolicy);
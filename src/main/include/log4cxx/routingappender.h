@@ -0,0 +1,239 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _LOG4CXX_ROUTING_APPENDER_H
+#define _LOG4CXX_ROUTING_APPENDER_H
+
+#include <log4cxx/appenderskeleton.h>
+
+namespace LOG4CXX_NS
+{
+
+/**
+Writes each spi::LoggingEvent to a file chosen by a value of the event,
+for example an MDC entry identifying a tenant or the logger name.
+
+The <b>Route</b> option is a PatternLayout conversion pattern
+(such as <code>%X{tenant}</code> or <code>%c</code>) that is formatted for each event
+to obtain its route key.
+Events with an empty route key use the <b>DefaultRoute</b> key.
+
+An appender of <b>AppenderClass</b> (by default FileAppender) is created for each route key
+when it is first used.
+<b>AppenderClass</b> must be FileAppender or a subclass of it, such as rolling::RollingFileAppender.
+Its file name is <b>FileNamePattern</b> with each occurrence of <code>{route}</code>
+replaced by the route key.
+Characters in the route key that could select a different directory are replaced by '_'.
+Options not listed below (for example <b>Append</b>, <b>BufferedIO</b> or <b>Encoding</b>)
+are passed to each created appender. All routes use the layout of this appender.
+
+At most <b>MaxRoutes</b> route keys are kept. Once that many are in use,
+events with a new route key are written to the file of the <b>DefaultRoute</b> key
+and a warning is reported once.
+Finding the route of such an event takes a lock.
+
+At most <b>MaxOpenFiles</b> files are open at once.
+When another file is required, the least recently used file is closed.
+When <b>IdleTimeout</b> is greater than zero, a background thread closes
+files that have not been used for that many milliseconds.
+A closed file is reopened in append mode when its route is next used.
+
+The route of an event is found without taking a lock
+and events for different routes are written concurrently.
+Option changes take effect when activateOptions is next called.
+
+Here is an example configuration:
+~~~{.xml}
+<log4j:configuration xmlns:log4j="http://jakarta.apache.org/log4j/">
+<appender name="TENANTS" class="RoutingAppender">
+  <param name="Route"           value="%X{tenant}" />
+  <param name="FileNamePattern" value="logs/tenant-{route}.log" />
+  <param name="MaxOpenFiles"    value="200" />
+  <param name="IdleTimeout"     value="60000" />
+  <param name="BufferedIO"      value="true" />
+  <layout class="PatternLayout">
+    <param name="ConversionPattern" value="%d %-5p %c - %m%n" />
+  </layout>
+</appender>
+<root>
+  <priority value ="INFO" />
+  <appender-ref ref="TENANTS" />
+</root>
+</log4j:configuration>
+~~~
+*/
+class LOG4CXX_EXPORT RoutingAppender : public AppenderSkeleton
+{
+	protected:
+		struct RoutingAppenderPriv;
+
+	public:
+		DECLARE_LOG4CXX_OBJECT(RoutingAppender)
+		BEGIN_LOG4CXX_CAST_MAP()
+		LOG4CXX_CAST_ENTRY(RoutingAppender)
+		LOG4CXX_CAST_ENTRY_CHAIN(AppenderSkeleton)
+		END_LOG4CXX_CAST_MAP()
+
+		RoutingAppender();
+		~RoutingAppender();
+
+		/**
+		\copybrief AppenderSkeleton::setOption()
+
+		Supported options | Supported values | Default value
+		:-------------- | :----------------: | :---------------:
+		Route | (\ref routingPattern "1") | -
+		FileNamePattern | (\ref routingFileName "2") | -
+		DefaultRoute | {any} | default
+		AppenderClass | (\ref routingClass "3") | FileAppender
+		MaxOpenFiles | int | 100
+		MaxRoutes | int | 1000
+		IdleTimeout | int | 0
+		{any other} | (\ref routingChild "4") | -
+
+		\anchor routingPattern (1) A PatternLayout conversion pattern.
+
+		\anchor routingFileName (2) A file name in which <code>{route}</code> is replaced by the route key.
+
+		\anchor routingClass (3) The name of FileAppender or a class derived from it.
+
+		\anchor routingChild (4) Any option supported by <b>AppenderClass</b>,
+		which is applied to each created appender.
+
+		\sa AppenderSkeleton::setOption()
+		*/
+		void setOption(const LogString& option, const LogString& value) override;
+
+		/**
+		Close any open files and, when <b>IdleTimeout</b> is greater than zero,
+		start the background thread.
+		*/
+		void activateOptions(helpers::Pool& p) override;
+
+		/**
+		Write \c event to the file of its route without holding the lock of this appender.
+		*/
+		void doAppend(const spi::LoggingEventPtr& event, helpers::Pool& p) override;
+
+		/**
+		Stop the background thread and close all files.
+		*/
+		void close() override;
+
+		/**
+		A layout is required.
+		*/
+		bool requiresLayout() const override
+		{
+			return true;
+		}
+
+		/**
+		Use the PatternLayout conversion \c pattern to obtain the route key of an event.
+		*/
+		void setRoute(const LogString& pattern);
+
+		/**
+		The conversion pattern that provides the route key.
+		*/
+		LogString getRoute() const;
+
+		/**
+		Use \c pattern, in which <code>{route}</code> is replaced by the route key, as the file name.
+		*/
+		void setFileNamePattern(const LogString& pattern);
+
+		/**
+		The file name before the route key is inserted.
+		*/
+		LogString getFileNamePattern() const;
+
+		/**
+		Use \c key when an event has an empty route key.
+		*/
+		void setDefaultRoute(const LogString& key);
+
+		/**
+		The route key used when an event has an empty route key.
+		*/
+		LogString getDefaultRoute() const;
+
+		/**
+		Create appenders of the class named \c className,
+		which must be FileAppender or derived from it.
+		*/
+		void setAppenderClass(const LogString& className);
+
+		/**
+		The name of the class of the created appenders.
+		*/
+		LogString getAppenderClass() const;
+
+		/**
+		Keep at most \c count files open.
+		*/
+		void setMaxOpenFiles(int count);
+
+		/**
+		The maximum number of open files.
+		*/
+		int getMaxOpenFiles() const;
+
+		/**
+		Use the default route for events with a new route key once \c count route keys are in use.
+		*/
+		void setMaxRoutes(int count);
+
+		/**
+		The maximum number of route keys.
+		*/
+		int getMaxRoutes() const;
+
+		/**
+		Close a file when it has not been used for \c milliseconds. Zero keeps files open.
+		*/
+		void setIdleTimeout(int milliseconds);
+
+		/**
+		The milliseconds after which an unused file is closed.
+		*/
+		int getIdleTimeout() const;
+
+		/**
+		The number of route keys used since this appender was created.
+		*/
+		size_t getRouteCount() const;
+
+		/**
+		The number of files currently open.
+		*/
+		size_t getOpenFileCount() const;
+
+	protected:
+		void append(const spi::LoggingEventPtr& event, helpers::Pool& p) override;
+
+	private:
+		RoutingAppender(const RoutingAppender&);
+		RoutingAppender& operator=(const RoutingAppender&);
+};
+
+LOG4CXX_PTR_DEF(RoutingAppender);
+
+} // namespace LOG4CXX_NS
+
+#endif // _LOG4CXX_ROUTING_APPENDER_H
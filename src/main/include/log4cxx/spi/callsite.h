@@ -0,0 +1,172 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_SPI_CALLSITE_H
+#define _LOG4CXX_SPI_CALLSITE_H
+
+#include <log4cxx/log4cxx.h>
+#include <log4cxx/spi/location/locationinfo.h>
+#include <atomic>
+#include <vector>
+#include <memory>
+
+namespace LOG4CXX_NS
+{
+class Logger;
+LOG4CXX_PTR_DEF(Logger);
+class Level;
+LOG4CXX_PTR_DEF(Level);
+
+namespace spi
+{
+class CallSite;
+LOG4CXX_LIST_DEF(CallSiteList, const CallSite*);
+
+/**
+The state of a single logging request in the source code.
+
+Each expansion of the LOG4CXX_TRACE ... LOG4CXX_FATAL macros
+owns a static instance of this class.
+It holds the enabled/disabled decision
+for the first logger used at that call site
+tagged with the configuration generation number current at the time it was made.
+The cached decision is discarded when the generation number changes,
+that is, when any logger level, repository threshold or appender is changed.
+
+When the cached decision is current,
+a disabled logging request costs only a load and compare of static data.
+
+Call sites that have been evaluated at least once
+are available from #getCallSites for diagnostic purposes.
+*/
+class LOG4CXX_EXPORT CallSite
+{
+	public:
+		/**
+		A call site for a logging request at \c level
+		located at \c lineNumber of \c fileName in \c methodName.
+
+		Constant initialized so a function scope static instance requires no guard.
+		*/
+		constexpr CallSite(int level, const char* fileName, const char* methodName, int lineNumber) noexcept
+			: m_level(level)
+			, m_fileName(fileName)
+			, m_methodName(methodName)
+			, m_lineNumber(lineNumber)
+			, m_logger(nullptr)
+			, m_state(0)
+			, m_next(nullptr)
+			, m_registered(false)
+		{
+		}
+
+		/**
+		Is \c logger enabled for requests at the level of this call site?
+
+		The cached value is used when \c logger is the one first seen at this call site
+		and no configuration change has happened since the decision was made.
+		*/
+		bool isEnabledFor(const LoggerPtr& logger)
+		{
+			if (logger.get() == m_logger.load(std::memory_order_relaxed))
+			{
+				auto state = m_state.load(std::memory_order_acquire);
+				if ((state ^ (s_generation.load(std::memory_order_acquire) << 1)) <= 1)
+					return 0 != (state & 1);
+			}
+			return evaluate(logger);
+		}
+
+		/**
+		The level of requests made at this call site.
+		*/
+		LevelPtr getLevel() const;
+
+		/**
+		The source code location of this call site.
+		*/
+		LocationInfo getLocation() const;
+
+		/**
+		Was this call site found to be enabled
+		when last evaluated under the current configuration?
+		*/
+		bool isEnabled() const;
+
+		/**
+		The call sites that have been evaluated at least once.
+		*/
+		static CallSiteList getCallSites();
+
+		/**
+		The current configuration generation number.
+		*/
+		static unsigned getGeneration();
+
+		/**
+		Discard the cached decision of every call site.
+
+		Called by the hierarchy whenever a logger level,
+		the repository threshold or an appender is changed.
+		*/
+		static void invalidateAll();
+
+	private:
+		bool evaluate(const LoggerPtr& logger);
+		void registerCallSite();
+
+		const int m_level;
+		const char* const m_fileName;
+		const char* const m_methodName;
+		const int m_lineNumber;
+		std::atomic<const Logger*> m_logger; //!< The logger the cached state applies to
+		std::atomic<unsigned> m_state; //!< The generation (shifted left one bit) and the enabled flag
+		const CallSite* m_next; //!< The next entry in the list of evaluated call sites
+		std::atomic<bool> m_registered;
+
+		static std::atomic<unsigned> s_generation;
+
+		CallSite(const CallSite&);
+		CallSite& operator=(const CallSite&);
+};
+
+} // namespace spi
+} // namespace LOG4CXX_NS
+
+#if !defined(LOG4CXX_CALL_SITE_CACHE)
+/**
+Set LOG4CXX_CALL_SITE_CACHE to zero to evaluate
+the enabled state of a logger on every logging request.
+*/
+#define LOG4CXX_CALL_SITE_CACHE 1
+#endif
+
+#if LOG4CXX_CALL_SITE_CACHE
+#if LOG4CXX_DISABLE_LOCATION_INFO || !defined(__LOG4CXX_FUNC__)
+#define LOG4CXX_CALL_SITE(levelInt) \
+	static ::LOG4CXX_NS::spi::CallSite callSite_(::LOG4CXX_NS::Level::levelInt, nullptr, nullptr, -1);
+#else
+#define LOG4CXX_CALL_SITE(levelInt) \
+	static ::LOG4CXX_NS::spi::CallSite callSite_(::LOG4CXX_NS::Level::levelInt, __FILE__, __LOG4CXX_FUNC__, __LINE__);
+#endif
+#define LOG4CXX_CALL_SITE_IS_ENABLED(logger, levelName) callSite_.isEnabledFor(logger)
+#else
+#define LOG4CXX_CALL_SITE(levelInt)
+#define LOG4CXX_CALL_SITE_IS_ENABLED(logger, levelName) ::LOG4CXX_NS::Logger::is##levelName##EnabledFor(logger)
+#endif
+
+#endif //_LOG4CXX_SPI_CALLSITE_H
@@ -21,6 +21,7 @@
 #include <log4cxx/helpers/object.h>
 #include <log4cxx/spi/optionhandler.h>
 #include <log4cxx/spi/loggingevent.h>
+#include <atomic>
 
 namespace LOG4CXX_NS
 {
@@ -125,9 +126,16 @@ class LOG4CXX_EXPORT Filter : public virtual OptionHandler
 		the event will be logged without consulting with other filters in
 		the chain.
 
+		An appender derived from AppenderSkeleton calls this without holding its lock,
+		so concurrent calls must be allowed.
+
 		@param event The LoggingEvent to decide upon.
 		@return The decision of the filter.  */
 		virtual FilterDecision decide(const LoggingEventPtr& event) const = 0;
+
+	private:
+		friend void onFilterChange(Filter& filter);
+		friend void addFilterOwner(Filter& filter, const std::shared_ptr<std::atomic<unsigned>>& generation);
 };
 }
 }
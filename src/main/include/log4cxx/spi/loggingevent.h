@@ -94,6 +94,33 @@ class LOG4CXX_EXPORT LoggingEvent :
 			const LevelPtr& level,   const LogString& message,
 			const LOG4CXX_NS::spi::LocationInfo& location);
 
+		/**
+		Instantiate a LoggingEvent received from another process.
+
+		@param logger The logger of this event.
+		@param level The level of this event.
+		@param location The source code location of the logging request.
+		@param message  The text to add to this event.
+		@param timeStamp The number of microseconds elapsed from 01.01.1970 until the event was created.
+		@param threadName The identifier of the thread that created this event.
+		@param threadUserName The name of the thread that created this event.
+		\c threadName and \c threadUserName are not copied
+		and must remain valid for the lifetime of this event.
+		@param ndc The nested diagnostic context of this event or null.
+		@param mdc The mapped diagnostic context of this event.
+		*/
+		LoggingEvent
+			( const LogString& logger
+			, const LevelPtr& level
+			, const spi::LocationInfo& location
+			, LogString&& message
+			, log4cxx_time_t timeStamp
+			, const LogString& threadName
+			, const LogString& threadUserName
+			, const LogString* ndc
+			, MDC::Map&& mdc
+			);
+
 		~LoggingEvent();
 
 		/** Return the level of this event. */
@@ -82,6 +82,32 @@ class LOG4CXX_EXPORT WriterAppender : public AppenderSkeleton
 		*/
 		bool getImmediateFlush() const;
 
+		/**
+		Use \c value as whether events are formatted before the appender lock is taken.
+
+		When true, each thread formats its event concurrently with other threads
+		and the thread that next obtains the appender lock writes all events formatted so far,
+		in the order they were formatted, using a single write to the underlying stream.
+
+		The layout must support concurrent use by multiple threads.
+
+		\sa setOption
+		*/
+		void setConcurrentFormat(bool value);
+
+		/**
+		Are events formatted before the appender lock is taken?
+		*/
+		bool getConcurrentFormat() const;
+
+		/**
+		\copybrief AppenderSkeleton::doAppend()
+
+		When the <b>ConcurrentFormat</b> option is true,
+		\c event is formatted before the appender lock is taken.
+		*/
+		void doAppend(const spi::LoggingEventPtr& event, helpers::Pool& p) override;
+
 		/**
 		This method is called by the AppenderSkeleton#doAppend
 		method.
@@ -150,6 +176,7 @@ class LOG4CXX_EXPORT WriterAppender : public AppenderSkeleton
 		Supported options | Supported values | Default value
 		-------------- | ---------------- | ---------------
 		Encoding | C,UTF-8,UTF-16,UTF-16BE,UTF-16LE,646,US-ASCII,ISO646-US,ANSI_X3.4-1968,ISO-8859-1,ISO-LATIN-1 | UTF-8
+		ConcurrentFormat | True,False | False
 
 		\sa AppenderSkeleton::setOption()
 		 */
@@ -193,7 +220,16 @@ class LOG4CXX_EXPORT WriterAppender : public AppenderSkeleton
 		 */
 		void setWriterInternal(const LOG4CXX_NS::helpers::WriterPtr& writer);
 
+		/**
+		 * Write the output of events appended since the last write
+		 * when the <b>ConcurrentFormat</b> option is in effect.
+		 * Mutex must already be held.
+		 */
+		void writeCombinedOutput(LOG4CXX_NS::helpers::Pool& p);
+
 	private:
+		void appendPendingEvents(LOG4CXX_NS::helpers::Pool& p);
+
 		//
 		//  prevent copy and assignment
 		WriterAppender(const WriterAppender&);
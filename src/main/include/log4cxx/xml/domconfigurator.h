@@ -59,6 +59,17 @@ files. You can enable log4cxx internal logging by setting the
         &lt;/log4j:configuration>
 </pre>
 
+<p>When the configuration file is being watched (see #configureAndWatch),
+a change normally re-creates every configured appender.
+Set the <code>incrementalReload</code> attribute to instead retain
+the attached appenders whose <code>appender</code> element is unchanged
+and reset the loggers that are no longer configured. As in
+<pre>
+        &lt;log4j:configuration <b>incrementalReload="true"</b> xmlns:log4j="http://jakarta.apache.org/log4j/">
+        ...
+        &lt;/log4j:configuration>
+</pre>
+
 <p>There are sample XML files included in the package.
 */
 class LOG4CXX_EXPORT DOMConfigurator :
@@ -330,10 +341,17 @@ class LOG4CXX_EXPORT DOMConfigurator :
 		LogString subst(const LogString& value);
 
 	private:
+		/**
+		Use the attached appenders that have an unchanged definition
+		and reset loggers that are no longer configured.
+		*/
+		void retainUnchangedAppenders();
+
 		//   prevent assignment or copy statements
 		DOMConfigurator(const DOMConfigurator&);
 		DOMConfigurator& operator=(const DOMConfigurator&);
 		static XMLWatchdog* xdog;
+		friend class XMLWatchdog;
 
 		LOG4CXX_DECLARE_PRIVATE_MEMBER_PTR(DOMConfiguratorPrivate, m_priv)
 };
@@ -33,6 +33,14 @@
 #include <log4cxx/xml/domconfigurator.h>
 #include <log4cxx/file.h>
 #include <thread>
+#if !defined(_WIN32)
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -127,6 +135,9 @@ class AsyncAppenderTestCase : public AppenderSkeletonTestCase
 		LOGUNIT_TEST(testMultiThread);
 		LOGUNIT_TEST(testBadAppender);
 		LOGUNIT_TEST(testBufferOverflowBehavior);
+#if !defined(_WIN32)
+		LOGUNIT_TEST(testEmergencyDrain);
+#endif
 #if LOG4CXX_HAS_DOMCONFIGURATOR
 		LOGUNIT_TEST(testConfiguration);
 #endif
@@ -352,6 +363,56 @@ class AsyncAppenderTestCase : public AppenderSkeletonTestCase
 				discardEvent->getLocationInformation().getClassName());
 		}
 
+#if !defined(_WIN32)
+		/**
+		 * Tests undispatched events are written when the process aborts.
+		 */
+		void testEmergencyDrain()
+		{
+			Pool p;
+			LogString fileName(LOG4CXX_STR("output/emergency-async.log"));
+			File(fileName).deleteFile(p);
+
+			pid_t pid = fork();
+			LOGUNIT_ASSERT(0 <= pid);
+			if (0 == pid)
+			{
+				struct rlimit noCore = { 0, 0 };
+				setrlimit(RLIMIT_CORE, &noCore);
+				BlockableVectorAppenderPtr blockableAppender = BlockableVectorAppenderPtr(new BlockableVectorAppender());
+				AsyncAppenderPtr async = AsyncAppenderPtr(new AsyncAppender());
+				async->addAppender(blockableAppender);
+				async->setEmergencyFile(fileName);
+				async->setEmergencyDrain(true);
+				async->activateOptions(p);
+				auto logger = Logger::getLogger("org.apache.log4j.emergency");
+				logger->addAppender(async);
+				// The dispatch thread cannot pass on any event
+				std::unique_lock<std::mutex> sync(blockableAppender->getBlocker());
+				for (int i = 0; i < 3; ++i)
+					LOG4CXX_WARN(logger, "pending " << i);
+				std::abort();
+			}
+
+			int status = 0;
+			LOGUNIT_ASSERT_EQUAL(pid, waitpid(pid, &status, 0));
+			LOGUNIT_ASSERT(WIFSIGNALED(status));
+			LOGUNIT_ASSERT_EQUAL(SIGABRT, WTERMSIG(status));
+
+			std::ifstream input("output/emergency-async.log");
+			std::string line;
+			int lineCount = 0;
+			while (std::getline(input, line))
+			{
+				std::string expected = " WARN org.apache.log4j.emergency - pending " + std::to_string(lineCount);
+				LOGUNIT_ASSERT(expected.size() < line.size());
+				LOGUNIT_ASSERT_EQUAL(expected, line.substr(line.size() - expected.size()));
+				++lineCount;
+			}
+			LOGUNIT_ASSERT_EQUAL(3, lineCount);
+		}
+#endif
+
 #if LOG4CXX_HAS_DOMCONFIGURATOR
 		void testConfiguration()
 		{
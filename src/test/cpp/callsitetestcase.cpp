@@ -0,0 +1,148 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/logger.h>
+#include <log4cxx/logmanager.h>
+#include <log4cxx/spi/callsite.h>
+#include <log4cxx/spi/loggerrepository.h>
+#include "vectorappender.h"
+#include "logunit.h"
+#include <cstring>
+
+using namespace log4cxx;
+
+namespace
+{
+
+void logDebug(const LoggerPtr& logger, int id)
+{
+	LOG4CXX_DEBUG(logger, "message " << id);
+}
+
+} // anonymous namespace
+
+LOGUNIT_CLASS(CallSiteTestCase)
+{
+	LOGUNIT_TEST_SUITE(CallSiteTestCase);
+	LOGUNIT_TEST(testLevelChange);
+	LOGUNIT_TEST(testThresholdChange);
+	LOGUNIT_TEST(testMultipleLoggers);
+	LOGUNIT_TEST(testRegistry);
+	LOGUNIT_TEST_SUITE_END();
+
+	VectorAppenderPtr appender;
+
+public:
+	void setUp()
+	{
+		appender = std::make_shared<VectorAppender>();
+		Logger::getRootLogger()->addAppender(appender);
+	}
+
+	void tearDown()
+	{
+		LogManager::resetConfiguration();
+		appender.reset();
+	}
+
+	/**
+	 * Check a cached call site decision follows the logger level.
+	 */
+	void testLevelChange()
+	{
+		auto logger = Logger::getLogger("org.apache.log4j.callsite.level");
+		logger->setLevel(Level::getInfo());
+		logDebug(logger, 1);
+		logDebug(logger, 2);
+		LOGUNIT_ASSERT_EQUAL((size_t) 0, appender->getVector().size());
+
+		logger->setLevel(Level::getDebug());
+		logDebug(logger, 3);
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, appender->getVector().size());
+
+		// Changing the level of an ancestor changes the effective level
+		logger->setLevel(LevelPtr());
+		Logger::getLogger("org.apache.log4j.callsite")->setLevel(Level::getWarn());
+		logDebug(logger, 4);
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, appender->getVector().size());
+	}
+
+	/**
+	 * Check a cached call site decision follows the repository threshold.
+	 */
+	void testThresholdChange()
+	{
+		auto logger = Logger::getLogger("org.apache.log4j.callsite.threshold");
+		logger->setLevel(Level::getDebug());
+		logDebug(logger, 1);
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, appender->getVector().size());
+
+		LogManager::getLoggerRepository()->setThreshold(Level::getInfo());
+		logDebug(logger, 2);
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, appender->getVector().size());
+
+		LogManager::getLoggerRepository()->setThreshold(Level::getAll());
+		logDebug(logger, 3);
+		LOGUNIT_ASSERT_EQUAL((size_t) 2, appender->getVector().size());
+	}
+
+	/**
+	 * Check a call site used with different loggers gives the correct decision for each.
+	 */
+	void testMultipleLoggers()
+	{
+		auto enabled = Logger::getLogger("org.apache.log4j.callsite.enabled");
+		enabled->setLevel(Level::getDebug());
+		auto disabled = Logger::getLogger("org.apache.log4j.callsite.disabled");
+		disabled->setLevel(Level::getError());
+		for (int i = 0; i < 3; ++i)
+		{
+			logDebug(disabled, i);
+			logDebug(enabled, i);
+		}
+		LOGUNIT_ASSERT_EQUAL((size_t) 3, appender->getVector().size());
+		for (auto& event : appender->getVector())
+			LOGUNIT_ASSERT_EQUAL(enabled->getName(), event->getLoggerName());
+	}
+
+	/**
+	 * Check an evaluated call site is available for enumeration.
+	 */
+	void testRegistry()
+	{
+		auto logger = Logger::getLogger("org.apache.log4j.callsite.registry");
+		logger->setLevel(Level::getDebug());
+		int line = __LINE__ + 1;
+		LOG4CXX_DEBUG(logger, "registered");
+		int found = 0;
+		for (auto site : spi::CallSite::getCallSites())
+		{
+			auto location = site->getLocation();
+			if (location.getLineNumber() == line
+				&& location.getFileName()
+				&& std::strstr(location.getFileName(), "callsitetestcase") != nullptr)
+			{
+				++found;
+				LOGUNIT_ASSERT_EQUAL(Level::getDebug(), site->getLevel());
+				LOGUNIT_ASSERT(site->isEnabled());
+			}
+		}
+		LOGUNIT_ASSERT_EQUAL(1, found);
+	}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(CallSiteTestCase);
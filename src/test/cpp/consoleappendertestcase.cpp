@@ -16,12 +16,75 @@
  */
 
 #include <log4cxx/consoleappender.h>
+#include <log4cxx/simplelayout.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/appendermetrics.h>
+#include <cstdio>
 #include "logunit.h"
 #include "writerappendertestcase.h"
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
 
+#if !defined(_WIN32)
+namespace
+{
+/**
+ * Sends stdout to a pipe for the life of this object.
+ */
+class StdoutCapture
+{
+	public:
+		StdoutCapture()
+		{
+			fflush(stdout);
+			m_saved = dup(STDOUT_FILENO);
+			if (pipe(m_pipe) == 0)
+				dup2(m_pipe[1], STDOUT_FILENO);
+		}
+
+		~StdoutCapture()
+		{
+			restore();
+			close(m_pipe[0]);
+		}
+
+		/**
+		 * The data written to stdout.
+		 */
+		std::string getOutput()
+		{
+			restore();
+			std::string result;
+			char buf[1024];
+			ssize_t size;
+			while (0 < (size = read(m_pipe[0], buf, sizeof (buf))))
+				result.append(buf, size_t(size));
+			return result;
+		}
+
+	private:
+		void restore()
+		{
+			if (0 <= m_saved)
+			{
+				fflush(stdout);
+				dup2(m_saved, STDOUT_FILENO);
+				close(m_saved);
+				close(m_pipe[1]);
+				m_saved = -1;
+			}
+		}
+
+		int m_saved;
+		int m_pipe[2];
+};
+} // namespace
+#endif
+
 /**
    Unit tests of ConsoleAppender.
  */
@@ -34,6 +97,11 @@ class ConsoleAppenderTestCase : public WriterAppenderTestCase
 		LOGUNIT_TEST(testDefaultThreshold);
 		LOGUNIT_TEST(testSetOptionThreshold);
 		LOGUNIT_TEST(testNoLayout);
+#if !defined(_WIN32)
+		LOGUNIT_TEST(testDirectWrite);
+		LOGUNIT_TEST(testBackgroundWrite);
+		LOGUNIT_TEST(testLargeBuffer);
+#endif
 		LOGUNIT_TEST_SUITE_END();
 
 
@@ -54,6 +122,108 @@ class ConsoleAppenderTestCase : public WriterAppenderTestCase
 			LOG4CXX_INFO(logger, "No layout specified for ConsoleAppender");
 			logger->removeAppender(appender);
 		}
+
+#if !defined(_WIN32)
+		void appendEvents(const ConsoleAppenderPtr& appender, int count)
+		{
+			Pool p;
+			for (int i = 0; i < count; ++i)
+			{
+				LogString msg(LOG4CXX_STR("Message "));
+				StringHelper::toString(i, p, msg);
+				auto event = std::make_shared<spi::LoggingEvent>
+					( LOG4CXX_STR("org.apache.log4j.console")
+					, Level::getInfo()
+					, LOG4CXX_LOCATION
+					, std::move(msg)
+					);
+				appender->doAppend(event, p);
+			}
+		}
+
+		std::string expectedOutput(int count)
+		{
+			std::string result;
+			for (int i = 0; i < count; ++i)
+				result += "INFO - Message " + std::to_string(i) + "\n";
+			return result;
+		}
+
+		/**
+		 * Text left in the stdio buffer of stdout.
+		 * Output written directly to the descriptor precedes it
+		 * whereas output written through stdio follows it.
+		 */
+		const char* addStdioMarker()
+		{
+			// No newline, so the marker stays buffered whether stdout is line or fully buffered
+			fputs("[stdio]", stdout);
+			return "[stdio]";
+		}
+
+		/**
+		 * Check events are written in order, bypassing stdio, when collected by the appender.
+		 */
+		void testDirectWrite()
+		{
+			StdoutCapture capture;
+			auto appender = std::make_shared<ConsoleAppender>();
+			appender->setLayout(std::make_shared<SimpleLayout>());
+			appender->setOption(LOG4CXX_STR("DirectWrite"), LOG4CXX_STR("true"));
+			appender->setOption(LOG4CXX_STR("ImmediateFlush"), LOG4CXX_STR("false"));
+			appender->setOption(LOG4CXX_STR("BufferSize"), LOG4CXX_STR("64"));
+			appender->setOption(LOG4CXX_STR("Metrics"), LOG4CXX_STR("true"));
+			Pool p;
+			appender->activateOptions(p);
+			auto marker = addStdioMarker();
+			appendEvents(appender, 20);
+			auto snapshot = appender->getMetrics()->getSnapshot();
+			appender->close();
+			LOGUNIT_ASSERT_EQUAL(expectedOutput(20) + marker, capture.getOutput());
+			LOGUNIT_ASSERT_EQUAL((uint64_t) expectedOutput(20).size(), snapshot.counters[AppenderMetrics::BytesWritten]);
+		}
+
+		/**
+		 * Check events are written in order by the background thread.
+		 */
+		void testBackgroundWrite()
+		{
+			StdoutCapture capture;
+			auto appender = std::make_shared<ConsoleAppender>();
+			appender->setLayout(std::make_shared<SimpleLayout>());
+			appender->setDirectWrite(true);
+			appender->setBackgroundWrite(true);
+			appender->setMetricsEnabled(true);
+			Pool p;
+			appender->activateOptions(p);
+			auto marker = addStdioMarker();
+			appendEvents(appender, 100);
+			auto snapshot = appender->getMetrics()->getSnapshot();
+			appender->close();
+			LOGUNIT_ASSERT_EQUAL(expectedOutput(100) + marker, capture.getOutput());
+			LOGUNIT_ASSERT_EQUAL((uint64_t) 0, snapshot.counters[AppenderMetrics::Discards]);
+		}
+
+		/**
+		 * Check collected output larger than PIPE_BUF is written completely and in order.
+		 */
+		void testLargeBuffer()
+		{
+			StdoutCapture capture;
+			auto appender = std::make_shared<ConsoleAppender>();
+			appender->setLayout(std::make_shared<SimpleLayout>());
+			appender->setDirectWrite(true);
+			appender->setImmediateFlush(false);
+			appender->setBufferSize(32 * 1024);
+			Pool p;
+			appender->activateOptions(p);
+			auto marker = addStdioMarker();
+			// Less than the pipe capacity, so nothing is read until the appender is closed
+			appendEvents(appender, 1000);
+			appender->close();
+			LOGUNIT_ASSERT_EQUAL(expectedOutput(1000) + marker, capture.getOutput());
+		}
+#endif
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(ConsoleAppenderTestCase);
@@ -0,0 +1,122 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/logmanager.h>
+#include <log4cxx/db/dbappender.h>
+#include <log4cxx/helpers/pool.h>
+#include "../appenderskeletontestcase.h"
+#include <apr_dbd.h>
+#include <apr_file_io.h>
+#include <cstdlib>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+/**
+   Unit tests of log4cxx::db::DBAppender
+ */
+class DBAppenderTestCase : public AppenderSkeletonTestCase
+{
+		LOGUNIT_TEST_SUITE(DBAppenderTestCase);
+		//
+		//	    tests inherited from AppenderSkeletonTestCase
+		//
+		LOGUNIT_TEST(testDefaultThreshold);
+		LOGUNIT_TEST(testSetOptionThreshold);
+		LOGUNIT_TEST(testSetOptionBufferSize);
+#if LOG4CXX_TEST_SQLITE3
+		LOGUNIT_TEST(testBufferedInsert);
+#endif
+		LOGUNIT_TEST_SUITE_END();
+
+	public:
+
+		AppenderSkeleton* createAppenderSkeleton() const
+		{
+			return new db::DBAppender();
+		}
+
+		void tearDown()
+		{
+			LogManager::resetConfiguration();
+		}
+
+		void testSetOptionBufferSize()
+		{
+			db::DBAppender appender;
+			LOGUNIT_ASSERT_EQUAL(1, appender.getBufferSize());
+			appender.setOption(LOG4CXX_STR("BufferSize"), LOG4CXX_STR("100"));
+			appender.setOption(LOG4CXX_STR("FlushInterval"), LOG4CXX_STR("250"));
+			LOGUNIT_ASSERT_EQUAL(100, appender.getBufferSize());
+			LOGUNIT_ASSERT_EQUAL(250, appender.getFlushInterval());
+			LOGUNIT_ASSERT_EQUAL(0, appender.getMaxPendingRows());
+			appender.setOption(LOG4CXX_STR("MaxPendingRows"), LOG4CXX_STR("5000"));
+			LOGUNIT_ASSERT_EQUAL(5000, appender.getMaxPendingRows());
+			appender.setBufferSize(0);
+			LOGUNIT_ASSERT_EQUAL(1, appender.getBufferSize());
+		}
+
+#if LOG4CXX_TEST_SQLITE3
+		/**
+		 * Check all buffered rows are inserted, using the SQLite driver of APR-util.
+		 * Only registered when the build found the driver.
+		 */
+		void testBufferedInsert()
+		{
+			Pool p;
+			const apr_dbd_driver_t* driver = nullptr;
+			apr_dbd_init(p.getAPRPool());
+			LOGUNIT_ASSERT_EQUAL(APR_SUCCESS, apr_dbd_get_driver(p.getAPRPool(), "sqlite3", &driver));
+
+			const char* dbName = "output/dbappender.db";
+			apr_file_remove(dbName, p.getAPRPool());
+			apr_dbd_t* handle = nullptr;
+			LOGUNIT_ASSERT_EQUAL(APR_SUCCESS, apr_dbd_open(driver, p.getAPRPool(), dbName, &handle));
+			int rowCount = 0;
+			LOGUNIT_ASSERT_EQUAL(0, apr_dbd_query(driver, handle, &rowCount,
+				"CREATE TABLE logs (logger VARCHAR(200), level CHAR(5), message VARCHAR(1000))"));
+
+			auto appender = std::make_shared<db::DBAppender>();
+			appender->setOption(LOG4CXX_STR("DriverName"), LOG4CXX_STR("sqlite3"));
+			appender->setOption(LOG4CXX_STR("DriverParams"), LOG4CXX_STR("output/dbappender.db"));
+			appender->setOption(LOG4CXX_STR("SQL"), LOG4CXX_STR("INSERT INTO logs (logger, level, message) VALUES (%s, %s, %s)"));
+			appender->setOption(LOG4CXX_STR("ColumnMapping"), LOG4CXX_STR("logger"));
+			appender->setOption(LOG4CXX_STR("ColumnMapping"), LOG4CXX_STR("level"));
+			appender->setOption(LOG4CXX_STR("ColumnMapping"), LOG4CXX_STR("message"));
+			appender->setBufferSize(100);
+			appender->setFlushInterval(60000);
+			appender->activateOptions(p);
+
+			auto logger = Logger::getLogger("org.apache.log4j.db");
+			logger->addAppender(appender);
+			logger->setLevel(Level::getInfo());
+			for (int i = 0; i < 250; ++i)
+				LOG4CXX_INFO(logger, "Message " << i);
+			// Rows still buffered are written by close()
+			appender->close();
+
+			apr_dbd_results_t* results = nullptr;
+			LOGUNIT_ASSERT_EQUAL(0, apr_dbd_select(driver, p.getAPRPool(), handle, &results, "SELECT COUNT(*) FROM logs", 0));
+			apr_dbd_row_t* row = nullptr;
+			LOGUNIT_ASSERT_EQUAL(0, apr_dbd_get_row(driver, p.getAPRPool(), results, &row, -1));
+			LOGUNIT_ASSERT_EQUAL(250, std::atoi(apr_dbd_get_entry(driver, row, 0)));
+			apr_dbd_close(driver, handle);
+		}
+#endif
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(DBAppenderTestCase);
@@ -18,14 +18,25 @@
 #include <log4cxx/logmanager.h>
 #include <log4cxx/db/odbcappender.h>
 #include <log4cxx/xml/domconfigurator.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/ndc.h>
 #include "../appenderskeletontestcase.h"
 #include <apr_time.h>
+#include <apr_file_io.h>
 
 #define LOG4CXX_TEST 1
 #include <log4cxx/private/log4cxx_private.h>
 
 #ifdef LOG4CXX_HAVE_ODBC
 
+#if LOG4CXX_TEST_ODBC_SQLITE3
+#include <sqlext.h>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#endif
+
 using namespace log4cxx;
 
 /**
@@ -39,6 +50,11 @@ class ODBCAppenderTestCase : public AppenderSkeletonTestCase
 		//
 		LOGUNIT_TEST(testDefaultThreshold);
 		LOGUNIT_TEST(testSetOptionThreshold);
+		LOGUNIT_TEST(testSetOptionBackgroundFlush);
+#if LOG4CXX_TEST_ODBC_SQLITE3
+		LOGUNIT_TEST(testBufferedInsert);
+		LOGUNIT_TEST(testBackgroundFlush);
+#endif
 		//LOGUNIT_TEST(testConnectUsingDSN);
 		LOGUNIT_TEST_SUITE_END();
 
@@ -56,6 +72,162 @@ class ODBCAppenderTestCase : public AppenderSkeletonTestCase
 			LogManager::shutdown();
 		}
 
+		void testSetOptionBackgroundFlush()
+		{
+			db::ODBCAppender appender;
+			LOGUNIT_ASSERT(!appender.getBackgroundFlush());
+			appender.setOption(LOG4CXX_STR("BackgroundFlush"), LOG4CXX_STR("true"));
+			appender.setOption(LOG4CXX_STR("BufferSize"), LOG4CXX_STR("50"));
+			LOGUNIT_ASSERT(appender.getBackgroundFlush());
+			LOGUNIT_ASSERT_EQUAL((size_t) 50, appender.getBufferSize());
+		}
+
+#if LOG4CXX_TEST_ODBC_SQLITE3
+		/**
+		 * A connection to the SQLite database of the data source 'Log4cxxSQLite',
+		 * which is defined in output/odbc.ini.
+		 */
+		struct TestDatabase
+		{
+			SQLHENV env = SQL_NULL_HENV;
+			SQLHDBC con = SQL_NULL_HDBC;
+
+			TestDatabase()
+			{
+				helpers::Pool p;
+				apr_file_remove("output/odbcappender.db", p.getAPRPool());
+				std::ofstream("output/odbc.ini")
+					<< "[Log4cxxSQLite]\n"
+					<< "Driver = SQLite3\n"
+					<< "Database = output/odbcappender.db\n";
+				setenv("ODBCINI", "output/odbc.ini", 1);
+				LOGUNIT_ASSERT(SQL_SUCCEEDED(SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &env)));
+				SQLSetEnvAttr(env, SQL_ATTR_ODBC_VERSION, (SQLPOINTER)SQL_OV_ODBC3, 0);
+				LOGUNIT_ASSERT(SQL_SUCCEEDED(SQLAllocHandle(SQL_HANDLE_DBC, env, &con)));
+				LOGUNIT_ASSERT(SQL_SUCCEEDED(SQLConnectA(con, (SQLCHAR*)"Log4cxxSQLite", SQL_NTS, nullptr, 0, nullptr, 0)));
+				execute("CREATE TABLE logs (logger VARCHAR(200), level VARCHAR(10), ndc VARCHAR(200), message VARCHAR(200))");
+			}
+
+			~TestDatabase()
+			{
+				SQLDisconnect(con);
+				SQLFreeHandle(SQL_HANDLE_DBC, con);
+				SQLFreeHandle(SQL_HANDLE_ENV, env);
+			}
+
+			void execute(const char* sql)
+			{
+				SQLHSTMT stmt;
+				LOGUNIT_ASSERT(SQL_SUCCEEDED(SQLAllocHandle(SQL_HANDLE_STMT, con, &stmt)));
+				LOGUNIT_ASSERT(SQL_SUCCEEDED(SQLExecDirectA(stmt, (SQLCHAR*)sql, SQL_NTS)));
+				SQLFreeHandle(SQL_HANDLE_STMT, stmt);
+			}
+
+			/**
+			 * The \c column value of each committed row in insertion order.
+			 */
+			std::vector<std::string> values(const std::string& column = "message")
+			{
+				std::vector<std::string> result;
+				SQLHSTMT stmt;
+				LOGUNIT_ASSERT(SQL_SUCCEEDED(SQLAllocHandle(SQL_HANDLE_STMT, con, &stmt)));
+				LOGUNIT_ASSERT(SQL_SUCCEEDED(SQLExecDirectA(stmt, (SQLCHAR*)("SELECT " + column + " FROM logs ORDER BY rowid").c_str(), SQL_NTS)));
+				while (SQL_SUCCEEDED(SQLFetch(stmt)))
+				{
+					char buf[256];
+					SQLLEN len = 0;
+					LOGUNIT_ASSERT(SQL_SUCCEEDED(SQLGetData(stmt, 1, SQL_C_CHAR, buf, sizeof (buf), &len)));
+					result.push_back(SQL_NULL_DATA == len ? std::string() : std::string(buf));
+				}
+				SQLFreeHandle(SQL_HANDLE_STMT, stmt);
+				return result;
+			}
+		};
+
+		static db::ODBCAppenderPtr createSQLiteAppender(size_t bufferSize, bool backgroundFlush)
+		{
+			auto appender = std::make_shared<db::ODBCAppender>();
+			appender->setOption(LOG4CXX_STR("DSN"), LOG4CXX_STR("Log4cxxSQLite"));
+			appender->setOption(LOG4CXX_STR("SQL"), LOG4CXX_STR("INSERT INTO logs (logger, level, ndc, message) VALUES (?, ?, ?, ?)"));
+			appender->setOption(LOG4CXX_STR("ColumnMapping"), LOG4CXX_STR("logger"));
+			appender->setOption(LOG4CXX_STR("ColumnMapping"), LOG4CXX_STR("level"));
+			appender->setOption(LOG4CXX_STR("ColumnMapping"), LOG4CXX_STR("ndc"));
+			appender->setOption(LOG4CXX_STR("ColumnMapping"), LOG4CXX_STR("message"));
+			appender->setBufferSize(bufferSize);
+			appender->setBackgroundFlush(backgroundFlush);
+			helpers::Pool p;
+			appender->activateOptions(p);
+			return appender;
+		}
+
+		/**
+		 * A message whose length varies with \c i,
+		 * so a value that overran its row or lost its terminator would be seen.
+		 */
+		static std::string makeMessage(int i)
+		{
+			return "Message " + std::to_string(i) + std::string((i * 7) % 50, 'x');
+		}
+
+		/**
+		 * Check that each buffer of events is committed as a whole
+		 * and each row holds the value of its own event.
+		 */
+		void testBufferedInsert()
+		{
+			TestDatabase db;
+			auto appender = createSQLiteAppender(10, false);
+			auto logger = Logger::getLogger("org.apache.log4j.db.odbc");
+			logger->addAppender(appender);
+			logger->setLevel(Level::getInfo());
+			logger->setAdditivity(false);
+
+			for (int i = 0; i < 15; ++i)
+				LOG4CXX_INFO(logger, makeMessage(i));
+			// Only the first full buffer has been written and committed
+			auto rows = db.values();
+			LOGUNIT_ASSERT_EQUAL((size_t) 10, rows.size());
+
+			// The remaining events are written by close()
+			appender->close();
+			logger->removeAppender(appender);
+			rows = db.values();
+			LOGUNIT_ASSERT_EQUAL((size_t) 15, rows.size());
+			for (int i = 0; i < 15; ++i)
+				LOGUNIT_ASSERT_EQUAL(makeMessage(i), rows[i]);
+		}
+
+		/**
+		 * Check that the events of full buffers written by the background thread
+		 * and the events written by close() are all inserted in order
+		 * with the diagnostic context of the logging thread.
+		 */
+		void testBackgroundFlush()
+		{
+			TestDatabase db;
+			auto appender = createSQLiteAppender(10, true);
+			auto logger = Logger::getLogger("org.apache.log4j.db.odbc");
+			logger->addAppender(appender);
+			logger->setLevel(Level::getInfo());
+			logger->setAdditivity(false);
+
+			{
+				NDC context("background");
+				for (int i = 0; i < 35; ++i)
+					LOG4CXX_INFO(logger, makeMessage(i));
+			}
+			appender->close();
+			logger->removeAppender(appender);
+
+			auto rows = db.values();
+			LOGUNIT_ASSERT_EQUAL((size_t) 35, rows.size());
+			for (int i = 0; i < 35; ++i)
+				LOGUNIT_ASSERT_EQUAL(makeMessage(i), rows[i]);
+			for (auto& ndc : db.values("ndc"))
+				LOGUNIT_ASSERT_EQUAL(std::string("background"), ndc);
+		}
+#endif
+
 // 'odbcAppenderDSN-Log4cxxTest.xml' requires the data souce name 'Log4cxxTest'
 // containing a 'ApplicationLogs' database
 // with 'UnitTestLog' table
@@ -17,7 +17,29 @@
 #include <log4cxx/helpers/pool.h>
 #include <log4cxx/fileappender.h>
 #include <log4cxx/patternlayout.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/logmanager.h>
+#include <log4cxx/private/log4cxx_private.h>
+#include <log4cxx/varia/fallbackerrorhandler.h>
 #include "logunit.h"
+#include "vectorappender.h"
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#if LOG4CXX_HAS_ZLIB
+#include <zlib.h>
+#endif
+#if !defined(_WIN32)
+#include <csignal>
+#include <cstdlib>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -33,8 +55,23 @@ LOGUNIT_CLASS(FileAppenderTest)
 	LOGUNIT_TEST(testDirectoryCreation);
 	LOGUNIT_TEST(testgetSetThreshold);
 	LOGUNIT_TEST(testIsAsSevereAsThreshold);
+	LOGUNIT_TEST(testConcurrentFormat);
+	LOGUNIT_TEST(testGroupCommit);
+#if LOG4CXX_HAS_ZLIB
+	LOGUNIT_TEST(testCompression);
+	LOGUNIT_TEST(testIdleCompression);
+#endif
+#if !defined(_WIN32)
+	LOGUNIT_TEST(testEmergencyDrain);
+	LOGUNIT_TEST(testGroupCommitFailure);
+#endif
 	LOGUNIT_TEST_SUITE_END();
 public:
+	void tearDown()
+	{
+		LogManager::resetConfiguration();
+	}
+
 	/**
 	 * Tests that any necessary directories are attempted to
 	 * be created if they don't exist.  See bug 9150.
@@ -81,6 +118,317 @@ public:
 		LevelPtr debug = Level::getDebug();
 		LOGUNIT_ASSERT(appender->isAsSevereAsThreshold(debug));
 	}
+
+	/**
+	 * Tests events formatted outside the appender lock
+	 * are all written and keep their order within each thread.
+	 */
+	void testConcurrentFormat()
+	{
+		Pool p;
+		LogString fileName(LOG4CXX_STR("output/concurrentformat.log"));
+		File(fileName).deleteFile(p);
+
+		FileAppenderPtr appender(new FileAppender());
+		appender->setFile(fileName);
+		appender->setAppend(false);
+		appender->setLayout(PatternLayoutPtr(new PatternLayout(LOG4CXX_STR("%d{ISO8601} %m%n"))));
+		appender->setOption(LOG4CXX_STR("ConcurrentFormat"), LOG4CXX_STR("true"));
+		appender->activateOptions(p);
+		LOGUNIT_ASSERT(appender->getConcurrentFormat());
+
+		auto logger = Logger::getLogger("org.apache.log4j.concurrentformat");
+		logger->setAdditivity(false);
+		logger->addAppender(appender);
+
+		const int threadCount = 4;
+		const int messageCount = 500;
+		std::vector<std::thread> threads;
+		for (int i = 0; i < threadCount; ++i)
+		{
+			threads.emplace_back([logger, i]()
+			{
+				for (int j = 0; j < messageCount; ++j)
+					LOG4CXX_INFO(logger, "thread " << i << " message " << j);
+			});
+		}
+		for (auto& t : threads)
+			t.join();
+		appender->close();
+
+		std::ifstream input("output/concurrentformat.log");
+		std::vector<int> nextMessage(threadCount, 0);
+		std::string line;
+		int lineCount = 0;
+		while (std::getline(input, line))
+		{
+			auto pos = line.find("thread ");
+			LOGUNIT_ASSERT(pos != std::string::npos);
+			std::istringstream fields(line.substr(pos));
+			std::string word;
+			int thread = -1, message = -1;
+			fields >> word >> thread >> word >> message;
+			LOGUNIT_ASSERT(0 <= thread && thread < threadCount);
+			LOGUNIT_ASSERT_EQUAL(nextMessage[thread], message);
+			++nextMessage[thread];
+			++lineCount;
+		}
+		LOGUNIT_ASSERT_EQUAL(threadCount * messageCount, lineCount);
+	}
+
+	/**
+	 * Tests threads waiting for their events to reach stable storage
+	 * all continue and each event is written once.
+	 */
+	void testGroupCommit()
+	{
+		Pool p;
+		LogString fileName(LOG4CXX_STR("output/groupcommit.log"));
+		File(fileName).deleteFile(p);
+
+		FileAppenderPtr appender(new FileAppender());
+		appender->setFile(fileName);
+		appender->setAppend(false);
+		appender->setBufferedIO(true);
+		appender->setLayout(PatternLayoutPtr(new PatternLayout(LOG4CXX_STR("%m%n"))));
+		appender->setOption(LOG4CXX_STR("Durability"), LOG4CXX_STR("GroupCommit"));
+		appender->activateOptions(p);
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("GroupCommit"), appender->getDurability());
+
+		auto logger = Logger::getLogger("org.apache.log4j.groupcommit");
+		logger->setAdditivity(false);
+		logger->addAppender(appender);
+
+		const int threadCount = 8;
+		const int messageCount = 20;
+		std::vector<std::thread> threads;
+		for (int i = 0; i < threadCount; ++i)
+		{
+			threads.emplace_back([logger, i]()
+			{
+				for (int j = 0; j < messageCount; ++j)
+					LOG4CXX_INFO(logger, "thread " << i << " message " << j);
+			});
+		}
+		for (auto& t : threads)
+			t.join();
+
+		// Each event was written when its thread continued, although the buffer was not full
+		std::ifstream input("output/groupcommit.log");
+		std::string line;
+		int lineCount = 0;
+		while (std::getline(input, line))
+			++lineCount;
+		LOGUNIT_ASSERT_EQUAL(threadCount * messageCount, lineCount);
+		appender->close();
+	}
+
+#if !defined(_WIN32)
+	/**
+	 * Tests a thread waiting for its event to reach stable storage continues
+	 * and the error handler is called when the file cannot be synchronized.
+	 */
+	void testGroupCommitFailure()
+	{
+		Pool p;
+		FileAppenderPtr appender(new FileAppender());
+		appender->setName(LOG4CXX_STR("groupcommit-failure"));
+		// The null device does not support synchronization
+		appender->setFile(LOG4CXX_STR("/dev/null"));
+		appender->setLayout(PatternLayoutPtr(new PatternLayout(LOG4CXX_STR("%m%n"))));
+		appender->setOption(LOG4CXX_STR("Durability"), LOG4CXX_STR("GroupCommit"));
+		appender->activateOptions(p);
+
+		auto logger = Logger::getLogger("org.apache.log4j.groupcommitfailure");
+		logger->setAdditivity(false);
+		logger->addAppender(appender);
+
+		varia::FallbackErrorHandlerPtr errorHandler(new varia::FallbackErrorHandler());
+		errorHandler->setAppender(appender);
+		VectorAppenderPtr vectorAppender(new VectorAppender());
+		vectorAppender->setName(LOG4CXX_STR("groupcommit-backup"));
+		errorHandler->setBackupAppender(vectorAppender);
+		errorHandler->setLogger(logger);
+		appender->setErrorHandler(errorHandler);
+
+		auto logged = std::async(std::launch::async, [logger]()
+		{
+			LOG4CXX_INFO(logger, "not durable");
+		});
+		LOGUNIT_ASSERT(std::future_status::ready == logged.wait_for(std::chrono::seconds(10)));
+		LOGUNIT_ASSERT(errorHandler->errorReported());
+
+		// The error handler replaced the appender
+		LOG4CXX_INFO(logger, "after the failure");
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, vectorAppender->getVector().size());
+		appender->close();
+	}
+#endif
+
+#if LOG4CXX_HAS_ZLIB
+	/**
+	 * Decompress the complete gzip members in \c data.
+	 */
+	std::string decompress(const std::string& data)
+	{
+		std::string result;
+		size_t offset = 0;
+		while (offset < data.size())
+		{
+			z_stream zs{};
+			LOGUNIT_ASSERT_EQUAL(Z_OK, inflateInit2(&zs, 15 + 16));
+			zs.next_in = (Bytef*) &data[offset];
+			zs.avail_in = (uInt) (data.size() - offset);
+			std::string member;
+			char buffer[4096];
+			int rc;
+			do
+			{
+				zs.next_out = (Bytef*) buffer;
+				zs.avail_out = sizeof(buffer);
+				rc = inflate(&zs, Z_NO_FLUSH);
+				member.append(buffer, sizeof(buffer) - zs.avail_out);
+			} while (rc == Z_OK);
+			offset = data.size() - zs.avail_in;
+			inflateEnd(&zs);
+			if (rc != Z_STREAM_END)
+				break;
+			result += member;
+		}
+		return result;
+	}
+
+	/**
+	 * Tests compressed output can be read
+	 * up to the last complete member of a truncated file.
+	 */
+	void testCompression()
+	{
+		Pool p;
+		LogString fileName(LOG4CXX_STR("output/compressed.log.gz"));
+		File(fileName).deleteFile(p);
+
+		FileAppenderPtr appender(new FileAppender());
+		appender->setFile(fileName);
+		appender->setAppend(false);
+		appender->setLayout(PatternLayoutPtr(new PatternLayout(LOG4CXX_STR("%m%n"))));
+		appender->setOption(LOG4CXX_STR("Compression"), LOG4CXX_STR("GZip"));
+		appender->setOption(LOG4CXX_STR("CompressionFrameSize"), LOG4CXX_STR("1KB"));
+		appender->setOption(LOG4CXX_STR("CompressionInterval"), LOG4CXX_STR("3600000"));
+		appender->activateOptions(p);
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("GZip"), appender->getCompression());
+
+		auto logger = Logger::getLogger("org.apache.log4j.compression");
+		logger->setAdditivity(false);
+		logger->addAppender(appender);
+		std::string expected;
+		for (int i = 0; i < 1000; ++i)
+		{
+			LOG4CXX_INFO(logger, "message " << i);
+			expected += "message " + std::to_string(i) + "\n";
+		}
+		appender->close();
+
+		std::ifstream input("output/compressed.log.gz", std::ios::binary);
+		std::string data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+		LOGUNIT_ASSERT(data.size() < expected.size() / 2);
+		LOGUNIT_ASSERT_EQUAL(expected, decompress(data));
+
+		auto partial = decompress(data.substr(0, data.size() / 2));
+		LOGUNIT_ASSERT(!partial.empty());
+		LOGUNIT_ASSERT(partial.size() < expected.size());
+		LOGUNIT_ASSERT_EQUAL(expected.substr(0, partial.size()), partial);
+	}
+
+	/**
+	 * Tests the output of an idle appender is completed
+	 * without a further write, flush or close.
+	 */
+	void testIdleCompression()
+	{
+		Pool p;
+		LogString fileName(LOG4CXX_STR("output/idlecompressed.log.gz"));
+		File(fileName).deleteFile(p);
+
+		FileAppenderPtr appender(new FileAppender());
+		appender->setFile(fileName);
+		appender->setAppend(false);
+		appender->setLayout(PatternLayoutPtr(new PatternLayout(LOG4CXX_STR("%m%n"))));
+		appender->setOption(LOG4CXX_STR("Compression"), LOG4CXX_STR("GZip"));
+		appender->setOption(LOG4CXX_STR("CompressionInterval"), LOG4CXX_STR("100"));
+		appender->activateOptions(p);
+
+		auto logger = Logger::getLogger("org.apache.log4j.idlecompression");
+		logger->setAdditivity(false);
+		logger->addAppender(appender);
+		std::string expected;
+		for (int i = 0; i < 10; ++i)
+		{
+			LOG4CXX_INFO(logger, "message " << i);
+			expected += "message " + std::to_string(i) + "\n";
+		}
+
+		std::string result;
+		for (int i = 0; i < 50 && result != expected; ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			std::ifstream input("output/idlecompressed.log.gz", std::ios::binary);
+			std::string data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+			result = decompress(data);
+		}
+		appender->close();
+		LOGUNIT_ASSERT_EQUAL(expected, result);
+	}
+#endif
+
+#if !defined(_WIN32)
+	/**
+	 * Tests buffered output reaches the file when the process aborts.
+	 */
+	void testEmergencyDrain()
+	{
+		Pool p;
+		LogString fileName(LOG4CXX_STR("output/emergency.log"));
+		File(fileName).deleteFile(p);
+
+		pid_t pid = fork();
+		LOGUNIT_ASSERT(0 <= pid);
+		if (0 == pid)
+		{
+			struct rlimit noCore = { 0, 0 };
+			setrlimit(RLIMIT_CORE, &noCore);
+			FileAppenderPtr appender(new FileAppender());
+			appender->setFile(fileName);
+			appender->setAppend(false);
+			appender->setBufferedIO(true);
+			appender->setBufferSize(64 * 1024);
+			appender->setImmediateFlush(false);
+			appender->setEmergencyDrain(true);
+			appender->setLayout(PatternLayoutPtr(new PatternLayout(LOG4CXX_STR("%m%n"))));
+			appender->activateOptions(p);
+			auto logger = Logger::getLogger("org.apache.log4j.emergency");
+			logger->addAppender(appender);
+			for (int i = 0; i < 3; ++i)
+				LOG4CXX_INFO(logger, "message " << i);
+			std::abort();
+		}
+
+		int status = 0;
+		LOGUNIT_ASSERT_EQUAL(pid, waitpid(pid, &status, 0));
+		LOGUNIT_ASSERT(WIFSIGNALED(status));
+		LOGUNIT_ASSERT_EQUAL(SIGABRT, WTERMSIG(status));
+
+		std::ifstream input("output/emergency.log");
+		std::string line;
+		int lineCount = 0;
+		while (std::getline(input, line))
+		{
+			LOGUNIT_ASSERT_EQUAL("message " + std::to_string(lineCount), line);
+			++lineCount;
+		}
+		LOGUNIT_ASSERT_EQUAL(3, lineCount);
+	}
+#endif
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(FileAppenderTest);
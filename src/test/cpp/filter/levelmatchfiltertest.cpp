@@ -18,7 +18,9 @@
 #include <log4cxx/logger.h>
 #include <log4cxx/spi/filter.h>
 #include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/filter/denyallfilter.h>
 #include "../logunit.h"
+#include "../vectorappender.h"
 
 using namespace log4cxx;
 using namespace log4cxx::filter;
@@ -37,6 +39,8 @@ LOGUNIT_CLASS(LevelMatchFilterTest)
 	LOGUNIT_TEST(test3);
 	LOGUNIT_TEST(test4);
 	LOGUNIT_TEST(test5);
+	LOGUNIT_TEST(test6);
+	LOGUNIT_TEST(test7);
 	LOGUNIT_TEST_SUITE_END();
 
 public:
@@ -128,6 +132,61 @@ public:
 		filter->activateOptions(p);
 		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(event));
 	}
+
+	/**
+	 * Check that an appender applies a LevelMatchFilter
+	 *    including a change made after it was added.
+	 */
+	void test6()
+	{
+		auto appender = std::make_shared<VectorAppender>();
+		LevelMatchFilterPtr filter(new LevelMatchFilter());
+		filter->setLevelToMatch(LOG4CXX_STR("info"));
+		appender->addFilter(filter);
+		appender->addFilter(std::make_shared<DenyAllFilter>());
+		auto logger = Logger::getLogger(LOG4CXX_STR("org.apache.log4j.filter.LevelMatchFilterTest"));
+		Pool p;
+		LevelPtr levels[] = { Level::getDebug(), Level::getInfo(), Level::getWarn() };
+		for (auto& level : levels)
+			appender->doAppend(std::make_shared<LoggingEvent>(logger->getName(), level, LOG4CXX_STR("Hello"), LOG4CXX_LOCATION), p);
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, appender->getVector().size());
+		LOGUNIT_ASSERT_EQUAL(Level::getInfo(), appender->getVector().back()->getLevel());
+
+		filter->setLevelToMatch(LOG4CXX_STR("warn"));
+		for (auto& level : levels)
+			appender->doAppend(std::make_shared<LoggingEvent>(logger->getName(), level, LOG4CXX_STR("Hello"), LOG4CXX_LOCATION), p);
+		LOGUNIT_ASSERT_EQUAL((size_t) 2, appender->getVector().size());
+		LOGUNIT_ASSERT_EQUAL(Level::getWarn(), appender->getVector().back()->getLevel());
+	}
+
+	/**
+	 * Check that an appender applies the filters added after clearFilters
+	 *    and is not affected by a change to a filter of another appender.
+	 */
+	void test7()
+	{
+		auto appender = std::make_shared<VectorAppender>();
+		auto other = std::make_shared<VectorAppender>();
+		LevelMatchFilterPtr otherFilter(new LevelMatchFilter());
+		otherFilter->setLevelToMatch(LOG4CXX_STR("debug"));
+		other->addFilter(otherFilter);
+		auto logger = Logger::getLogger(LOG4CXX_STR("org.apache.log4j.filter.LevelMatchFilterTest"));
+		Pool p;
+		LevelPtr levels[] = { Level::getDebug(), Level::getInfo(), Level::getWarn() };
+		for (int i = 0; i < 100; ++i)
+		{
+			appender->clearFilters();
+			LevelMatchFilterPtr filter(new LevelMatchFilter());
+			filter->setLevelToMatch(levels[i % 3]->toString());
+			appender->addFilter(filter);
+			appender->addFilter(std::make_shared<DenyAllFilter>());
+			otherFilter->setAcceptOnMatch(i % 2 == 0);
+			for (auto& level : levels)
+				appender->doAppend(std::make_shared<LoggingEvent>(logger->getName(), level, LOG4CXX_STR("Hello"), LOG4CXX_LOCATION), p);
+			LOGUNIT_ASSERT_EQUAL((size_t) i + 1, appender->getVector().size());
+			LOGUNIT_ASSERT_EQUAL(levels[i % 3], appender->getVector().back()->getLevel());
+		}
+	}
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(LevelMatchFilterTest);
@@ -0,0 +1,137 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/helpers/appendermetrics.h>
+#include "../logunit.h"
+#include "../vectorappender.h"
+
+#include <log4cxx/logmanager.h>
+#include <log4cxx/logger.h>
+#include <thread>
+#include <vector>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+LOGUNIT_CLASS(AppenderMetricsTestCase)
+{
+	LOGUNIT_TEST_SUITE(AppenderMetricsTestCase);
+	LOGUNIT_TEST(testBuckets);
+	LOGUNIT_TEST(testPercentile);
+	LOGUNIT_TEST(testShards);
+	LOGUNIT_TEST(testAppender);
+	LOGUNIT_TEST_SUITE_END();
+
+public:
+	void tearDown()
+	{
+		LogManager::resetConfiguration();
+	}
+
+	/**
+	 * Check each duration is held by a bucket whose bounds contain it.
+	 */
+	void testBuckets()
+	{
+		size_t previousIndex = 0;
+		for (uint64_t value = 0; value < (uint64_t(1) << 40); value = value * 3 / 2 + 1)
+		{
+			auto index = AppenderMetrics::getBucketIndex(value);
+			LOGUNIT_ASSERT(index < AppenderMetrics::getBucketCount());
+			LOGUNIT_ASSERT(previousIndex <= index);
+			LOGUNIT_ASSERT(value <= AppenderMetrics::getBucketUpperBound(index));
+			if (0 < index)
+				LOGUNIT_ASSERT(AppenderMetrics::getBucketUpperBound(index - 1) < value);
+			previousIndex = index;
+		}
+		LOGUNIT_ASSERT_EQUAL(AppenderMetrics::getBucketCount() - 1, AppenderMetrics::getBucketIndex(UINT64_MAX));
+	}
+
+	/**
+	 * Check percentiles are within the bucket resolution.
+	 */
+	void testPercentile()
+	{
+		AppenderMetrics metrics;
+		for (int i = 1; i <= 1000; ++i)
+			metrics.record(AppenderMetrics::AppendLatency, std::chrono::microseconds(i));
+		auto h = metrics.getSnapshot().histograms[AppenderMetrics::AppendLatency];
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 1000, h.getCount());
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 1000000, h.getMaximum());
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 500500, h.getMean());
+		auto median = h.getValueAtPercentile(50.0);
+		LOGUNIT_ASSERT(500000 <= median && median < 500000 * 9 / 8);
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 1000000, h.getValueAtPercentile(100.0));
+
+		metrics.reset();
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 0, metrics.getSnapshot().histograms[AppenderMetrics::AppendLatency].getCount());
+	}
+
+	/**
+	 * Check updates from many threads are combined.
+	 */
+	void testShards()
+	{
+		AppenderMetrics metrics;
+		std::vector<std::thread> threads;
+		for (int i = 0; i < 8; ++i)
+		{
+			threads.emplace_back([&metrics]()
+			{
+				for (int j = 0; j < 1000; ++j)
+					metrics.add(AppenderMetrics::BytesWritten, 2);
+			});
+		}
+		for (auto& t : threads)
+			t.join();
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 16000, metrics.getSnapshot().counters[AppenderMetrics::BytesWritten]);
+	}
+
+	/**
+	 * Check the values collected by an appender.
+	 */
+	void testAppender()
+	{
+		auto appender = std::make_shared<VectorAppender>();
+		LOGUNIT_ASSERT(!appender->getMetrics());
+		appender->setOption(LOG4CXX_STR("Metrics"), LOG4CXX_STR("true"));
+		appender->setThreshold(Level::getInfo());
+		auto logger = Logger::getLogger("org.apache.log4j.metrics");
+		logger->addAppender(appender);
+		logger->setLevel(Level::getDebug());
+		LOG4CXX_DEBUG(logger, "denied");
+		LOG4CXX_INFO(logger, "accepted");
+		LOG4CXX_WARN(logger, "accepted");
+
+		auto metrics = appender->getMetrics();
+		LOGUNIT_ASSERT(metrics);
+		auto snapshot = metrics->getSnapshot();
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 2, snapshot.counters[AppenderMetrics::EventsAppended]);
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 1, snapshot.counters[AppenderMetrics::FilterDenials]);
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 2, snapshot.histograms[AppenderMetrics::LockWait].getCount());
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 2, snapshot.histograms[AppenderMetrics::AppendLatency].getCount());
+
+		LogString summary;
+		AppenderMetrics::format(summary, snapshot);
+		LOGUNIT_ASSERT(summary.find(LOG4CXX_STR("EventsAppended=2")) != LogString::npos);
+
+		appender->setMetricsEnabled(false);
+		LOGUNIT_ASSERT(!appender->getMetrics());
+	}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(AppenderMetricsTestCase);
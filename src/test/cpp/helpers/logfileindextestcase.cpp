@@ -0,0 +1,206 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/helpers/logfileindex.h>
+#include "../logunit.h"
+
+#include <log4cxx/fileappender.h>
+#include <log4cxx/file.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/logmanager.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/rolling/fixedwindowrollingpolicy.h>
+#include <log4cxx/rolling/rollingfileappender.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/date.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+LOGUNIT_CLASS(LogFileIndexTestCase)
+{
+	LOGUNIT_TEST_SUITE(LogFileIndexTestCase);
+	LOGUNIT_TEST(testEncoding);
+	LOGUNIT_TEST(testFindRanges);
+	LOGUNIT_TEST(testAppender);
+	LOGUNIT_TEST(testCompressedArchive);
+	LOGUNIT_TEST_SUITE_END();
+
+	LogFileIndex::Entry makeEntry(uint64_t offset, uint64_t length, log4cxx_time_t minimumTime, log4cxx_time_t maximumTime)
+	{
+		LogFileIndex::Entry entry{};
+		entry.offset = offset;
+		entry.length = length;
+		entry.minimumTime = minimumTime;
+		entry.maximumTime = maximumTime;
+		entry.levels = LogFileIndex::getLevelBit(Level::getInfo());
+		entry.loggers = LogFileIndex::getLoggerBits(LOG4CXX_STR("a.b"));
+		entry.eventCount = 1;
+		return entry;
+	}
+
+public:
+	void tearDown()
+	{
+		LogManager::resetConfiguration();
+	}
+
+	/**
+	 * Check an entry is unchanged by encoding and decoding.
+	 */
+	void testEncoding()
+	{
+		auto entry = makeEntry(1234567890123ULL, 4096, -5, 1700000000000000LL);
+		char data[LogFileIndex::EntrySize];
+		LogFileIndex::encode(entry, data);
+		LogFileIndex::Entry result;
+		LogFileIndex::decode(data, result);
+		LOGUNIT_ASSERT_EQUAL(entry.offset, result.offset);
+		LOGUNIT_ASSERT_EQUAL(entry.length, result.length);
+		LOGUNIT_ASSERT_EQUAL(entry.minimumTime, result.minimumTime);
+		LOGUNIT_ASSERT_EQUAL(entry.maximumTime, result.maximumTime);
+		LOGUNIT_ASSERT_EQUAL(entry.loggers, result.loggers);
+		LOGUNIT_ASSERT_EQUAL(entry.levels, result.levels);
+		LOGUNIT_ASSERT_EQUAL(entry.eventCount, result.eventCount);
+	}
+
+	/**
+	 * Check the ranges selected by time, level and logger,
+	 * and that bytes without an entry are always selected.
+	 */
+	void testFindRanges()
+	{
+		std::vector<LogFileIndex::Entry> entries;
+		entries.push_back(makeEntry(100, 100, 10, 19));
+		entries.push_back(makeEntry(200, 100, 20, 29));
+		entries.push_back(makeEntry(300, 100, 30, 39));
+
+		auto ranges = LogFileIndex::findRanges(entries, 22, 25);
+		LOGUNIT_ASSERT_EQUAL((size_t) 3, ranges.size());
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 0, ranges[0].first);
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 100, ranges[0].second);
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 200, ranges[1].first);
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 300, ranges[1].second);
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 400, ranges[2].first);
+		LOGUNIT_ASSERT_EQUAL(UINT64_MAX, ranges[2].second);
+
+		ranges = LogFileIndex::findRanges(entries, 15, 35);
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, ranges.size());
+
+		ranges = LogFileIndex::findRanges(entries, 22, 25, LogFileIndex::getLevelMask(Level::getWarn()));
+		LOGUNIT_ASSERT_EQUAL((size_t) 2, ranges.size());
+
+		LOGUNIT_ASSERT(LogFileIndex::getLevelMask(Level::getInfo()) & LogFileIndex::getLevelBit(Level::getError()));
+		LOGUNIT_ASSERT(!(LogFileIndex::getLevelMask(Level::getInfo()) & LogFileIndex::getLevelBit(Level::getDebug())));
+
+		ranges = LogFileIndex::findRanges(entries, 22, 25, UINT32_MAX, LOG4CXX_STR("a.b"));
+		LOGUNIT_ASSERT_EQUAL((size_t) 3, ranges.size());
+	}
+
+	/**
+	 * Check the index written by a FileAppender describes the whole file.
+	 */
+	void testAppender()
+	{
+		Pool p;
+		LogString fileName(LOG4CXX_STR("output/indexed.log"));
+		File(fileName).deleteFile(p);
+		File(LogFileIndex::getIndexFileName(fileName)).deleteFile(p);
+
+		FileAppenderPtr appender(new FileAppender());
+		appender->setFile(fileName);
+		appender->setAppend(false);
+		appender->setLayout(PatternLayoutPtr(new PatternLayout(LOG4CXX_STR("%d %p %c - %m%n"))));
+		appender->setOption(LOG4CXX_STR("IndexInterval"), LOG4CXX_STR("1KB"));
+		appender->activateOptions(p);
+
+		auto logger = Logger::getLogger("org.apache.log4j.index");
+		logger->setAdditivity(false);
+		logger->addAppender(appender);
+		auto before = Date::currentTime();
+		for (int i = 0; i < 200; ++i)
+			LOG4CXX_INFO(logger, "message " << i);
+		auto after = Date::currentTime();
+		appender->close();
+
+		auto entries = LogFileIndex::read(LogFileIndex::getIndexFileName(fileName), p);
+		LOGUNIT_ASSERT(1 < entries.size());
+		uint64_t position = 0;
+		uint32_t eventCount = 0;
+		for (auto& entry : entries)
+		{
+			LOGUNIT_ASSERT_EQUAL(position, entry.offset);
+			LOGUNIT_ASSERT(before <= entry.minimumTime);
+			LOGUNIT_ASSERT(entry.maximumTime <= after);
+			position += entry.length;
+			eventCount += entry.eventCount;
+		}
+		LOGUNIT_ASSERT_EQUAL((uint64_t) File(fileName).length(p), position);
+		LOGUNIT_ASSERT_EQUAL((uint32_t) 200, eventCount);
+
+		// Only the unindexed end of the file can hold later events
+		auto ranges = LogFileIndex::findRanges(entries, after + 1, after + 2);
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, ranges.size());
+		LOGUNIT_ASSERT_EQUAL(position, ranges[0].first);
+	}
+
+	/**
+	 * Check the index of a log file is removed when the file is compressed.
+	 */
+	void testCompressedArchive()
+	{
+		Pool p;
+		LogString fileName(LOG4CXX_STR("output/indexed-rolling.log"));
+		LogString archiveName(LOG4CXX_STR("output/indexed-rolling.1.log"));
+		for (auto& name : { fileName, archiveName, archiveName + LOG4CXX_STR(".gz") })
+		{
+			File(name).deleteFile(p);
+			File(LogFileIndex::getIndexFileName(name)).deleteFile(p);
+		}
+
+		auto policy = std::make_shared<rolling::FixedWindowRollingPolicy>();
+		policy->setMinIndex(1);
+		policy->setFileNamePattern(LOG4CXX_STR("output/indexed-rolling.%i.log.gz"));
+		policy->activateOptions(p);
+		auto appender = std::make_shared<rolling::RollingFileAppender>();
+		appender->setFile(fileName);
+		appender->setAppend(false);
+		appender->setLayout(PatternLayoutPtr(new PatternLayout(LOG4CXX_STR("%d %p %c - %m%n"))));
+		appender->setOption(LOG4CXX_STR("IndexInterval"), LOG4CXX_STR("1KB"));
+		appender->setRollingPolicy(policy);
+		appender->activateOptions(p);
+
+		auto logger = Logger::getLogger("org.apache.log4j.index.rolling");
+		logger->setAdditivity(false);
+		logger->addAppender(appender);
+		for (int i = 0; i < 200; ++i)
+			LOG4CXX_INFO(logger, "message " << i);
+		LOGUNIT_ASSERT(File(LogFileIndex::getIndexFileName(fileName)).exists(p));
+
+		// The helper thread has compressed the archive when the appender is closed
+		LOGUNIT_ASSERT(appender->rollover(p));
+		appender->close();
+		logger->removeAppender(appender);
+
+		LOGUNIT_ASSERT(File(archiveName + LOG4CXX_STR(".gz")).exists(p));
+		LOGUNIT_ASSERT(!File(archiveName).exists(p));
+		LOGUNIT_ASSERT(!File(LogFileIndex::getIndexFileName(archiveName)).exists(p));
+	}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(LogFileIndexTestCase);
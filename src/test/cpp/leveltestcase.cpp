@@ -45,6 +45,7 @@ LOGUNIT_CLASS(LevelTestCase)
 	LOGUNIT_TEST(testCFStringToTrace);
 #endif
 	LOGUNIT_TEST(testTrimmedToTrace);
+	LOGUNIT_TEST(testPermanent);
 	LOGUNIT_TEST_SUITE_END();
 
 #ifdef _DEBUG
@@ -142,6 +143,17 @@ public:
 		LOGUNIT_ASSERT(trace->toString() == LOG4CXX_STR("TRACE"));
 	}
 
+	/**
+	 * Tests copying a built-in level does not update a reference count.
+	 */
+	void testPermanent()
+	{
+		LevelPtr info(Level::getInfo());
+		LevelPtr copy(info);
+		LOGUNIT_ASSERT_EQUAL(0L, info.use_count());
+		LOGUNIT_ASSERT_EQUAL(Level::getInfo(), copy);
+	}
+
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(LevelTestCase);
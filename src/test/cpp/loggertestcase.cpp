@@ -31,6 +31,8 @@
 #include "logunit.h"
 #include <log4cxx/helpers/locale.h>
 #include "vectorappender.h"
+#include <atomic>
+#include <thread>
 
 using namespace log4cxx;
 using namespace log4cxx::spi;
@@ -91,6 +93,8 @@ LOGUNIT_CLASS(LoggerTestCase)
 	LOGUNIT_TEST_SUITE(LoggerTestCase);
 	LOGUNIT_TEST(testAppender1);
 	LOGUNIT_TEST(testAppender2);
+	LOGUNIT_TEST(testReconfigure);
+	LOGUNIT_TEST(testConcurrentAppenderChanges);
 	LOGUNIT_TEST(testAdditivity1);
 	LOGUNIT_TEST(testAdditivity2);
 	LOGUNIT_TEST(testAdditivity3);
@@ -158,6 +162,73 @@ public:
 		LOGUNIT_ASSERT(list.size() == 1);
 	}
 
+	/**
+	Check that reconfigure closes only the removed appenders
+	that are not attached to another logger.
+	*/
+	void testReconfigure()
+	{
+		auto kept = std::make_shared<VectorAppender>();
+		auto shared = std::make_shared<VectorAppender>();
+		auto dropped = std::make_shared<VectorAppender>();
+		auto added = std::make_shared<VectorAppender>();
+		LoggerPtr a = Logger::getLogger(LOG4CXX_TEST_STR("reconfigure.a"));
+		LoggerPtr b = Logger::getLogger(LOG4CXX_TEST_STR("reconfigure.b"));
+		a->addAppender(kept);
+		a->addAppender(shared);
+		a->addAppender(dropped);
+		b->addAppender(shared);
+
+		a->reconfigure({ kept, added }, false);
+
+		AppenderList expected{ kept, added };
+		LOGUNIT_ASSERT(expected == a->getAllAppenders());
+		LOGUNIT_ASSERT(!a->getAdditivity());
+		LOGUNIT_ASSERT(!kept->isClosed());
+		LOGUNIT_ASSERT(!shared->isClosed());
+		LOGUNIT_ASSERT(dropped->isClosed());
+		LOGUNIT_ASSERT(!added->isClosed());
+	}
+
+	/**
+	Check events are delivered while other threads add and remove appenders.
+	*/
+	void testConcurrentAppenderChanges()
+	{
+		LoggerPtr a = Logger::getLogger(LOG4CXX_TEST_STR("concurrent.a"));
+		a->setAdditivity(false);
+		auto permanent = std::make_shared<CountingAppender>();
+		a->addAppender(permanent);
+		const int threadCount = 4;
+		const int eventCount = 10000;
+		std::atomic<bool> stopping{false};
+		std::thread changer([a, &stopping]()
+		{
+			while (!stopping)
+			{
+				auto transient = std::make_shared<CountingAppender>();
+				a->addAppender(transient);
+				a->removeAppender(transient);
+			}
+		});
+		std::vector<std::thread> loggers;
+		for (int i = 0; i < threadCount; ++i)
+		{
+			loggers.emplace_back([a]()
+			{
+				for (int j = 0; j < eventCount; ++j)
+					a->forcedLog(Level::getInfo(), std::string("Hello"));
+			});
+		}
+		for (auto& t : loggers)
+			t.join();
+		stopping = true;
+		changer.join();
+		a->removeAllAppenders();
+		// CountingAppender::append runs under the appender lock
+		LOGUNIT_ASSERT_EQUAL(threadCount * eventCount, permanent->counter);
+	}
+
 	/**
 	Test if LoggerPtr a.b inherits its appender from a.
 	*/
@@ -0,0 +1,317 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/net/binarysocketappender.h>
+#include <log4cxx/net/binarysocketreceiver.h>
+#include <log4cxx/net/binaryeventencoder.h>
+#include <log4cxx/net/binaryeventdecoder.h>
+#include <log4cxx/logmanager.h>
+#include <log4cxx/mdc.h>
+#include <log4cxx/ndc.h>
+#include "../appenderskeletontestcase.h"
+#include "../vectorappender.h"
+#include <chrono>
+#include <thread>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::net;
+using namespace log4cxx::spi;
+
+/**
+   Unit tests of log4cxx::net::BinarySocketAppender
+ */
+class BinarySocketAppenderTestCase : public AppenderSkeletonTestCase
+{
+		LOGUNIT_TEST_SUITE(BinarySocketAppenderTestCase);
+		//
+		//    tests inherited from AppenderSkeletonTestCase
+		//
+		LOGUNIT_TEST(testDefaultThreshold);
+		LOGUNIT_TEST(testSetOptionThreshold);
+		LOGUNIT_TEST(testEncodeDecode);
+		LOGUNIT_TEST(testFragments);
+		LOGUNIT_TEST(testInvalidStream);
+		LOGUNIT_TEST(testUnterminatedLength);
+		LOGUNIT_TEST(testTooManyNames);
+		LOGUNIT_TEST(testSendReceive);
+		LOGUNIT_TEST(testLocationLifetime);
+		LOGUNIT_TEST(testMaxConnections);
+		LOGUNIT_TEST_SUITE_END();
+
+		enum { TEST_PORT = 4562 };
+
+		static LoggingEventPtr createEvent(int id)
+		{
+			LogString message(LOG4CXX_STR("Message "));
+			message.append(1, LogString::value_type(0x30 + id % 10));
+			return std::make_shared<LoggingEvent>
+				( LOG4CXX_STR("org.apache.log4j.binary")
+				, Level::getWarn()
+				, LOG4CXX_LOCATION
+				, std::move(message)
+				);
+		}
+
+	public:
+
+		void tearDown()
+		{
+			MDC::clear();
+			NDC::clear();
+			LogManager::resetConfiguration();
+		}
+
+		AppenderSkeleton* createAppenderSkeleton() const
+		{
+			return new BinarySocketAppender();
+		}
+
+		/**
+		 * Check the fields of an event are restored.
+		 */
+		void testEncodeDecode()
+		{
+			MDC::put(LOG4CXX_STR("key1"), LOG4CXX_STR("value1"));
+			NDC::push(LOG4CXX_STR("context"));
+			auto event = createEvent(1);
+			BinaryEventEncoder encoder;
+			encoder.setLocationInfo(true);
+			std::string bytes;
+			BinaryEventEncoder::encodeHeader(bytes);
+			encoder.encode(event, bytes);
+			encoder.encode(event, bytes);
+
+			BinaryEventDecoder decoder;
+			decoder.append(bytes.data(), bytes.size());
+			for (int i = 0; i < 2; ++i)
+			{
+				auto result = decoder.next();
+				LOGUNIT_ASSERT(result);
+				LOGUNIT_ASSERT_EQUAL(event->getLoggerName(), result->getLoggerName());
+				LOGUNIT_ASSERT_EQUAL(event->getLevel(), result->getLevel());
+				LOGUNIT_ASSERT_EQUAL(event->getMessage(), result->getMessage());
+				LOGUNIT_ASSERT_EQUAL(event->getTimeStamp(), result->getTimeStamp());
+				LOGUNIT_ASSERT_EQUAL(event->getThreadName(), result->getThreadName());
+				LogString ndc;
+				LOGUNIT_ASSERT(result->getNDC(ndc));
+				LOGUNIT_ASSERT_EQUAL(LogString(LOG4CXX_STR("context")), ndc);
+				LogString value;
+				LOGUNIT_ASSERT(result->getMDC(LOG4CXX_STR("key1"), value));
+				LOGUNIT_ASSERT_EQUAL(LogString(LOG4CXX_STR("value1")), value);
+				auto& location = result->getLocationInformation();
+				LOGUNIT_ASSERT_EQUAL(event->getLocationInformation().getLineNumber(), location.getLineNumber());
+				LOGUNIT_ASSERT_EQUAL(event->getLocationInformation().getMethodName(), location.getMethodName());
+				LOGUNIT_ASSERT_EQUAL(event->getLocationInformation().getClassName(), location.getClassName());
+			}
+			LOGUNIT_ASSERT(!decoder.next());
+
+			// The logger name is only sent once
+			std::string second;
+			encoder.encode(event, second);
+			LOGUNIT_ASSERT(second.size() < bytes.size() / 2);
+		}
+
+		/**
+		 * Check events are decoded when data arrives one byte at a time.
+		 */
+		void testFragments()
+		{
+			BinaryEventEncoder encoder;
+			std::string bytes;
+			BinaryEventEncoder::encodeHeader(bytes);
+			for (int i = 0; i < 10; ++i)
+				encoder.encode(createEvent(i), bytes);
+
+			BinaryEventDecoder decoder;
+			int count = 0;
+			for (auto ch : bytes)
+			{
+				decoder.append(&ch, 1);
+				while (auto event = decoder.next())
+				{
+					LOGUNIT_ASSERT_EQUAL(createEvent(count)->getMessage(), event->getMessage());
+					++count;
+				}
+			}
+			LOGUNIT_ASSERT_EQUAL(10, count);
+		}
+
+		/**
+		 * Check data without the stream header is rejected.
+		 */
+		void testInvalidStream()
+		{
+			BinaryEventDecoder decoder;
+			decoder.append("<log4j:event", 12);
+			bool thrown = false;
+			try
+			{
+				decoder.next();
+			}
+			catch (IOException&)
+			{
+				thrown = true;
+			}
+			LOGUNIT_ASSERT(thrown);
+		}
+
+		static void appendUnsigned(std::string& buf, uint64_t value)
+		{
+			for (; 0x80 <= value; value >>= 7)
+				buf.push_back(char(0x80 | (value & 0x7F)));
+			buf.push_back(char(value));
+		}
+
+		static std::string streamHeader()
+		{
+			std::string result("L4CB");
+			result.push_back(char(BinaryEventEncoder::VERSION));
+			return result;
+		}
+
+		/**
+		 * Decode \c data and return whether it was rejected.
+		 */
+		static bool isRejected(const std::string& data)
+		{
+			BinaryEventDecoder decoder;
+			decoder.append(data.data(), data.size());
+			try
+			{
+				while (decoder.next())
+					;
+			}
+			catch (IOException&)
+			{
+				return true;
+			}
+			return false;
+		}
+
+		/**
+		 * Check a record length that never ends is rejected.
+		 */
+		void testUnterminatedLength()
+		{
+			LOGUNIT_ASSERT(isRejected(streamHeader() + std::string(20, '\x80')));
+		}
+
+		/**
+		 * Check a peer cannot define an unlimited number or size of logger names.
+		 */
+		void testTooManyNames()
+		{
+			auto nameRecord = [](std::string& data, size_t index, size_t nameSize)
+			{
+				std::string body(1, char(1)); // NameRecord
+				appendUnsigned(body, index);
+				appendUnsigned(body, nameSize);
+				body.append(nameSize, 'n');
+				appendUnsigned(data, body.size());
+				data += body;
+			};
+			std::string manyNames = streamHeader();
+			for (size_t i = 0; i < 64 * 1024; ++i)
+				nameRecord(manyNames, i, 4);
+			LOGUNIT_ASSERT(!isRejected(manyNames));
+			nameRecord(manyNames, 64 * 1024, 4);
+			LOGUNIT_ASSERT(isRejected(manyNames));
+
+			std::string longNames = streamHeader();
+			for (size_t i = 0; i < 3; ++i)
+				nameRecord(longNames, i, 8 * 1024 * 1024);
+			LOGUNIT_ASSERT(isRejected(longNames));
+		}
+
+		/**
+		 * Check events sent by the appender are logged by the receiver.
+		 */
+		void testSendReceive()
+		{
+			auto vectorAppender = std::make_shared<VectorAppender>();
+			auto logger = Logger::getLogger("org.apache.log4j.binary");
+			logger->addAppender(vectorAppender);
+			logger->setAdditivity(false);
+			BinarySocketReceiver receiver(TEST_PORT, LogManager::getLoggerRepository());
+			receiver.start();
+
+			auto appender = std::make_shared<BinarySocketAppender>(LOG4CXX_STR("localhost"), TEST_PORT);
+			Pool p;
+			const int eventCount = 100;
+			for (int i = 0; i < eventCount; ++i)
+				appender->doAppend(createEvent(i), p);
+			appender->close();
+
+			for (int i = 0; i < 100 && vectorAppender->getVector().size() < (size_t) eventCount; ++i)
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			receiver.close();
+			LOGUNIT_ASSERT_EQUAL((size_t) eventCount, vectorAppender->getVector().size());
+			LOGUNIT_ASSERT_EQUAL((size_t) eventCount, receiver.getEventCount());
+		}
+
+		/**
+		 * Check the location of a decoded event remains valid after the decoder is gone.
+		 */
+		void testLocationLifetime()
+		{
+			auto event = createEvent(1);
+			BinaryEventEncoder encoder;
+			encoder.setLocationInfo(true);
+			std::string bytes;
+			BinaryEventEncoder::encodeHeader(bytes);
+			encoder.encode(event, bytes);
+
+			LoggingEventPtr result;
+			{
+				BinaryEventDecoder decoder;
+				decoder.append(bytes.data(), bytes.size());
+				result = decoder.next();
+			}
+			LOGUNIT_ASSERT(result);
+			auto& location = result->getLocationInformation();
+			LOGUNIT_ASSERT_EQUAL(std::string(event->getLocationInformation().getFileName())
+				, std::string(location.getFileName()));
+			LOGUNIT_ASSERT_EQUAL(event->getLocationInformation().getMethodName(), location.getMethodName());
+		}
+
+		/**
+		 * Check connections beyond the limit are closed.
+		 */
+		void testMaxConnections()
+		{
+			BinarySocketReceiver receiver(TEST_PORT, LogManager::getLoggerRepository());
+			receiver.setMaxConnections(1);
+			receiver.start();
+
+			Pool p;
+			auto first = std::make_shared<BinarySocketAppender>(LOG4CXX_STR("localhost"), TEST_PORT);
+			first->doAppend(createEvent(1), p);
+			for (int i = 0; i < 100 && receiver.getEventCount() < 1; ++i)
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			auto second = std::make_shared<BinarySocketAppender>(LOG4CXX_STR("localhost"), TEST_PORT);
+			for (int i = 0; i < 100 && receiver.getRejectedCount() < 1; ++i)
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			LOGUNIT_ASSERT_EQUAL((size_t) 1, receiver.getRejectedCount());
+			second->close();
+			first->close();
+			receiver.close();
+		}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(BinarySocketAppenderTestCase);
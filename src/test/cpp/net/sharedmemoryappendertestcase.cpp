@@ -0,0 +1,294 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/net/sharedmemoryappender.h>
+#include <log4cxx/net/sharedmemorycollector.h>
+#include <log4cxx/private/sharedmemoryring.h>
+#include <log4cxx/logmanager.h>
+#include "../appenderskeletontestcase.h"
+#include "../vectorappender.h"
+#include <log4cxx/private/appenderskeleton_priv.h>
+#include <cstring>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::net;
+using namespace log4cxx::spi;
+
+#define RING_NAME LOG4CXX_STR("/log4cxx-test-ring")
+
+namespace
+{
+// Provides access to the appender lock
+class LockableSharedMemoryAppender : public SharedMemoryAppender
+{
+	public:
+		std::unique_lock<std::recursive_mutex> lock()
+		{
+			return std::unique_lock<std::recursive_mutex>(m_priv->mutex);
+		}
+};
+}
+
+/**
+   Unit tests of log4cxx::net::SharedMemoryAppender
+ */
+class SharedMemoryAppenderTestCase : public AppenderSkeletonTestCase
+{
+		LOGUNIT_TEST_SUITE(SharedMemoryAppenderTestCase);
+		//
+		//    tests inherited from AppenderSkeletonTestCase
+		//
+		LOGUNIT_TEST(testDefaultThreshold);
+		LOGUNIT_TEST(testSetOptionThreshold);
+		LOGUNIT_TEST(testWrapAround);
+		LOGUNIT_TEST(testFull);
+		LOGUNIT_TEST(testMultipleProducers);
+		LOGUNIT_TEST(testAbandonedRecord);
+		LOGUNIT_TEST(testCollector);
+		LOGUNIT_TEST(testConcurrentAppend);
+		LOGUNIT_TEST_SUITE_END();
+
+	public:
+
+		void setUp()
+		{
+			SharedMemoryRing::unlink(RING_NAME);
+		}
+
+		void tearDown()
+		{
+			SharedMemoryRing::unlink(RING_NAME);
+			LogManager::resetConfiguration();
+		}
+
+		AppenderSkeleton* createAppenderSkeleton() const
+		{
+			return new SharedMemoryAppender();
+		}
+
+		/**
+		 * Check records of varying size are returned intact as the ring wraps around.
+		 */
+		void testWrapAround()
+		{
+			SharedMemoryRing ring(RING_NAME, 4096);
+			LOGUNIT_ASSERT_EQUAL((size_t) 4096, ring.getCapacity());
+			std::string received;
+			for (size_t size = 1; size < 1000; size += 7)
+			{
+				std::string record(size, char('a' + size % 26));
+				LOGUNIT_ASSERT(ring.publish(record.data(), record.size()));
+				received.clear();
+				auto count = ring.consume([&received](const char* data, size_t size)
+					{ received.assign(data, size); });
+				LOGUNIT_ASSERT_EQUAL((size_t) 1, count);
+				LOGUNIT_ASSERT_EQUAL(record, received);
+			}
+		}
+
+		/**
+		 * Check records are discarded when there is no room.
+		 */
+		void testFull()
+		{
+			SharedMemoryRing ring(RING_NAME, 4096);
+			char record[100] = {0};
+			int published = 0;
+			while (ring.publish(record, sizeof (record)))
+				++published;
+			LOGUNIT_ASSERT(30 < published);
+			LOGUNIT_ASSERT_EQUAL((uint64_t) 1, ring.getDiscardCount());
+
+			// A second mapping sees the same records
+			SharedMemoryRing reader(RING_NAME, 0);
+			LOGUNIT_ASSERT_EQUAL((size_t) published, reader.consume([](const char*, size_t) {}));
+			LOGUNIT_ASSERT(ring.publish(record, sizeof (record)));
+		}
+
+		/**
+		 * Check records from concurrent writers are each delivered once and in order.
+		 */
+		void testMultipleProducers()
+		{
+			SharedMemoryRing ring(RING_NAME, 64 * 1024);
+			const int threadCount = 4;
+			const int recordCount = 20000;
+			std::vector<std::thread> producers;
+			for (int id = 0; id < threadCount; ++id)
+			{
+				producers.emplace_back([&ring, id]()
+				{
+					for (int sequence = 0; sequence < recordCount; ++sequence)
+					{
+						int record[2] = { id, sequence };
+						while (!ring.publish(reinterpret_cast<const char*>(record), sizeof (record)))
+							std::this_thread::yield();
+					}
+				});
+			}
+			std::vector<int> next(threadCount, 0);
+			bool ordered = true;
+			int total = 0;
+			while (total < threadCount * recordCount)
+			{
+				total += int(ring.consume([&next, &ordered](const char* data, size_t size)
+				{
+					int record[2];
+					std::memcpy(record, data, sizeof (record));
+					ordered &= (size == sizeof (record) && record[1] == next[record[0]]);
+					++next[record[0]];
+				}));
+			}
+			for (auto& t : producers)
+				t.join();
+			LOGUNIT_ASSERT(ordered);
+			for (auto count : next)
+				LOGUNIT_ASSERT_EQUAL(recordCount, count);
+		}
+
+		/**
+		 * Check a record reserved by a process that crashed is skipped once the process has ended.
+		 */
+		void testAbandonedRecord()
+		{
+			SharedMemoryRing reader(RING_NAME, 4096);
+			auto pid = fork();
+			LOGUNIT_ASSERT(0 <= pid);
+			if (0 == pid)
+			{
+				SharedMemoryRing writer(RING_NAME, 0);
+				// Crash while copying the record data
+				writer.publish(reinterpret_cast<const char*>(uintptr_t(8)), 100);
+				_exit(0);
+			}
+			int status = 0;
+			waitpid(pid, &status, 0);
+			LOGUNIT_ASSERT(WIFSIGNALED(status));
+
+			SharedMemoryRing writer(RING_NAME, 0);
+			std::string record("after");
+			LOGUNIT_ASSERT(writer.publish(record.data(), record.size()));
+			std::string received;
+			auto consumer = [&received](const char* data, size_t size)
+				{ received.assign(data, size); };
+			LOGUNIT_ASSERT_EQUAL((size_t) 0, reader.consume(consumer));
+			size_t count = 0;
+			for (int i = 0; i < 200 && 0 == count; ++i)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+				count = reader.consume(consumer);
+			}
+			LOGUNIT_ASSERT_EQUAL((size_t) 1, count);
+			LOGUNIT_ASSERT_EQUAL(record, received);
+			LOGUNIT_ASSERT_EQUAL((uint64_t) 1, reader.getDiscardCount());
+		}
+
+		/**
+		 * Check events added by the appender are logged by the collector.
+		 */
+		void testCollector()
+		{
+			auto vectorAppender = std::make_shared<VectorAppender>();
+			auto logger = Logger::getLogger("org.apache.log4j.shm");
+			logger->addAppender(vectorAppender);
+			logger->setAdditivity(false);
+
+			auto appender = std::make_shared<SharedMemoryAppender>();
+			appender->setSharedMemoryName(RING_NAME);
+			appender->setBufferSize(64 * 1024);
+			Pool p;
+			appender->activateOptions(p);
+			const int eventCount = 100;
+			for (int i = 0; i < eventCount; ++i)
+			{
+				auto event = std::make_shared<LoggingEvent>
+					( LOG4CXX_STR("org.apache.log4j.shm")
+					, Level::getWarn()
+					, LOG4CXX_LOCATION
+					, LOG4CXX_STR("Message")
+					);
+				appender->doAppend(event, p);
+			}
+			// Events remain available after the appender is closed
+			appender->close();
+
+			SharedMemoryCollector collector(RING_NAME, LogManager::getLoggerRepository());
+			collector.start();
+			collector.close();
+			LOGUNIT_ASSERT_EQUAL((size_t) eventCount, collector.getEventCount());
+			LOGUNIT_ASSERT_EQUAL((size_t) eventCount, vectorAppender->getVector().size());
+			LOGUNIT_ASSERT_EQUAL(LogString(LOG4CXX_STR("Message")), vectorAppender->getVector()[0]->getRenderedMessage());
+		}
+
+		/**
+		 * Check threads add events without waiting for the appender lock.
+		 */
+		void testConcurrentAppend()
+		{
+			auto vectorAppender = std::make_shared<VectorAppender>();
+			auto logger = Logger::getLogger("org.apache.log4j.shm");
+			logger->addAppender(vectorAppender);
+			logger->setAdditivity(false);
+
+			auto appender = std::make_shared<LockableSharedMemoryAppender>();
+			appender->setSharedMemoryName(RING_NAME);
+			appender->setBufferSize(1024 * 1024);
+			Pool p;
+			appender->activateOptions(p);
+			const int threadCount = 4;
+			const int eventCount = 1000;
+			std::vector<std::future<void>> producers;
+			{
+				auto appenderLock = appender->lock();
+				for (int id = 0; id < threadCount; ++id)
+				{
+					producers.push_back(std::async(std::launch::async, [appender]()
+					{
+						Pool threadPool;
+						for (int i = 0; i < eventCount; ++i)
+						{
+							auto event = std::make_shared<LoggingEvent>
+								( LOG4CXX_STR("org.apache.log4j.shm")
+								, Level::getWarn()
+								, LOG4CXX_LOCATION
+								, LOG4CXX_STR("Message")
+								);
+							appender->doAppend(event, threadPool);
+						}
+					}));
+				}
+				for (auto& producer : producers)
+					LOGUNIT_ASSERT(std::future_status::ready == producer.wait_for(std::chrono::seconds(10)));
+			}
+			appender->close();
+
+			SharedMemoryCollector collector(RING_NAME, LogManager::getLoggerRepository());
+			collector.start();
+			collector.close();
+			LOGUNIT_ASSERT_EQUAL((size_t) threadCount * eventCount, collector.getEventCount());
+		}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(SharedMemoryAppenderTestCase);
@@ -24,6 +24,12 @@
 #include <log4cxx/logmanager.h>
 #include <log4cxx/simplelayout.h>
 #include <log4cxx/helpers/onlyonceerrorhandler.h>
+#include <log4cxx/helpers/serversocket.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/private/aprsocket.h>
+#include <log4cxx/private/aprserversocket.h>
+#include <apr_network_io.h>
+#include <thread>
 
 namespace LOG4CXX_NS
 {
@@ -61,6 +67,119 @@ using namespace log4cxx::net;
 
 IMPLEMENT_LOG4CXX_OBJECT(MockTriggeringEventEvaluator)
 
+namespace
+{
+
+/**
+ * A local SMTP server that accepts one session and keeps the content of each message.
+ */
+class SMTPStandIn
+{
+	public:
+		/**
+		 * Listen on a port chosen by the operating system.
+		 */
+		SMTPStandIn()
+			: port(0)
+		{
+			auto aprServer = std::make_unique<APRServerSocket>(0);
+			apr_sockaddr_t* address;
+			if (APR_SUCCESS == apr_socket_addr_get(&address, APR_LOCAL, aprServer->getSocketHandle()))
+				port = address->port;
+			server = std::move(aprServer);
+			server->setSoTimeout(10000);
+			thread = std::thread([this]() { run(); });
+		}
+
+		~SMTPStandIn()
+		{
+			if (thread.joinable())
+				thread.join();
+			server->close();
+		}
+
+		/**
+		 * The port on which the server listens.
+		 */
+		int getPort() const
+		{
+			return port;
+		}
+
+		/**
+		 * The messages received once the session has ended.
+		 */
+		const std::vector<std::string>& getMessages()
+		{
+			thread.join();
+			return messages;
+		}
+
+	private:
+		ServerSocketUniquePtr server;
+		int port;
+		std::thread thread;
+		std::vector<std::string> messages;
+
+		static void reply(APRSocket& socket, const std::string& text)
+		{
+			std::string line = text + "\r\n";
+			ByteBuffer buf(&line[0], line.size());
+			socket.write(buf);
+		}
+
+		void run()
+		{
+			auto socket = std::dynamic_pointer_cast<APRSocket>(server->accept());
+			if (!socket)
+				return;
+			socket->setSoTimeout(10000);
+			reply(*socket, "220 localhost");
+			std::string input, content;
+			bool inData = false;
+			char data[1024];
+			for (;;)
+			{
+				auto eol = input.find("\r\n");
+				if (input.npos == eol)
+				{
+					ByteBuffer buf(data, sizeof (data));
+					if (0 == socket->read(buf))
+						break;
+					input.append(data, buf.position());
+					continue;
+				}
+				auto line = input.substr(0, eol);
+				input.erase(0, eol + 2);
+				auto command = line.substr(0, 4);
+				if (inData && line == ".")
+				{
+					messages.push_back(content);
+					content.clear();
+					inData = false;
+					reply(*socket, "250 OK");
+				}
+				else if (inData)
+					content += line + "\n";
+				else if (command == "DATA")
+				{
+					inData = true;
+					reply(*socket, "354 End data with <CR><LF>.<CR><LF>");
+				}
+				else if (command == "QUIT")
+				{
+					reply(*socket, "221 Bye");
+					break;
+				}
+				else
+					reply(*socket, "250 OK");
+			}
+			socket->close();
+		}
+};
+
+} // namespace
+
 
 /**
    Unit tests of log4cxx::SocketAppender
@@ -75,6 +194,10 @@ class SMTPAppenderTestCase : public AppenderSkeletonTestCase
 		LOGUNIT_TEST(testSetOptionThreshold);
 		LOGUNIT_TEST(testTrigger);
 		LOGUNIT_TEST(testInvalid);
+		LOGUNIT_TEST(testSetOptionBackgroundSend);
+#if LOG4CXX_HAVE_LIBESMTP
+		LOGUNIT_TEST(testCoalesce);
+#endif
 //#define LOG4CXX_TEST_EMAIL_AND_SMTP_HOST_ARE_IN_ENVIRONMENT_VARIABLES
 #ifdef LOG4CXX_TEST_EMAIL_AND_SMTP_HOST_ARE_IN_ENVIRONMENT_VARIABLES
 		// This test requires the following environment variables:
@@ -133,6 +256,54 @@ class SMTPAppenderTestCase : public AppenderSkeletonTestCase
 		}
 
 
+		void testSetOptionBackgroundSend()
+		{
+			SMTPAppender appender;
+			LOGUNIT_ASSERT(!appender.getBackgroundSend());
+			appender.setOption(LOG4CXX_STR("BackgroundSend"), LOG4CXX_STR("true"));
+			appender.setOption(LOG4CXX_STR("CoalesceInterval"), LOG4CXX_STR("5000"));
+			appender.setOption(LOG4CXX_STR("MinimumSendInterval"), LOG4CXX_STR("60000"));
+			LOGUNIT_ASSERT(appender.getBackgroundSend());
+			LOGUNIT_ASSERT_EQUAL(5000, appender.getCoalesceInterval());
+			LOGUNIT_ASSERT_EQUAL(60000, appender.getMinimumSendInterval());
+		}
+
+		/**
+		 * Check triggering events within the coalesce interval are sent in one e-mail.
+		 */
+		void testCoalesce()
+		{
+			SMTPStandIn server;
+			LOGUNIT_ASSERT(0 < server.getPort());
+			auto appender = std::make_shared<SMTPAppender>();
+			appender->setSMTPHost(LOG4CXX_STR("127.0.0.1"));
+			appender->setSMTPPort(server.getPort());
+			appender->setTo(LOG4CXX_STR("you@example.invalid"));
+			appender->setFrom(LOG4CXX_STR("me@example.invalid"));
+			appender->setLayout(std::make_shared<SimpleLayout>());
+			appender->setBackgroundSend(true);
+			appender->setCoalesceInterval(60000);
+			Pool p;
+			appender->activateOptions(p);
+			auto logger = Logger::getLogger("org.apache.log4j.smtp.coalesce");
+			logger->addAppender(appender);
+			logger->setAdditivity(false);
+			LOG4CXX_ERROR(logger, "first");
+			LOG4CXX_INFO(logger, "context");
+			LOG4CXX_ERROR(logger, "second");
+			// Pending events are sent when the appender is closed
+			appender->close();
+
+			auto& messages = server.getMessages();
+			LOGUNIT_ASSERT_EQUAL((size_t) 1, messages.size());
+			LOGUNIT_ASSERT(messages[0].find("ERROR - first") != std::string::npos);
+			LOGUNIT_ASSERT(messages[0].find("INFO - context") != std::string::npos);
+			LOGUNIT_ASSERT(messages[0].find("ERROR - second") != std::string::npos);
+			auto eh = dynamic_cast<helpers::OnlyOnceErrorHandler*>(appender->getErrorHandler().get());
+			LOGUNIT_ASSERT(eh);
+			LOGUNIT_ASSERT(!eh->errorReported());
+		}
+
 		void testValid()
 		{
 			xml::DOMConfigurator::configure("input/xml/smtpAppenderValid.xml");
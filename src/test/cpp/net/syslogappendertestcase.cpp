@@ -17,7 +17,14 @@
 
 #include <log4cxx/helpers/datagramsocket.h>
 #include <log4cxx/net/syslogappender.h>
+#include <log4cxx/helpers/serversocket.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/private/aprsocket.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/logger.h>
 #include "../appenderskeletontestcase.h"
+#include <chrono>
+#include <cstdlib>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -33,9 +40,14 @@ class SyslogAppenderTestCase : public AppenderSkeletonTestCase
 		//
 		LOGUNIT_TEST(testDefaultThreshold);
 		LOGUNIT_TEST(testSetOptionThreshold);
+		LOGUNIT_TEST(testSetOptionProtocol);
+		LOGUNIT_TEST(testOctetCounting);
+		LOGUNIT_TEST(testCloseWhileUnavailable);
 
 		LOGUNIT_TEST_SUITE_END();
 
+		enum { TEST_PORT = 1514 };
+
 
 	public:
 
@@ -43,6 +55,85 @@ class SyslogAppenderTestCase : public AppenderSkeletonTestCase
 		{
 			return new log4cxx::net::SyslogAppender();
 		}
+
+		void testSetOptionProtocol()
+		{
+			net::SyslogAppender appender;
+			LOGUNIT_ASSERT_EQUAL(LogString(LOG4CXX_STR("UDP")), appender.getProtocol());
+			appender.setOption(LOG4CXX_STR("Protocol"), LOG4CXX_STR("tcp"));
+			LOGUNIT_ASSERT_EQUAL(LogString(LOG4CXX_STR("TCP")), appender.getProtocol());
+			appender.setOption(LOG4CXX_STR("MaxQueueSize"), LOG4CXX_STR("4KB"));
+			LOGUNIT_ASSERT_EQUAL((size_t) 4096, appender.getMaxQueueSize());
+		}
+
+		/**
+		 * Check each message is sent whole in an RFC 6587 octet-counted frame.
+		 */
+		void testOctetCounting()
+		{
+			auto server = ServerSocket::create(TEST_PORT);
+			server->setSoTimeout(10000);
+
+			auto appender = std::make_shared<net::SyslogAppender>();
+			appender->setLayout(std::make_shared<PatternLayout>(LOG4CXX_STR("%m")));
+			appender->setSyslogHost(LOG4CXX_STR("127.0.0.1:1514"));
+			appender->setProtocol(LOG4CXX_STR("TCP"));
+			appender->setMaxMessageLength(100);
+			Pool p;
+			appender->activateOptions(p);
+
+			auto logger = Logger::getLogger("org.apache.log4j.syslog.tcp");
+			logger->addAppender(appender);
+			logger->setAdditivity(false);
+			LogString longMessage(300, LOG4CXX_STR('x'));
+			LOG4CXX_INFO(logger, "Hello");
+			LOG4CXX_WARN(logger, longMessage);
+
+			auto socket = std::dynamic_pointer_cast<APRSocket>(server->accept());
+			LOGUNIT_ASSERT(socket);
+			socket->setSoTimeout(10000);
+			std::string received;
+			std::string expected = "9 <14>Hello304 <12>" + std::string(300, 'x');
+			char data[1024];
+			while (received.size() < expected.size())
+			{
+				ByteBuffer buf(data, sizeof (data));
+				if (0 == socket->read(buf))
+					break;
+				received.append(data, buf.position());
+			}
+			logger->removeAppender(appender);
+			appender->close();
+			socket->close();
+			server->close();
+			LOGUNIT_ASSERT_EQUAL(expected, received);
+		}
+
+		/**
+		 * Check close does not wait for the host when it cannot be reached.
+		 */
+		void testCloseWhileUnavailable()
+		{
+			auto logger = Logger::getLogger("org.apache.log4j.syslog.unavailable");
+			logger->setAdditivity(false);
+			for (auto delay : { LOG4CXX_STR("0"), LOG4CXX_STR("60000") })
+			{
+				auto appender = std::make_shared<net::SyslogAppender>();
+				appender->setLayout(std::make_shared<PatternLayout>(LOG4CXX_STR("%m")));
+				appender->setSyslogHost(LOG4CXX_STR("127.0.0.1:1514"));
+				appender->setProtocol(LOG4CXX_STR("TCP"));
+				appender->setOption(LOG4CXX_STR("ReconnectionDelay"), delay);
+				Pool p;
+				appender->activateOptions(p);
+				logger->addAppender(appender);
+				LOG4CXX_INFO(logger, "Hello");
+				logger->removeAppender(appender);
+
+				auto start = std::chrono::steady_clock::now();
+				appender->close();
+				LOGUNIT_ASSERT(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+			}
+		}
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(SyslogAppenderTestCase);
@@ -17,6 +17,8 @@
 
 #include <log4cxx/net/telnetappender.h>
 #include <log4cxx/patternlayout.h>
+#include <log4cxx/helpers/inetaddress.h>
+#include <log4cxx/helpers/socket.h>
 #include "../appenderskeletontestcase.h"
 #include <apr_thread_proc.h>
 #include <apr_time.h>
@@ -39,6 +41,8 @@ class TelnetAppenderTestCase : public AppenderSkeletonTestCase
 		LOGUNIT_TEST(testActivateClose);
 		LOGUNIT_TEST(testActivateSleepClose);
 		LOGUNIT_TEST(testActivateWriteClose);
+		LOGUNIT_TEST(testSetOptionMaxQueueSize);
+		LOGUNIT_TEST(testStalledClient);
 
 		LOGUNIT_TEST_SUITE_END();
 
@@ -97,6 +101,43 @@ class TelnetAppenderTestCase : public AppenderSkeletonTestCase
 			appender->close();
 		}
 
+		void testSetOptionMaxQueueSize()
+		{
+			TelnetAppenderPtr appender(new TelnetAppender());
+			appender->setOption(LOG4CXX_STR("MaxQueueSize"), LOG4CXX_STR("2KB"));
+			LOGUNIT_ASSERT_EQUAL((size_t) 2048, appender->getMaxQueueSize());
+		}
+
+		/**
+		 * Check a client that does not read does not delay logging.
+		 */
+		void testStalledClient()
+		{
+			TelnetAppenderPtr appender(new TelnetAppender());
+			appender->setLayout(createLayout());
+			appender->setPort(TEST_PORT);
+			appender->setMaxQueueSize(4096);
+			Pool p;
+			appender->activateOptions(p);
+			auto address = InetAddress::getByName(LOG4CXX_STR("127.0.0.1"));
+			auto client = Socket::create(address, TEST_PORT);
+			// Allow time for the connection to be accepted
+			std::this_thread::sleep_for( std::chrono::milliseconds( 200 ) );
+			LoggerPtr root(Logger::getRootLogger());
+			root->addAppender(appender);
+
+			// Much more than the socket buffers can hold
+			std::string padding(1000, 'x');
+			for (int i = 0; i < 20000; i++)
+			{
+				LOG4CXX_INFO(root, "Hello, World " << i << padding);
+			}
+
+			root->removeAppender(appender);
+			appender->close();
+			client->close();
+		}
+
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(TelnetAppenderTestCase);
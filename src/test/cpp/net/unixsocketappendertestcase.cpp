@@ -0,0 +1,200 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/net/unixsocketappender.h>
+#include <log4cxx/simplelayout.h>
+#include <log4cxx/logmanager.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include "../appenderskeletontestcase.h"
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::net;
+using namespace log4cxx::spi;
+
+#define SOCKET_PATH "output/unixsocketappender.sock"
+
+/**
+   Unit tests of log4cxx::net::UnixSocketAppender
+ */
+class UnixSocketAppenderTestCase : public AppenderSkeletonTestCase
+{
+		LOGUNIT_TEST_SUITE(UnixSocketAppenderTestCase);
+		//
+		//    tests inherited from AppenderSkeletonTestCase
+		//
+		LOGUNIT_TEST(testDefaultThreshold);
+		LOGUNIT_TEST(testSetOptionThreshold);
+		LOGUNIT_TEST(testDatagram);
+		LOGUNIT_TEST(testBatch);
+		LOGUNIT_TEST(testSeqPacket);
+		LOGUNIT_TEST(testNonBlocking);
+		LOGUNIT_TEST_SUITE_END();
+
+		int receiver = -1;
+
+	public:
+
+		void tearDown()
+		{
+			if (0 <= receiver)
+				::close(receiver);
+			receiver = -1;
+			::unlink(SOCKET_PATH);
+			LogManager::resetConfiguration();
+		}
+
+		AppenderSkeleton* createAppenderSkeleton() const
+		{
+			return new UnixSocketAppender();
+		}
+
+		/**
+		 * Bind a socket of \c type to SOCKET_PATH.
+		 */
+		int createReceiver(int type)
+		{
+			::unlink(SOCKET_PATH);
+			struct sockaddr_un address;
+			std::memset(&address, 0, sizeof (address));
+			address.sun_family = AF_UNIX;
+			std::strcpy(address.sun_path, SOCKET_PATH);
+			receiver = ::socket(AF_UNIX, type, 0);
+			LOGUNIT_ASSERT(0 <= receiver);
+			LOGUNIT_ASSERT_EQUAL(0, ::bind(receiver, reinterpret_cast<struct sockaddr*>(&address), sizeof (address)));
+			return receiver;
+		}
+
+		UnixSocketAppenderPtr createAppender(int bufferSize)
+		{
+			auto appender = std::make_shared<UnixSocketAppender>();
+			appender->setLayout(std::make_shared<SimpleLayout>());
+			appender->setSocketPath(LOG4CXX_STR(SOCKET_PATH));
+			appender->setBufferSize(bufferSize);
+			return appender;
+		}
+
+		void appendEvents(const UnixSocketAppenderPtr& appender, int count)
+		{
+			Pool p;
+			for (int i = 0; i < count; ++i)
+			{
+				LogString msg(LOG4CXX_STR("Message "));
+				StringHelper::toString(i, p, msg);
+				auto event = std::make_shared<LoggingEvent>
+					( LOG4CXX_STR("org.apache.log4j.unixsocket")
+					, Level::getWarn()
+					, LOG4CXX_LOCATION
+					, std::move(msg)
+					);
+				appender->doAppend(event, p);
+			}
+		}
+
+		/**
+		 * The messages available at \c fd.
+		 */
+		std::vector<std::string> receive(int fd)
+		{
+			std::vector<std::string> result;
+			char buffer[1024];
+			ssize_t size;
+			while (0 < (size = ::recv(fd, buffer, sizeof (buffer), MSG_DONTWAIT)))
+				result.push_back(std::string(buffer, size_t(size)));
+			return result;
+		}
+
+		/**
+		 * Check each event is sent as a datagram.
+		 */
+		void testDatagram()
+		{
+			auto fd = createReceiver(SOCK_DGRAM);
+			auto appender = createAppender(1);
+			Pool p;
+			appender->activateOptions(p);
+			appendEvents(appender, 3);
+			auto messages = receive(fd);
+			LOGUNIT_ASSERT_EQUAL((size_t) 3, messages.size());
+			LOGUNIT_ASSERT_EQUAL(std::string("WARN - Message 2\n"), messages[2]);
+			LOGUNIT_ASSERT_EQUAL((uint64_t) 0, appender->getDiscardCount());
+		}
+
+		/**
+		 * Check buffered events are sent in order when the appender is closed.
+		 */
+		void testBatch()
+		{
+			auto fd = createReceiver(SOCK_DGRAM);
+			auto appender = createAppender(10);
+			appender->setFlushInterval(60000);
+			Pool p;
+			appender->activateOptions(p);
+			appendEvents(appender, 8);
+			appender->close();
+			auto messages = receive(fd);
+			LOGUNIT_ASSERT_EQUAL((size_t) 8, messages.size());
+			for (size_t i = 0; i < messages.size(); ++i)
+				LOGUNIT_ASSERT_EQUAL("WARN - Message " + std::to_string(i) + "\n", messages[i]);
+		}
+
+		/**
+		 * Check events are sent as records on a SOCK_SEQPACKET connection.
+		 */
+		void testSeqPacket()
+		{
+			auto listener = createReceiver(SOCK_SEQPACKET);
+			LOGUNIT_ASSERT_EQUAL(0, ::listen(listener, 1));
+			auto appender = createAppender(4);
+			appender->setOption(LOG4CXX_STR("SocketType"), LOG4CXX_STR("SeqPacket"));
+			LOGUNIT_ASSERT(appender->getSeqPacket());
+			Pool p;
+			appender->activateOptions(p);
+			int fd = ::accept(listener, nullptr, nullptr);
+			LOGUNIT_ASSERT(0 <= fd);
+			appendEvents(appender, 4);
+			appender->close();
+			auto messages = receive(fd);
+			::close(fd);
+			LOGUNIT_ASSERT_EQUAL((size_t) 4, messages.size());
+			LOGUNIT_ASSERT_EQUAL(std::string("WARN - Message 0\n"), messages[0]);
+		}
+
+		/**
+		 * Check events are discarded instead of waiting for a receiver that is not reading.
+		 */
+		void testNonBlocking()
+		{
+			auto fd = createReceiver(SOCK_DGRAM);
+			auto appender = createAppender(1);
+			appender->setOption(LOG4CXX_STR("Blocking"), LOG4CXX_STR("false"));
+			Pool p;
+			appender->activateOptions(p);
+			const int eventCount = 10000;
+			appendEvents(appender, eventCount);
+			auto discardCount = appender->getDiscardCount();
+			LOGUNIT_ASSERT(0 < discardCount);
+			LOGUNIT_ASSERT_EQUAL(size_t(eventCount - discardCount), receive(fd).size());
+		}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(UnixSocketAppenderTestCase);
@@ -17,6 +17,8 @@
 
 #include <log4cxx/net/xmlsocketappender.h>
 #include <log4cxx/xml/domconfigurator.h>
+#include <log4cxx/helpers/appendermetrics.h>
+#include <log4cxx/logger.h>
 #include "../appenderskeletontestcase.h"
 #include "apr.h"
 
@@ -34,6 +36,8 @@ class XMLSocketAppenderTestCase : public AppenderSkeletonTestCase
 		//
 		LOGUNIT_TEST(testDefaultThreshold);
 		LOGUNIT_TEST(testSetOptionThreshold);
+		LOGUNIT_TEST(testBackgroundSendOptions);
+		LOGUNIT_TEST(testBackgroundSendUnavailable);
 		//LOGUNIT_TEST(test_fluent_bit);
 
 		LOGUNIT_TEST_SUITE_END();
@@ -46,6 +50,47 @@ class XMLSocketAppenderTestCase : public AppenderSkeletonTestCase
 			return new log4cxx::net::XMLSocketAppender();
 		}
 
+		void testBackgroundSendOptions()
+		{
+			net::XMLSocketAppenderPtr appender(new net::XMLSocketAppender());
+			appender->setOption(LOG4CXX_STR("BackgroundSend"), LOG4CXX_STR("true"));
+			appender->setOption(LOG4CXX_STR("MaxQueueSize"), LOG4CXX_STR("2KB"));
+			appender->setOption(LOG4CXX_STR("ReplayBufferSize"), LOG4CXX_STR("1KB"));
+			LOGUNIT_ASSERT(appender->getBackgroundSend());
+			LOGUNIT_ASSERT_EQUAL((size_t) 2048, appender->getMaxQueueSize());
+			LOGUNIT_ASSERT_EQUAL((size_t) 1024, appender->getReplayBufferSize());
+		}
+
+		/**
+		 * Check logging does not wait when the server is unavailable.
+		 */
+		void testBackgroundSendUnavailable()
+		{
+			net::XMLSocketAppenderPtr appender(new net::XMLSocketAppender());
+			appender->setRemoteHost(LOG4CXX_STR("localhost"));
+			// A port which is not expected to be in use
+			appender->setPort(9);
+			appender->setReconnectionDelay(60000);
+			appender->setBackgroundSend(true);
+			appender->setMaxQueueSize(4096);
+			appender->setMetricsEnabled(true);
+			Pool p;
+			appender->activateOptions(p);
+
+			auto logger = Logger::getLogger("org.apache.log4j.xmlsocket.unavailable");
+			logger->addAppender(appender);
+			logger->setAdditivity(false);
+			for (int i = 0; i < 1000; ++i)
+			{
+				LOG4CXX_INFO(logger, "Message " << i);
+			}
+			logger->removeAppender(appender);
+
+			auto snapshot = appender->getMetrics()->getSnapshot();
+			LOGUNIT_ASSERT(0 < snapshot.counters[AppenderMetrics::Discards]);
+			appender->close();
+		}
+
 		void test_fluent_bit()
 		{
 			xml::DOMConfigurator::configure("input/xml/fluent-bit.xml");
@@ -31,6 +31,7 @@ LOGUNIT_CLASS(PropertyConfiguratorTest)
 	LOGUNIT_TEST(testInherited);
 	LOGUNIT_TEST(testNull);
 	LOGUNIT_TEST(testAppenderThreshold);
+	LOGUNIT_TEST(testReconfigure);
 	LOGUNIT_TEST_SUITE_END();
 
 public:
@@ -85,6 +86,54 @@ public:
 		LogManager::resetConfiguration();
 	}
 
+	void testReconfigure()
+	{
+		Properties previous;
+		previous.put(LOG4CXX_STR("log4j.rootLogger"), LOG4CXX_STR("INFO,VECTOR1"));
+		previous.put(LOG4CXX_STR("log4j.logger.org.apache.log4j.PropertyConfiguratorTest"), LOG4CXX_STR("WARN,VECTOR2"));
+		previous.put(LOG4CXX_STR("log4j.logger.org.apache.log4j.Removed"), LOG4CXX_STR("ERROR"));
+		previous.put(LOG4CXX_STR("log4j.appender.VECTOR1"), LOG4CXX_STR("org.apache.log4j.VectorAppender"));
+		previous.put(LOG4CXX_STR("log4j.appender.VECTOR2"), LOG4CXX_STR("org.apache.log4j.VectorAppender"));
+		PropertyConfigurator().doConfigure(previous, LogManager::getLoggerRepository());
+		LoggerPtr root(Logger::getRootLogger());
+		LoggerPtr logger = Logger::getLogger("org.apache.log4j.PropertyConfiguratorTest");
+		LoggerPtr removed = Logger::getLogger("org.apache.log4j.Removed");
+		auto vector1 = log4cxx::cast<VectorAppender>(root->getAppender(LOG4CXX_STR("VECTOR1")));
+		auto vector2 = log4cxx::cast<VectorAppender>(logger->getAppender(LOG4CXX_STR("VECTOR2")));
+		LOGUNIT_ASSERT(vector1);
+		LOGUNIT_ASSERT(vector2);
+		LOG4CXX_INFO(root, "Before reconfigure");
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, vector1->vector.size());
+
+		Properties current;
+		current.put(LOG4CXX_STR("log4j.rootLogger"), LOG4CXX_STR("DEBUG,VECTOR1"));
+		current.put(LOG4CXX_STR("log4j.logger.org.apache.log4j.PropertyConfiguratorTest"), LOG4CXX_STR("INFO,VECTOR2"));
+		current.put(LOG4CXX_STR("log4j.appender.VECTOR1"), LOG4CXX_STR("org.apache.log4j.VectorAppender"));
+		current.put(LOG4CXX_STR("log4j.appender.VECTOR2"), LOG4CXX_STR("org.apache.log4j.VectorAppender"));
+		current.put(LOG4CXX_STR("log4j.appender.VECTOR2.threshold"), LOG4CXX_STR("WARN"));
+		PropertyConfigurator().doReconfigure(previous, current, LogManager::getLoggerRepository());
+
+		// The unchanged appender is retained and remains open
+		LOGUNIT_ASSERT(root->getAppender(LOG4CXX_STR("VECTOR1")) == vector1);
+		LOGUNIT_ASSERT(!vector1->isClosed());
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, vector1->vector.size());
+
+		// The changed appender is replaced and the previous instance closed
+		auto newVector2 = log4cxx::cast<VectorAppender>(logger->getAppender(LOG4CXX_STR("VECTOR2")));
+		LOGUNIT_ASSERT(newVector2);
+		LOGUNIT_ASSERT(newVector2 != vector2);
+		LOGUNIT_ASSERT(vector2->isClosed());
+		LOGUNIT_ASSERT_EQUAL((int) Level::WARN_INT, newVector2->getThreshold()->toInt());
+
+		// Levels are updated
+		LOGUNIT_ASSERT_EQUAL((int) Level::DEBUG_INT, root->getLevel()->toInt());
+		LOGUNIT_ASSERT_EQUAL((int) Level::INFO_INT, logger->getLevel()->toInt());
+
+		// A logger no longer configured is reset
+		LOGUNIT_ASSERT(!removed->getLevel());
+		LogManager::resetConfiguration();
+	}
+
 };
 
 
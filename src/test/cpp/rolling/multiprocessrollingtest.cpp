@@ -0,0 +1,250 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../logunit.h"
+#include <log4cxx/logger.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/file.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/rolling/fixedwindowrollingpolicy.h>
+#include <log4cxx/rolling/multiprocessrollingfileappender.h>
+#include <log4cxx/private/multiprocessrolloverstate.h>
+#include <apr_time.h>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::rolling;
+
+namespace
+{
+// The offsets of fields in the control block
+const std::streamoff SequenceOffset = 8;
+const std::streamoff NameLengthOffset = 24;
+
+std::string readFile(const char* fileName)
+{
+	std::ifstream input(fileName);
+	std::stringstream content;
+	content << input.rdbuf();
+	return content.str();
+}
+
+template <typename T>
+void overwrite(const char* fileName, std::streamoff offset, T value)
+{
+	std::fstream file(fileName, std::ios::in | std::ios::out | std::ios::binary);
+	file.seekp(offset);
+	file.write(reinterpret_cast<const char*>(&value), sizeof (value));
+}
+}
+
+/**
+ * Tests of the state that MultiprocessRollingFileAppender shares between processes.
+ */
+LOGUNIT_CLASS(MultiprocessRollingTest)
+{
+	LOGUNIT_TEST_SUITE(MultiprocessRollingTest);
+	LOGUNIT_TEST(testGenerationSeenByOtherProcess);
+	LOGUNIT_TEST(testRolloverSeenByOtherProcess);
+	LOGUNIT_TEST(testGarbageControlFile);
+	LOGUNIT_TEST(testTruncatedControlFile);
+	LOGUNIT_TEST(testTornControlFile);
+	LOGUNIT_TEST_SUITE_END();
+
+public:
+	/**
+	 * Check that a rollover published by one process
+	 * is seen by another process that has the control file open.
+	 */
+	void testGenerationSeenByOtherProcess()
+	{
+		const char* controlFile = "output/multiprocess-generation.ctl";
+		Pool p;
+		File().setPath(LOG4CXX_STR("output/multiprocess-generation.ctl")).deleteFile(p);
+		MultiprocessRolloverState state;
+		LOGUNIT_ASSERT(state.open(controlFile));
+		auto initialGeneration = state.getGeneration();
+
+		int ready[2];
+		LOGUNIT_ASSERT_EQUAL(0, pipe(ready));
+		pid_t pid = fork();
+		LOGUNIT_ASSERT(0 <= pid);
+		if (0 == pid)
+		{
+			MultiprocessRolloverState childState;
+			bool opened = childState.open(controlFile);
+			char ok = opened ? 1 : 0;
+			if (write(ready[1], &ok, 1) != 1 || !opened)
+				_exit(1);
+			// Wait up to 5 seconds for the rollover
+			for (int i = 0; i < 500 && childState.getGeneration() == initialGeneration; ++i)
+				apr_sleep(10000);
+			uint64_t generation;
+			auto activeFile = childState.getActiveFileName(generation);
+			_exit(generation != initialGeneration && activeFile == LOG4CXX_STR("output/rolled.log") ? 0 : 2);
+		}
+
+		char ok = 0;
+		LOGUNIT_ASSERT_EQUAL(1, (int) read(ready[0], &ok, 1));
+		LOGUNIT_ASSERT_EQUAL(1, (int) ok);
+		state.publish(LOG4CXX_STR("output/rolled.log"), 0);
+
+		int status = 0;
+		LOGUNIT_ASSERT_EQUAL(pid, waitpid(pid, &status, 0));
+		LOGUNIT_ASSERT(WIFEXITED(status));
+		LOGUNIT_ASSERT_EQUAL(0, WEXITSTATUS(status));
+		close(ready[0]);
+		close(ready[1]);
+	}
+
+	/**
+	 * Check that an appender in another process reopens the active file
+	 * after this process rolls it over, instead of writing to the renamed file.
+	 */
+	void testRolloverSeenByOtherProcess()
+	{
+		Pool p;
+		File().setPath(LOG4CXX_STR("output/multiprocess.log")).deleteFile(p);
+		File().setPath(LOG4CXX_STR("output/multiprocess.1.log")).deleteFile(p);
+		auto appender = createAppender(p);
+		auto logger = Logger::getLogger("org.apache.log4j.rolling.MultiprocessRollingTest");
+		logger->setAdditivity(false);
+		logger->addAppender(appender);
+		LOG4CXX_INFO(logger, "before rollover");
+
+		int ready[2], rolled[2];
+		LOGUNIT_ASSERT_EQUAL(0, pipe(ready));
+		LOGUNIT_ASSERT_EQUAL(0, pipe(rolled));
+		pid_t pid = fork();
+		LOGUNIT_ASSERT(0 <= pid);
+		if (0 == pid)
+		{
+			logger->removeAllAppenders();
+			Pool childPool;
+			auto childAppender = createAppender(childPool);
+			logger->addAppender(childAppender);
+			char signal = 1;
+			if (write(ready[1], &signal, 1) != 1 || read(rolled[0], &signal, 1) != 1)
+				_exit(1);
+			LOG4CXX_INFO(logger, "from the other process");
+			childAppender->close();
+			_exit(0);
+		}
+
+		char signal = 0;
+		LOGUNIT_ASSERT_EQUAL(1, (int) read(ready[0], &signal, 1));
+		LOGUNIT_ASSERT(appender->rollover(p));
+		LOGUNIT_ASSERT_EQUAL(1, (int) write(rolled[1], &signal, 1));
+
+		int status = 0;
+		LOGUNIT_ASSERT_EQUAL(pid, waitpid(pid, &status, 0));
+		LOGUNIT_ASSERT(WIFEXITED(status));
+		LOGUNIT_ASSERT_EQUAL(0, WEXITSTATUS(status));
+		for (auto fd : { ready[0], ready[1], rolled[0], rolled[1] })
+			close(fd);
+		appender->close();
+		logger->removeAllAppenders();
+
+		auto backup = readFile("output/multiprocess.1.log");
+		auto active = readFile("output/multiprocess.log");
+		LOGUNIT_ASSERT(backup.find("before rollover") != std::string::npos);
+		LOGUNIT_ASSERT(backup.find("from the other process") == std::string::npos);
+		LOGUNIT_ASSERT(active.find("from the other process") != std::string::npos);
+	}
+
+	/**
+	 * Check that a file that does not hold a control block is not used.
+	 */
+	void testGarbageControlFile()
+	{
+		const char* controlFile = "output/multiprocess-garbage.ctl";
+		std::ofstream(controlFile, std::ios::binary) << std::string(4096, '\xA5');
+		MultiprocessRolloverState state;
+		LOGUNIT_ASSERT(!state.open(controlFile));
+		LOGUNIT_ASSERT(!state.isOpen());
+	}
+
+	/**
+	 * Check that a file shorter than a control block is not used.
+	 */
+	void testTruncatedControlFile()
+	{
+		const char* controlFile = "output/multiprocess-truncated.ctl";
+		Pool p;
+		File().setPath(LOG4CXX_STR("output/multiprocess-truncated.ctl")).deleteFile(p);
+		{
+			MultiprocessRolloverState state;
+			LOGUNIT_ASSERT(state.open(controlFile));
+		}
+		auto content = readFile(controlFile);
+		std::ofstream(controlFile, std::ios::binary | std::ios::trunc) << content.substr(0, 16);
+		MultiprocessRolloverState state;
+		LOGUNIT_ASSERT(!state.open(controlFile));
+	}
+
+	/**
+	 * Check that a name left partly written by a process that ended while publishing
+	 * is not used, and that a corrupt name length causes the file to be rejected.
+	 */
+	void testTornControlFile()
+	{
+		const char* controlFile = "output/multiprocess-torn.ctl";
+		Pool p;
+		File().setPath(LOG4CXX_STR("output/multiprocess-torn.ctl")).deleteFile(p);
+		MultiprocessRolloverState state;
+		LOGUNIT_ASSERT(state.open(controlFile));
+		state.publish(LOG4CXX_STR("output/first.log"), 0);
+		uint64_t generation = state.getGeneration();
+
+		// An odd sequence number marks a publication in progress
+		overwrite(controlFile, SequenceOffset, generation + 1);
+		LOGUNIT_ASSERT(state.getActiveFileName(generation).empty());
+
+		// The next rollover replaces the torn name
+		state.publish(LOG4CXX_STR("output/second.log"), 0);
+		LOGUNIT_ASSERT_EQUAL(LogString(LOG4CXX_STR("output/second.log")), state.getActiveFileName(generation));
+		LOGUNIT_ASSERT_EQUAL((uint64_t) 0, generation & 1);
+		state.close();
+
+		overwrite(controlFile, NameLengthOffset, uint32_t(100000));
+		LOGUNIT_ASSERT(!state.open(controlFile));
+	}
+
+private:
+	MultiprocessRollingFileAppenderPtr createAppender(Pool& p)
+	{
+		auto policy = std::make_shared<FixedWindowRollingPolicy>();
+		policy->setMinIndex(1);
+		policy->setMaxIndex(2);
+		policy->setFileNamePattern(LOG4CXX_STR("output/multiprocess.%i.log"));
+		auto appender = std::make_shared<MultiprocessRollingFileAppender>();
+		appender->setLayout(std::make_shared<PatternLayout>(LOG4CXX_STR("%m%n")));
+		appender->setFile(LOG4CXX_STR("output/multiprocess.log"));
+		appender->setAppend(true);
+		appender->setRollingPolicy(policy);
+		appender->activateOptions(p);
+		return appender;
+	}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(MultiprocessRollingTest);
@@ -33,6 +33,7 @@
 #include <log4cxx/consoleappender.h>
 #include <log4cxx/helpers/exception.h>
 #include <log4cxx/helpers/fileoutputstream.h>
+#include <thread>
 
 
 using namespace log4cxx;
@@ -56,6 +57,8 @@ LOGUNIT_CLASS(SizeBasedRollingTest)
 	LOGUNIT_TEST(test4);
 	LOGUNIT_TEST(test5);
 	LOGUNIT_TEST(test6);
+	LOGUNIT_TEST(test7);
+	LOGUNIT_TEST(test8);
 	LOGUNIT_TEST_SUITE_END();
 
 	LoggerPtr root;
@@ -362,6 +365,101 @@ public:
 		LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sbr-test6.log"),  File("witness/rolling/sbr-test3.log")));
 	}
 
+	/**
+	 * Tests increasing index values with a window of one file.
+	 */
+	void test7()
+	{
+		Pool p;
+		File("output/sizeBased-test7.log.manifest").deleteFile(p);
+		File("output/sizeBased-test7.0").deleteFile(p);
+		File("output/sizeBased-test7.1").deleteFile(p);
+
+		{
+			PatternLayoutPtr layout = PatternLayoutPtr(new PatternLayout(LOG4CXX_STR("%m\n")));
+			RollingFileAppenderPtr rfa = RollingFileAppenderPtr(new RollingFileAppender());
+			rfa->setName(LOG4CXX_STR("ROLLING"));
+			rfa->setAppend(false);
+			rfa->setLayout(layout);
+			rfa->setFile(LOG4CXX_STR("output/sizeBased-test7.log"));
+
+			FixedWindowRollingPolicyPtr fwrp = FixedWindowRollingPolicyPtr(new FixedWindowRollingPolicy());
+			SizeBasedTriggeringPolicyPtr sbtp = SizeBasedTriggeringPolicyPtr(new SizeBasedTriggeringPolicy());
+
+			sbtp->setMaxFileSize(100);
+			fwrp->setMinIndex(0);
+			fwrp->setMaxIndex(0);
+			fwrp->setMonotonicIndex(true);
+			fwrp->setFileNamePattern(LOG4CXX_STR("output/sizeBased-test7.%i"));
+			fwrp->activateOptions(p);
+
+			rfa->setRollingPolicy(fwrp);
+			rfa->setTriggeringPolicy(sbtp);
+			rfa->activateOptions(p);
+			root->addAppender(rfa);
+
+			common(logger, 0);
+
+			// Destroying the policy completes the background work
+			root->removeAppender(rfa);
+			rfa->close();
+		}
+
+		LOGUNIT_ASSERT_EQUAL(true, File("output/sizeBased-test7.log").exists(p));
+		LOGUNIT_ASSERT_EQUAL(false, File("output/sizeBased-test7.0").exists(p));
+		LOGUNIT_ASSERT_EQUAL(true, File("output/sizeBased-test7.1").exists(p));
+		LOGUNIT_ASSERT_EQUAL(true, File("output/sizeBased-test7.log.manifest").exists(p));
+
+		LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sizeBased-test7.log"),
+				File("witness/rolling/sbr-test2.log")));
+		LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sizeBased-test7.1"),
+				File("witness/rolling/sbr-test2.0")));
+	}
+
+
+	/**
+	 * Tests rolling to a file created in advance.
+	 */
+	void test8()
+	{
+		PatternLayoutPtr layout = PatternLayoutPtr(new PatternLayout(LOG4CXX_STR("%m\n")));
+		RollingFileAppenderPtr rfa = RollingFileAppenderPtr(new RollingFileAppender());
+		rfa->setName(LOG4CXX_STR("ROLLING"));
+		rfa->setAppend(false);
+		rfa->setLayout(layout);
+		rfa->setFile(LOG4CXX_STR("output/sizeBased-test8.log"));
+		rfa->setPreOpenNextFile(true);
+		rfa->setPreallocateSize(4096);
+
+		FixedWindowRollingPolicyPtr swrp = FixedWindowRollingPolicyPtr(new FixedWindowRollingPolicy());
+		SizeBasedTriggeringPolicyPtr sbtp = SizeBasedTriggeringPolicyPtr(new SizeBasedTriggeringPolicy());
+
+		sbtp->setMaxFileSize(100);
+		swrp->setMinIndex(0);
+
+		swrp->setFileNamePattern(LOG4CXX_STR("output/sizeBased-test8.%i"));
+		Pool p;
+		swrp->activateOptions(p);
+
+		rfa->setRollingPolicy(swrp);
+		rfa->setTriggeringPolicy(sbtp);
+		rfa->activateOptions(p);
+		root->addAppender(rfa);
+
+		// Allow time for the next file to be prepared
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		common(logger, 0);
+		rfa->close();
+
+		LOGUNIT_ASSERT_EQUAL(false, File("output/sizeBased-test8.log.next").exists(p));
+		LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sizeBased-test8.log"),
+				File("witness/rolling/sbr-test2.log")));
+		LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sizeBased-test8.0"),
+				File("witness/rolling/sbr-test2.0")));
+		LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sizeBased-test8.1"),
+				File("witness/rolling/sbr-test2.1")));
+	}
+
 };
 
 
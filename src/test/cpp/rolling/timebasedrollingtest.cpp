@@ -28,9 +28,12 @@
 #include <log4cxx/helpers/date.h>
 #include <iostream>
 #include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/fileoutputstream.h>
+#include <log4cxx/helpers/bytebuffer.h>
 #include "../util/compare.h"
 #include "../logunit.h"
 
+#include <apr_file_io.h>
 #include <apr_strings.h>
 #include <apr_time.h>
 #include <random>
@@ -83,6 +86,7 @@ LOGUNIT_CLASS(TimeBasedRollingTest)
 	LOGUNIT_TEST(test6);
 	LOGUNIT_TEST(test7);
 	LOGUNIT_TEST(rollIntoDir);
+	LOGUNIT_TEST(maxHistory);
 	LOGUNIT_TEST_SUITE_END();
 
 private:
@@ -680,6 +684,49 @@ public:
 		this->checkFilesExist(	pool, LOG4CXX_STR("test6."), fnames, 0, __LINE__);
 	}
 
+	/**
+	 * Check the oldest existing archives are deleted on activation when CleanHistoryOnStart is set.
+	 */
+	void maxHistory()
+	{
+		Pool pool;
+		const LogString fnames[] =
+		{
+			LOG4CXX_STR("" DIR_PRE_OUTPUT "maxHistory-2000-01-01"),
+			LOG4CXX_STR("" DIR_PRE_OUTPUT "maxHistory-2000-01-02"),
+			LOG4CXX_STR("" DIR_PRE_OUTPUT "maxHistory-2000-01-03"),
+			LOG4CXX_STR("" DIR_PRE_OUTPUT "maxHistory-2000-01-04")
+		};
+		apr_time_t modified = apr_time_now() - 10 * APR_USEC_PER_SEC;
+
+		for (auto& fname : fnames)
+		{
+			FileOutputStream fos(fname, false);
+			char data[] = "archived\n";
+			ByteBuffer buf(data, sizeof(data) - 1);
+			fos.write(buf, pool);
+			fos.close(pool);
+			LOG4CXX_ENCODE_CHAR(path, fname);
+			apr_file_mtime_set(path.c_str(), modified, pool.getAPRPool());
+			modified += APR_USEC_PER_SEC;
+		}
+
+		{
+			TimeBasedRollingPolicyPtr tbrp(new TimeBasedRollingPolicy());
+			tbrp->setFileNamePattern(LOG4CXX_STR("" DIR_PRE_OUTPUT "maxHistory-%d{yyyy-MM-dd}"));
+			tbrp->setOption(LOG4CXX_STR("MaxHistory"), LOG4CXX_STR("2"));
+			tbrp->setOption(LOG4CXX_STR("CleanHistoryOnStart"), LOG4CXX_STR("true"));
+			tbrp->activateOptions(pool);
+			LOGUNIT_ASSERT_EQUAL(2, tbrp->getMaxHistory());
+			// Destroying the policy completes the background work
+		}
+
+		LOGUNIT_ASSERT_EQUAL(false, File(fnames[0]).exists(pool));
+		LOGUNIT_ASSERT_EQUAL(false, File(fnames[1]).exists(pool));
+		LOGUNIT_ASSERT_EQUAL(true, File(fnames[2]).exists(pool));
+		LOGUNIT_ASSERT_EQUAL(true, File(fnames[3]).exists(pool));
+	}
+
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(TimeBasedRollingTest);
@@ -0,0 +1,230 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <log4cxx/routingappender.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/logmanager.h>
+#include <log4cxx/mdc.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/file.h>
+#include "logunit.h"
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+/**
+ * RoutingAppender tests.
+ */
+LOGUNIT_CLASS(RoutingAppenderTestCase)
+{
+	LOGUNIT_TEST_SUITE(RoutingAppenderTestCase);
+	LOGUNIT_TEST(testMDCRoute);
+	LOGUNIT_TEST(testMaxOpenFiles);
+	LOGUNIT_TEST(testFileName);
+	LOGUNIT_TEST(testIdleTimeout);
+	LOGUNIT_TEST(testMaxRoutes);
+	LOGUNIT_TEST(testAppenderClass);
+	LOGUNIT_TEST_SUITE_END();
+
+public:
+	void tearDown()
+	{
+		MDC::clear();
+		LogManager::resetConfiguration();
+	}
+
+	RoutingAppenderPtr createAppender(const LogString& fileNamePattern, int maxOpenFiles
+		, const std::vector<std::pair<LogString, LogString>>& options = {})
+	{
+		auto appender = std::make_shared<RoutingAppender>();
+		for (auto& option : options)
+			appender->setOption(option.first, option.second);
+		appender->setLayout(std::make_shared<PatternLayout>(LOG4CXX_STR("%m%n")));
+		appender->setRoute(LOG4CXX_STR("%X{tenant}"));
+		appender->setFileNamePattern(fileNamePattern);
+		appender->setMaxOpenFiles(maxOpenFiles);
+		appender->setOption(LOG4CXX_STR("Append"), LOG4CXX_STR("false"));
+		Pool p;
+		appender->activateOptions(p);
+		return appender;
+	}
+
+	std::vector<std::string> readLines(const std::string& fileName)
+	{
+		std::vector<std::string> result;
+		std::ifstream input(fileName.c_str());
+		std::string line;
+		while (std::getline(input, line))
+			result.push_back(line);
+		return result;
+	}
+
+	/**
+	 * Check events are written to the file of their MDC value.
+	 */
+	void testMDCRoute()
+	{
+		auto appender = createAppender(LOG4CXX_STR("output/routing-{route}.log"), 100);
+		auto logger = Logger::getLogger("org.apache.log4j.RoutingAppenderTestCase");
+		logger->addAppender(appender);
+		for (auto tenant : {"alpha", "beta", "alpha"})
+		{
+			MDC::put("tenant", tenant);
+			LOG4CXX_INFO(logger, "event for " << tenant);
+		}
+		MDC::remove("tenant");
+		LOG4CXX_INFO(logger, "untagged");
+		LOGUNIT_ASSERT_EQUAL((size_t) 3, appender->getRouteCount());
+		appender->close();
+
+		auto alpha = readLines("output/routing-alpha.log");
+		LOGUNIT_ASSERT_EQUAL((size_t) 2, alpha.size());
+		LOGUNIT_ASSERT_EQUAL(std::string("event for alpha"), alpha[1]);
+		auto beta = readLines("output/routing-beta.log");
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, beta.size());
+		LOGUNIT_ASSERT_EQUAL(std::string("event for beta"), beta[0]);
+		auto other = readLines("output/routing-default.log");
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, other.size());
+		LOGUNIT_ASSERT_EQUAL(std::string("untagged"), other[0]);
+	}
+
+	/**
+	 * Check files closed to stay within MaxOpenFiles are reopened in append mode.
+	 */
+	void testMaxOpenFiles()
+	{
+		auto appender = createAppender(LOG4CXX_STR("output/routinglru-{route}.log"), 2);
+		auto logger = Logger::getLogger("org.apache.log4j.RoutingAppenderTestCase");
+		logger->addAppender(appender);
+		const char* tenants[] = { "t0", "t1", "t2" };
+		for (int i = 0; i < 30; ++i)
+		{
+			MDC::put("tenant", tenants[i % 3]);
+			LOG4CXX_INFO(logger, "event " << i);
+			LOGUNIT_ASSERT(appender->getOpenFileCount() <= 2);
+		}
+		appender->close();
+		LOGUNIT_ASSERT_EQUAL((size_t) 0, appender->getOpenFileCount());
+
+		for (int t = 0; t < 3; ++t)
+		{
+			auto lines = readLines(std::string("output/routinglru-") + tenants[t] + ".log");
+			LOGUNIT_ASSERT_EQUAL((size_t) 10, lines.size());
+			LOGUNIT_ASSERT_EQUAL("event " + std::to_string(t), lines[0]);
+			LOGUNIT_ASSERT_EQUAL("event " + std::to_string(27 + t), lines[9]);
+		}
+	}
+
+	/**
+	 * Check a route key cannot select another directory.
+	 */
+	void testFileName()
+	{
+		auto appender = createAppender(LOG4CXX_STR("output/routingname-{route}.log"), 100);
+		auto logger = Logger::getLogger("org.apache.log4j.RoutingAppenderTestCase");
+		logger->addAppender(appender);
+		MDC::put("tenant", "../x/y");
+		LOG4CXX_INFO(logger, "escaped");
+		appender->close();
+
+		auto lines = readLines("output/routingname-_._x_y.log");
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, lines.size());
+		LOGUNIT_ASSERT_EQUAL(std::string("escaped"), lines[0]);
+	}
+
+	/**
+	 * Check an unused file is closed after IdleTimeout and reopened in append mode.
+	 */
+	void testIdleTimeout()
+	{
+		auto appender = createAppender(LOG4CXX_STR("output/routingidle-{route}.log"), 100
+			, { { LOG4CXX_STR("IdleTimeout"), LOG4CXX_STR("100") } });
+		auto logger = Logger::getLogger("org.apache.log4j.RoutingAppenderTestCase");
+		logger->addAppender(appender);
+		MDC::put("tenant", "idle");
+		LOG4CXX_INFO(logger, "before");
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, appender->getOpenFileCount());
+		for (int i = 0; i < 100 && 0 < appender->getOpenFileCount(); ++i)
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		LOGUNIT_ASSERT_EQUAL((size_t) 0, appender->getOpenFileCount());
+
+		LOG4CXX_INFO(logger, "after");
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, appender->getOpenFileCount());
+		appender->close();
+
+		auto lines = readLines("output/routingidle-idle.log");
+		LOGUNIT_ASSERT_EQUAL((size_t) 2, lines.size());
+		LOGUNIT_ASSERT_EQUAL(std::string("before"), lines[0]);
+		LOGUNIT_ASSERT_EQUAL(std::string("after"), lines[1]);
+	}
+
+	/**
+	 * Check route keys beyond MaxRoutes use the default route.
+	 */
+	void testMaxRoutes()
+	{
+		auto appender = createAppender(LOG4CXX_STR("output/routingmax-{route}.log"), 100
+			, { { LOG4CXX_STR("MaxRoutes"), LOG4CXX_STR("2") } });
+		auto logger = Logger::getLogger("org.apache.log4j.RoutingAppenderTestCase");
+		logger->addAppender(appender);
+		for (auto tenant : {"m0", "m1", "m2", "m3", "m0"})
+		{
+			MDC::put("tenant", tenant);
+			LOG4CXX_INFO(logger, "event for " << tenant);
+		}
+		LOGUNIT_ASSERT_EQUAL((size_t) 3, appender->getRouteCount());
+		appender->close();
+
+		LOGUNIT_ASSERT_EQUAL((size_t) 2, readLines("output/routingmax-m0.log").size());
+		LOGUNIT_ASSERT_EQUAL((size_t) 1, readLines("output/routingmax-m1.log").size());
+		auto other = readLines("output/routingmax-default.log");
+		LOGUNIT_ASSERT_EQUAL((size_t) 2, other.size());
+		LOGUNIT_ASSERT_EQUAL(std::string("event for m2"), other[0]);
+		LOGUNIT_ASSERT_EQUAL(std::string("event for m3"), other[1]);
+	}
+
+	/**
+	 * Check the options of a FileAppender subclass are applied to each route.
+	 */
+	void testAppenderClass()
+	{
+		Pool p;
+		File backup(LOG4CXX_STR("output/routingroll-r.log.1"));
+		backup.deleteFile(p);
+		auto appender = createAppender(LOG4CXX_STR("output/routingroll-{route}.log"), 100
+			, { { LOG4CXX_STR("AppenderClass"), LOG4CXX_STR("RollingFileAppender") }
+			  , { LOG4CXX_STR("MaxFileSize"), LOG4CXX_STR("1KB") }
+			  , { LOG4CXX_STR("MaxBackupIndex"), LOG4CXX_STR("1") }
+			  });
+		auto logger = Logger::getLogger("org.apache.log4j.RoutingAppenderTestCase");
+		logger->addAppender(appender);
+		MDC::put("tenant", "r");
+		for (int i = 0; i < 100; ++i)
+			LOG4CXX_INFO(logger, "rolling event " << i);
+		appender->close();
+		LOGUNIT_ASSERT(backup.exists(p));
+	}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(RoutingAppenderTestCase);
@@ -24,7 +24,10 @@
 #include "../util/iso8601filter.h"
 #include "../util/threadfilter.h"
 #include "../util/transformer.h"
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <thread>
 #include <log4cxx/file.h>
 #include <log4cxx/fileappender.h>
 #include <apr_pools.h>
@@ -53,6 +56,7 @@ LOGUNIT_CLASS(DOMTestCase)
 #endif
 	LOGUNIT_TEST(test3);
 	LOGUNIT_TEST(test4);
+	LOGUNIT_TEST(testIncrementalReload);
 	LOGUNIT_TEST_SUITE_END();
 
 	LoggerPtr root;
@@ -226,6 +230,54 @@ public:
 		bool exists = file.exists(p);
 		LOGUNIT_ASSERT(exists);
 	}
+
+	/**
+	 * Writes a configuration with two file appenders attached to the root logger,
+	 * the second using \c pattern.
+	 */
+	static void writeIncrementalConfiguration(const char* fileName, const char* pattern)
+	{
+		std::ofstream config(fileName, std::ios::trunc);
+		config << "<log4j:configuration incrementalReload=\"true\" xmlns:log4j=\"http://jakarta.apache.org/log4j/\">\n"
+			<< "<appender name=\"Unchanged\" class=\"org.apache.log4j.FileAppender\">\n"
+			<< "<param name=\"File\" value=\"output/incremental-unchanged.log\"/>\n"
+			<< "<layout class=\"org.apache.log4j.PatternLayout\"><param name=\"ConversionPattern\" value=\"%m%n\"/></layout>\n"
+			<< "</appender>\n"
+			<< "<appender name=\"Changed\" class=\"org.apache.log4j.FileAppender\">\n"
+			<< "<param name=\"File\" value=\"output/incremental-changed.log\"/>\n"
+			<< "<layout class=\"org.apache.log4j.PatternLayout\"><param name=\"ConversionPattern\" value=\"" << pattern << "\"/></layout>\n"
+			<< "</appender>\n"
+			<< "<root><level value=\"info\"/><appender-ref ref=\"Unchanged\"/><appender-ref ref=\"Changed\"/></root>\n"
+			<< "</log4j:configuration>\n";
+	}
+
+	/**
+	 * Checks a reload with incrementalReload set keeps an appender whose definition is unchanged
+	 * and replaces one whose definition has changed.
+	 */
+	void testIncrementalReload()
+	{
+		const char* fileName = "output/incremental.xml";
+		writeIncrementalConfiguration(fileName, "%m%n");
+		DOMConfigurator::configureAndWatch(fileName, 100);
+		auto unchanged = root->getAppender(LOG4CXX_STR("Unchanged"));
+		auto changed = root->getAppender(LOG4CXX_STR("Changed"));
+		LOGUNIT_ASSERT(unchanged);
+		LOGUNIT_ASSERT(changed);
+
+		// Ensure the modification time differs where it has a resolution of one second
+		std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+		writeIncrementalConfiguration(fileName, "%p %m%n");
+		AppenderPtr replacement;
+		for (int i = 0; i < 100 && (!replacement || replacement == changed); ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			replacement = root->getAppender(LOG4CXX_STR("Changed"));
+		}
+		LOGUNIT_ASSERT(replacement);
+		LOGUNIT_ASSERT(replacement != changed);
+		LOGUNIT_ASSERT(unchanged == root->getAppender(LOG4CXX_STR("Unchanged")));
+	}
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(DOMTestCase);
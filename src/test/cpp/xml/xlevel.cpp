@@ -31,13 +31,13 @@ XLevel::XLevel(int level1, const LogString& name1, int syslogEquivalent1)
 
 LevelPtr XLevel::getTrace()
 {
-	static const LevelPtr trace(new XLevel(XLevel::TRACE_INT, LOG4CXX_STR("TRACE"), 7));
+	static const LevelPtr trace = makePermanent(new XLevel(XLevel::TRACE_INT, LOG4CXX_STR("TRACE"), 7));
 	return trace;
 }
 
 LevelPtr XLevel::getLethal()
 {
-	static const LevelPtr lethal(new XLevel(XLevel::LETHAL_INT, LOG4CXX_STR("LETHAL"), 0));
+	static const LevelPtr lethal = makePermanent(new XLevel(XLevel::LETHAL_INT, LOG4CXX_STR("LETHAL"), 0));
 	return lethal;
 }
 